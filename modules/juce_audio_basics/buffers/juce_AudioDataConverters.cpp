@@ -450,6 +450,319 @@ void AudioDataConverters::deinterleaveSamples (const float* source, float** dest
                                     numSamples);
 }
 
+//==============================================================================
+namespace FastConversionHelpers
+{
+    using Format = AudioData::FastConversion::Format;
+
+    static int getBytesPerSample (Format format) noexcept
+    {
+        return format == AudioData::FastConversion::int16 ? 2
+             : format == AudioData::FastConversion::int24 ? 3 : 4;
+    }
+
+    template <typename Type, bool swapBytes>
+    static inline Type read (const char* source) noexcept
+    {
+        auto v = readUnaligned<Type> (source);
+        return swapBytes ? ByteOrder::swap (v) : v;
+    }
+
+    template <typename Type, bool swapBytes>
+    static inline void write (char* dest, Type v) noexcept
+    {
+        writeUnaligned<Type> (dest, swapBytes ? ByteOrder::swap (v) : v);
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    static inline __m128i load128 (const void* source) noexcept       { return _mm_loadu_si128 (static_cast<const __m128i*> (source)); }
+    static inline void store128 (void* dest, __m128i v) noexcept      { _mm_storeu_si128 (static_cast<__m128i*> (dest), v); }
+
+    static inline __m128i swapBytesIn16BitValues (__m128i v) noexcept
+    {
+        return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+    }
+
+    static inline __m128i swapBytesIn32BitValues (__m128i v) noexcept
+    {
+        v = swapBytesIn16BitValues (v);
+        return _mm_or_si128 (_mm_slli_epi32 (v, 16), _mm_srli_epi32 (v, 16));
+    }
+   #endif
+
+    //==============================================================================
+    /*  The load functions read samples into 32-bit integers, with the integer formats
+        shifted up to fill all 32 bits, as AudioData::Pointer::getAsInt32() does, and
+        floats left as their raw bit patterns. The store functions do the reverse.
+
+        Where the SIMD loops read a whole register from interleaved data, they read a
+        little way past the last sample they use, so they stop early enough to keep
+        those reads inside the data.
+    */
+    template <bool swapBytes>
+    static void loadInt16 (int32* dest, const char* source, int stride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (stride == 2)
+        {
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                auto v = load128 (source + 2 * i);
+
+                if (swapBytes)
+                    v = swapBytesIn16BitValues (v);
+
+                store128 (dest + i,     _mm_unpacklo_epi16 (_mm_setzero_si128(), v));
+                store128 (dest + i + 4, _mm_unpackhi_epi16 (_mm_setzero_si128(), v));
+            }
+        }
+        else if (stride == 4)
+        {
+            for (; i + 5 <= numSamples; i += 4)
+            {
+                auto v = load128 (source + 4 * i);
+
+                if (swapBytes)
+                    v = swapBytesIn16BitValues (v);
+
+                store128 (dest + i, _mm_slli_epi32 (v, 16));
+            }
+        }
+       #endif
+
+        for (source += i * stride; i < numSamples; ++i, source += stride)
+            dest[i] = (int32) ((uint32) read<uint16, swapBytes> (source) << 16);
+    }
+
+    template <bool bigEndian>
+    static void loadInt24 (int32* dest, const char* source, int stride, int numSamples) noexcept
+    {
+        // Reading 4 bytes at a time is much quicker, but reads a byte beyond each
+        // sample, so the last one has to be done separately.
+        for (int i = 0; i < numSamples - 1; ++i, source += stride)
+        {
+            auto v = readUnaligned<uint32> (source);
+
+            dest[i] = bigEndian ? (int32) (ByteOrder::swapIfLittleEndian (v) & 0xffffff00u)
+                                : (int32) (ByteOrder::swapIfBigEndian (v) << 8);
+        }
+
+        dest[numSamples - 1] = (int32) ((uint32) (bigEndian ? ByteOrder::bigEndian24Bit (source)
+                                                            : ByteOrder::littleEndian24Bit (source)) << 8);
+    }
+
+    template <bool swapBytes>
+    static void loadInt32 (int32* dest, const char* source, int stride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (stride == 4)
+        {
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                auto v = load128 (source + 4 * i);
+                store128 (dest + i, swapBytes ? swapBytesIn32BitValues (v) : v);
+            }
+        }
+        else if (stride == 8)
+        {
+            for (; i + 5 <= numSamples; i += 4)
+            {
+                auto v = _mm_castps_si128 (_mm_shuffle_ps (_mm_castsi128_ps (load128 (source + 8 * i)),
+                                                           _mm_castsi128_ps (load128 (source + 8 * i + 16)),
+                                                           _MM_SHUFFLE (2, 0, 2, 0)));
+                store128 (dest + i, swapBytes ? swapBytesIn32BitValues (v) : v);
+            }
+        }
+       #endif
+
+        for (source += i * stride; i < numSamples; ++i, source += stride)
+            dest[i] = (int32) read<uint32, swapBytes> (source);
+    }
+
+    template <bool swapBytes>
+    static void storeInt16 (char* dest, const int32* source, int stride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (stride == 2)
+        {
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                auto v = _mm_packs_epi32 (_mm_srai_epi32 (load128 (source + i), 16),
+                                          _mm_srai_epi32 (load128 (source + i + 4), 16));
+
+                store128 (dest + 2 * i, swapBytes ? swapBytesIn16BitValues (v) : v);
+            }
+        }
+       #endif
+
+        for (dest += i * stride; i < numSamples; ++i, dest += stride)
+            write<uint16, swapBytes> (dest, (uint16) (source[i] >> 16));
+    }
+
+    template <bool bigEndian>
+    static void storeInt24 (char* dest, const int32* source, int stride, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i, dest += stride)
+        {
+            if (bigEndian)
+                ByteOrder::bigEndian24BitToChars (source[i] >> 8, dest);
+            else
+                ByteOrder::littleEndian24BitToChars (source[i] >> 8, dest);
+        }
+    }
+
+    template <bool swapBytes>
+    static void storeInt32 (char* dest, const int32* source, int stride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (stride == 4)
+        {
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                auto v = load128 (source + i);
+                store128 (dest + 4 * i, swapBytes ? swapBytesIn32BitValues (v) : v);
+            }
+        }
+       #endif
+
+        for (dest += i * stride; i < numSamples; ++i, dest += stride)
+            write<uint32, swapBytes> (dest, (uint32) source[i]);
+    }
+
+    static void load (int32* dest, const char* source, Format format, bool bigEndian, int stride, int numSamples) noexcept
+    {
+        const auto swapBytes = (bigEndian != (bool) AudioData::NativeEndian::isBigEndian);
+
+        switch (format)
+        {
+            case AudioData::FastConversion::int16:      swapBytes ? loadInt16<true> (dest, source, stride, numSamples)
+                                                                  : loadInt16<false> (dest, source, stride, numSamples); break;
+            case AudioData::FastConversion::int24:      bigEndian ? loadInt24<true> (dest, source, stride, numSamples)
+                                                                  : loadInt24<false> (dest, source, stride, numSamples); break;
+            case AudioData::FastConversion::int32:
+            case AudioData::FastConversion::float32:    swapBytes ? loadInt32<true> (dest, source, stride, numSamples)
+                                                                  : loadInt32<false> (dest, source, stride, numSamples); break;
+            case AudioData::FastConversion::unsupported:
+            default:                                    jassertfalse; break;
+        }
+    }
+
+    static void store (char* dest, const int32* source, Format format, bool bigEndian, int stride, int numSamples) noexcept
+    {
+        const auto swapBytes = (bigEndian != (bool) AudioData::NativeEndian::isBigEndian);
+
+        switch (format)
+        {
+            case AudioData::FastConversion::int16:      swapBytes ? storeInt16<true> (dest, source, stride, numSamples)
+                                                                  : storeInt16<false> (dest, source, stride, numSamples); break;
+            case AudioData::FastConversion::int24:      bigEndian ? storeInt24<true> (dest, source, stride, numSamples)
+                                                                  : storeInt24<false> (dest, source, stride, numSamples); break;
+            case AudioData::FastConversion::int32:
+            case AudioData::FastConversion::float32:    swapBytes ? storeInt32<true> (dest, source, stride, numSamples)
+                                                                  : storeInt32<false> (dest, source, stride, numSamples); break;
+            case AudioData::FastConversion::unsupported:
+            default:                                    jassertfalse; break;
+        }
+    }
+
+    /*  Converts full-scale 32-bit integers to floats, in place. */
+    static void convertIntsToFloats (int32* samples, int numSamples) noexcept
+    {
+        auto* floats = reinterpret_cast<float*> (samples);
+        constexpr auto scale = (float) (1.0 / (1.0 + (double) AudioData::Int32::maxValue));
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto scales = _mm_set1_ps (scale);
+
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_ps (floats + i, _mm_mul_ps (_mm_cvtepi32_ps (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (samples + i))), scales));
+       #elif JUCE_USE_ARM_NEON
+        for (; i + 4 <= numSamples; i += 4)
+            vst1q_f32 (floats + i, vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 (samples + i)), scale));
+       #endif
+
+        for (; i < numSamples; ++i)
+            floats[i] = (float) samples[i] * scale;
+    }
+
+    /*  Converts floats to full-scale 32-bit integers, in place. This works in double
+        precision so that the rounding matches AudioData::Float32::getAsInt32().
+    */
+    static void convertFloatsToInts (int32* samples, int numSamples) noexcept
+    {
+        auto* floats = reinterpret_cast<const float*> (samples);
+        constexpr auto maxValue = (double) AudioData::Int32::maxValue;
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto one = _mm_set1_pd (1.0), minusOne = _mm_set1_pd (-1.0), scale = _mm_set1_pd (maxValue);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto f = _mm_loadu_ps (floats + i);
+            const auto low  = _mm_mul_pd (_mm_min_pd (_mm_max_pd (_mm_cvtps_pd (f), minusOne), one), scale);
+            const auto high = _mm_mul_pd (_mm_min_pd (_mm_max_pd (_mm_cvtps_pd (_mm_movehl_ps (f, f)), minusOne), one), scale);
+
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (samples + i), _mm_unpacklo_epi64 (_mm_cvtpd_epi32 (low), _mm_cvtpd_epi32 (high)));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            samples[i] = roundToInt (jlimit (-1.0, 1.0, (double) floats[i]) * maxValue);
+    }
+}
+
+bool AudioData::FastConversion::convert (void* dest, Format destFormat, bool destIsBigEndian, int destStrideBytes,
+                                         const void* source, Format sourceFormat, bool sourceIsBigEndian, int sourceStrideBytes,
+                                         int numSamples) noexcept
+{
+    using namespace FastConversionHelpers;
+
+    if (destFormat == unsupported || sourceFormat == unsupported || numSamples <= 0)
+        return false;
+
+    auto* destBytes = static_cast<char*> (dest);
+    auto* sourceBytes = static_cast<const char*> (source);
+
+    // in-place conversions have to be done in a particular order, so leave them to the caller
+    const auto destEnd   = destBytes   + (numSamples - 1) * (int64) destStrideBytes   + getBytesPerSample (destFormat);
+    const auto sourceEnd = sourceBytes + (numSamples - 1) * (int64) sourceStrideBytes + getBytesPerSample (sourceFormat);
+
+    if (destBytes < sourceEnd && sourceBytes < destEnd)
+        return false;
+
+    const auto sourceIsFloat = (sourceFormat == float32), destIsFloat = (destFormat == float32);
+
+    constexpr int blockSize = 256;
+    alignas (16) juce::int32 block[blockSize];
+
+    for (int done = 0; done < numSamples;)
+    {
+        const auto num = jmin (blockSize, numSamples - done);
+
+        load (block, sourceBytes + done * (int64) sourceStrideBytes, sourceFormat, sourceIsBigEndian, sourceStrideBytes, num);
+
+        if (sourceIsFloat && ! destIsFloat)
+            convertFloatsToInts (block, num);
+        else if (destIsFloat && ! sourceIsFloat)
+            convertIntsToFloats (block, num);
+
+        store (destBytes + done * (int64) destStrideBytes, block, destFormat, destIsBigEndian, destStrideBytes, num);
+        done += num;
+    }
+
+    return true;
+}
+
 //==============================================================================
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -531,6 +844,86 @@ public:
         JUCE_END_IGNORE_WARNINGS_MSVC
     };
 
+    // converts samples the slow way, to check the results of the vectorised conversions
+    template <class DestPointer, class SourcePointer>
+    static void convertOneAtATime (DestPointer dest, SourcePointer source, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i, ++dest, ++source)
+        {
+            if (dest.isFloatingPoint())
+                dest.setAsFloat (source.getAsFloat());
+            else
+                dest.setAsInt32 (source.getAsInt32());
+        }
+    }
+
+    template <class SourceFormat, class SourceEndianness, class DestFormat, class DestEndianness>
+    struct FastConversionTest
+    {
+        using SourcePointer = AudioData::Pointer<SourceFormat, SourceEndianness, AudioData::Interleaved, AudioData::NonConst>;
+        using DestPointer   = AudioData::Pointer<DestFormat,   DestEndianness,   AudioData::Interleaved, AudioData::NonConst>;
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            for (int numSourceChannels = 1; numSourceChannels <= 3; ++numSourceChannels)
+            {
+                for (int numDestChannels = 1; numDestChannels <= 2; ++numDestChannels)
+                {
+                    const auto numSamples = 500 + r.nextInt (20);
+                    HeapBlock<char> source ((size_t) (numSamples * numSourceChannels * 4), true),
+                                    expected ((size_t) (numSamples * numDestChannels * 4), true),
+                                    result ((size_t) (numSamples * numDestChannels * 4), true);
+
+                    const auto sourceChannel = numSourceChannels - 1, destChannel = numDestChannels - 1;
+                    SourcePointer s (addBytesToPointer (source.get(), sourceChannel * SourcePointer::getBytesPerSample()), numSourceChannels);
+
+                    for (int i = 0; i < numSamples; ++i, ++s)
+                    {
+                        if ((i & 1) == 0)
+                            s.setAsFloat (r.nextFloat() * 2.2f - 1.1f);
+                        else
+                            s.setAsInt32 (r.nextInt());
+                    }
+
+                    SourcePointer source1 (addBytesToPointer (source.get(), sourceChannel * SourcePointer::getBytesPerSample()), numSourceChannels);
+                    DestPointer dest1 (addBytesToPointer (expected.get(), destChannel * DestPointer::getBytesPerSample()), numDestChannels);
+                    DestPointer dest2 (addBytesToPointer (result.get(), destChannel * DestPointer::getBytesPerSample()), numDestChannels);
+
+                    convertOneAtATime (dest1, source1, numSamples);
+                    dest2.convertSamples (source1, numSamples);
+
+                    unitTest.expect (memcmp (expected.get(), result.get(), (size_t) (numSamples * numDestChannels * 4)) == 0);
+                }
+            }
+        }
+    };
+
+    template <class SourceFormat, class SourceEndianness>
+    struct FastConversionTestForSource
+    {
+        template <class DestFormat>
+        static void testDest (UnitTest& unitTest, Random& r)
+        {
+            FastConversionTest<SourceFormat, SourceEndianness, DestFormat, AudioData::LittleEndian>::test (unitTest, r);
+            FastConversionTest<SourceFormat, SourceEndianness, DestFormat, AudioData::BigEndian>::test (unitTest, r);
+        }
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            testDest<AudioData::Int16>   (unitTest, r);
+            testDest<AudioData::Int24>   (unitTest, r);
+            testDest<AudioData::Int32>   (unitTest, r);
+            testDest<AudioData::Float32> (unitTest, r);
+        }
+    };
+
+    template <class SourceFormat>
+    static void testFastConversions (UnitTest& unitTest, Random& r)
+    {
+        FastConversionTestForSource<SourceFormat, AudioData::LittleEndian>::test (unitTest, r);
+        FastConversionTestForSource<SourceFormat, AudioData::BigEndian>::test (unitTest, r);
+    }
+
     template <class F1, class E1, class FormatType>
     struct Test3
     {
@@ -579,6 +972,12 @@ public:
         beginTest ("Round-trip conversion: Float32");
         Test1 <AudioData::Float32>::test (*this, r);
 
+        beginTest ("Vectorised conversions match per-sample conversions");
+        testFastConversions<AudioData::Int16>   (*this, r);
+        testFastConversions<AudioData::Int24>   (*this, r);
+        testFastConversions<AudioData::Int32>   (*this, r);
+        testFastConversions<AudioData::Float32> (*this, r);
+
         using Format = AudioData::Format<AudioData::Float32, AudioData::NativeEndian>;
 
         beginTest ("Interleaving");
@@ -461,6 +461,9 @@ public:
             // trying to write to a const pointer! For a writeable one, use AudioData::NonConst instead!
             static_assert (Constness::isConst == 0, "Attempt to write to a const pointer");
 
+            if (FastConversion::convert (*this, source, numSamples))
+                return;
+
             Pointer dest (*this);
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
@@ -565,6 +568,9 @@ public:
         /** Returns a pointer to the underlying data. */
         const void* getRawData() const noexcept                 { return data.data; }
 
+        /** @internal */
+        using SampleFormatType = SampleFormat;
+
     private:
         //==============================================================================
         SampleFormat data;
@@ -575,6 +581,46 @@ public:
         Pointer operator-- (int);
     };
 
+    //==============================================================================
+    /** @internal
+        Vectorised routines that Pointer::convertSamples() uses to convert blocks of the
+        16, 24 and 32-bit integer and 32-bit float formats, instead of converting them
+        one sample at a time. The results are identical to the per-sample conversions.
+    */
+    struct JUCE_API  FastConversion
+    {
+        enum Format { unsupported, int16, int24, int32, float32 };
+
+        /** Converts the samples if there's a routine for this pair of formats and the
+            source and destination don't overlap, otherwise returns false.
+        */
+        template <class DestPointerType, class SourcePointerType>
+        static bool convert (const DestPointerType& dest, const SourcePointerType& source, int numSamples) noexcept
+        {
+            constexpr auto destFormat   = getFormat (static_cast<const typename DestPointerType::SampleFormatType*>   (nullptr));
+            constexpr auto sourceFormat = getFormat (static_cast<const typename SourcePointerType::SampleFormatType*> (nullptr));
+
+            return destFormat != unsupported && sourceFormat != unsupported && numSamples >= minSamplesToConvert
+                    && convert (const_cast<void*> (dest.getRawData()), destFormat, DestPointerType::isBigEndian(), dest.getNumBytesBetweenSamples(),
+                                source.getRawData(), sourceFormat, SourcePointerType::isBigEndian(), source.getNumBytesBetweenSamples(),
+                                numSamples);
+        }
+
+        static bool convert (void* dest, Format destFormat, bool destIsBigEndian, int destStrideBytes,
+                             const void* source, Format sourceFormat, bool sourceIsBigEndian, int sourceStrideBytes,
+                             int numSamples) noexcept;
+
+    private:
+        enum { minSamplesToConvert = 16 };
+
+        static constexpr Format getFormat (const void*) noexcept        { return unsupported; }
+        static constexpr Format getFormat (const Int16*) noexcept       { return int16; }
+        static constexpr Format getFormat (const Int24*) noexcept       { return int24; }
+        static constexpr Format getFormat (const Int32*) noexcept       { return int32; }
+        static constexpr Format getFormat (const Int24in32*) noexcept   { return unsupported; }
+        static constexpr Format getFormat (const Float32*) noexcept     { return float32; }
+    };
+
     //==============================================================================
     /** A base class for objects that are used to convert between two different sample formats.
 
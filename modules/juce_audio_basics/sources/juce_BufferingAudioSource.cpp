@@ -51,8 +51,18 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
 {
     auto bufferSizeNeeded = jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
 
+    {
+        const ScopedLock sl (bufferRangeLock);
+
+        if (maximumBufferSize > 0)
+            bufferSizeNeeded = jlimit (jmax (samplesPerBlockExpected * 2, minimumBufferSize),
+                                       jmax (samplesPerBlockExpected * 2, maximumBufferSize),
+                                       numberOfSamplesToBuffer);
+    }
+
     if (newSampleRate != sampleRate
-         || bufferSizeNeeded != buffer.getNumSamples()
+         || buffer == nullptr
+         || bufferSizeNeeded != buffer->getNumSamples()
          || ! isPrepared)
     {
         backgroundThread.removeTimeSliceClient (this);
@@ -62,16 +72,23 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
 
         source->prepareToPlay (samplesPerBlockExpected, newSampleRate);
 
-        buffer.setSize (numberOfChannels, bufferSizeNeeded);
-        buffer.clear();
+        auto newBuffer = std::make_unique<AudioBuffer<float>> (numberOfChannels, bufferSizeNeeded);
+        newBuffer->clear();
 
         const ScopedLock sl (bufferRangeLock);
 
         bufferValidStart = 0;
         bufferValidEnd = 0;
+        publishValidRange (0, 0, ++rangeGeneration);
+        setBuffer (std::move (newBuffer));
+        retiredBuffer.reset();
+
+        lastResetTime = lastUnderrunRiskTime = Time::getMillisecondCounter();
 
         backgroundThread.addTimeSliceClient (this);
 
+        // The background thread may replace the buffer while the lock is released, so its
+        // size has to be read from currentBufferSize rather than from the buffer itself
         do
         {
             const ScopedUnlock ul (bufferRangeLock);
@@ -80,7 +97,7 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
             Thread::sleep (5);
         }
         while (prefillBuffer
-         && (bufferValidEnd - bufferValidStart < jmin (((int) newSampleRate) / 4, buffer.getNumSamples() / 2)));
+         && (bufferValidEnd - bufferValidStart < jmin (((int) newSampleRate) / 4, currentBufferSize.load() / 2)));
     }
 }
 
@@ -89,7 +106,15 @@ void BufferingAudioSource::releaseResources()
     isPrepared = false;
     backgroundThread.removeTimeSliceClient (this);
 
-    buffer.setSize (numberOfChannels, 0);
+    {
+        const ScopedLock sl (bufferRangeLock);
+
+        bufferValidStart = 0;
+        bufferValidEnd = 0;
+        publishValidRange (0, 0, ++rangeGeneration);
+        setBuffer (nullptr);
+        retiredBuffer.reset();
+    }
 
     // MSVC2015 seems to need this if statement to not generate a warning during linking.
     // As source is set in the constructor, there is no way that source could
@@ -100,58 +125,83 @@ void BufferingAudioSource::releaseResources()
 
 void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const auto bufferRange = getValidBufferRange (info.numSamples);
-
-    if (bufferRange.isEmpty())
-    {
-        // total cache miss
-        info.clearActiveBufferRegion();
-        return;
-    }
-
-    const auto validStart = bufferRange.getStart();
-    const auto validEnd = bufferRange.getEnd();
-
-    const ScopedLock sl (callbackLock);
-
-    if (validStart > 0)
-        info.buffer->clear (info.startSample, validStart);  // partial cache miss at start
+    auto* ringBuffer = acquireBuffer();
+    const auto seekCount = numSeeks.load();
+    const auto pos = nextPlayPos.load();
+    const auto validRange = readValidRange();
 
-    if (validEnd < info.numSamples)
-        info.buffer->clear (info.startSample + validEnd,
-                            info.numSamples - validEnd);    // partial cache miss at end
+    auto bufferRange = ringBuffer != nullptr ? getValidBufferRange (validRange, pos, info.numSamples)
+                                             : Range<int>();
 
-    if (validStart < validEnd)
+    if (! bufferRange.isEmpty())
     {
+        const auto validStart = bufferRange.getStart();
+        const auto validEnd = bufferRange.getEnd();
+        const auto ringSize = ringBuffer->getNumSamples();
+
         for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
         {
-            jassert (buffer.getNumSamples() > 0);
+            jassert (ringSize > 0);
 
-            const auto startBufferIndex = (int) ((validStart + nextPlayPos) % buffer.getNumSamples());
-            const auto endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer.getNumSamples());
+            const auto startBufferIndex = (int) ((validStart + pos) % ringSize);
+            const auto endBufferIndex   = (int) ((validEnd + pos)   % ringSize);
 
             if (startBufferIndex < endBufferIndex)
             {
                 info.buffer->copyFrom (chan, info.startSample + validStart,
-                                       buffer,
+                                       *ringBuffer,
                                        chan, startBufferIndex,
                                        validEnd - validStart);
             }
             else
             {
-                const auto initialSize = buffer.getNumSamples() - startBufferIndex;
+                const auto initialSize = ringSize - startBufferIndex;
 
                 info.buffer->copyFrom (chan, info.startSample + validStart,
-                                       buffer,
+                                       *ringBuffer,
                                        chan, startBufferIndex,
                                        initialSize);
 
                 info.buffer->copyFrom (chan, info.startSample + validStart + initialSize,
-                                       buffer,
+                                       *ringBuffer,
                                        chan, 0,
                                        (validEnd - validStart) - initialSize);
             }
         }
+
+        // If the background thread discarded this part of the buffer while we were
+        // copying it (e.g. because of a seek), it may have been overwritten
+        if (! isCopyStillValid (ringBuffer, validRange, pos + validStart, pos + validEnd))
+            bufferRange = {};
+    }
+
+    bufferInUse.store (nullptr);
+
+    if (bufferRange.isEmpty())
+    {
+        // total cache miss
+        info.clearActiveBufferRegion();
+    }
+    else
+    {
+        if (bufferRange.getStart() > 0)
+            info.buffer->clear (info.startSample, bufferRange.getStart());  // partial cache miss at start
+
+        if (bufferRange.getEnd() < info.numSamples)
+            info.buffer->clear (info.startSample + bufferRange.getEnd(),
+                                info.numSamples - bufferRange.getEnd());    // partial cache miss at end
+    }
+
+    if (bufferRange.getStart() <= 0 && bufferRange.getEnd() >= info.numSamples)
+    {
+        seekCountAtLastCompleteBlock = seekCount;
+    }
+    else if (pos >= 0 && seekCount == seekCountAtLastCompleteBlock)
+    {
+        // Only count gaps in continuous playback, rather than the ones that are
+        // expected while the buffer refills after a seek
+        ++numUnderruns;
+        seekCountAtLastCompleteBlock = -1;
     }
 
     nextPlayPos += info.numSamples;
@@ -214,24 +264,216 @@ void BufferingAudioSource::setNextReadPosition (int64 newPosition)
 {
     const ScopedLock sl (bufferRangeLock);
 
+    ++numSeeks;
     nextPlayPos = newPosition;
     backgroundThread.moveToFrontOfQueue (this);
 }
 
-Range<int> BufferingAudioSource::getValidBufferRange (int numSamples) const
+//==============================================================================
+void BufferingAudioSource::setAdaptiveBufferSize (int minimumSamplesToBuffer, int maximumSamplesToBuffer)
 {
+    jassert (minimumSamplesToBuffer <= maximumSamplesToBuffer);
+
     const ScopedLock sl (bufferRangeLock);
 
+    minimumBufferSize = jmax (0, minimumSamplesToBuffer);
+    maximumBufferSize = jmax (minimumBufferSize, maximumSamplesToBuffer);
+}
+
+int BufferingAudioSource::getNumBufferedSamples() const noexcept
+{
+    const auto validRange = readValidRange();
     const auto pos = nextPlayPos.load();
 
-    return { (int) (jlimit (bufferValidStart, bufferValidEnd, pos) - pos),
-             (int) (jlimit (bufferValidStart, bufferValidEnd, pos + numSamples) - pos) };
+    if (pos < validRange.start || pos >= validRange.end)
+        return 0;
+
+    return (int) (validRange.end - pos);
+}
+
+//==============================================================================
+/*  The valid region of the ring buffer is published to the audio thread through two
+    slots. The background thread always writes to the slot that isn't current and then
+    flips the counter, so a reader only has to retry if a whole update completed while
+    it was reading, and never has to wait for the background thread.
+*/
+BufferingAudioSource::ValidRange BufferingAudioSource::readValidRange() const noexcept
+{
+    for (;;)
+    {
+        const auto count = numRangesPublished.load();
+        const auto& slot = publishedRanges[count & 1];
+
+        const ValidRange range { slot.start.load(), slot.end.load(), slot.generation.load() };
+
+        if (numRangesPublished.load() == count)
+            return range;
+    }
+}
+
+void BufferingAudioSource::publishValidRange (int64 start, int64 end, uint32 generation) noexcept
+{
+    auto& slot = publishedRanges[(numRangesPublished.load() + 1) & 1];
+
+    slot.start = start;
+    slot.end = end;
+    slot.generation = generation;
+
+    ++numRangesPublished;
+}
+
+Range<int> BufferingAudioSource::getValidBufferRange (const ValidRange& range, int64 pos, int numSamples) const noexcept
+{
+    return { (int) (jlimit (range.start, range.end, pos) - pos),
+             (int) (jlimit (range.start, range.end, pos + numSamples) - pos) };
+}
+
+Range<int> BufferingAudioSource::getValidBufferRange (int numSamples) const
+{
+    return getValidBufferRange (readValidRange(), nextPlayPos.load(), numSamples);
+}
+
+//==============================================================================
+AudioBuffer<float>* BufferingAudioSource::acquireBuffer() noexcept
+{
+    for (;;)
+    {
+        auto* b = activeBuffer.load();
+        bufferInUse.store (b);
+
+        // If the buffer was replaced before we marked it as in use, the background
+        // thread may not have seen our mark, so go round again to get the new one
+        if (activeBuffer.load() == b)
+            return b;
+    }
+}
+
+bool BufferingAudioSource::isCopyStillValid (const AudioBuffer<float>* ringBuffer, const ValidRange& rangeBeforeCopy,
+                                             int64 start, int64 end) const noexcept
+{
+    // Within a generation, the valid range only ever moves forwards, and the background
+    // thread only writes to samples which are outside it. So if the samples we copied are
+    // still in range, they can't have been touched since we started copying.
+    const auto rangeAfterCopy = readValidRange();
+
+    return activeBuffer.load() == ringBuffer
+        && rangeAfterCopy.generation == rangeBeforeCopy.generation
+        && rangeAfterCopy.start <= start
+        && end <= rangeAfterCopy.end;
+}
+
+void BufferingAudioSource::setBuffer (std::unique_ptr<AudioBuffer<float>> newBuffer)
+{
+    activeBuffer.store (newBuffer.get());
+    currentBufferSize = newBuffer != nullptr ? newBuffer->getNumSamples() : 0;
+
+    jassert (retiredBuffer == nullptr || bufferInUse.load() != retiredBuffer.get());
+    retiredBuffer = std::move (buffer);
+    buffer = std::move (newBuffer);
+}
+
+void BufferingAudioSource::releaseRetiredBuffer()
+{
+    if (retiredBuffer != nullptr && bufferInUse.load() != retiredBuffer.get())
+        retiredBuffer.reset();
+}
+
+void BufferingAudioSource::resizeBuffer (int newSize)
+{
+    jassert (buffer != nullptr && retiredBuffer == nullptr);
+
+    auto newBuffer = std::make_unique<AudioBuffer<float>> (numberOfChannels, newSize);
+    newBuffer->clear();
+
+    const auto oldSize = buffer->getNumSamples();
+
+    const ScopedLock sl (bufferRangeLock);
+
+    // Keep as much of the data that's ahead of the playback position as will fit
+    const auto start = jlimit (bufferValidStart, bufferValidEnd, nextPlayPos.load());
+    const auto end = jmin (bufferValidEnd, start + newSize - 4);
+
+    for (auto pos = start; pos < end;)
+    {
+        const auto sourceIndex = (int) (pos % oldSize);
+        const auto destIndex = (int) (pos % newSize);
+        const auto numToCopy = (int) jmin (end - pos, (int64) (oldSize - sourceIndex), (int64) (newSize - destIndex));
+
+        for (int chan = 0; chan < numberOfChannels; ++chan)
+            newBuffer->copyFrom (chan, destIndex, *buffer, chan, sourceIndex, numToCopy);
+
+        pos += numToCopy;
+    }
+
+    // The audio thread must see an empty range before the new buffer, so that it can't
+    // use the old buffer's range to read from the new one
+    ++rangeGeneration;
+    publishValidRange (0, 0, rangeGeneration);
+    setBuffer (std::move (newBuffer));
+
+    bufferValidStart = start;
+    bufferValidEnd = jmax (start, end);
+    publishValidRange (bufferValidStart, bufferValidEnd, rangeGeneration);
 }
 
+void BufferingAudioSource::updateBufferSize()
+{
+    releaseRetiredBuffer();
+
+    int minSize, maxSize;
+    int64 fillLevel, playPos;
+
+    {
+        const ScopedLock sl (bufferRangeLock);
+
+        minSize = minimumBufferSize;
+        maxSize = maximumBufferSize;
+        playPos = nextPlayPos.load();
+        fillLevel = (playPos >= bufferValidStart && playPos < bufferValidEnd) ? bufferValidEnd - playPos : 0;
+    }
+
+    if (maxSize <= 0 || buffer == nullptr || retiredBuffer != nullptr)
+        return;
+
+    const auto currentSize = buffer->getNumSamples();
+    const auto now = Time::getMillisecondCounter();
+    const auto underruns = numUnderruns.load();
+
+    const auto isPlaying = playPos != playPosAtLastCheck;
+    const auto hasUnderrun = underruns != numUnderrunsAtLastCheck;
+    const auto isRunningLow = isPlaying
+                               && fillLevel < currentSize / 4
+                               && now - lastResetTime > 1000;
+
+    playPosAtLastCheck = playPos;
+    numUnderrunsAtLastCheck = underruns;
+
+    if (hasUnderrun || isRunningLow)
+    {
+        lastUnderrunRiskTime = now;
+
+        if (currentSize < maxSize)
+            resizeBuffer (jmin (maxSize, currentSize * 2));
+    }
+    else if (now - lastUnderrunRiskTime > 10000
+              && fillLevel >= (currentSize * 3) / 4
+              && currentSize > minSize)
+    {
+        lastUnderrunRiskTime = now;
+        resizeBuffer (jmax (minSize, currentSize / 2, 1024));
+    }
+}
+
+//==============================================================================
 bool BufferingAudioSource::readNextBufferChunk()
 {
+    updateBufferSize();
+
     int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
 
+    jassert (buffer != nullptr);
+    const auto bufferSize = buffer->getNumSamples();
+
     {
         const ScopedLock sl (bufferRangeLock);
 
@@ -240,10 +482,11 @@ bool BufferingAudioSource::readNextBufferChunk()
             wasSourceLooping = isLooping();
             bufferValidStart = 0;
             bufferValidEnd = 0;
+            publishValidRange (0, 0, ++rangeGeneration);
         }
 
         newBVS = jmax ((int64) 0, nextPlayPos.load());
-        newBVE = newBVS + buffer.getNumSamples() - 4;
+        newBVE = newBVS + bufferSize - 4;
         sectionToReadStart = 0;
         sectionToReadEnd = 0;
 
@@ -258,6 +501,8 @@ bool BufferingAudioSource::readNextBufferChunk()
 
             bufferValidStart = 0;
             bufferValidEnd = 0;
+            publishValidRange (0, 0, ++rangeGeneration);
+            lastResetTime = Time::getMillisecondCounter();
         }
         else if (std::abs ((int) (newBVS - bufferValidStart)) > 512
                   || std::abs ((int) (newBVE - bufferValidEnd)) > 512)
@@ -269,16 +514,15 @@ bool BufferingAudioSource::readNextBufferChunk()
 
             bufferValidStart = newBVS;
             bufferValidEnd = jmin (bufferValidEnd, newBVE);
+            publishValidRange (bufferValidStart, bufferValidEnd, rangeGeneration);
         }
     }
 
     if (sectionToReadStart == sectionToReadEnd)
         return false;
 
-    jassert (buffer.getNumSamples() > 0);
-
-    const auto bufferIndexStart = (int) (sectionToReadStart % buffer.getNumSamples());
-    const auto bufferIndexEnd   = (int) (sectionToReadEnd   % buffer.getNumSamples());
+    const auto bufferIndexStart = (int) (sectionToReadStart % bufferSize);
+    const auto bufferIndexEnd   = (int) (sectionToReadEnd   % bufferSize);
 
     if (bufferIndexStart < bufferIndexEnd)
     {
@@ -288,7 +532,7 @@ bool BufferingAudioSource::readNextBufferChunk()
     }
     else
     {
-        const auto initialSize = buffer.getNumSamples() - bufferIndexStart;
+        const auto initialSize = bufferSize - bufferIndexStart;
 
         readBufferSection (sectionToReadStart,
                            initialSize,
@@ -304,6 +548,7 @@ bool BufferingAudioSource::readNextBufferChunk()
 
         bufferValidStart = newBVS;
         bufferValidEnd = newBVE;
+        publishValidRange (bufferValidStart, bufferValidEnd, rangeGeneration);
     }
 
     bufferReadyEvent.signal();
@@ -315,9 +560,7 @@ void BufferingAudioSource::readBufferSection (int64 start, int length, int buffe
     if (source->getNextReadPosition() != start)
         source->setNextReadPosition (start);
 
-    AudioSourceChannelInfo info (&buffer, bufferOffset, length);
-
-    const ScopedLock sl (callbackLock);
+    AudioSourceChannelInfo info (buffer.get(), bufferOffset, length);
     source->getNextAudioBlock (info);
 }
 
@@ -326,4 +569,128 @@ int BufferingAudioSource::useTimeSlice()
     return readNextBufferChunk() ? 1 : 100;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct BufferingAudioSourceTests  : public UnitTest
+{
+    BufferingAudioSourceTests()  : UnitTest ("BufferingAudioSource", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        constexpr int blockSize = 512;
+        constexpr int sourceLength = 200000;
+
+        TimeSliceThread thread ("BufferingAudioSource test");
+        thread.startThread();
+
+        beginTest ("Playback matches the source, including after seeking");
+        {
+            BufferingAudioSource bufferingSource (new StallableSource (sourceLength), thread, true, 8192, 1);
+            bufferingSource.prepareToPlay (blockSize, 44100.0);
+
+            AudioBuffer<float> output (1, blockSize);
+            AudioSourceChannelInfo info (output);
+
+            for (auto startPos : { (int64) 0, (int64) 100000, (int64) 3000 })
+            {
+                bufferingSource.setNextReadPosition (startPos);
+
+                for (int block = 0; block < 40; ++block)
+                {
+                    const auto pos = bufferingSource.getNextReadPosition();
+                    expect (bufferingSource.waitForNextAudioBlockReady (info, 5000));
+                    bufferingSource.getNextAudioBlock (info);
+
+                    auto allMatch = true;
+
+                    for (int i = 0; i < blockSize; ++i)
+                        allMatch = allMatch && output.getSample (0, i) == StallableSource::getValue (pos + i);
+
+                    expect (allMatch);
+                }
+            }
+
+            expectEquals (bufferingSource.getNumUnderruns(), 0);
+        }
+
+        beginTest ("Underruns are counted, and make an adaptive buffer grow");
+        {
+            auto* stallableSource = new StallableSource (sourceLength);
+            BufferingAudioSource bufferingSource (stallableSource, thread, true, 4096, 1);
+            bufferingSource.setAdaptiveBufferSize (4096, 65536);
+            bufferingSource.prepareToPlay (blockSize, 44100.0);
+
+            const auto initialSize = bufferingSource.getBufferSize();
+            expectEquals (initialSize, 4096);
+
+            AudioBuffer<float> output (1, blockSize);
+            AudioSourceChannelInfo info (output);
+
+            expect (bufferingSource.waitForNextAudioBlockReady (info, 5000));
+            stallableSource->setStalled (true);
+
+            for (int block = 0; block < (2 * initialSize) / blockSize; ++block)
+                bufferingSource.getNextAudioBlock (info);
+
+            expectEquals (bufferingSource.getNumUnderruns(), 1);
+
+            stallableSource->setStalled (false);
+
+            for (int i = 0; i < 500 && bufferingSource.getBufferSize() == initialSize; ++i)
+                Thread::sleep (10);
+
+            expect (bufferingSource.getBufferSize() > initialSize);
+
+            bufferingSource.releaseResources();
+        }
+    }
+
+    //==============================================================================
+    struct StallableSource  : public PositionableAudioSource
+    {
+        explicit StallableSource (int64 length) : totalLength (length) {}
+
+        static float getValue (int64 pos)     { return (float) (pos % 1000) / 1000.0f; }
+
+        void setStalled (bool shouldStall)
+        {
+            stalled = shouldStall;
+
+            if (! shouldStall)
+                resumed.signal();
+        }
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            while (stalled)
+                resumed.wait (10);
+
+            for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                for (int i = 0; i < info.numSamples; ++i)
+                    info.buffer->setSample (chan, info.startSample + i, getValue (position + i));
+
+            position += info.numSamples;
+        }
+
+        void setNextReadPosition (int64 newPosition) override    { position = newPosition; }
+        int64 getNextReadPosition() const override               { return position; }
+        int64 getTotalLength() const override                    { return totalLength; }
+        bool isLooping() const override                          { return false; }
+
+        int64 position = 0;
+        const int64 totalLength;
+        std::atomic<bool> stalled { false };
+        WaitableEvent resumed;
+    };
+};
+
+static BufferingAudioSourceTests bufferingAudioSourceTests;
+
+#endif
+
 } // namespace juce
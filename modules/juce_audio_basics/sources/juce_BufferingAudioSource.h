@@ -31,6 +31,15 @@ namespace juce
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
+    The background thread hands data over to the audio thread through a single-producer,
+    single-consumer ring buffer, so getNextAudioBlock() never takes a lock or waits for
+    the background thread. If the background thread can't keep up, the missing samples
+    are replaced with silence and counted by getNumUnderruns().
+
+    By default the read-ahead buffer has a fixed size, but setAdaptiveBufferSize() can
+    be used to let it grow when playback is at risk of underrunning, and shrink again
+    once the source is being read comfortably ahead of the playback position.
+
     @see PositionableAudioSource, AudioTransportSource
 
     @tags{Audio}
@@ -97,9 +106,64 @@ public:
     */
     bool waitForNextAudioBlockReady (const AudioSourceChannelInfo& info, const uint32 timeout);
 
+    //==============================================================================
+    /** Lets the size of the read-ahead buffer adapt to how well the background thread
+        is keeping up.
+
+        When enabled, the buffer doubles in size (up to maximumSamplesToBuffer) whenever
+        playback underruns, or the amount of buffered data falls below a quarter of the
+        buffer during continuous playback. If the buffer then stays mostly full for
+        several seconds without any underruns, it halves in size again (down to
+        minimumSamplesToBuffer), so that sources which are cheap to read don't hold on
+        to more memory than they need.
+
+        Passing 0 for both values disables this, which is the default, in which case
+        the buffer size passed to the constructor is used.
+    */
+    void setAdaptiveBufferSize (int minimumSamplesToBuffer, int maximumSamplesToBuffer);
+
+    /** Returns the number of times that playback has run out of buffered data since
+        this source was created.
+
+        Gaps caused by repositioning the source aren't counted, only those that occur
+        during continuous playback.
+    */
+    int getNumUnderruns() const noexcept                { return numUnderruns.load(); }
+
+    /** Returns the number of samples that are currently buffered ahead of the
+        playback position.
+    */
+    int getNumBufferedSamples() const noexcept;
+
+    /** Returns the current size of the read-ahead buffer, in samples. */
+    int getBufferSize() const noexcept                  { return currentBufferSize.load(); }
+
 private:
     //==============================================================================
+    struct ValidRange
+    {
+        int64 start, end;
+        uint32 generation;
+    };
+
+    struct PublishedRange
+    {
+        std::atomic<int64> start { 0 }, end { 0 };
+        std::atomic<uint32> generation { 0 };
+    };
+
+    ValidRange readValidRange() const noexcept;
+    void publishValidRange (int64 start, int64 end, uint32 generation) noexcept;
+    Range<int> getValidBufferRange (const ValidRange&, int64 playPos, int numSamples) const noexcept;
     Range<int> getValidBufferRange (int numSamples) const;
+
+    AudioBuffer<float>* acquireBuffer() noexcept;
+    bool isCopyStillValid (const AudioBuffer<float>*, const ValidRange&, int64 start, int64 end) const noexcept;
+    void setBuffer (std::unique_ptr<AudioBuffer<float>>);
+    void resizeBuffer (int newSize);
+    void updateBufferSize();
+    void releaseRetiredBuffer();
+
     bool readNextBufferChunk();
     void readBufferSection (int64 start, int length, int bufferOffset);
     int useTimeSlice() override;
@@ -108,11 +172,20 @@ private:
     OptionalScopedPointer<PositionableAudioSource> source;
     TimeSliceThread& backgroundThread;
     int numberOfSamplesToBuffer, numberOfChannels;
-    AudioBuffer<float> buffer;
-    CriticalSection callbackLock, bufferRangeLock;
+    int minimumBufferSize = 0, maximumBufferSize = 0;
+    std::unique_ptr<AudioBuffer<float>> buffer, retiredBuffer;
+    std::atomic<AudioBuffer<float>*> activeBuffer { nullptr }, bufferInUse { nullptr };
+    CriticalSection bufferRangeLock;
     WaitableEvent bufferReadyEvent;
     int64 bufferValidStart = 0, bufferValidEnd = 0;
+    uint32 rangeGeneration = 0;
+    PublishedRange publishedRanges[2];
+    std::atomic<uint32> numRangesPublished { 0 };
     std::atomic<int64> nextPlayPos { 0 };
+    std::atomic<int> numSeeks { 0 }, numUnderruns { 0 }, currentBufferSize { 0 };
+    int seekCountAtLastCompleteBlock = -1, numUnderrunsAtLastCheck = 0;
+    int64 playPosAtLastCheck = 0;
+    uint32 lastResetTime = 0, lastUnderrunRiskTime = 0;
     double sampleRate = 0;
     bool wasSourceLooping = false, isPrepared = false;
     const bool prefillBuffer;
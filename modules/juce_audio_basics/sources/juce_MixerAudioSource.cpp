@@ -23,6 +23,67 @@
 namespace juce
 {
 
+//==============================================================================
+/*  An immutable snapshot of the mixer's inputs, which the audio thread can read
+    without taking a lock. A new one is published whenever the inputs or worker
+    threads change, and the old one is only deleted once the audio thread is no
+    longer using it.
+*/
+struct MixerAudioSource::InputList
+{
+    Array<AudioSource*> sources;
+    Array<WorkerThread*> workers;
+
+    // When rendering serially, a single buffer is reused for all the inputs after the
+    // first one. When rendering in parallel, each of those inputs gets its own buffer.
+    OwnedArray<AudioBuffer<float>> buffers;
+};
+
+//==============================================================================
+class MixerAudioSource::WorkerThread  : public Thread
+{
+public:
+    explicit WorkerThread (MixerAudioSource& mixer)
+        : Thread ("MixerAudioSource worker"), owner (mixer)
+    {
+        startThread (realtimeAudioPriority);
+    }
+
+    ~WorkerThread() override
+    {
+        // The worker may be part-way through rendering an input, so it has to be allowed
+        // to finish that rather than being killed
+        signalThreadShouldExit();
+        workAvailable.signal();
+        waitForThreadToExit (-1);
+    }
+
+    void notify()
+    {
+        workAvailable.signal();
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            workAvailable.wait (-1);
+
+            if (threadShouldExit())
+                break;
+
+            owner.renderPendingInputs();
+        }
+    }
+
+private:
+    MixerAudioSource& owner;
+    WaitableEvent workAvailable;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+};
+
+//==============================================================================
 MixerAudioSource::MixerAudioSource()
    : currentSampleRate (0.0), bufferSizeExpected (0)
 {
@@ -31,6 +92,9 @@ MixerAudioSource::MixerAudioSource()
 MixerAudioSource::~MixerAudioSource()
 {
     removeAllInputs();
+    setNumWorkerThreads (0);
+
+    delete activeList.exchange (nullptr);
 }
 
 //==============================================================================
@@ -54,6 +118,8 @@ void MixerAudioSource::addInputSource (AudioSource* input, const bool deleteWhen
 
         inputsToDelete.setBit (inputs.size(), deleteWhenRemoved);
         inputs.add (input);
+
+        publishInputList (createInputList());
     }
 }
 
@@ -75,6 +141,8 @@ void MixerAudioSource::removeInputSource (AudioSource* const input)
 
             inputsToDelete.shiftBits (-1, index);
             inputs.remove (index);
+
+            publishInputList (createInputList());
         }
 
         input->releaseResources();
@@ -93,16 +161,47 @@ void MixerAudioSource::removeAllInputs()
                 toDelete.add (inputs.getUnchecked(i));
 
         inputs.clear();
+
+        publishInputList (createInputList());
     }
 
     for (int i = toDelete.size(); --i >= 0;)
         toDelete.getUnchecked(i)->releaseResources();
 }
 
-void MixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+//==============================================================================
+void MixerAudioSource::setNumWorkerThreads (int numThreads)
 {
-    tempBuffer.setSize (2, samplesPerBlockExpected);
+    jassert (numThreads >= 0);
 
+    OwnedArray<WorkerThread> oldWorkers;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (numThreads == workers.size())
+            return;
+
+        oldWorkers.swapWith (workers);
+
+        for (int i = 0; i < numThreads; ++i)
+            workers.add (new WorkerThread (*this));
+
+        publishInputList (createInputList());
+    }
+
+    // The old threads are stopped here, now that no audio callback can be using them
+}
+
+int MixerAudioSource::getNumWorkerThreads() const
+{
+    const ScopedLock sl (lock);
+    return workers.size();
+}
+
+//==============================================================================
+void MixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
     const ScopedLock sl (lock);
 
     currentSampleRate = sampleRate;
@@ -110,6 +209,8 @@ void MixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sample
 
     for (int i = inputs.size(); --i >= 0;)
         inputs.getUnchecked(i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
+
+    publishInputList (createInputList());
 }
 
 void MixerAudioSource::releaseResources()
@@ -119,40 +220,246 @@ void MixerAudioSource::releaseResources()
     for (int i = inputs.size(); --i >= 0;)
         inputs.getUnchecked(i)->releaseResources();
 
-    tempBuffer.setSize (2, 0);
-
     currentSampleRate = 0;
     bufferSizeExpected = 0;
+
+    publishInputList (createInputList());
 }
 
-void MixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+//==============================================================================
+std::unique_ptr<MixerAudioSource::InputList> MixerAudioSource::createInputList() const
 {
-    const ScopedLock sl (lock);
+    auto list = std::make_unique<InputList>();
+    list->sources = inputs;
+    list->workers.addArray (workers);
+
+    const auto numBuffers = workers.isEmpty() ? jmin (1, inputs.size() - 1)
+                                              : inputs.size() - 1;
+
+    for (int i = 0; i < numBuffers; ++i)
+        list->buffers.add (new AudioBuffer<float> (2, bufferSizeExpected));
+
+    return list;
+}
+
+void MixerAudioSource::publishInputList (std::unique_ptr<InputList> newList)
+{
+    std::unique_ptr<InputList> oldList (activeList.exchange (newList.release()));
+
+    // The audio thread may still be in the middle of a callback that's using the
+    // old list, in which case we need to wait for it to finish before deleting it
+    if (oldList != nullptr)
+        while (listInUse.load() == oldList.get())
+            Thread::sleep (1);
+}
 
-    if (inputs.size() > 0)
+MixerAudioSource::InputList* MixerAudioSource::acquireInputList() noexcept
+{
+    for (;;)
     {
-        inputs.getUnchecked(0)->getNextAudioBlock (info);
+        auto* list = activeList.load();
+        listInUse.store (list);
 
-        if (inputs.size() > 1)
+        // If the list was replaced before we marked it as in use, the publishing
+        // thread may not have seen our mark, so go round again to get the new one
+        if (activeList.load() == list)
+            return list;
+    }
+}
+
+void MixerAudioSource::renderPendingInputs()
+{
+    for (;;)
+    {
+        const auto index = numInputsToStart.fetch_sub (1) - 1;
+
+        if (index < 0)
+            return;
+
+        auto& list = *currentList;
+        const auto numSources = list.sources.size();
+
+        if (index == 0)
+        {
+            list.sources.getUnchecked (0)->getNextAudioBlock (*currentInfo);
+        }
+        else
         {
-            tempBuffer.setSize (jmax (1, info.buffer->getNumChannels()),
-                                info.buffer->getNumSamples());
+            AudioSourceChannelInfo info (list.buffers.getUnchecked (index - 1), 0, currentInfo->numSamples);
+            list.sources.getUnchecked (index)->getNextAudioBlock (info);
+        }
 
-            AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+        // As soon as the last input is finished, the audio thread may return and the
+        // list may be deleted, so it mustn't be touched after this
+        if (numInputsFinished.fetch_add (1) + 1 == numSources)
+            allInputsFinished.signal();
+    }
+}
 
-            for (int i = 1; i < inputs.size(); ++i)
-            {
-                inputs.getUnchecked(i)->getNextAudioBlock (info2);
+void MixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    auto* list = acquireInputList();
+    const auto numInputs = list != nullptr ? list->sources.size() : 0;
+
+    if (numInputs > 0)
+    {
+        const auto addToOutput = [&info] (const AudioBuffer<float>& buffer)
+        {
+            for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                info.buffer->addFrom (chan, info.startSample, buffer, chan, 0, info.numSamples);
+        };
 
-                for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
-                    info.buffer->addFrom (chan, info.startSample, tempBuffer, chan, 0, info.numSamples);
+        for (auto* buffer : list->buffers)
+            buffer->setSize (jmax (1, info.buffer->getNumChannels()), info.numSamples, false, false, true);
+
+        if (list->workers.isEmpty() || numInputs == 1)
+        {
+            list->sources.getUnchecked (0)->getNextAudioBlock (info);
+
+            if (numInputs > 1)
+            {
+                auto& tempBuffer = *list->buffers.getUnchecked (0);
+                AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+
+                for (int i = 1; i < numInputs; ++i)
+                {
+                    list->sources.getUnchecked (i)->getNextAudioBlock (info2);
+                    addToOutput (tempBuffer);
+                }
             }
         }
+        else
+        {
+            currentList = list;
+            currentInfo = &info;
+            numInputsFinished.store (0);
+            numInputsToStart.store (numInputs);
+
+            for (int i = jmin (list->workers.size(), numInputs - 1); --i >= 0;)
+                list->workers.getUnchecked (i)->notify();
+
+            renderPendingInputs();
+            allInputsFinished.wait (-1);
+
+            for (int i = 1; i < numInputs; ++i)
+                addToOutput (*list->buffers.getUnchecked (i - 1));
+        }
     }
     else
     {
         info.clearActiveBufferRegion();
     }
+
+    listInUse.store (nullptr);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MixerAudioSourceTests  : public UnitTest
+{
+    MixerAudioSourceTests()  : UnitTest ("MixerAudioSource", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        constexpr int blockSize = 256;
+        constexpr int numInputs = 16;
+
+        beginTest ("Parallel rendering produces the same output as serial rendering");
+        {
+            for (auto numThreads : { 1, 3, 8 })
+            {
+                AudioBuffer<float> serialOutput (2, blockSize), parallelOutput (2, blockSize);
+
+                MixerAudioSource serialMixer, parallelMixer;
+                parallelMixer.setNumWorkerThreads (numThreads);
+                expectEquals (parallelMixer.getNumWorkerThreads(), numThreads);
+
+                for (int i = 0; i < numInputs; ++i)
+                {
+                    serialMixer.addInputSource (createInput (i), true);
+                    parallelMixer.addInputSource (createInput (i), true);
+                }
+
+                serialMixer.prepareToPlay (blockSize, 44100.0);
+                parallelMixer.prepareToPlay (blockSize, 44100.0);
+
+                for (int block = 0; block < 8; ++block)
+                {
+                    serialMixer.getNextAudioBlock (AudioSourceChannelInfo (serialOutput));
+                    parallelMixer.getNextAudioBlock (AudioSourceChannelInfo (parallelOutput));
+
+                    for (int chan = 0; chan < 2; ++chan)
+                        for (int sample = 0; sample < blockSize; ++sample)
+                            expectWithinAbsoluteError (parallelOutput.getSample (chan, sample),
+                                                       serialOutput.getSample (chan, sample),
+                                                       1.0e-5f);
+                }
+            }
+        }
+
+        beginTest ("Inputs can be added and removed while another thread is rendering");
+        {
+            MixerAudioSource mixer;
+            mixer.setNumWorkerThreads (2);
+            mixer.prepareToPlay (blockSize, 44100.0);
+
+            RenderThread audioThread (mixer, blockSize);
+            audioThread.startThread();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto* input = createInput (i);
+                mixer.addInputSource (input, true);
+
+                if (i % 3 == 0)
+                    mixer.removeInputSource (input);
+
+                if (i % 10 == 0)
+                    mixer.setNumWorkerThreads (1 + (i / 10) % 3);
+            }
+
+            mixer.removeAllInputs();
+            expect (audioThread.stopThread (10000));
+
+            AudioBuffer<float> output (2, blockSize);
+            mixer.getNextAudioBlock (AudioSourceChannelInfo (output));
+            expect (output.getMagnitude (0, blockSize) == 0.0f);
+        }
+    }
+
+    struct RenderThread  : public Thread
+    {
+        RenderThread (MixerAudioSource& m, int size)
+            : Thread ("MixerAudioSource test"), mixer (m), output (2, size)
+        {
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+                mixer.getNextAudioBlock (AudioSourceChannelInfo (output));
+        }
+
+        MixerAudioSource& mixer;
+        AudioBuffer<float> output;
+    };
+
+    static AudioSource* createInput (int index)
+    {
+        AudioBuffer<float> buffer (2, 1000);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                buffer.setSample (chan, sample, std::sin ((float) (sample * (index + 1) + chan)) * 0.1f);
+
+        return new MemoryAudioSource (buffer, true, true);
+    }
+};
+
+static MixerAudioSourceTests mixerAudioSourceTests;
+
+#endif
+
 } // namespace juce
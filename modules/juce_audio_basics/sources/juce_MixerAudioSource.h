@@ -29,7 +29,13 @@ namespace juce
 
     Input sources can be added and removed while the mixer is running as long as their
     prepareToPlay() and releaseResources() methods are called before and after adding
-    them to the mixer.
+    them to the mixer. The audio thread never blocks on these changes: the list of
+    inputs is swapped atomically, and removeInputSource() waits for any callback that
+    is still using the old list to finish before releasing the removed source.
+
+    By default the inputs are pulled one after another on the audio thread. If the
+    inputs are expensive to render (e.g. each one is decoding or resampling a file),
+    setNumWorkerThreads() can be used to pull them concurrently.
 
     @tags{Audio}
 */
@@ -69,6 +75,26 @@ public:
     */
     void removeAllInputs();
 
+    //==============================================================================
+    /** Sets the number of worker threads used to pull the input sources in parallel.
+
+        With the default value of 0, all inputs are rendered serially on the thread
+        that calls getNextAudioBlock(). With one or more worker threads, the calling
+        thread and the workers share out the inputs between them, each one rendering
+        into its own buffer, and the results are summed on the calling thread once
+        they have all finished.
+
+        When this is enabled, each input source may be called on any of the worker
+        threads, so inputs must not share any state that isn't thread-safe.
+
+        This may be called while the mixer is running, but it will block until any
+        audio callback which is using the previous set of threads has finished.
+    */
+    void setNumWorkerThreads (int numThreads);
+
+    /** Returns the number of worker threads set by setNumWorkerThreads(). */
+    int getNumWorkerThreads() const;
+
     //==============================================================================
     /** Implementation of the AudioSource method.
         This will call prepareToPlay() on all its input sources.
@@ -85,14 +111,31 @@ public:
 
 
 private:
+    //==============================================================================
+    struct InputList;
+    class WorkerThread;
+
+    std::unique_ptr<InputList> createInputList() const;
+    void publishInputList (std::unique_ptr<InputList>);
+    InputList* acquireInputList() noexcept;
+    void renderPendingInputs();
+
     //==============================================================================
     Array<AudioSource*> inputs;
     BigInteger inputsToDelete;
+    OwnedArray<WorkerThread> workers;
     CriticalSection lock;
-    AudioBuffer<float> tempBuffer;
     double currentSampleRate;
     int bufferSizeExpected;
 
+    std::atomic<InputList*> activeList { nullptr }, listInUse { nullptr };
+
+    // The state of the block that's currently being rendered by the worker threads
+    InputList* currentList = nullptr;
+    const AudioSourceChannelInfo* currentInfo = nullptr;
+    std::atomic<int> numInputsToStart { 0 }, numInputsFinished { 0 };
+    WaitableEvent allInputsFinished;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerAudioSource)
 };
 
@@ -34,6 +34,11 @@ namespace juce
     it any new data. And like with any other stateful filter, if you're resampling
     multiple channels, make sure each one uses its own interpolator object.
 
+    The InterpolatorTraits::valueAtOffset function is always given a pointer to the
+    memorySize most recent input samples laid out contiguously, oldest first, and
+    an index of 0. When a block of input is long enough, this window points
+    directly into the caller's input data, so no per-sample copying is needed.
+
     @see LagrangeInterpolator, CatmullRomInterpolator, WindowedSincInterpolator,
          LinearInterpolator, ZeroOrderHoldInterpolator
 
@@ -64,9 +69,9 @@ public:
     */
     void reset() noexcept
     {
-        indexBuffer = 0;
         subSamplePos = 1.0;
-        std::fill (std::begin (lastInputSamples), std::end (lastInputSamples), 0.0f);
+        writePos = memorySize;
+        std::fill (history, history + memorySize, 0.0f);
     }
 
     /** Resamples a stream of samples.
@@ -171,12 +176,34 @@ public:
 
 private:
     //==============================================================================
+    /*  The history is kept as a linear buffer rather than a ring, so that the
+        traits always see the last memorySize samples contiguously, oldest first.
+        When the write position reaches the end, the most recent samples are
+        moved back to the start, which costs memorySize copies every
+        (historySize - memorySize) pushes.
+    */
+    static constexpr int historySize = memorySize + jmax (memorySize, 64);
+
+    forcedinline const float* getHistory() const noexcept
+    {
+        return history + (writePos - memorySize);
+    }
+
     forcedinline void pushInterpolationSample (float newValue) noexcept
     {
-        lastInputSamples[indexBuffer] = newValue;
+        if (writePos == historySize)
+        {
+            std::copy (history + (historySize - memorySize), history + historySize, history);
+            writePos = memorySize;
+        }
+
+        history[writePos++] = newValue;
+    }
 
-        if (++indexBuffer == memorySize)
-            indexBuffer = 0;
+    forcedinline void setHistory (const float* mostRecentSamples) noexcept
+    {
+        std::copy (mostRecentSamples, mostRecentSamples + memorySize, history);
+        writePos = memorySize;
     }
 
     forcedinline void pushInterpolationSamples (const float* input,
@@ -258,15 +285,18 @@ private:
     }
 
     //==============================================================================
-    int interpolate (double speedRatio,
-                     const float* input,
-                     float* output,
-                     int numOutputSamplesToProduce) noexcept
+    template <typename OutputWriter>
+    int interpolateContiguous (double speedRatio,
+                               const float* input,
+                               int numOutputSamplesToProduce,
+                               OutputWriter&& writeOutput) noexcept
     {
         auto pos = subSamplePos;
         int numUsed = 0;
+        int i = 0;
 
-        while (numOutputSamplesToProduce > 0)
+        // Until a full window of new input has been consumed, the oldest samples have to come from the history..
+        for (; i < numOutputSamplesToProduce; ++i)
         {
             while (pos >= 1.0)
             {
@@ -274,15 +304,47 @@ private:
                 pos -= 1.0;
             }
 
-            *output++ = InterpolatorTraits::valueAtOffset (lastInputSamples, (float) pos, indexBuffer);
+            if (numUsed >= memorySize)
+                break;
+
+            writeOutput (i, InterpolatorTraits::valueAtOffset (getHistory(), (float) pos, 0));
             pos += speedRatio;
-            --numOutputSamplesToProduce;
+        }
+
+        // ..after which the window lies entirely within the input block, so it can be read in place.
+        if (i < numOutputSamplesToProduce)
+        {
+            for (;;)
+            {
+                writeOutput (i, InterpolatorTraits::valueAtOffset (input + (numUsed - memorySize), (float) pos, 0));
+                pos += speedRatio;
+
+                if (++i == numOutputSamplesToProduce)
+                    break;
+
+                while (pos >= 1.0)
+                {
+                    ++numUsed;
+                    pos -= 1.0;
+                }
+            }
+
+            setHistory (input + (numUsed - memorySize));
         }
 
         subSamplePos = pos;
         return numUsed;
     }
 
+    int interpolate (double speedRatio,
+                     const float* input,
+                     float* output,
+                     int numOutputSamplesToProduce) noexcept
+    {
+        return interpolateContiguous (speedRatio, input, numOutputSamplesToProduce,
+                                      [output] (int i, float value) noexcept { output[i] = value; });
+    }
+
     int interpolate (double speedRatio,
                      const float* input, float* output,
                      int numOutputSamplesToProduce,
@@ -324,7 +386,7 @@ private:
                     pos -= 1.0;
                 }
 
-                *output++ = InterpolatorTraits::valueAtOffset (lastInputSamples, (float) pos, indexBuffer);
+                *output++ = InterpolatorTraits::valueAtOffset (getHistory(), (float) pos, 0);
                 pos += speedRatio;
             }
         }
@@ -360,7 +422,7 @@ private:
                 }
 
                 pos -= speedRatio;
-                *output++ = InterpolatorTraits::valueAtOffset (lastInputSamples, jmax (0.0f, 1.0f - (float) pos), indexBuffer);
+                *output++ = InterpolatorTraits::valueAtOffset (getHistory(), jmax (0.0f, 1.0f - (float) pos), 0);
             }
         }
 
@@ -415,7 +477,7 @@ private:
                     pos -= 1.0;
                 }
 
-                *output++ += gain * InterpolatorTraits::valueAtOffset (lastInputSamples, (float) pos, indexBuffer);
+                *output++ += gain * InterpolatorTraits::valueAtOffset (getHistory(), (float) pos, 0);
                 pos += speedRatio;
             }
         }
@@ -451,7 +513,7 @@ private:
                 }
 
                 pos -= speedRatio;
-                *output++ += gain * InterpolatorTraits::valueAtOffset (lastInputSamples, jmax (0.0f, 1.0f - (float) pos), indexBuffer);
+                *output++ += gain * InterpolatorTraits::valueAtOffset (getHistory(), jmax (0.0f, 1.0f - (float) pos), 0);
             }
         }
 
@@ -469,30 +531,14 @@ private:
                            int numOutputSamplesToProduce,
                            float gain) noexcept
     {
-        auto pos = subSamplePos;
-        int numUsed = 0;
-
-        while (numOutputSamplesToProduce > 0)
-        {
-            while (pos >= 1.0)
-            {
-                pushInterpolationSample (input[numUsed++]);
-                pos -= 1.0;
-            }
-
-            *output++ += gain * InterpolatorTraits::valueAtOffset (lastInputSamples, (float) pos, indexBuffer);
-            pos += speedRatio;
-            --numOutputSamplesToProduce;
-        }
-
-        subSamplePos = pos;
-        return numUsed;
+        return interpolateContiguous (speedRatio, input, numOutputSamplesToProduce,
+                                      [output, gain] (int i, float value) noexcept { output[i] += gain * value; });
     }
 
     //==============================================================================
-    float lastInputSamples[(size_t) memorySize];
+    float history[(size_t) historySize];
     double subSamplePos = 1.0;
-    int indexBuffer = 0;
+    int writePos = memorySize;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GenericInterpolator)
 };
@@ -174,6 +174,143 @@ private:
         }
     }
 
+    template <typename InterpolatorType>
+    void runBlockSizeTests (const String& interpolatorName)
+    {
+        beginTest (interpolatorName + " output is independent of block size");
+
+        auto random = getRandom();
+
+        std::vector<float> input (4096);
+
+        for (auto& sample : input)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+
+        for (auto speedRatio : { 0.37, 1.0, 1.7, 3.3 })
+        {
+            const auto numOutputSamples = (int) ((double) (input.size() - 8) / speedRatio);
+
+            InterpolatorType interpolator;
+            std::vector<float> reference ((size_t) numOutputSamples);
+            interpolator.process (speedRatio, input.data(), reference.data(), numOutputSamples);
+
+            interpolator.reset();
+            std::vector<float> output ((size_t) numOutputSamples);
+            auto inputPos = 0;
+
+            for (int outputPos = 0; outputPos < numOutputSamples;)
+            {
+                const auto blockSize = jmin (numOutputSamples - outputPos, 1 + random.nextInt (300));
+                inputPos += interpolator.process (speedRatio, input.data() + inputPos, output.data() + outputPos, blockSize);
+                outputPos += blockSize;
+            }
+
+            expect (reference == output);
+        }
+    }
+
+    // The sinc interpolator as it was before it used a polyphase table, with a circular history
+    struct OriginalWindowedSinc
+    {
+        float valueAtOffset (float offset) const noexcept
+        {
+            const auto* lookupTable = Interpolators::WindowedSincTraits::lookupTable;
+            const int numCrossings = 100;
+            const float floatCrossings = (float) numCrossings;
+            float result = 0.0f;
+
+            auto samplePosition = indexBuffer;
+            float firstFrac = 0.0f;
+            float lastSincPosition = -1.0f;
+            int index = 0, sign = -1;
+
+            for (int i = -numCrossings; i <= numCrossings; ++i)
+            {
+                auto sincPosition = (1.0f - offset) + (float) i;
+
+                if (i == -numCrossings || (sincPosition >= 0 && lastSincPosition < 0))
+                {
+                    auto indexFloat = (sincPosition >= 0.f ? sincPosition : -sincPosition) * 100.0f;
+                    auto indexFloored = std::floor (indexFloat);
+                    index = (int) indexFloored;
+                    firstFrac = indexFloat - indexFloored;
+                    sign = (sincPosition < 0 ? -1 : 1);
+                }
+
+                if (sincPosition == 0.0f)
+                    result += history[samplePosition];
+                else if (sincPosition < floatCrossings && sincPosition > -floatCrossings)
+                    result += history[samplePosition] * (lookupTable[index] + firstFrac * (lookupTable[index + 1] - lookupTable[index]));
+
+                if (++samplePosition == numCrossings * 2)
+                    samplePosition = 0;
+
+                lastSincPosition = sincPosition;
+                index += 100 * sign;
+            }
+
+            return result;
+        }
+
+        void process (double speedRatio, const float* input, float* output, int numOutputSamples) noexcept
+        {
+            for (int i = 0; i < numOutputSamples; ++i)
+            {
+                while (pos >= 1.0)
+                {
+                    history[indexBuffer] = *input++;
+
+                    if (++indexBuffer == 200)
+                        indexBuffer = 0;
+
+                    pos -= 1.0;
+                }
+
+                output[i] = valueAtOffset ((float) pos);
+                pos += speedRatio;
+            }
+        }
+
+        float history[200] = {};
+        int indexBuffer = 0;
+        double pos = 1.0;
+    };
+
+    void runOriginalWindowedSincTests()
+    {
+        beginTest ("WindowedSincInterpolator matches the original implementation");
+
+        auto random = getRandom();
+
+        std::vector<float> input (4096);
+
+        for (auto& sample : input)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+
+        for (auto speedRatio : { 0.37, 1.0, 1.7, 3.3 })
+        {
+            const auto numOutputSamples = (int) ((double) (input.size() - 8) / speedRatio);
+
+            OriginalWindowedSinc original;
+            std::vector<float> expected ((size_t) numOutputSamples);
+            original.process (speedRatio, input.data(), expected.data(), numOutputSamples);
+
+            WindowedSincInterpolator interpolator;
+            std::vector<float> output ((size_t) numOutputSamples);
+            auto inputPos = 0;
+
+            for (int outputPos = 0; outputPos < numOutputSamples;)
+            {
+                const auto blockSize = jmin (numOutputSamples - outputPos, 1 + random.nextInt (300));
+                inputPos += interpolator.process (speedRatio, input.data() + inputPos, output.data() + outputPos, blockSize);
+                outputPos += blockSize;
+            }
+
+            for (int i = 0; i < numOutputSamples; ++i)
+                expectWithinAbsoluteError (output[(size_t) i], expected[(size_t) i], 1.0e-5f);
+        }
+    }
+
 public:
     void runTest() override
     {
@@ -181,6 +318,14 @@ public:
         runInterplatorTests<LagrangeInterpolator>     ("LagrangeInterpolator");
         runInterplatorTests<CatmullRomInterpolator>   ("CatmullRomInterpolator");
         runInterplatorTests<LinearInterpolator>       ("LinearInterpolator");
+
+        runBlockSizeTests<WindowedSincInterpolator>   ("WindowedSincInterpolator");
+        runBlockSizeTests<LagrangeInterpolator>       ("LagrangeInterpolator");
+        runBlockSizeTests<CatmullRomInterpolator>     ("CatmullRomInterpolator");
+        runBlockSizeTests<LinearInterpolator>         ("LinearInterpolator");
+        runBlockSizeTests<ZeroOrderHoldInterpolator>  ("ZeroOrderHoldInterpolator");
+
+        runOriginalWindowedSincTests();
     }
 };
 
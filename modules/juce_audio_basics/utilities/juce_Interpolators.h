@@ -41,55 +41,7 @@ private:
     {
         static constexpr float algorithmicLatency = 100.0f;
 
-        static forcedinline float windowedSinc (float firstFrac, int index) noexcept
-        {
-            auto index2 = index + 1;
-            auto frac = firstFrac;
-
-            auto value1 = lookupTable[index];
-            auto value2 = lookupTable[index2];
-
-            return value1 + (frac * (value2 - value1));
-        }
-
-        static forcedinline float valueAtOffset (const float* const inputs, const float offset, int indexBuffer) noexcept
-        {
-            const int numCrossings = 100;
-            const float floatCrossings = (float) numCrossings;
-            float result = 0.0f;
-
-            auto samplePosition = indexBuffer;
-            float firstFrac = 0.0f;
-            float lastSincPosition = -1.0f;
-            int index = 0, sign = -1;
-
-            for (int i = -numCrossings; i <= numCrossings; ++i)
-            {
-                auto sincPosition = (1.0f - offset) + (float) i;
-
-                if (i == -numCrossings || (sincPosition >= 0 && lastSincPosition < 0))
-                {
-                    auto indexFloat = (sincPosition >= 0.f ? sincPosition : -sincPosition) * 100.0f;
-                    auto indexFloored = std::floor (indexFloat);
-                    index = (int) indexFloored;
-                    firstFrac = indexFloat - indexFloored;
-                    sign = (sincPosition < 0 ? -1 : 1);
-                }
-
-                if (sincPosition == 0.0f)
-                    result += inputs[samplePosition];
-                else if (sincPosition < floatCrossings && sincPosition > -floatCrossings)
-                    result += inputs[samplePosition] * windowedSinc (firstFrac, index);
-
-                if (++samplePosition == numCrossings * 2)
-                    samplePosition = 0;
-
-                lastSincPosition = sincPosition;
-                index += 100 * sign;
-            }
-
-            return result;
-        }
+        static float valueAtOffset (const float*, float, int) noexcept;
 
         static const float lookupTable[10001];
     };
@@ -145,6 +97,8 @@ private:
         }
     };
 
+    friend class InterpolatorTests;
+
 public:
     using WindowedSinc  = GenericInterpolator<WindowedSincTraits,  200>;
     using Lagrange      = GenericInterpolator<LagrangeTraits,      5>;
@@ -23,6 +23,90 @@
 namespace juce
 {
 
+void SmoothedValueRamp::fill (ValueSmoothingTypes::Linear, float* destination, float, float target, float step,
+                              int countdown, int numValues) noexcept
+{
+    int i = 0;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const auto targets = _mm_set1_ps (target);
+    const auto steps = _mm_set1_ps (step);
+    const auto four = _mm_set1_epi32 (4);
+    auto remaining = _mm_setr_epi32 (countdown - 1, countdown - 2, countdown - 3, countdown - 4);
+
+    for (; i + 4 <= numValues; i += 4)
+    {
+        _mm_storeu_ps (destination + i, _mm_sub_ps (targets, _mm_mul_ps (steps, _mm_cvtepi32_ps (remaining))));
+        remaining = _mm_sub_epi32 (remaining, four);
+    }
+   #elif JUCE_USE_ARM_NEON
+    const auto targets = vdupq_n_f32 (target);
+    const auto steps = vdupq_n_f32 (step);
+    const auto four = vdupq_n_s32 (4);
+    const int32_t initial[] = { countdown - 1, countdown - 2, countdown - 3, countdown - 4 };
+    auto remaining = vld1q_s32 (initial);
+
+    for (; i + 4 <= numValues; i += 4)
+    {
+        // a separate multiply and subtract keeps the rounding the same as the scalar loop
+        vst1q_f32 (destination + i, vsubq_f32 (targets, vmulq_f32 (steps, vcvtq_f32_s32 (remaining))));
+        remaining = vsubq_s32 (remaining, four);
+    }
+   #endif
+
+    for (; i < numValues; ++i)
+        destination[i] = target - step * (float) (countdown - (i + 1));
+}
+
+void SmoothedValueRamp::fill (ValueSmoothingTypes::Multiplicative, float* destination, float current, float, float step,
+                              int, int numValues) noexcept
+{
+    float powers[8];
+    auto power = step;
+
+    for (auto& p : powers)
+    {
+        p = power;
+        power *= step;
+    }
+
+    int i = 0;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const auto powers0 = _mm_loadu_ps (powers), powers1 = _mm_loadu_ps (powers + 4);
+
+    for (; i + 8 <= numValues; i += 8)
+    {
+        const auto currents = _mm_set1_ps (current);
+        _mm_storeu_ps (destination + i,     _mm_mul_ps (currents, powers0));
+        _mm_storeu_ps (destination + i + 4, _mm_mul_ps (currents, powers1));
+        current = destination[i + 7];
+    }
+   #elif JUCE_USE_ARM_NEON
+    const auto powers0 = vld1q_f32 (powers), powers1 = vld1q_f32 (powers + 4);
+
+    for (; i + 8 <= numValues; i += 8)
+    {
+        const auto currents = vdupq_n_f32 (current);
+        vst1q_f32 (destination + i,     vmulq_f32 (currents, powers0));
+        vst1q_f32 (destination + i + 4, vmulq_f32 (currents, powers1));
+        current = destination[i + 7];
+    }
+   #else
+    for (; i + 8 <= numValues; i += 8)
+    {
+        for (int j = 0; j < 8; ++j)
+            destination[i + j] = current * powers[j];
+
+        current = destination[i + 7];
+    }
+   #endif
+
+    for (int j = 0; i + j < numValues; ++j)
+        destination[i + j] = current * powers[j];
+}
+
+//==============================================================================
 #if JUCE_UNIT_TESTS
 
 static CommonSmoothedValueTests <SmoothedValue<float, ValueSmoothingTypes::Linear>> commonLinearSmoothedValueTests;
@@ -57,6 +141,27 @@ public:
             expectWithinAbsoluteError (doubleDelta, delta * 2.0f, 1.0e-7f);
         }
 
+        beginTest ("Linear values are computed from the distance to the target");
+        {
+            SmoothedValue<float, ValueSmoothingTypes::Linear> sv;
+            sv.reset (100);
+            sv.setCurrentAndTargetValue (0.3f);
+            sv.setTargetValue (1.7f);
+
+            const auto step = (1.7f - 0.3f) / 100.0f;
+            float block[50];
+
+            for (int countdown = 99; countdown >= 50; --countdown)
+                expectEquals (sv.getNextValue(), 1.7f - step * (float) countdown);
+
+            sv.getNextValues (block, 50);
+
+            for (int i = 0; i < 49; ++i)
+                expectEquals (block[i], 1.7f - step * (float) (49 - i));
+
+            expectEquals (block[49], 1.7f);
+        }
+
         beginTest ("Multiplicative curve");
         {
             SmoothedValue<double, ValueSmoothingTypes::Multiplicative> sv;
@@ -82,6 +187,87 @@ public:
             for (int i = 0; i < values.getNumSamples(); ++i)
                 expectWithinAbsoluteError (values.getSample (0, i), values.getSample (1, i), 1.0e-9);
         }
+
+        beginTest ("Bank matches individual values");
+        {
+            testBank<ValueSmoothingTypes::Linear>();
+            testBank<ValueSmoothingTypes::Multiplicative>();
+        }
+
+        beginTest ("Bank gain");
+        {
+            SmoothedValueBank<float> bank (2);
+            bank.reset (20);
+            bank.setCurrentAndTargetValue (0, 1.0f);
+            bank.setTargetValue (0, 0.5f);
+
+            float ramp[32], samples[32];
+            bank.getNextValues (0, ramp, 32);
+            FloatVectorOperations::fill (samples, 2.0f, 32);
+            bank.applyGain (0, samples, 32);
+
+            for (int i = 0; i < 32; ++i)
+                expectWithinAbsoluteError (samples[i], ramp[i] * 2.0f, 1.0e-6f);
+
+            expectEquals (ramp[19], 0.5f);
+            expectEquals (ramp[31], 0.5f);
+
+            expect (bank.isAnySmoothing());
+            bank.skip (32);
+            expect (! bank.isAnySmoothing());
+            expectEquals (bank.getCurrentValue (0), 0.5f);
+        }
+    }
+
+private:
+    template <typename SmoothingType>
+    void testBank()
+    {
+        constexpr int numValues = 5, rampLength = 50, blockSize = 16;
+
+        SmoothedValueBank<float, SmoothingType> bank (numValues);
+        OwnedArray<SmoothedValue<float, SmoothingType>> values;
+
+        bank.reset (rampLength);
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            values.add (new SmoothedValue<float, SmoothingType> (1.0f))->reset (rampLength);
+            bank.setCurrentAndTargetValue (i, 1.0f);
+        }
+
+        Random random (1);
+        float bankRamp[blockSize], ramp[blockSize];
+
+        for (int block = 0; block < 20; ++block)
+        {
+            for (int i = 0; i < numValues; ++i)
+            {
+                if (random.nextInt (3) == 0)
+                {
+                    auto target = 0.1f + random.nextFloat() * 4.0f;
+                    bank.setTargetValue (i, target);
+                    values[i]->setTargetValue (target);
+                }
+            }
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                bank.getNextValues (i, bankRamp, blockSize);
+                values[i]->getNextValues (ramp, blockSize);
+
+                for (int j = 0; j < blockSize; ++j)
+                    expectWithinAbsoluteError (bankRamp[j], ramp[j], 1.0e-4f);
+            }
+
+            bank.skip (blockSize);
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                expectWithinAbsoluteError (bank.getCurrentValue (i), values[i]->getCurrentValue(), 1.0e-4f);
+                expect (bank.isSmoothing (i) == values[i]->isSmoothing());
+            }
+        }
     }
 };
 
@@ -80,6 +80,24 @@ public:
         countdown = 0;
     }
 
+    //==============================================================================
+    /** Fills a buffer with the next values of the ramp.
+
+        This gives the same results as calling getNextValue() numSamples times and
+        storing them, but classes like SmoothedValue can do it much more efficiently.
+        For multiplicative ramps, the values may differ from getNextValue()'s in the
+        last few bits, because they're computed in a different order.
+        @param destination  Pointer to a raw array which will receive the values
+        @param numSamples   The number of values to write
+    */
+    void getNextValues (FloatType* destination, int numSamples) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = getNextSmoothedValue();
+    }
+
     //==============================================================================
     /** Applies a smoothed gain to a stream of samples
         S[i] *= gain
@@ -90,15 +108,18 @@ public:
     {
         jassert (numSamples >= 0);
 
-        if (isSmoothing())
-        {
-            for (int i = 0; i < numSamples; ++i)
-                samples[i] *= getNextSmoothedValue();
-        }
-        else
+        FloatType gains[gainBlockSize];
+
+        while (numSamples > 0 && isSmoothing())
         {
-            FloatVectorOperations::multiply (samples, target, numSamples);
+            auto numThisTime = getNextGains (gains, numSamples);
+            FloatVectorOperations::multiply (samples, gains, numThisTime);
+
+            samples += numThisTime;
+            numSamples -= numThisTime;
         }
+
+        FloatVectorOperations::multiply (samples, target, numSamples);
     }
 
     /** Computes output as a smoothed gain applied to a stream of samples.
@@ -111,15 +132,19 @@ public:
     {
         jassert (numSamples >= 0);
 
-        if (isSmoothing())
-        {
-            for (int i = 0; i < numSamples; ++i)
-                samplesOut[i] = samplesIn[i] * getNextSmoothedValue();
-        }
-        else
+        FloatType gains[gainBlockSize];
+
+        while (numSamples > 0 && isSmoothing())
         {
-            FloatVectorOperations::multiply (samplesOut, samplesIn, target, numSamples);
+            auto numThisTime = getNextGains (gains, numSamples);
+            FloatVectorOperations::multiply (samplesOut, samplesIn, gains, numThisTime);
+
+            samplesOut += numThisTime;
+            samplesIn += numThisTime;
+            numSamples -= numThisTime;
         }
+
+        FloatVectorOperations::multiply (samplesOut, samplesIn, target, numSamples);
     }
 
     /** Applies a smoothed gain to a buffer */
@@ -127,39 +152,40 @@ public:
     {
         jassert (numSamples >= 0);
 
-        if (isSmoothing())
+        FloatType gains[gainBlockSize];
+        int startSample = 0;
+
+        while (startSample < numSamples && isSmoothing())
         {
-            if (buffer.getNumChannels() == 1)
-            {
-                auto* samples = buffer.getWritePointer (0);
+            auto numThisTime = getNextGains (gains, numSamples - startSample);
 
-                for (int i = 0; i < numSamples; ++i)
-                    samples[i] *= getNextSmoothedValue();
-            }
-            else
-            {
-                for (auto i = 0; i < numSamples; ++i)
-                {
-                    auto gain = getNextSmoothedValue();
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                FloatVectorOperations::multiply (buffer.getWritePointer (channel, startSample), gains, numThisTime);
 
-                    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
-                        buffer.setSample (channel, i, buffer.getSample (channel, i) * gain);
-                }
-            }
-        }
-        else
-        {
-            buffer.applyGain (0, numSamples, target);
+            startSample += numThisTime;
         }
+
+        buffer.applyGain (startSample, numSamples - startSample, target);
     }
 
 private:
     //==============================================================================
+    static constexpr int gainBlockSize = 64;
+
     FloatType getNextSmoothedValue() noexcept
     {
         return static_cast <SmoothedValueType*> (this)->getNextValue();
     }
 
+    // Fills a block of gains which ends no later than the end of the ramp, so
+    // that the rest of the samples can use the constant target gain
+    int getNextGains (FloatType* gains, int numSamplesRemaining) noexcept
+    {
+        auto numThisTime = jmin (numSamplesRemaining, countdown, gainBlockSize);
+        static_cast <SmoothedValueType*> (this)->getNextValues (gains, numThisTime);
+        return numThisTime;
+    }
+
 protected:
     //==============================================================================
     FloatType currentValue = 0;
@@ -194,6 +220,101 @@ namespace ValueSmoothingTypes
     struct Multiplicative {};
 }
 
+#ifndef DOXYGEN
+template <typename FloatType, typename SmoothingType> class SmoothedValue;
+template <typename FloatType, typename SmoothingType> class SmoothedValueBank;
+
+/*  The closed-form sequences used internally by SmoothedValue and SmoothedValueBank.
+
+    A linear ramp's value is computed from its distance to the target, which is
+    what SmoothedValue::getNextValue() does too, so that filling a block gives
+    exactly the same values as stepping through it. As no value depends on the
+    previous one, the loops that fill buffers can be vectorised. The float versions
+    are written with SSE or NEON intrinsics, and produce the same values as the
+    generic versions.
+
+    A multiplicative ramp is filled by multiplying by powers of the step, rather
+    than by the step once per value, so its values only match stepping through it
+    to within rounding.
+*/
+class JUCE_API  SmoothedValueRamp
+{
+    template <typename, typename> friend class SmoothedValue;
+    template <typename, typename> friend class SmoothedValueBank;
+
+    template <typename FloatType>
+    static FloatType getStep (ValueSmoothingTypes::Linear, FloatType current, FloatType target, int numSteps) noexcept
+    {
+        return (target - current) / (FloatType) numSteps;
+    }
+
+    template <typename FloatType>
+    static FloatType getStep (ValueSmoothingTypes::Multiplicative, FloatType current, FloatType target, int numSteps) noexcept
+    {
+        return std::exp ((std::log (std::abs (target)) - std::log (std::abs (current))) / (FloatType) numSteps);
+    }
+
+    /*  Returns the value after numSteps more steps, for a ramp which is countdown steps from its target. */
+    template <typename FloatType>
+    static FloatType advance (ValueSmoothingTypes::Linear, FloatType, FloatType target, FloatType step, int countdown, int numSteps) noexcept
+    {
+        return target - step * (FloatType) (countdown - numSteps);
+    }
+
+    template <typename FloatType>
+    static FloatType advance (ValueSmoothingTypes::Multiplicative, FloatType current, FloatType, FloatType step, int, int numSteps) noexcept
+    {
+        return current * (FloatType) std::pow (step, numSteps);
+    }
+
+    /*  Writes the numValues values that follow the current one. */
+    template <typename FloatType>
+    static void fill (ValueSmoothingTypes::Linear, FloatType* destination, FloatType, FloatType target, FloatType step,
+                      int countdown, int numValues) noexcept
+    {
+        for (int i = 0; i < numValues; ++i)
+            destination[i] = target - step * (FloatType) (countdown - (i + 1));
+    }
+
+    static void fill (ValueSmoothingTypes::Linear, float* destination, float current, float target, float step,
+                      int countdown, int numValues) noexcept;
+
+    /*  The powers of the step are computed once for a small block, and each block
+        of output only depends on the last value of the previous one.
+    */
+    template <typename FloatType>
+    static void fill (ValueSmoothingTypes::Multiplicative, FloatType* destination, FloatType current, FloatType, FloatType step,
+                      int, int numValues) noexcept
+    {
+        constexpr int blockSize = 8;
+        FloatType powers[blockSize];
+        auto power = step;
+
+        for (auto& p : powers)
+        {
+            p = power;
+            power *= step;
+        }
+
+        int i = 0;
+
+        for (; i + blockSize <= numValues; i += blockSize)
+        {
+            for (int j = 0; j < blockSize; ++j)
+                destination[i + j] = current * powers[j];
+
+            current = destination[i + blockSize - 1];
+        }
+
+        for (int j = 0; i + j < numValues; ++j)
+            destination[i + j] = current * powers[j];
+    }
+
+    static void fill (ValueSmoothingTypes::Multiplicative, float* destination, float current, float target, float step,
+                      int countdown, int numValues) noexcept;
+};
+#endif
+
 //==============================================================================
 /**
     A utility class for values that need smoothing to avoid audio glitches.
@@ -292,6 +413,11 @@ public:
 
     //==============================================================================
     /** Compute the next value.
+
+        A linear ramp's values are worked out from the number of steps left to the
+        target, rather than by adding the step to the previous value each time, so
+        rounding errors don't build up over long ramps.
+
         @returns Smoothed value
     */
     FloatType getNextValue() noexcept
@@ -309,6 +435,46 @@ public:
         return this->currentValue;
     }
 
+    /** Fills a buffer with the next values of the ramp.
+
+        This matches calling getNextValue() numSamples times and storing the results,
+        but the values are computed directly from their position in the ramp, so the
+        buffer can be filled with vectorised code. This is the fastest way to get a
+        per-sample ramp for a whole block.
+
+        Linear ramps give exactly the same values as getNextValue(). Multiplicative
+        ramps multiply by powers of the step rather than by the step once per sample,
+        so their values match to within rounding, but not always bit-for-bit. Either
+        way, the last value of the ramp is always exactly the target.
+
+        @param destination  Pointer to a raw array which will receive the values
+        @param numSamples   The number of values to write
+        @see getNextValue, applyGain
+    */
+    void getNextValues (FloatType* destination, int numSamples) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        auto numToSmooth = jmin (numSamples, this->countdown);
+
+        if (numToSmooth > 0)
+        {
+            // The final step always lands exactly on the target, as it does with getNextValue()
+            auto numOnRamp = numToSmooth < this->countdown ? numToSmooth : numToSmooth - 1;
+            SmoothedValueRamp::fill (SmoothingType(), destination, this->currentValue, this->target,
+                                             step, this->countdown, numOnRamp);
+
+            this->countdown -= numToSmooth;
+
+            if (this->isSmoothing())
+                this->currentValue = destination[numOnRamp - 1];
+            else
+                this->currentValue = destination[numOnRamp] = this->target;
+        }
+
+        FloatVectorOperations::fill (destination + numToSmooth, this->target, numSamples - numToSmooth);
+    }
+
     //==============================================================================
     /** Skip the next numSamples samples.
         This is identical to calling getNextValue numSamples times. It returns
@@ -361,23 +527,16 @@ private:
     using MultiplicativeVoid = typename std::enable_if <std::is_same <T, ValueSmoothingTypes::Multiplicative>::value, void>::type;
 
     //==============================================================================
-    template <typename T = SmoothingType>
-    LinearVoid<T> setStepSize() noexcept
-    {
-        step = (this->target - this->currentValue) / (FloatType) this->countdown;
-    }
-
-    template <typename T = SmoothingType>
-    MultiplicativeVoid<T> setStepSize()
+    void setStepSize() noexcept
     {
-        step = std::exp ((std::log (std::abs (this->target)) - std::log (std::abs (this->currentValue))) / (FloatType) this->countdown);
+        step = SmoothedValueRamp::getStep (SmoothingType(), this->currentValue, this->target, this->countdown);
     }
 
     //==============================================================================
     template <typename T = SmoothingType>
     LinearVoid<T> setNextValue() noexcept
     {
-        this->currentValue += step;
+        this->currentValue = this->target - step * (FloatType) this->countdown;
     }
 
     template <typename T = SmoothingType>
@@ -387,16 +546,10 @@ private:
     }
 
     //==============================================================================
-    template <typename T = SmoothingType>
-    LinearVoid<T> skipCurrentValue (int numSamples) noexcept
-    {
-        this->currentValue += step * (FloatType) numSamples;
-    }
-
-    template <typename T = SmoothingType>
-    MultiplicativeVoid<T> skipCurrentValue (int numSamples)
+    void skipCurrentValue (int numSamples) noexcept
     {
-        this->currentValue *= (FloatType) std::pow (step, numSamples);
+        this->currentValue = SmoothedValueRamp::advance (SmoothingType(), this->currentValue, this->target,
+                                                                 step, this->countdown, numSamples);
     }
 
     //==============================================================================
@@ -407,6 +560,244 @@ private:
 template <typename FloatType>
 using LinearSmoothedValue = SmoothedValue <FloatType, ValueSmoothingTypes::Linear>;
 
+//==============================================================================
+/**
+    A set of smoothed values which share the same ramp length.
+
+    This behaves like an array of SmoothedValue objects, but the values are stored
+    as a structure of arrays, so that advancing all of them at the end of a block
+    is a single pass which the compiler can vectorise. This makes it a much cheaper
+    way to smooth a large number of parameters than using a SmoothedValue for each.
+
+    A typical processBlock() sets the new targets, uses getNextValues() or
+    getCurrentValue() to read each value, and then calls skip() once to move all
+    the values on to the end of the block:
+
+    @code
+    for (int i = 0; i < parameters.size(); ++i)
+        bank.setTargetValue (i, parameters[i]->get());
+
+    bank.getNextValues (gainIndex, gainRamp, numSamples);
+    // ...
+    bank.skip (numSamples);
+    @endcode
+
+    @see SmoothedValue
+
+    @tags{Audio}
+*/
+template <typename FloatType, typename SmoothingType = ValueSmoothingTypes::Linear>
+class SmoothedValueBank
+{
+public:
+    //==============================================================================
+    /** Creates an empty bank. */
+    SmoothedValueBank() = default;
+
+    /** Creates a bank holding the given number of values. */
+    explicit SmoothedValueBank (int numValuesToUse)
+    {
+        setSize (numValuesToUse);
+    }
+
+    //==============================================================================
+    /** Changes the number of values in the bank.
+
+        This allocates memory, so shouldn't be called on the audio thread. All the
+        values are set to the same initial value that a SmoothedValue would have.
+    */
+    void setSize (int newNumValues)
+    {
+        jassert (newNumValues >= 0);
+
+        numValues = newNumValues;
+        currentValues.malloc (numValues);
+        targetValues.malloc (numValues);
+        steps.calloc (numValues);
+        countdowns.calloc (numValues);
+
+        auto initialValue = (FloatType) (std::is_same<SmoothingType, ValueSmoothingTypes::Linear>::value ? 0 : 1);
+        FloatVectorOperations::fill (currentValues.get(), initialValue, numValues);
+        FloatVectorOperations::fill (targetValues.get(),  initialValue, numValues);
+        numSmoothing = 0;
+    }
+
+    /** Returns the number of values in the bank. */
+    int size() const noexcept                                { return numValues; }
+
+    //==============================================================================
+    /** Reset to a new sample rate and ramp length.
+        All the values will jump to their targets.
+        @param sampleRate           The sample rate
+        @param rampLengthInSeconds  The duration of the ramp in seconds
+    */
+    void reset (double sampleRate, double rampLengthInSeconds) noexcept
+    {
+        jassert (sampleRate > 0 && rampLengthInSeconds >= 0);
+        reset ((int) std::floor (rampLengthInSeconds * sampleRate));
+    }
+
+    /** Set a new ramp length directly in samples.
+        All the values will jump to their targets.
+        @param numSteps     The number of samples over which the ramps should be active
+    */
+    void reset (int numSteps) noexcept
+    {
+        stepsToTarget = numSteps;
+
+        FloatVectorOperations::copy (currentValues.get(), targetValues.get(), numValues);
+        zeromem (countdowns.get(), (size_t) numValues * sizeof (int));
+        numSmoothing = 0;
+    }
+
+    //==============================================================================
+    /** Set the next value to ramp towards for one of the values. */
+    void setTargetValue (int index, FloatType newValue) noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues));
+
+        if (newValue == targetValues[index])
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue (index, newValue);
+            return;
+        }
+
+        // Multiplicative smoothed values cannot ever reach 0!
+        jassert (! (std::is_same<SmoothingType, ValueSmoothingTypes::Multiplicative>::value && newValue == 0));
+
+        if (countdowns[index] == 0)
+            ++numSmoothing;
+
+        targetValues[index] = newValue;
+        countdowns[index] = stepsToTarget;
+        steps[index] = SmoothedValueRamp::getStep (SmoothingType(), currentValues[index], newValue, stepsToTarget);
+    }
+
+    /** Sets the current value and the target value for one of the values. */
+    void setCurrentAndTargetValue (int index, FloatType newValue) noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues));
+
+        if (countdowns[index] > 0)
+            --numSmoothing;
+
+        currentValues[index] = targetValues[index] = newValue;
+        countdowns[index] = 0;
+    }
+
+    //==============================================================================
+    /** Returns the current value of one of the ramps. */
+    FloatType getCurrentValue (int index) const noexcept     { jassert (isPositiveAndBelow (index, numValues)); return currentValues[index]; }
+
+    /** Returns the value towards which one of the ramps is moving. */
+    FloatType getTargetValue (int index) const noexcept      { jassert (isPositiveAndBelow (index, numValues)); return targetValues[index]; }
+
+    /** Returns true if one of the values is currently being interpolated. */
+    bool isSmoothing (int index) const noexcept              { jassert (isPositiveAndBelow (index, numValues)); return countdowns[index] > 0; }
+
+    /** Returns true if any of the values are currently being interpolated. */
+    bool isAnySmoothing() const noexcept                     { return numSmoothing > 0; }
+
+    //==============================================================================
+    /** Writes the values that one of the ramps will take over the next numSamples samples.
+
+        Unlike SmoothedValue::getNextValues(), this doesn't move the ramp on, so that all
+        the values in the bank can be advanced together by calling skip() at the end of
+        the block.
+    */
+    void getNextValues (int index, FloatType* destination, int numSamples) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues) && numSamples >= 0);
+
+        auto numToSmooth = jmin (numSamples, countdowns[index]);
+
+        if (numToSmooth > 0)
+        {
+            auto reachesTarget = (numToSmooth == countdowns[index]);
+            auto numOnRamp = reachesTarget ? numToSmooth - 1 : numToSmooth;
+
+            SmoothedValueRamp::fill (SmoothingType(), destination, currentValues[index], targetValues[index],
+                                             steps[index], countdowns[index], numOnRamp);
+
+            if (reachesTarget)
+                destination[numOnRamp] = targetValues[index];
+        }
+
+        FloatVectorOperations::fill (destination + numToSmooth, targetValues[index], numSamples - numToSmooth);
+    }
+
+    /** Applies one of the ramps as a gain to a stream of samples, without moving the ramp on.
+        @see getNextValues, skip
+    */
+    void applyGain (int index, FloatType* samples, int numSamples) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues) && numSamples >= 0);
+
+        FloatType gains[gainBlockSize];
+        auto numToSmooth = jmin (numSamples, countdowns[index]);
+        int startSample = 0;
+
+        // Each block is computed from the start of the ramp, so it has to be offset into it
+        while (startSample < numToSmooth)
+        {
+            auto numThisTime = jmin (numToSmooth - startSample, (int) gainBlockSize);
+            auto countdown = countdowns[index] - startSample;
+            auto blockStart = SmoothedValueRamp::advance (SmoothingType(), currentValues[index], targetValues[index],
+                                                                  steps[index], countdowns[index], startSample);
+            SmoothedValueRamp::fill (SmoothingType(), gains, blockStart, targetValues[index],
+                                             steps[index], countdown, numThisTime);
+
+            if (numThisTime == countdown)
+                gains[numThisTime - 1] = targetValues[index];
+
+            FloatVectorOperations::multiply (samples + startSample, gains, numThisTime);
+            startSample += numThisTime;
+        }
+
+        FloatVectorOperations::multiply (samples + startSample, targetValues[index], numSamples - startSample);
+    }
+
+    /** Moves all the ramps on by numSamples samples.
+
+        This is identical to calling SmoothedValue::skip() on each value, but is done in
+        a single pass over the arrays.
+    */
+    void skip (int numSamples) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        if (numSmoothing == 0 || numSamples == 0)
+            return;
+
+        numSmoothing = 0;
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            auto countdown = countdowns[i];
+            auto advanced = SmoothedValueRamp::advance (SmoothingType(), currentValues[i], targetValues[i],
+                                                                steps[i], countdown, jmin (numSamples, countdown));
+            auto remaining = jmax (0, countdown - numSamples);
+
+            currentValues[i] = remaining > 0 ? advanced : targetValues[i];
+            countdowns[i] = remaining;
+            numSmoothing += (remaining > 0 ? 1 : 0);
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr int gainBlockSize = 64;
+
+    HeapBlock<FloatType> currentValues, targetValues, steps;
+    HeapBlock<int> countdowns;
+    int numValues = 0, numSmoothing = 0, stepsToTarget = 0;
+
+    JUCE_LEAK_DETECTOR (SmoothedValueBank)
+};
+
 
 //==============================================================================
 //==============================================================================
@@ -555,6 +946,31 @@ public:
             compareData (testData, referenceData);
         }
 
+        beginTest ("Block fill");
+        {
+            SmoothedValueType sv (1.0f);
+            sv.reset (100);
+            sv.setTargetValue (2.0f);
+
+            auto reference = sv;
+            const int blockSizes[] = { 1, 7, 64, 13, 100 };
+
+            for (auto blockSize : blockSizes)
+            {
+                HeapBlock<float> values (blockSize);
+                sv.getNextValues (values, blockSize);
+
+                for (int i = 0; i < blockSize; ++i)
+                    expectWithinAbsoluteError (values[i], reference.getNextValue(), 1.0e-5f);
+
+                expectWithinAbsoluteError (sv.getCurrentValue(), reference.getCurrentValue(), 1.0e-5f);
+                expect (sv.isSmoothing() == reference.isSmoothing());
+            }
+
+            expect (! sv.isSmoothing());
+            expectEquals (sv.getCurrentValue(), sv.getTargetValue());
+        }
+
         beginTest ("Skip");
         {
             SmoothedValueType sv;
@@ -10030,4 +10030,115 @@ const float Interpolators::WindowedSincTraits::lookupTable[] {
     0.000000000000000000e+00f
 };
 
+//==============================================================================
+namespace WindowedSincHelpers
+{
+    constexpr int numCrossings = 100;
+    constexpr int numTaps = 2 * numCrossings;
+    constexpr int numPhases = 100;
+
+    /*  The lookup table holds one side of the windowed sinc, sampled at 100 points per
+        zero crossing. For a given phase p, the coefficients of all 200 taps are spaced
+        100 entries apart, so here they're regathered into one contiguous row per phase,
+        with the negative half reversed so that a row lines up with a history window
+        that is stored oldest-sample-first.
+
+        For an offset o = (p + f) / 100, the filter is then the linear interpolation
+        between rows p and p + 1, which lets each output sample be computed as a single
+        contiguous pass over the input.
+    */
+    struct PolyphaseTable
+    {
+        explicit PolyphaseTable (const float* lookupTable) noexcept
+        {
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                for (int k = 0; k < numCrossings; ++k)
+                {
+                    rows[phase][numCrossings - 1 - k] = lookupTable[k * 100 + phase];
+                    rows[phase][numCrossings + k]     = lookupTable[k * 100 + (numPhases - phase)];
+                }
+            }
+        }
+
+        alignas (16) float rows[numPhases + 1][numTaps];
+    };
+
+    static const PolyphaseTable& getPolyphaseTable (const float* lookupTable) noexcept
+    {
+        static const PolyphaseTable table (lookupTable);
+        return table;
+    }
+
+    // Returns the sum of input[i] * (row0[i] + frac * (row1[i] - row0[i])).
+    static float interpolatedDotProduct (const float* input, const float* row0, const float* row1,
+                                         float frac, int num) noexcept
+    {
+        int i = 0;
+        float result = 0.0f;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto f = _mm_set1_ps (frac);
+        auto acc0 = _mm_setzero_ps();
+        auto acc1 = _mm_setzero_ps();
+
+        for (; i + 8 <= num; i += 8)
+        {
+            const auto r0a = _mm_loadu_ps (row0 + i), r0b = _mm_loadu_ps (row0 + i + 4);
+            const auto r1a = _mm_loadu_ps (row1 + i), r1b = _mm_loadu_ps (row1 + i + 4);
+
+            acc0 = _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (input + i),
+                                                 _mm_add_ps (r0a, _mm_mul_ps (f, _mm_sub_ps (r1a, r0a)))));
+            acc1 = _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (input + i + 4),
+                                                 _mm_add_ps (r0b, _mm_mul_ps (f, _mm_sub_ps (r1b, r0b)))));
+        }
+
+        alignas (16) float lanes[4];
+        _mm_store_ps (lanes, _mm_add_ps (acc0, acc1));
+        result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+       #elif JUCE_USE_ARM_NEON
+        const auto f = vdupq_n_f32 (frac);
+        auto acc0 = vdupq_n_f32 (0.0f);
+        auto acc1 = vdupq_n_f32 (0.0f);
+
+        for (; i + 8 <= num; i += 8)
+        {
+            const auto r0a = vld1q_f32 (row0 + i), r0b = vld1q_f32 (row0 + i + 4);
+            const auto r1a = vld1q_f32 (row1 + i), r1b = vld1q_f32 (row1 + i + 4);
+
+            acc0 = vmlaq_f32 (acc0, vld1q_f32 (input + i),     vmlaq_f32 (r0a, f, vsubq_f32 (r1a, r0a)));
+            acc1 = vmlaq_f32 (acc1, vld1q_f32 (input + i + 4), vmlaq_f32 (r0b, f, vsubq_f32 (r1b, r0b)));
+        }
+
+        const auto sum = vaddq_f32 (acc0, acc1);
+        result = (vgetq_lane_f32 (sum, 0) + vgetq_lane_f32 (sum, 1))
+               + (vgetq_lane_f32 (sum, 2) + vgetq_lane_f32 (sum, 3));
+       #endif
+
+        for (; i < num; ++i)
+            result += input[i] * (row0[i] + frac * (row1[i] - row0[i]));
+
+        return result;
+    }
+}
+
+float Interpolators::WindowedSincTraits::valueAtOffset (const float* inputs, float offset, int index) noexcept
+{
+    // GenericInterpolator always passes a contiguous window, so there's never a wrapped history to unroll
+    jassertquiet (index == 0);
+
+    using namespace WindowedSincHelpers;
+
+    const auto& table = getPolyphaseTable (lookupTable);
+
+    const auto scaledOffset = jlimit (0.0f, 1.0f, offset) * (float) numPhases;
+    const auto phase = jmin ((int) scaledOffset, numPhases - 1);
+    const auto frac = scaledOffset - (float) phase;
+
+    const auto* row0 = table.rows[phase];
+    const auto* row1 = table.rows[phase + 1];
+
+    return interpolatedDotProduct (inputs, row0, row1, frac, numTaps);
+}
+
 } // namespace juce
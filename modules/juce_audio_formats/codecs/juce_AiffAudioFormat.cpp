@@ -924,6 +924,8 @@ public:
 
     using AudioFormatReader::readMaxLevels;
 
+    bool canReadMaxLevelsQuickly() const override    { return true; }
+
 private:
     const bool littleEndian;
 
@@ -170,14 +170,326 @@ static const char* const flacFormatName = "FLAC file";
 template <typename Item>
 auto emptyRange (Item item) { return Range<Item>::emptyRange (item); }
 
+//==============================================================================
+namespace FlacHelpers
+{
+    // The readers and writers share one pool, which only exists while one of them needs it
+    struct SharedThreadPool  : public ThreadPool
+    {
+        SharedThreadPool()  : ThreadPool (jmax (2, SystemStats::getNumCpus())) {}
+    };
+
+    // Runs task (0) to task (numTasks - 1), using the calling thread as one of the workers
+    static void runInParallel (ThreadPool& pool, int numTasks, const std::function<void (int)>& task)
+    {
+        std::atomic<int> numRemaining { numTasks - 1 };
+        WaitableEvent allFinished;
+
+        for (int i = 1; i < numTasks; ++i)
+        {
+            pool.addJob ([&, i]
+            {
+                task (i);
+
+                if (--numRemaining == 0)
+                    allFinished.signal();
+            });
+        }
+
+        task (0);
+
+        if (numTasks > 1)
+            allFinished.wait();
+    }
+
+    //==============================================================================
+    static uint8 crc8 (const uint8* data, size_t numBytes) noexcept
+    {
+        static const auto table = []
+        {
+            std::array<uint8, 256> t;
+
+            for (int i = 0; i < 256; ++i)
+            {
+                auto crc = (uint8) i;
+
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (uint8) ((crc & 0x80) != 0 ? (crc << 1) ^ 0x07 : (crc << 1));
+
+                t[(size_t) i] = crc;
+            }
+
+            return t;
+        }();
+
+        uint8 crc = 0;
+
+        while (numBytes-- > 0)
+            crc = table[(size_t) (crc ^ *data++)];
+
+        return crc;
+    }
+
+    static uint16 crc16 (const uint8* data, size_t numBytes) noexcept
+    {
+        static const auto table = []
+        {
+            std::array<uint16, 256> t;
+
+            for (int i = 0; i < 256; ++i)
+            {
+                auto crc = (uint16) (i << 8);
+
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (uint16) ((crc & 0x8000) != 0 ? (crc << 1) ^ 0x8005 : (crc << 1));
+
+                t[(size_t) i] = crc;
+            }
+
+            return t;
+        }();
+
+        uint16 crc = 0;
+
+        while (numBytes-- > 0)
+            crc = (uint16) ((crc << 8) ^ table[(size_t) ((crc >> 8) ^ *data++)]);
+
+        return crc;
+    }
+
+    // Writes the frame number in the UTF-8-like coding that frame headers use
+    static int writeFrameNumber (uint32 number, uint8* dest) noexcept
+    {
+        if (number < 0x80)
+        {
+            dest[0] = (uint8) number;
+            return 1;
+        }
+
+        const int numBytes = number < 0x800 ? 2 : number < 0x10000 ? 3 : number < 0x200000 ? 4 : number < 0x4000000 ? 5 : 6;
+
+        for (int i = numBytes; --i > 0;)
+        {
+            dest[i] = (uint8) (0x80 | (number & 0x3f));
+            number >>= 6;
+        }
+
+        dest[0] = (uint8) ((0xff00 >> numBytes) | number);
+        return numBytes;
+    }
+
+    /*  Copies a fixed-blocksize frame to the output, replacing its frame number and
+        recalculating its checksums. Returns the size of the new frame, or 0 if the
+        frame couldn't be parsed.
+    */
+    static size_t writeRenumberedFrame (const uint8* frame, size_t numBytes, uint32 newFrameNumber, MemoryOutputStream& out)
+    {
+        if (numBytes < 8 || frame[0] != 0xff || frame[1] != 0xf8)
+            return 0;
+
+        int numNumberBytes = 1;
+
+        if ((frame[4] & 0x80) != 0)
+        {
+            numNumberBytes = 0;
+
+            while (numNumberBytes < 8 && (frame[4] & (0x80 >> numNumberBytes)) != 0)
+                ++numNumberBytes;
+
+            if (numNumberBytes < 2 || numNumberBytes > 6)
+                return 0;
+        }
+
+        const auto blockSizeCode  = frame[2] >> 4;
+        const auto sampleRateCode = frame[2] & 0x0f;
+        const auto numExtraBytes = (blockSizeCode == 6 ? 1 : blockSizeCode == 7 ? 2 : 0)
+                                 + (sampleRateCode == 12 ? 1 : (sampleRateCode == 13 || sampleRateCode == 14) ? 2 : 0);
+
+        const auto oldHeaderSize = (size_t) (4 + numNumberBytes + numExtraBytes);
+
+        if (oldHeaderSize + 3 > numBytes)
+            return 0;
+
+        uint8 header[16];
+        memcpy (header, frame, 4);
+        auto headerSize = (size_t) (4 + writeFrameNumber (newFrameNumber, header + 4));
+        memcpy (header + headerSize, frame + 4 + numNumberBytes, (size_t) numExtraBytes);
+        headerSize += (size_t) numExtraBytes;
+        header[headerSize] = crc8 (header, headerSize);
+        ++headerSize;
+
+        const auto startPos = out.getDataSize();
+        out.write (header, headerSize);
+        out.write (frame + oldHeaderSize + 1, numBytes - oldHeaderSize - 3);
+
+        const auto newFrameSize = out.getDataSize() - startPos;
+        const auto crc = crc16 (static_cast<const uint8*> (out.getData()) + startPos, newFrameSize);
+        out.writeByte ((char) (crc >> 8));
+        out.writeByte ((char) (crc & 0xff));
+
+        return newFrameSize + 2;
+    }
+
+    //==============================================================================
+    static void writeStreamInfo (OutputStream& out, const FlacNamespace::FLAC__StreamMetadata_StreamInfo& info)
+    {
+        using namespace FlacNamespace;
+
+        const auto packUint32 = [] (FLAC__uint32 val, FLAC__byte* b, const int bytes)
+        {
+            b += bytes;
+
+            for (int i = 0; i < bytes; ++i)
+            {
+                *(--b) = (FLAC__byte) (val & 0xff);
+                val >>= 8;
+            }
+        };
+
+        unsigned char buffer[FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
+        const unsigned int channelsMinus1 = info.channels - 1;
+        const unsigned int bitsMinus1 = info.bits_per_sample - 1;
+
+        packUint32 (info.min_blocksize, buffer, 2);
+        packUint32 (info.max_blocksize, buffer + 2, 2);
+        packUint32 (info.min_framesize, buffer + 4, 3);
+        packUint32 (info.max_framesize, buffer + 7, 3);
+        buffer[10] = (uint8) ((info.sample_rate >> 12) & 0xff);
+        buffer[11] = (uint8) ((info.sample_rate >> 4) & 0xff);
+        buffer[12] = (uint8) (((info.sample_rate & 0x0f) << 4) | (channelsMinus1 << 1) | (bitsMinus1 >> 4));
+        buffer[13] = (FLAC__byte) (((bitsMinus1 & 0x0f) << 4) | (unsigned int) ((info.total_samples >> 32) & 0x0f));
+        packUint32 ((FLAC__uint32) info.total_samples, buffer + 14, 4);
+        memcpy (buffer + 18, info.md5sum, 16);
+
+        out.writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+        out.write (buffer, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+    }
+
+    static void configureEncoder (FlacNamespace::FLAC__StreamEncoder* encoder, unsigned int numChannels,
+                                  unsigned int bitsPerSample, double sampleRate, int qualityOptionIndex)
+    {
+        if (qualityOptionIndex > 0)
+            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
+
+        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
+        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
+        FLAC__stream_encoder_set_channels (encoder, numChannels);
+        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
+        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
+        FLAC__stream_encoder_set_blocksize (encoder, 0);
+        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+    }
+
+    //==============================================================================
+    /*  Decodes a run of frames which have been loaded into memory, copying the part of
+        them that overlaps the range that was asked for into the destination buffers.
+    */
+    struct SegmentDecoder
+    {
+        const uint8* data;
+        size_t size, position = 0;
+        int64 nextSample;
+        Range<int64> rangeToRead;
+        int* const* destSamples;
+        int numDestChannels, destOffset;
+        unsigned int numChannels, bitsPerSample;
+        bool failed = false;
+
+        bool decode (int64 endSample)
+        {
+            auto* decoder = FlacNamespace::FLAC__stream_decoder_new();
+
+            if (FLAC__stream_decoder_init_stream (decoder, readCallback, nullptr, nullptr, nullptr, eofCallback,
+                                                  writeCallback, nullptr, errorCallback, this)
+                  == FlacNamespace::FLAC__STREAM_DECODER_INIT_STATUS_OK)
+            {
+                while (! failed && nextSample < endSample)
+                {
+                    if (! FLAC__stream_decoder_process_single (decoder)
+                         || FLAC__stream_decoder_get_state (decoder) == FlacNamespace::FLAC__STREAM_DECODER_END_OF_STREAM)
+                        break;
+                }
+            }
+
+            FlacNamespace::FLAC__stream_decoder_delete (decoder);
+            return ! failed && nextSample == endSample;
+        }
+
+        void useSamples (const FlacNamespace::FLAC__Frame* frame, const FlacNamespace::FLAC__int32* const buffer[])
+        {
+            if (frame->header.channels != numChannels || frame->header.bits_per_sample != bitsPerSample)
+            {
+                failed = true;
+                return;
+            }
+
+            const Range<int64> frameRange (nextSample, nextSample + (int64) frame->header.blocksize);
+            const auto overlap = frameRange.getIntersectionWith (rangeToRead);
+            const auto bitsToShift = 32 - (int) bitsPerSample;
+
+            for (int i = jmin (numDestChannels, (int) numChannels); --i >= 0;)
+            {
+                if (auto* dest = destSamples[i])
+                {
+                    auto* src = buffer[i] + (overlap.getStart() - frameRange.getStart());
+                    dest += destOffset + (overlap.getStart() - rangeToRead.getStart());
+
+                    for (auto j = overlap.getLength(); --j >= 0;)
+                        *dest++ = *src++ << bitsToShift;
+                }
+            }
+
+            nextSample = frameRange.getEnd();
+        }
+
+        static FlacNamespace::FLAC__StreamDecoderReadStatus readCallback (const FlacNamespace::FLAC__StreamDecoder*, FlacNamespace::FLAC__byte buffer[], size_t* bytes, void* client_data)
+        {
+            auto& d = *static_cast<SegmentDecoder*> (client_data);
+            *bytes = jmin (*bytes, d.size - d.position);
+            memcpy (buffer, d.data + d.position, *bytes);
+            d.position += *bytes;
+
+            return *bytes > 0 ? FlacNamespace::FLAC__STREAM_DECODER_READ_STATUS_CONTINUE
+                              : FlacNamespace::FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+        }
+
+        static FlacNamespace::FLAC__bool eofCallback (const FlacNamespace::FLAC__StreamDecoder*, void* client_data)
+        {
+            auto& d = *static_cast<SegmentDecoder*> (client_data);
+            return d.position >= d.size;
+        }
+
+        static FlacNamespace::FLAC__StreamDecoderWriteStatus writeCallback (const FlacNamespace::FLAC__StreamDecoder*,
+                                                                            const FlacNamespace::FLAC__Frame* frame,
+                                                                            const FlacNamespace::FLAC__int32* const buffer[],
+                                                                            void* client_data)
+        {
+            auto& d = *static_cast<SegmentDecoder*> (client_data);
+            d.useSamples (frame, buffer);
+
+            return d.failed ? FlacNamespace::FLAC__STREAM_DECODER_WRITE_STATUS_ABORT
+                            : FlacNamespace::FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+        }
+
+        static void errorCallback (const FlacNamespace::FLAC__StreamDecoder*, FlacNamespace::FLAC__StreamDecoderErrorStatus, void* client_data)
+        {
+            // a lost sync or a bad checksum means the seek table can't be trusted
+            static_cast<SegmentDecoder*> (client_data)->failed = true;
+        }
+    };
+}
+
 //==============================================================================
 class FlacReader  : public AudioFormatReader
 {
 public:
-    FlacReader (InputStream* in)  : AudioFormatReader (in, flacFormatName)
+    FlacReader (InputStream* in, int numThreadsToUse)
+        : AudioFormatReader (in, flacFormatName),
+          numThreads (numThreadsToUse)
     {
         lengthInSamples = 0;
         decoder = FlacNamespace::FLAC__stream_decoder_new();
+        FLAC__stream_decoder_set_metadata_respond (decoder, FlacNamespace::FLAC__METADATA_TYPE_SEEKTABLE);
 
         ok = FLAC__stream_decoder_init_stream (decoder,
                                                readCallback_, seekCallback_, tellCallback_, lengthCallback_,
@@ -201,6 +513,15 @@ public:
                 FLAC__stream_decoder_process_until_end_of_metadata (decoder);
                 lengthInSamples = tempLength;
             }
+
+            FlacNamespace::FLAC__uint64 position = 0;
+
+            if (numThreads > 1 && seekPoints.size() > 1
+                 && FLAC__stream_decoder_get_decode_position (decoder, &position))
+            {
+                firstFramePosition = (int64) position;
+                threadPool = std::make_unique<SharedResourcePointer<FlacHelpers::SharedThreadPool>>();
+            }
         }
     }
 
@@ -219,12 +540,39 @@ public:
         reservoir.setSize ((int) numChannels, 2 * (int) info.max_blocksize, false, false, true);
     }
 
+    void useSeekTable (const FlacNamespace::FLAC__StreamMetadata_SeekTable& table)
+    {
+        seekPoints.clearQuick();
+
+        for (unsigned int i = 0; i < table.num_points; ++i)
+        {
+            auto& point = table.points[i];
+
+            if (point.sample_number == FlacNamespace::FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER)
+                continue;
+
+            // only a strictly ascending table can be split up into segments
+            if (! seekPoints.isEmpty() && (seekPoints.getLast().sampleNumber >= (int64) point.sample_number
+                                            || seekPoints.getLast().byteOffset >= (int64) point.stream_offset))
+            {
+                seekPoints.clearQuick();
+                return;
+            }
+
+            seekPoints.add ({ (int64) point.sample_number, (int64) point.stream_offset });
+        }
+    }
+
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override
     {
         if (! ok)
             return false;
 
+        if (threadPool != nullptr
+             && readSamplesInParallel (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples))
+            return true;
+
         const auto getBufferedRange = [this] { return bufferedRange; };
 
         const auto readFromReservoir = [this, &destSamples, &numDestChannels, &startOffsetInDestBuffer, &startSampleInFile] (const Range<int64> rangeToRead)
@@ -258,6 +606,15 @@ public:
                 // accurately than this. Probably fixed in newer versions of the library, though.
                 bufferedRange = emptyRange (requestedStart & ~511);
                 FLAC__stream_decoder_seek_absolute (decoder, (FlacNamespace::FLAC__uint64) bufferedRange.getStart());
+
+                // the seek only delivers the rest of the frame that it lands in, which
+                // may end before the sample that was asked for
+                while (! bufferedRange.isEmpty() && bufferedRange.getEnd() <= requestedStart)
+                {
+                    bufferedRange = emptyRange (bufferedRange.getEnd());
+                    FLAC__stream_decoder_process_single (decoder);
+                }
+
                 return;
             }
 
@@ -273,7 +630,124 @@ public:
         if (! remainingSamples.isEmpty())
             for (int i = numDestChannels; --i >= 0;)
                 if (destSamples[i] != nullptr)
-                    zeromem (destSamples[i] + startOffsetInDestBuffer, (size_t) remainingSamples.getLength() * sizeof (int));
+                    zeromem (destSamples[i] + startOffsetInDestBuffer + (remainingSamples.getStart() - startSampleInFile),
+                             (size_t) remainingSamples.getLength() * sizeof (int));
+
+        return true;
+    }
+
+    const uint8* getDataInMemory() const
+    {
+        if (auto* mappedStream = dynamic_cast<MemoryMappedFileInputStream*> (input))
+            return static_cast<const uint8*> (mappedStream->getData());
+
+        if (auto* memoryStream = dynamic_cast<MemoryInputStream*> (input))
+            return static_cast<const uint8*> (memoryStream->getData());
+
+        return nullptr;
+    }
+
+    /*  Uses the seek table to split a large read into runs of frames which can be
+        decoded independently. If the table turns out not to match the frames, this
+        returns false and the normal single-threaded read is used instead.
+    */
+    bool readSamplesInParallel (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                int64 startSampleInFile, int numSamples)
+    {
+        const Range<int64> rangeToRead (startSampleInFile, jmin (startSampleInFile + numSamples, lengthInSamples));
+        const auto totalBytes = input->getTotalLength();
+
+        if (rangeToRead.getLength() < 2 * minSamplesPerSegment || totalBytes <= firstFramePosition
+             || seekPoints.getReference (0).sampleNumber > rangeToRead.getStart())
+            return false;
+
+        struct Segment
+        {
+            Range<int64> samples, bytes;
+        };
+
+        Array<Segment> segments;
+        int first = 0;
+
+        while (first + 1 < seekPoints.size() && seekPoints.getReference (first + 1).sampleNumber <= rangeToRead.getStart())
+            ++first;
+
+        for (int i = first; i < seekPoints.size() && seekPoints.getReference (i).sampleNumber < rangeToRead.getEnd();)
+        {
+            // merge closely-spaced seek points, so that each job has a useful amount of work to do
+            auto next = i + 1;
+
+            while (next < seekPoints.size()
+                    && seekPoints.getReference (next).sampleNumber - seekPoints.getReference (i).sampleNumber < minSamplesPerSegment)
+                ++next;
+
+            const auto isLast = next >= seekPoints.size();
+
+            segments.add ({ { seekPoints.getReference (i).sampleNumber,
+                              isLast ? lengthInSamples : seekPoints.getReference (next).sampleNumber },
+                            { seekPoints.getReference (i).byteOffset,
+                              isLast ? totalBytes - firstFramePosition : seekPoints.getReference (next).byteOffset } });
+            i = next;
+        }
+
+        if (segments.size() < 2)
+            return false;
+
+        // the serial decoder's position is about to be lost, so force it to seek next time
+        bufferedRange = emptyRange (lengthInSamples);
+
+        // if the whole file is already in memory, the frames can be decoded in place
+        // rather than being copied out of the stream first
+        auto* dataInMemory = getDataInMemory();
+
+        for (int batchStart = 0; batchStart < segments.size(); batchStart += numThreads)
+        {
+            const auto batchEnd = jmin (segments.size(), batchStart + numThreads);
+            const Range<int64> batchBytes (segments.getReference (batchStart).bytes.getStart(),
+                                           segments.getReference (batchEnd - 1).bytes.getEnd());
+
+            auto* batchData = dataInMemory != nullptr ? dataInMemory + firstFramePosition + batchBytes.getStart() : nullptr;
+
+            if (batchData == nullptr)
+            {
+                compressedData.setSize ((size_t) batchBytes.getLength(), false);
+
+                if (! input->setPosition (firstFramePosition + batchBytes.getStart())
+                     || input->read (compressedData.getData(), (int) batchBytes.getLength()) != (int) batchBytes.getLength())
+                    return false;
+
+                batchData = static_cast<const uint8*> (compressedData.getData());
+            }
+
+            std::atomic<bool> allDecoded { true };
+
+            FlacHelpers::runInParallel (**threadPool, batchEnd - batchStart, [&] (int index)
+            {
+                auto& segment = segments.getReference (batchStart + index);
+
+                FlacHelpers::SegmentDecoder segmentDecoder;
+                segmentDecoder.data = batchData + (segment.bytes.getStart() - batchBytes.getStart());
+                segmentDecoder.size = (size_t) segment.bytes.getLength();
+                segmentDecoder.nextSample = segment.samples.getStart();
+                segmentDecoder.rangeToRead = rangeToRead;
+                segmentDecoder.destSamples = destSamples;
+                segmentDecoder.numDestChannels = numDestChannels;
+                segmentDecoder.destOffset = startOffsetInDestBuffer;
+                segmentDecoder.numChannels = numChannels;
+                segmentDecoder.bitsPerSample = bitsPerSample;
+
+                if (! segmentDecoder.decode (segment.samples.getEnd()))
+                    allDecoded = false;
+            });
+
+            if (! allDecoded)
+                return false;
+        }
+
+        if (const auto numBeyondEnd = startSampleInFile + numSamples - rangeToRead.getEnd())
+            for (int i = numDestChannels; --i >= 0;)
+                if (destSamples[i] != nullptr)
+                    zeromem (destSamples[i] + startOffsetInDestBuffer + rangeToRead.getLength(), (size_t) numBeyondEnd * sizeof (int));
 
         return true;
     }
@@ -355,7 +829,12 @@ public:
                                    const FlacNamespace::FLAC__StreamMetadata* metadata,
                                    void* client_data)
     {
-        static_cast<FlacReader*> (client_data)->useMetadata (metadata->data.stream_info);
+        auto* reader = static_cast<FlacReader*> (client_data);
+
+        if (metadata->type == FlacNamespace::FLAC__METADATA_TYPE_STREAMINFO)
+            reader->useMetadata (metadata->data.stream_info);
+        else if (metadata->type == FlacNamespace::FLAC__METADATA_TYPE_SEEKTABLE)
+            reader->useSeekTable (metadata->data.seek_table);
     }
 
     static void errorCallback_ (const FlacNamespace::FLAC__StreamDecoder*, FlacNamespace::FLAC__StreamDecoderErrorStatus, void*)
@@ -363,11 +842,24 @@ public:
     }
 
 private:
+    struct SeekPoint
+    {
+        int64 sampleNumber, byteOffset;
+    };
+
+    static constexpr int64 minSamplesPerSegment = 65536;
+
     FlacNamespace::FLAC__StreamDecoder* decoder;
     AudioBuffer<float> reservoir;
     Range<int64> bufferedRange;
     bool ok = false, scanningForLength = false;
 
+    const int numThreads;
+    Array<SeekPoint> seekPoints;
+    int64 firstFramePosition = 0;
+    std::unique_ptr<SharedResourcePointer<FlacHelpers::SharedThreadPool>> threadPool;
+    MemoryBlock compressedData;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacReader)
 };
 
@@ -381,17 +873,7 @@ public:
           streamStartPos (output != nullptr ? jmax (output->getPosition(), 0ll) : 0ll)
     {
         encoder = FlacNamespace::FLAC__stream_encoder_new();
-
-        if (qualityOptionIndex > 0)
-            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
-
-        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_channels (encoder, numChannels);
-        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
-        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
-        FLAC__stream_encoder_set_blocksize (encoder, 0);
-        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+        FlacHelpers::configureEncoder (encoder, numChannels, bitsPerSample, sampleRate, qualityOptionIndex);
 
         ok = FLAC__stream_encoder_init_stream (encoder,
                                                encodeWriteCallback, encodeSeekCallback,
@@ -453,37 +935,8 @@ public:
         return output->write (data, (size_t) size);
     }
 
-    static void packUint32 (FlacNamespace::FLAC__uint32 val, FlacNamespace::FLAC__byte* b, const int bytes)
-    {
-        b += bytes;
-
-        for (int i = 0; i < bytes; ++i)
-        {
-            *(--b) = (FlacNamespace::FLAC__byte) (val & 0xff);
-            val >>= 8;
-        }
-    }
-
     void writeMetaData (const FlacNamespace::FLAC__StreamMetadata* metadata)
     {
-        using namespace FlacNamespace;
-        auto& info = metadata->data.stream_info;
-
-        unsigned char buffer[FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
-        const unsigned int channelsMinus1 = info.channels - 1;
-        const unsigned int bitsMinus1 = info.bits_per_sample - 1;
-
-        packUint32 (info.min_blocksize, buffer, 2);
-        packUint32 (info.max_blocksize, buffer + 2, 2);
-        packUint32 (info.min_framesize, buffer + 4, 3);
-        packUint32 (info.max_framesize, buffer + 7, 3);
-        buffer[10] = (uint8) ((info.sample_rate >> 12) & 0xff);
-        buffer[11] = (uint8) ((info.sample_rate >> 4) & 0xff);
-        buffer[12] = (uint8) (((info.sample_rate & 0x0f) << 4) | (channelsMinus1 << 1) | (bitsMinus1 >> 4));
-        buffer[13] = (FLAC__byte) (((bitsMinus1 & 0x0f) << 4) | (unsigned int) ((info.total_samples >> 32) & 0x0f));
-        packUint32 ((FLAC__uint32) info.total_samples, buffer + 14, 4);
-        memcpy (buffer + 18, info.md5sum, 16);
-
         const bool seekOk = output->setPosition (streamStartPos + 4);
         ignoreUnused (seekOk);
 
@@ -491,8 +944,7 @@ public:
         // to be able to seek back to write the header
         jassert (seekOk);
 
-        output->writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
-        output->write (buffer, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+        FlacHelpers::writeStreamInfo (*output, metadata->data.stream_info);
     }
 
     //==============================================================================
@@ -537,6 +989,358 @@ private:
 };
 
 
+//==============================================================================
+/*  Splits the audio into chunks which are encoded on a thread pool, and then
+    joins their frames back together in order.
+
+    Each chunk is encoded by its own libFLAC encoder, so its frames have to be
+    renumbered as they're collected. A seek point is written for each chunk
+    boundary, which is what lets FlacReader decode the file in parallel too.
+*/
+class ParallelFlacWriter  : public AudioFormatWriter
+{
+public:
+    ParallelFlacWriter (OutputStream* out, double rate, uint32 numChans, uint32 bits,
+                        int qualityOptionIndex, int numThreadsToUse)
+        : AudioFormatWriter (out, flacFormatName, rate, numChans, bits),
+          quality (qualityOptionIndex),
+          maxChunksInFlight (numThreadsToUse),
+          streamStartPos (output != nullptr ? jmax (output->getPosition(), 0ll) : 0ll)
+    {
+        using namespace FlacNamespace;
+
+        if (output == nullptr
+             || numChannels == 0 || numChannels > FLAC__MAX_CHANNELS
+             || ! FLAC__format_sample_rate_is_valid ((unsigned int) sampleRate))
+            return;
+
+        // use the same block size that the encoder would pick for this quality setting
+        auto* encoder = FLAC__stream_encoder_new();
+        FlacHelpers::configureEncoder (encoder, numChannels, bitsPerSample, sampleRate, quality);
+        blockSize = FLAC__stream_encoder_get_max_lpc_order (encoder) == 0 ? 1152 : 4096;
+        FLAC__stream_encoder_delete (encoder);
+
+        samplesPerChunk = blockSize * framesPerChunk;
+
+        output->write ("fLaC", 4);
+        output->writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+        output->writeRepeatedByte (0, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+
+        seekTablePos = output->getPosition();
+        output->writeIntBigEndian ((int) (0x83000000 | (uint32) (maxSeekPoints * FLAC__STREAM_METADATA_SEEKPOINT_LENGTH)));
+
+        for (int i = 0; i < maxSeekPoints; ++i)
+            writeSeekPoint (FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER, 0, 0);
+
+        firstFramePos = output->getPosition();
+        ok = firstFramePos == seekTablePos + 4 + maxSeekPoints * FLAC__STREAM_METADATA_SEEKPOINT_LENGTH;
+        initialisedOk = ok;
+
+       #if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+        FLAC__MD5Init (&md5);
+       #endif
+    }
+
+    ~ParallelFlacWriter() override
+    {
+        if (ok && currentChunk != nullptr && currentChunk->numSamples > 0)
+            submitChunk();
+
+        while (! chunksInFlight.isEmpty())
+            collectOldestChunk();
+
+        if (! initialisedOk)
+        {
+            output = nullptr; // to stop the base class deleting this, as it needs to be returned
+                              // to the caller of createWriter()
+        }
+        else if (ok)
+        {
+            writeHeaders();
+            output->flush();
+        }
+
+        // If writing failed part-way through, the headers are left empty, but we
+        // own the stream by now, so the base class deletes it.
+    }
+
+    //==============================================================================
+    bool write (const int** samplesToWrite, int numSamples) override
+    {
+        if (! ok)
+            return false;
+
+        const auto bitsToShift = 32 - (int) bitsPerSample;
+
+        for (int pos = 0; pos < numSamples;)
+        {
+            if (currentChunk == nullptr)
+                currentChunk.reset (getFreeChunk());
+
+            auto& chunk = *currentChunk;
+            const auto numToCopy = jmin (numSamples - pos, samplesPerChunk - chunk.numSamples);
+
+            for (unsigned int i = 0; i < numChannels; ++i)
+            {
+                auto* dest = chunk.getChannel (i) + chunk.numSamples;
+
+                if (auto* src = samplesToWrite[i])
+                {
+                    for (int j = 0; j < numToCopy; ++j)
+                        dest[j] = src[pos + j] >> bitsToShift;
+                }
+                else
+                {
+                    zeromem (dest, (size_t) numToCopy * sizeof (FlacNamespace::FLAC__int32));
+                }
+            }
+
+            chunk.numSamples += numToCopy;
+            pos += numToCopy;
+
+            if (chunk.numSamples == samplesPerChunk)
+                submitChunk();
+
+            if (! ok)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool ok = false;
+
+private:
+    //==============================================================================
+    enum
+    {
+        framesPerChunk = 64,
+        maxSeekPoints = 512
+    };
+
+    struct Chunk
+    {
+        FlacNamespace::FLAC__int32* getChannel (unsigned int channel) noexcept   { return samples + channel * (size_t) numSamplesAllocated; }
+
+        HeapBlock<FlacNamespace::FLAC__int32> samples;
+        int numSamplesAllocated = 0, numSamples = 0;
+        uint32 firstFrameNumber = 0, numFramesWritten = 0;
+        uint32 minFrameSize = 0, maxFrameSize = 0;
+        MemoryOutputStream encoded;
+        bool encodedOk = false;
+        WaitableEvent finished;
+    };
+
+    struct Settings
+    {
+        unsigned int numChannels, bitsPerSample;
+        double sampleRate;
+        int quality, blockSize;
+    };
+
+    Chunk* getFreeChunk()
+    {
+        auto* chunk = freeChunks.removeAndReturn (freeChunks.size() - 1);
+
+        if (chunk == nullptr)
+        {
+            chunk = new Chunk();
+            chunk->numSamplesAllocated = samplesPerChunk;
+            chunk->samples.malloc (numChannels * (size_t) samplesPerChunk);
+        }
+
+        chunk->numSamples = 0;
+        return chunk;
+    }
+
+    void submitChunk()
+    {
+        auto* chunk = currentChunk.release();
+
+        chunk->firstFrameNumber = numFramesSubmitted;
+        chunk->numFramesWritten = 0;
+        chunk->encoded.reset();
+        chunk->finished.reset();
+        numFramesSubmitted += (uint32) ((chunk->numSamples + blockSize - 1) / blockSize);
+
+        const Settings settings { numChannels, bitsPerSample, sampleRate, quality, blockSize };
+
+        threadPool->addJob ([chunk, settings]
+        {
+            chunk->encodedOk = encodeChunk (*chunk, settings);
+            chunk->finished.signal();
+        });
+
+        chunksInFlight.add (chunk);
+
+        while (chunksInFlight.size() > maxChunksInFlight)
+            collectOldestChunk();
+    }
+
+    void collectOldestChunk()
+    {
+        std::unique_ptr<Chunk> chunk (chunksInFlight.removeAndReturn (0));
+        chunk->finished.wait();
+
+        if (ok)
+        {
+            if (chunk->encodedOk && chunk->numFramesWritten > 0)
+            {
+                seekPointOffsets.add (output->getPosition() - firstFramePos);
+                ok = output->write (chunk->encoded.getData(), chunk->encoded.getDataSize());
+
+                const auto firstChunk = totalSamples == 0;
+                minFrameSize = firstChunk ? chunk->minFrameSize : jmin (minFrameSize, chunk->minFrameSize);
+                maxFrameSize = jmax (maxFrameSize, chunk->maxFrameSize);
+                totalSamples += (uint64) chunk->numSamples;
+
+               #if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+                HeapBlock<const FlacNamespace::FLAC__int32*> channels (numChannels);
+
+                for (unsigned int i = 0; i < numChannels; ++i)
+                    channels[i] = chunk->getChannel (i);
+
+                FLAC__MD5Accumulate (&md5, channels, numChannels, (unsigned int) chunk->numSamples, (bitsPerSample + 7) / 8);
+               #endif
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+
+        freeChunks.add (chunk.release());
+    }
+
+    static bool encodeChunk (Chunk& chunk, const Settings& settings)
+    {
+        using namespace FlacNamespace;
+
+        auto* encoder = FLAC__stream_encoder_new();
+        FlacHelpers::configureEncoder (encoder, settings.numChannels, settings.bitsPerSample, settings.sampleRate, settings.quality);
+        FLAC__stream_encoder_set_blocksize (encoder, (unsigned int) settings.blockSize);
+        FLAC__stream_encoder_set_do_md5 (encoder, false);
+
+        auto encodedOk = FLAC__stream_encoder_init_stream (encoder, encodeWriteCallback, nullptr, nullptr, nullptr, &chunk)
+                            == FLAC__STREAM_ENCODER_INIT_STATUS_OK;
+
+        if (encodedOk)
+        {
+            HeapBlock<const FLAC__int32*> channels (settings.numChannels);
+
+            for (unsigned int i = 0; i < settings.numChannels; ++i)
+                channels[i] = chunk.getChannel (i);
+
+            encodedOk = FLAC__stream_encoder_process (encoder, channels, (unsigned int) chunk.numSamples) != 0;
+            encodedOk = FLAC__stream_encoder_finish (encoder) != 0 && encodedOk;
+        }
+
+        FLAC__stream_encoder_delete (encoder);
+        return encodedOk;
+    }
+
+    static FlacNamespace::FLAC__StreamEncoderWriteStatus encodeWriteCallback (const FlacNamespace::FLAC__StreamEncoder*,
+                                                                              const FlacNamespace::FLAC__byte buffer[],
+                                                                              size_t bytes,
+                                                                              unsigned int samples,
+                                                                              unsigned int /*current_frame*/,
+                                                                              void* client_data)
+    {
+        // the stream header and metadata are written with a sample count of zero, and
+        // aren't needed, as the writer has already written its own
+        if (samples == 0)
+            return FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+
+        auto& chunk = *static_cast<Chunk*> (client_data);
+        const auto frameSize = (uint32) FlacHelpers::writeRenumberedFrame (buffer, bytes,
+                                                                           chunk.firstFrameNumber + chunk.numFramesWritten,
+                                                                           chunk.encoded);
+        if (frameSize == 0)
+            return FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+
+        chunk.minFrameSize = chunk.numFramesWritten == 0 ? frameSize : jmin (chunk.minFrameSize, frameSize);
+        chunk.maxFrameSize = jmax (chunk.maxFrameSize, frameSize);
+        ++chunk.numFramesWritten;
+
+        return FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+    }
+
+    //==============================================================================
+    void writeSeekPoint (uint64 sampleNumber, uint64 byteOffset, int numFrameSamples)
+    {
+        output->writeInt64BigEndian ((int64) sampleNumber);
+        output->writeInt64BigEndian ((int64) byteOffset);
+        output->writeShortBigEndian ((short) numFrameSamples);
+    }
+
+    void writeHeaders()
+    {
+        using namespace FlacNamespace;
+
+        const auto endPos = output->getPosition();
+
+        FLAC__StreamMetadata_StreamInfo info;
+        zerostruct (info);
+        info.min_blocksize = info.max_blocksize = (unsigned int) blockSize;
+        info.min_framesize = minFrameSize;
+        info.max_framesize = maxFrameSize;
+        info.sample_rate = (unsigned int) sampleRate;
+        info.channels = numChannels;
+        info.bits_per_sample = bitsPerSample;
+        info.total_samples = totalSamples;
+
+       #if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+        FLAC__MD5Final (info.md5sum, &md5);
+       #endif
+
+        const bool seekOk = output->setPosition (streamStartPos + 4);
+        ignoreUnused (seekOk);
+
+        // if this fails, you've given it an output stream that can't seek! It needs
+        // to be able to seek back to write the header
+        jassert (seekOk);
+
+        FlacHelpers::writeStreamInfo (*output, info);
+
+        // if there are more chunks than seek points, spread the points evenly
+        output->setPosition (seekTablePos + 4);
+        const auto numPoints = jmin ((int) maxSeekPoints, seekPointOffsets.size());
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto chunkIndex = (int) ((int64) i * seekPointOffsets.size() / numPoints);
+            const auto sampleNumber = (uint64) chunkIndex * (uint64) samplesPerChunk;
+
+            writeSeekPoint (sampleNumber, (uint64) seekPointOffsets.getUnchecked (chunkIndex),
+                            (int) jmin ((uint64) blockSize, totalSamples - sampleNumber));
+        }
+
+        output->setPosition (endPos);
+    }
+
+    //==============================================================================
+    const int quality, maxChunksInFlight;
+    int blockSize = 0, samplesPerChunk = 0;
+    int64 streamStartPos, seekTablePos = 0, firstFramePos = 0;
+
+    SharedResourcePointer<FlacHelpers::SharedThreadPool> threadPool;
+    std::unique_ptr<Chunk> currentChunk;
+    Array<Chunk*> chunksInFlight;
+    OwnedArray<Chunk> freeChunks;
+    Array<int64> seekPointOffsets;
+
+    uint32 numFramesSubmitted = 0, minFrameSize = 0, maxFrameSize = 0;
+    uint64 totalSamples = 0;
+    bool initialisedOk = false;
+
+   #if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+    FlacNamespace::FLAC__MD5Context md5;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelFlacWriter)
+};
+
+
 //==============================================================================
 FlacAudioFormat::FlacAudioFormat()  : AudioFormat (flacFormatName, ".flac") {}
 FlacAudioFormat::~FlacAudioFormat() {}
@@ -558,7 +1362,7 @@ bool FlacAudioFormat::isCompressed()    { return true; }
 
 AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails)
 {
-    std::unique_ptr<FlacReader> r (new FlacReader (in));
+    std::unique_ptr<FlacReader> r (new FlacReader (in, numThreads));
 
     if (r->sampleRate > 0)
         return r.release();
@@ -578,20 +1382,170 @@ AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
 {
     if (out != nullptr && getPossibleBitDepths().contains (bitsPerSample))
     {
-        std::unique_ptr<FlacWriter> w (new FlacWriter (out, sampleRate, numberOfChannels,
-                                                     (uint32) bitsPerSample, qualityOptionIndex));
-        if (w->ok)
-            return w.release();
+        if (numThreads > 1)
+        {
+            std::unique_ptr<ParallelFlacWriter> w (new ParallelFlacWriter (out, sampleRate, numberOfChannels,
+                                                                         (uint32) bitsPerSample, qualityOptionIndex, numThreads));
+            if (w->ok)
+                return w.release();
+        }
+        else
+        {
+            std::unique_ptr<FlacWriter> w (new FlacWriter (out, sampleRate, numberOfChannels,
+                                                         (uint32) bitsPerSample, qualityOptionIndex));
+            if (w->ok)
+                return w.release();
+        }
     }
 
     return nullptr;
 }
 
+void FlacAudioFormat::setNumThreads (int numThreadsToUse) noexcept
+{
+    numThreads = jmax (1, numThreadsToUse);
+}
+
 StringArray FlacAudioFormat::getQualityOptions()
 {
     return { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)" };
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct FlacAudioFormatTests  : public UnitTest
+{
+    FlacAudioFormatTests()
+        : UnitTest ("FLAC audio format tests", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        constexpr int numChannels = 2, numSamples = 700000;
+
+        AudioBuffer<int> source (numChannels, numSamples);
+        Random random (0x1234);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto tone = std::sin ((double) i * 0.01) * 4000000.0;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                source.setSample (ch, i, (roundToInt (tone) + random.nextInt (2000) - 1000) * 256);
+        }
+
+        beginTest ("Parallel encoding matches the source");
+        {
+            auto data = writeFile (source, 4);
+            expectBuffersMatch (readFile (data, 1), source);
+        }
+
+        beginTest ("Parallel decoding matches serial decoding");
+        {
+            auto data = writeFile (source, 4);
+            expectBuffersMatch (readFile (data, 4), source);
+            expectBuffersMatch (readFile (data, 3, 123457, 400000), readFile (data, 1, 123457, 400000));
+            expectBuffersMatch (readFile (data, 3, numSamples - 200000, 300000), readFile (data, 1, numSamples - 200000, 300000));
+        }
+
+        beginTest ("Parallel readers can read files without seek tables");
+        {
+            auto data = writeFile (source, 1);
+            expectBuffersMatch (readFile (data, 4), source);
+        }
+
+        beginTest ("Parallel writers delete their stream if writing fails");
+        {
+            bool streamDeleted = false;
+
+            FlacAudioFormat format;
+            format.setNumThreads (4);
+
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new FailingOutputStream (10000, streamDeleted),
+                                                                               44100.0, (unsigned int) numChannels, 24, {}, 0));
+            expect (writer != nullptr);
+
+            const int* channels[] = { source.getReadPointer (0), source.getReadPointer (1), nullptr };
+            bool writtenOk = true;
+
+            for (int pos = 0; pos < numSamples && writtenOk; pos += 100000)
+                writtenOk = writer->write (channels, 100000);
+
+            expect (! writtenOk);
+
+            writer.reset();
+            expect (streamDeleted);
+        }
+    }
+
+    // Accepts a limited number of bytes, and then fails every write
+    struct FailingOutputStream  : public MemoryOutputStream
+    {
+        FailingOutputStream (size_t maxSize, bool& deletedFlag)  : maxBytes (maxSize), deleted (deletedFlag) {}
+        ~FailingOutputStream() override     { deleted = true; }
+
+        bool write (const void* buffer, size_t numBytes) override
+        {
+            return getDataSize() + numBytes <= maxBytes && MemoryOutputStream::write (buffer, numBytes);
+        }
+
+        const size_t maxBytes;
+        bool& deleted;
+    };
+
+    static MemoryBlock writeFile (const AudioBuffer<int>& source, int numThreads)
+    {
+        FlacAudioFormat format;
+        format.setNumThreads (numThreads);
+
+        MemoryBlock data;
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false),
+                                                                           44100.0, (unsigned int) source.getNumChannels(),
+                                                                           24, {}, 0));
+
+        // write in uneven blocks, so that they don't line up with the encoder's chunks
+        for (int pos = 0; pos < source.getNumSamples();)
+        {
+            const auto numToWrite = jmin (source.getNumSamples() - pos, 10007);
+            const int* channels[] = { source.getReadPointer (0, pos), source.getReadPointer (1, pos), nullptr };
+            writer->write (channels, numToWrite);
+            pos += numToWrite;
+        }
+
+        writer.reset();
+        return data;
+    }
+
+    static AudioBuffer<int> readFile (const MemoryBlock& data, int numThreads, int64 start = 0, int numSamples = -1)
+    {
+        FlacAudioFormat format;
+        format.setNumThreads (numThreads);
+
+        std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (data, false), true));
+
+        if (numSamples < 0)
+            numSamples = (int) reader->lengthInSamples;
+
+        AudioBuffer<int> result ((int) reader->numChannels, numSamples);
+        reader->read (result.getArrayOfWritePointers(), result.getNumChannels(), start, numSamples, false);
+        return result;
+    }
+
+    void expectBuffersMatch (const AudioBuffer<int>& a, const AudioBuffer<int>& b)
+    {
+        expect (a.getNumChannels() == b.getNumChannels() && a.getNumSamples() == b.getNumSamples());
+
+        for (int ch = 0; ch < jmin (a.getNumChannels(), b.getNumChannels()); ++ch)
+            expect (std::equal (a.getReadPointer (ch), a.getReadPointer (ch) + jmin (a.getNumSamples(), b.getNumSamples()),
+                                b.getReadPointer (ch)));
+    }
+};
+
+static FlacAudioFormatTests flacAudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
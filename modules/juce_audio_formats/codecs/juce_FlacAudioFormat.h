@@ -65,7 +65,26 @@ public:
                                         int qualityOptionIndex) override;
     using AudioFormat::createWriterFor;
 
+    //==============================================================================
+    /** Sets the number of threads that readers and writers created by this format may use.
+
+        With more than one thread, writers encode blocks of frames in parallel and add
+        a seek table to the file, and readers use a file's seek table to decode large
+        reads in parallel. Files that are written this way can be read by any FLAC decoder.
+
+        The default is 1, which encodes and decodes everything on the calling thread.
+        This only affects readers and writers that are created after it's called.
+    */
+    void setNumThreads (int numThreadsToUse) noexcept;
+
+    /** Returns the number of threads that readers and writers will use.
+        @see setNumThreads
+    */
+    int getNumThreads() const noexcept          { return numThreads; }
+
 private:
+    int numThreads = 1;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacAudioFormat)
 };
 
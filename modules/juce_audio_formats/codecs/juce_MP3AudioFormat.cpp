@@ -1558,7 +1558,7 @@ struct MP3Stream
     {
         frameIndex = jmax (0, frameIndex);
 
-        while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
+        while (! indexIsComplete && frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
         {
             int dummy = 0;
             auto result = decodeNextBlock (nullptr, nullptr, dummy);
@@ -1570,6 +1570,9 @@ struct MP3Stream
                 break;
         }
 
+        if (frameStreamPositions.isEmpty())
+            return false;
+
         frameIndex = jmin (frameIndex & ~(storedStartPosInterval - 1),
                            (frameStreamPositions.size() - 1) * storedStartPosInterval);
 
@@ -1579,10 +1582,48 @@ struct MP3Stream
         return true;
     }
 
+    /*  Finds the positions of all the remaining frames, so that seek() never needs to
+        scan forwards. Returns false if the scan stopped before the end of the stream.
+    */
+    bool buildIndex()
+    {
+        for (;;)
+        {
+            int dummy = 0;
+
+            if (decodeNextBlock (nullptr, nullptr, dummy) < 0)
+                break;
+        }
+
+        indexIsComplete = reachedEndOfStream;
+        numFramesInIndex = currentFrameIndex;
+        return indexIsComplete;
+    }
+
+    /*  Replaces the index with the frame positions of a complete scan, which must have
+        been made from the same position in the same stream.
+    */
+    void setIndex (const Array<int64>& positions, int numFramesInStream)
+    {
+        frameStreamPositions = positions;
+        numFramesInIndex = numFramesInStream;
+        indexIsComplete = true;
+    }
+
+    const Array<int64>& getIndexPositions() const noexcept      { return frameStreamPositions; }
+    int getNumFramesInIndex() const noexcept                    { return numFramesInIndex; }
+    bool isIndexComplete() const noexcept                       { return indexIsComplete; }
+
+    int getSamplesPerFrame() const noexcept
+    {
+        return frame.layer == 1 ? 384 : (frame.layer == 3 && frame.lsf != 0 ? 576 : 1152);
+    }
+
     MP3Frame frame;
     VBRTagData vbrTagData;
     BufferedInputStream stream;
     int numFrames = 0, currentFrameIndex = 0;
+    int firstAudioFrameIndex = 0; // 1 if the first frame holds a VBR header rather than audio
     bool vbrHeaderFound = false;
 
 private:
@@ -1620,6 +1661,8 @@ private:
 
     enum { storedStartPosInterval = 4 };
     Array<int64> frameStreamPositions;
+    int numFramesInIndex = 0;
+    bool indexIsComplete = false, reachedEndOfStream = false;
 
     struct SideInfoLayer1
     {
@@ -1704,6 +1747,7 @@ private:
         {
             if (stream.isExhausted() || stream.getPosition() > oldPos + 32768)
             {
+                reachedEndOfStream = stream.isExhausted();
                 offset = -1;
                 break;
             }
@@ -1752,6 +1796,7 @@ private:
         if (vbrHeaderFound)
         {
             numFrames = (int) vbrTagData.frames;
+            firstAudioFrameIndex = currentFrameIndex;
             oldPos += jmax (vbrTagData.headersize, 1);
         }
 
@@ -2953,11 +2998,124 @@ private:
 //==============================================================================
 static const char* const mp3FormatName = "MP3 file";
 
+//==============================================================================
+/*  Reads and writes the files in which seek indexes are cached.
+
+    An index is only used if the MP3 file's size, modification time and a hash of
+    its first and last few kilobytes all match the values stored with the index.
+*/
+struct MP3SeekIndexFile
+{
+    static bool load (const File& indexFile, const File& audioFile, int64 streamStartPos,
+                      Array<int64>& positions, int& numFramesInStream)
+    {
+        FileInputStream in (indexFile);
+
+        if (in.failedToOpen()
+             || in.readInt() != magicNumber
+             || in.readInt64() != audioFile.getSize()
+             || in.readInt64() != audioFile.getLastModificationTime().toMilliseconds()
+             || in.readInt64() != getContentHash (audioFile)
+             || in.readInt64() != streamStartPos)
+            return false;
+
+        numFramesInStream = in.readInt();
+        const auto numPositions = in.readInt();
+
+        if (numFramesInStream <= 0 || numPositions <= 0 || numPositions > numFramesInStream)
+            return false;
+
+        positions.ensureStorageAllocated (numPositions);
+        auto position = in.readInt64();
+        positions.add (position);
+
+        for (int i = 1; i < numPositions; ++i)
+        {
+            const auto delta = in.readCompressedInt();
+
+            if (delta <= 0)
+                return false;
+
+            position += delta;
+            positions.add (position);
+        }
+
+        return in.getPosition() == in.getTotalLength();
+    }
+
+    static void save (const File& indexFile, const File& audioFile, int64 streamStartPos,
+                      const Array<int64>& positions, int numFramesInStream)
+    {
+        if (positions.isEmpty())
+            return;
+
+        TemporaryFile temp (indexFile);
+
+        {
+            FileOutputStream out (temp.getFile());
+
+            if (out.failedToOpen())
+                return;
+
+            out.writeInt (magicNumber);
+            out.writeInt64 (audioFile.getSize());
+            out.writeInt64 (audioFile.getLastModificationTime().toMilliseconds());
+            out.writeInt64 (getContentHash (audioFile));
+            out.writeInt64 (streamStartPos);
+            out.writeInt (numFramesInStream);
+            out.writeInt (positions.size());
+            out.writeInt64 (positions.getFirst());
+
+            for (int i = 1; i < positions.size(); ++i)
+                out.writeCompressedInt ((int) (positions.getUnchecked (i) - positions.getUnchecked (i - 1)));
+
+            out.flush();
+
+            if (out.getStatus().failed())
+                return;
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    static int64 getContentHash (const File& audioFile)
+    {
+        FileInputStream in (audioFile);
+        auto hash = (uint64) 0xcbf29ce484222325ULL;
+
+        if (in.failedToOpen())
+            return 0;
+
+        HeapBlock<uint8> buffer (bytesToHash);
+
+        const auto addToHash = [&]
+        {
+            const auto numRead = in.read (buffer, bytesToHash);
+
+            for (int i = 0; i < numRead; ++i)
+                hash = (hash ^ buffer[i]) * 0x100000001b3ULL;
+        };
+
+        addToHash();
+        in.setPosition (jmax ((int64) bytesToHash, in.getTotalLength() - bytesToHash));
+        addToHash();
+
+        return (int64) hash;
+    }
+
+    enum
+    {
+        magicNumber = 0x78335031, // "1P3x", which also acts as a version number
+        bytesToHash = 65536
+    };
+};
+
 //==============================================================================
 class MP3Reader : public AudioFormatReader
 {
 public:
-    MP3Reader (InputStream* const in)
+    MP3Reader (InputStream* const in, bool shouldIndexWhenOpened = false,
+               const File& audioFile = {}, const File& indexFile = {})
         : AudioFormatReader (in, mp3FormatName),
           stream (*in), currentPosition (0),
           decodedStart (0), decodedEnd (0)
@@ -2971,7 +3129,11 @@ public:
             usesFloatingPointData = true;
             sampleRate = stream.frame.getFrequency();
             numChannels = (unsigned int) stream.frame.numChannels;
+            samplesPerFrame = stream.getSamplesPerFrame();
             lengthInSamples = findLength (streamPos);
+
+            if (shouldIndexWhenOpened)
+                loadOrBuildIndex (streamPos, audioFile, indexFile);
         }
     }
 
@@ -2986,37 +3148,13 @@ public:
 
         if (currentPosition != startSampleInFile)
         {
-            if (! stream.seek ((int) (startSampleInFile / 1152 - 1)))
+            if (! seekToSample (startSampleInFile))
             {
                 currentPosition = -1;
                 createEmptyDecodedData();
             }
             else
             {
-                decodedStart = decodedEnd = 0;
-                const int64 streamPos = stream.currentFrameIndex * 1152;
-                int toSkip = (int) (startSampleInFile - streamPos);
-                jassert (toSkip >= 0);
-
-                while (toSkip > 0)
-                {
-                    if (! readNextBlock())
-                    {
-                        createEmptyDecodedData();
-                        break;
-                    }
-
-                    const int numReady = decodedEnd - decodedStart;
-
-                    if (numReady > toSkip)
-                    {
-                        decodedStart += toSkip;
-                        break;
-                    }
-
-                    toSkip -= numReady;
-                }
-
                 currentPosition = startSampleInFile;
             }
         }
@@ -3048,12 +3186,48 @@ public:
         return true;
     }
 
+    bool hasCompleteIndex() const noexcept      { return stream.isIndexComplete(); }
+
 private:
     MP3Stream stream;
     int64 currentPosition;
     enum { decodedDataSize = 1152 };
     float decoded0[decodedDataSize], decoded1[decodedDataSize];
     int decodedStart, decodedEnd;
+    int samplesPerFrame = 1152;
+
+    bool seekToSample (int64 sample)
+    {
+        // Start some frames early, because after a seek the decoder can't produce the first
+        // frames properly until its bit reservoir and overlap buffers have been refilled. The
+        // reservoir can reach back 511 bytes, which in a VBR file could be several quiet frames.
+        // The frames are identified by their index rather than by counting decoded samples,
+        // as the frames which couldn't be decoded don't produce any samples.
+        const auto targetFrame = stream.firstAudioFrameIndex + (int) (sample / samplesPerFrame);
+
+        if (! stream.seek (targetFrame - numPrimingFrames))
+            return false;
+
+        for (int lastFrameIndex = -1;;)
+        {
+            if (! readNextBlock() || stream.currentFrameIndex == lastFrameIndex)
+            {
+                createEmptyDecodedData();
+                return true;
+            }
+
+            lastFrameIndex = stream.currentFrameIndex;
+            const auto frameStart = (int64) (lastFrameIndex - 1 - stream.firstAudioFrameIndex) * samplesPerFrame;
+
+            if (frameStart + decodedEnd > sample)
+            {
+                decodedStart = (int) jlimit ((int64) 0, (int64) decodedEnd, sample - frameStart);
+                return true;
+            }
+        }
+    }
+
+    enum { numPrimingFrames = 10 };
 
     void createEmptyDecodedData() noexcept
     {
@@ -3132,7 +3306,40 @@ private:
             }
         }
 
-        return numFrames * 1152;
+        return numFrames * samplesPerFrame;
+    }
+
+    //==============================================================================
+    void loadOrBuildIndex (int64 streamStartPos, const File& audioFile, const File& indexFile)
+    {
+        if (indexFile != File())
+        {
+            Array<int64> positions;
+            int numFramesInStream = 0;
+
+            if (MP3SeekIndexFile::load (indexFile, audioFile, streamStartPos, positions, numFramesInStream))
+            {
+                stream.setIndex (positions, numFramesInStream);
+                useIndexForLength();
+                return;
+            }
+        }
+
+        if (stream.buildIndex())
+        {
+            useIndexForLength();
+
+            if (indexFile != File())
+                MP3SeekIndexFile::save (indexFile, audioFile, streamStartPos, stream.getIndexPositions(), stream.getNumFramesInIndex());
+        }
+
+        // the stream has been left at the end, so the next read will need to seek
+        currentPosition = -1;
+    }
+
+    void useIndexForLength()
+    {
+        lengthInSamples = (int64) (stream.getNumFramesInIndex() - stream.firstAudioFrameIndex) * samplesPerFrame;
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MP3Reader)
@@ -3153,7 +3360,21 @@ StringArray MP3AudioFormat::getQualityOptions()     { return {}; }
 
 AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, const bool deleteStreamIfOpeningFails)
 {
-    std::unique_ptr<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream));
+    File audioFile, indexFile;
+
+    if (seekIndexMode == SeekIndexMode::cacheAlongsideFile || seekIndexMode == SeekIndexMode::cacheInDirectory)
+    {
+        if (auto* fileStream = dynamic_cast<FileInputStream*> (sourceStream))
+            audioFile = fileStream->getFile();
+        else if (auto* mappedStream = dynamic_cast<MemoryMappedFileInputStream*> (sourceStream))
+            audioFile = mappedStream->getFile();
+
+        if (audioFile != File())
+            indexFile = getSeekIndexFile (audioFile);
+    }
+
+    std::unique_ptr<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream, seekIndexMode != SeekIndexMode::scanWhenNeeded,
+                                                                         audioFile, indexFile));
 
     if (r->lengthInSamples > 0)
         return r.release();
@@ -3164,6 +3385,84 @@ AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, c
     return nullptr;
 }
 
+void MP3AudioFormat::setSeekIndexMode (SeekIndexMode newMode, const File& cacheDirectory)
+{
+    seekIndexMode = newMode;
+    seekIndexDirectory = cacheDirectory;
+
+    // To keep the indexes in a directory, you need to say which directory!
+    jassert (seekIndexMode != SeekIndexMode::cacheInDirectory || seekIndexDirectory != File());
+}
+
+File MP3AudioFormat::getSeekIndexFile (const File& mp3File) const
+{
+    if (seekIndexMode == SeekIndexMode::cacheAlongsideFile)
+        return mp3File.getSiblingFile (mp3File.getFileName() + ".seekindex");
+
+    if (seekIndexMode == SeekIndexMode::cacheInDirectory && seekIndexDirectory != File())
+        return seekIndexDirectory.getChildFile (String::toHexString (mp3File.getFullPathName().hashCode64()) + ".seekindex");
+
+    return {};
+}
+
+int MP3AudioFormat::buildSeekIndexes (const Array<File>& files, int numThreads)
+{
+    // Indexes can only be kept if they're being cached in files
+    jassert (seekIndexMode == SeekIndexMode::cacheAlongsideFile || seekIndexMode == SeekIndexMode::cacheInDirectory);
+
+    std::atomic<int> nextFile { 0 }, numIndexed { 0 };
+
+    const auto indexFiles = [&]
+    {
+        for (int i = nextFile++; i < files.size(); i = nextFile++)
+        {
+            auto& file = files.getReference (i);
+            std::unique_ptr<InputStream> in (new MemoryMappedFileInputStream (file));
+
+            if (static_cast<MemoryMappedFileInputStream*> (in.get())->failedToOpen())
+                in = file.createInputStream();
+
+            if (in != nullptr)
+            {
+                std::unique_ptr<AudioFormatReader> reader (createReaderFor (in.release(), true));
+
+                if (auto* mp3Reader = dynamic_cast<MP3Decoder::MP3Reader*> (reader.get()))
+                    if (mp3Reader->hasCompleteIndex())
+                        ++numIndexed;
+            }
+        }
+    };
+
+    const auto numHelperThreads = jmin (numThreads, files.size()) - 1;
+
+    if (numHelperThreads > 0)
+    {
+        ThreadPool pool (numHelperThreads);
+        std::atomic<int> numRunning { numHelperThreads };
+        WaitableEvent allFinished;
+
+        for (int i = 0; i < numHelperThreads; ++i)
+        {
+            pool.addJob ([&]
+            {
+                indexFiles();
+
+                if (--numRunning == 0)
+                    allFinished.signal();
+            });
+        }
+
+        indexFiles();
+        allFinished.wait();
+    }
+    else
+    {
+        indexFiles();
+    }
+
+    return numIndexed;
+}
+
 AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*sampleRateToUse*/,
                                                     unsigned int /*numberOfChannels*/, int /*bitsPerSample*/,
                                                     const StringPairArray& /*metadataValues*/, int /*qualityOptionIndex*/)
@@ -3172,6 +3471,136 @@ AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*samp
     return nullptr;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MP3AudioFormatTests  : public UnitTest
+{
+    MP3AudioFormatTests()
+        : UnitTest ("MP3 audio format tests", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        constexpr int numFrames = 2000, samplesPerFrame = 384;
+
+        TemporaryFile mp3File (".mp3");
+        writeFrames (mp3File.getFile(), 0, numFrames);
+
+        beginTest ("Seeks are sample accurate");
+        {
+            MP3AudioFormat format;
+            auto reference = readAll (format, mp3File.getFile());
+            expectEquals (reference.getNumSamples(), numFrames * samplesPerFrame);
+            expect (reference.getMagnitude (0, reference.getNumSamples()) > 0.1f);
+
+            for (auto mode : { MP3AudioFormat::SeekIndexMode::scanWhenNeeded, MP3AudioFormat::SeekIndexMode::scanWhenOpened })
+            {
+                format.setSeekIndexMode (mode);
+                std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new FileInputStream (mp3File.getFile()), true));
+                expectEquals (reader->lengthInSamples, (int64) reference.getNumSamples());
+
+                AudioBuffer<float> section (1, 1000);
+                auto random = getRandom();
+
+                for (int i = 0; i < 50; ++i)
+                {
+                    const auto start = random.nextInt (reference.getNumSamples() - section.getNumSamples());
+                    reader->read (&section, 0, section.getNumSamples(), start, true, false);
+
+                    for (int j = 0; j < section.getNumSamples(); ++j)
+                        expectWithinAbsoluteError (section.getSample (0, j), reference.getSample (0, start + j), 1.0e-6f);
+                }
+            }
+        }
+
+        beginTest ("Seek indexes are cached alongside files");
+        {
+            MP3AudioFormat format;
+            format.setSeekIndexMode (MP3AudioFormat::SeekIndexMode::cacheAlongsideFile);
+            auto indexFile = format.getSeekIndexFile (mp3File.getFile());
+
+            expectEquals (readAll (format, mp3File.getFile()).getNumSamples(), numFrames * samplesPerFrame);
+            expect (indexFile.existsAsFile());
+            expectEquals (readAll (format, mp3File.getFile()).getNumSamples(), numFrames * samplesPerFrame);
+
+            // changing the file must make the cached index stale
+            writeFrames (mp3File.getFile(), numFrames, 100);
+            expectEquals (readAll (format, mp3File.getFile()).getNumSamples(), (numFrames + 100) * samplesPerFrame);
+
+            indexFile.deleteFile();
+        }
+
+        beginTest ("Seek indexes can be built in batches");
+        {
+            TemporaryFile directory;
+            directory.getFile().createDirectory();
+
+            OwnedArray<TemporaryFile> tempFiles;
+            Array<File> files;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                files.add (tempFiles.add (new TemporaryFile (".mp3"))->getFile());
+                writeFrames (files.getLast(), 0, 100 + i);
+            }
+
+            files.add (directory.getFile().getChildFile ("missing.mp3"));
+
+            MP3AudioFormat format;
+            format.setSeekIndexMode (MP3AudioFormat::SeekIndexMode::cacheInDirectory, directory.getFile());
+
+            expectEquals (format.buildSeekIndexes (files, 3), 4);
+            expectEquals (directory.getFile().getNumberOfChildFiles (File::findFiles), 4);
+
+            directory.getFile().deleteRecursively();
+        }
+    }
+
+    static AudioBuffer<float> readAll (MP3AudioFormat& format, const File& file)
+    {
+        std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new FileInputStream (file), true));
+        AudioBuffer<float> result (1, (int) reader->lengthInSamples);
+        reader->read (&result, 0, result.getNumSamples(), 0, true, false);
+        return result;
+    }
+
+    /*  Appends some mono MPEG-1 layer I frames to a file. Only the lowest sub-band has
+        any samples, and these change from frame to frame, so that a read from the wrong
+        position would return the wrong values.
+    */
+    static void writeFrames (const File& file, int firstFrame, int numFramesToWrite)
+    {
+        FileOutputStream out (file);
+
+        for (int frame = firstFrame; frame < firstFrame + numFramesToWrite; ++frame)
+        {
+            uint8 data[136] = { 0xff, 0xff, 0x40, 0xc0 };  // 128kbps, 44.1kHz, mono
+            int bitPosition = 32;
+
+            const auto writeBits = [&] (int value, int numBits)
+            {
+                for (int bit = numBits; --bit >= 0; ++bitPosition)
+                    if ((value >> bit) & 1)
+                        data[bitPosition >> 3] |= (uint8) (0x80 >> (bitPosition & 7));
+            };
+
+            writeBits (3, 4);                   // 4 bits per sample in the first sub-band..
+            bitPosition += 31 * 4;              // ..and none in the others
+            writeBits (8 + frame % 16, 6);      // scale factor
+
+            for (int i = 0; i < 12; ++i)
+                writeBits ((frame * 7 + i * 3) % 15, 4);
+
+            out.write (data, sizeof (data));
+        }
+    }
+};
+
+static MP3AudioFormatTests mp3AudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
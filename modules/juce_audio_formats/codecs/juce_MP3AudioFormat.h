@@ -66,6 +66,53 @@ public:
                                         unsigned int numberOfChannels, int bitsPerSample,
                                         const StringPairArray& metadataValues, int qualityOptionIndex) override;
     using AudioFormat::createWriterFor;
+
+    //==============================================================================
+    /** The ways in which readers can find the positions of the frames in a file.
+
+        To seek accurately, a reader needs to know where each frame starts, which for
+        variable bit-rate files means scanning through all the frames before the position
+        that's needed.
+    */
+    enum class SeekIndexMode
+    {
+        scanWhenNeeded,         /**< Frames are scanned when a read jumps beyond the part of the file that
+                                     has already been scanned. This makes opening a file quick, but the
+                                     first jump to a late position in a long file can be slow. */
+        scanWhenOpened,         /**< The whole file is scanned when the reader is created, so that all
+                                     seeks are quick. This also gives an exact length for files that
+                                     don't contain a VBR header. */
+        cacheAlongsideFile,     /**< Like scanWhenOpened, but the index is saved in a file next to the
+                                     MP3 file, and is reused the next time that the file is opened. This
+                                     only works for readers that are created with a FileInputStream. */
+        cacheInDirectory        /**< Like cacheAlongsideFile, but the index files are kept in the directory
+                                     that's passed to setSeekIndexMode(). */
+    };
+
+    /** Changes how readers created by this format find the positions of frames.
+        The default mode is SeekIndexMode::scanWhenNeeded.
+    */
+    void setSeekIndexMode (SeekIndexMode newMode, const File& cacheDirectory = {});
+
+    /** Returns the current seek index mode. */
+    SeekIndexMode getSeekIndexMode() const noexcept     { return seekIndexMode; }
+
+    /** Returns the file in which the index for an MP3 file would be cached, or an
+        empty File if indexes aren't being cached.
+    */
+    File getSeekIndexFile (const File& mp3File) const;
+
+    /** Builds and caches the seek indexes for a set of files, using several threads.
+
+        This is intended for importing large batches of files, so that they'll open
+        quickly later. It needs the mode to be set to one that caches indexes, and
+        returns the number of files which were successfully indexed.
+    */
+    int buildSeekIndexes (const Array<File>& mp3Files, int numThreads);
+
+private:
+    SeekIndexMode seekIndexMode = SeekIndexMode::scanWhenNeeded;
+    File seekIndexDirectory;
 };
 
 #endif
@@ -1680,6 +1680,8 @@ public:
 
     using AudioFormatReader::readMaxLevels;
 
+    bool canReadMaxLevelsQuickly() const override    { return true; }
+
 private:
     template <typename SampleType>
     void scanMinAndMax (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead) const noexcept
@@ -1958,6 +1960,19 @@ struct WaveAudioFormatTests : public UnitTest
             expect (a[WavAudioFormat::riffInfoSource] == "source");
             expect (a[WavAudioFormat::internationalStandardRecordingCode] == "UUVVVXXYYYYY");
         }
+        {
+            beginTest ("Only memory-mapped readers can read max levels quickly");
+            const auto mb = writeToBlock (format, {});
+
+            auto reader = rawToUniquePtr (format.createReaderFor (new MemoryInputStream (mb, false), true));
+            expect (reader != nullptr && ! reader->canReadMaxLevelsQuickly());
+
+            TemporaryFile tempFile (".wav");
+            expect (tempFile.getFile().replaceWithData (mb.getData(), mb.getSize()));
+
+            auto mappedReader = rawToUniquePtr (format.createMemoryMappedReader (tempFile.getFile()));
+            expect (mappedReader != nullptr && mappedReader->canReadMaxLevelsQuickly());
+        }
     }
 
 private:
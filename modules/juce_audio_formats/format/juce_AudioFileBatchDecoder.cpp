@@ -0,0 +1,434 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+bool AudioFileBatchDecoder::Listener::fileOpened (const File&, const AudioFormatReader&)
+{
+    return true;
+}
+
+//==============================================================================
+class AudioFileBatchDecoder::DecodeJob  : public ThreadPoolJob
+{
+public:
+    DecodeJob (AudioFileBatchDecoder& d, const File& f, Listener& l)
+        : ThreadPoolJob ("Decode " + f.getFileName()), decoder (d), file (f), listener (l)
+    {}
+
+    ~DecodeJob() override
+    {
+        // a job that was removed from the queue before it started still has to report back
+        if (! hasFinished)
+            finish (false);
+    }
+
+    JobStatus runJob() override
+    {
+        const auto openingStartTime = Time::getMillisecondCounterHiRes();
+        std::unique_ptr<AudioFormatReader> reader;
+
+        if (! shouldExit())
+            reader.reset (decoder.formatManager.createReaderFor (file));
+
+        stats.decodingSeconds = getSecondsSince (openingStartTime);
+
+        if (reader != nullptr)
+        {
+            stats.formatName = reader->getFormatName();
+
+            if (listener.fileOpened (file, *reader))
+                decode (*reader);
+        }
+
+        finish (succeeded);
+        return jobHasFinished;
+    }
+
+private:
+    void decode (AudioFormatReader& reader)
+    {
+        const auto numChannels = (int) reader.numChannels;
+        const auto blockSize = (int) jmin ((int64) decoder.options.samplesPerBlock, jmax ((int64) 1, reader.lengthInSamples));
+        const auto bufferBytes = (size_t) numChannels * (size_t) blockSize * sizeof (float);
+
+        if (! decoder.reserveMemory (bufferBytes, *this))
+            return;
+
+        // the time spent waiting for other jobs to release their memory isn't counted
+        const auto decodingStartTime = Time::getMillisecondCounterHiRes();
+
+        {
+            AudioBuffer<float> buffer (numChannels, blockSize);
+            succeeded = true;
+
+            for (int64 position = 0; position < reader.lengthInSamples; position += blockSize)
+            {
+                if (shouldExit())
+                {
+                    succeeded = false;
+                    break;
+                }
+
+                const auto numSamples = (int) jmin ((int64) blockSize, reader.lengthInSamples - position);
+
+                if (! reader.read (buffer.getArrayOfWritePointers(), numChannels, position, numSamples))
+                {
+                    succeeded = false;
+                    break;
+                }
+
+                listener.blockDecoded (file, AudioBuffer<float> (buffer.getArrayOfWritePointers(), numChannels, numSamples), position);
+                stats.numSamplesDecoded += numSamples;
+            }
+        }
+
+        stats.decodingSeconds += getSecondsSince (decodingStartTime);
+        decoder.releaseMemory (bufferBytes);
+    }
+
+    static double getSecondsSince (double startTimeMs) noexcept
+    {
+        return (Time::getMillisecondCounterHiRes() - startTimeMs) / 1000.0;
+    }
+
+    void finish (bool decodedSuccessfully)
+    {
+        hasFinished = true;
+
+        if (decodedSuccessfully)
+        {
+            stats.numFilesDecoded = 1;
+            stats.numBytesDecoded = file.getSize();
+        }
+        else
+        {
+            stats.numFailures = 1;
+        }
+
+        decoder.jobFinished (file, listener, stats, decodedSuccessfully);
+    }
+
+    AudioFileBatchDecoder& decoder;
+    const File file;
+    Listener& listener;
+    FormatStatistics stats;
+    bool succeeded = false, hasFinished = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodeJob)
+};
+
+//==============================================================================
+AudioFileBatchDecoder::AudioFileBatchDecoder (AudioFormatManager& fm, const Options& o)
+    : formatManager (fm), options (o), pool (jmax (1, o.numThreads))
+{
+    // A block has to contain at least one sample!
+    jassert (options.samplesPerBlock > 0);
+}
+
+AudioFileBatchDecoder::~AudioFileBatchDecoder()
+{
+    cancelAll();
+}
+
+void AudioFileBatchDecoder::addFile (const File& file, Listener& listener)
+{
+    ++numPendingFiles;
+    pool.addJob (new DecodeJob (*this, file, listener), true);
+}
+
+void AudioFileBatchDecoder::addFiles (const Array<File>& files, Listener& listener)
+{
+    for (auto& file : files)
+        addFile (file, listener);
+}
+
+bool AudioFileBatchDecoder::waitUntilFinished (int timeoutMilliseconds)
+{
+    const auto endTime = Time::getMillisecondCounter() + (uint32) timeoutMilliseconds;
+
+    while (numPendingFiles > 0)
+    {
+        auto timeToWait = 100;
+
+        if (timeoutMilliseconds >= 0)
+        {
+            const auto remaining = (int) (endTime - Time::getMillisecondCounter());
+
+            if (remaining <= 0)
+                return false;
+
+            timeToWait = jmin (timeToWait, remaining);
+        }
+
+        allFinished.wait (timeToWait);
+    }
+
+    return true;
+}
+
+void AudioFileBatchDecoder::cancelAll()
+{
+    pool.removeAllJobs (true, -1);
+}
+
+//==============================================================================
+bool AudioFileBatchDecoder::reserveMemory (size_t numBytes, ThreadPoolJob& job)
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (memoryLock);
+
+            if (memoryInUse == 0 || memoryInUse + numBytes <= options.maxMemoryBytes)
+            {
+                memoryInUse += numBytes;
+                return true;
+            }
+        }
+
+        if (job.shouldExit())
+            return false;
+
+        memoryReleased.wait (50);
+    }
+}
+
+void AudioFileBatchDecoder::releaseMemory (size_t numBytes)
+{
+    {
+        const ScopedLock sl (memoryLock);
+        memoryInUse -= numBytes;
+    }
+
+    memoryReleased.signal();
+}
+
+void AudioFileBatchDecoder::jobFinished (const File& file, Listener& listener,
+                                         const FormatStatistics& fileStats, bool decodedSuccessfully)
+{
+    {
+        const ScopedLock sl (statsLock);
+
+        auto* stats = [&]
+        {
+            for (auto& s : statistics)
+                if (s.formatName == fileStats.formatName)
+                    return &s;
+
+            statistics.add ({});
+            statistics.getReference (statistics.size() - 1).formatName = fileStats.formatName;
+            return &statistics.getReference (statistics.size() - 1);
+        }();
+
+        stats->numFilesDecoded   += fileStats.numFilesDecoded;
+        stats->numFailures       += fileStats.numFailures;
+        stats->numSamplesDecoded += fileStats.numSamplesDecoded;
+        stats->numBytesDecoded   += fileStats.numBytesDecoded;
+        stats->decodingSeconds   += fileStats.decodingSeconds;
+    }
+
+    listener.fileFinished (file, decodedSuccessfully);
+
+    if (--numPendingFiles == 0)
+        allFinished.signal();
+}
+
+Array<AudioFileBatchDecoder::FormatStatistics> AudioFileBatchDecoder::getStatistics() const
+{
+    const ScopedLock sl (statsLock);
+    return statistics;
+}
+
+void AudioFileBatchDecoder::resetStatistics()
+{
+    const ScopedLock sl (statsLock);
+    statistics.clear();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioFileBatchDecoderTests  : public UnitTest
+{
+    AudioFileBatchDecoderTests()
+        : UnitTest ("AudioFileBatchDecoder", UnitTestCategories::audio)
+    {}
+
+    struct TestListener  : public AudioFileBatchDecoder::Listener
+    {
+        void blockDecoded (const File& file, const AudioBuffer<float>& block, int64 startSample) override
+        {
+            const ScopedLock sl (lock);
+            auto& result = results[file.getFileName()];
+
+            if (startSample != result.numSamples)
+                result.blocksInOrder = false;
+
+            for (int i = 0; i < block.getNumSamples(); ++i)
+                if (std::abs (block.getSample (0, i) - expectedSample (startSample + i)) > 1.0e-4f
+                     || std::abs (block.getSample (1, i) + expectedSample (startSample + i)) > 1.0e-4f)
+                    result.samplesCorrect = false;
+
+            result.numSamples += block.getNumSamples();
+        }
+
+        void fileFinished (const File& file, bool decodedSuccessfully) override
+        {
+            const ScopedLock sl (lock);
+            auto& result = results[file.getFileName()];
+            ++result.numFinishedCallbacks;
+            result.succeeded = decodedSuccessfully;
+        }
+
+        struct Result
+        {
+            int64 numSamples = 0;
+            int numFinishedCallbacks = 0;
+            bool succeeded = false, samplesCorrect = true, blocksInOrder = true;
+        };
+
+        CriticalSection lock;
+        std::map<String, Result> results;
+    };
+
+    static float expectedSample (int64 index)
+    {
+        return (float) ((index % 200) - 100) / 128.0f;
+    }
+
+    void runTest() override
+    {
+        TemporaryFile directory;
+        directory.getFile().createDirectory();
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        Array<File> files;
+        int64 totalSamples = 0;
+
+        for (int i = 0; i < 12; ++i)
+        {
+            const auto numSamples = 1000 + 3771 * i;
+            files.add (directory.getFile().getChildFile ("test" + String (i) + ".wav"));
+            writeWavFile (files.getLast(), numSamples);
+            totalSamples += numSamples;
+        }
+
+        auto notAudio = directory.getFile().getChildFile ("notAudio.wav");
+        notAudio.replaceWithText ("This isn't audio");
+
+        beginTest ("Decoding");
+        {
+            AudioFileBatchDecoder::Options options;
+            options.numThreads = 3;
+            options.samplesPerBlock = 4000;
+            options.maxMemoryBytes = 2 * 2 * 4000 * sizeof (float);
+
+            AudioFileBatchDecoder decoder (formatManager, options);
+            TestListener listener;
+
+            decoder.addFiles (files, listener);
+            decoder.addFile (notAudio, listener);
+            expect (decoder.waitUntilFinished (20000));
+            expectEquals (decoder.getNumPendingFiles(), 0);
+
+            for (int i = 0; i < files.size(); ++i)
+            {
+                auto& result = listener.results[files[i].getFileName()];
+
+                expect (result.succeeded);
+                expect (result.samplesCorrect);
+                expect (result.blocksInOrder);
+                expectEquals (result.numFinishedCallbacks, 1);
+                expectEquals (result.numSamples, (int64) (1000 + 3771 * i));
+            }
+
+            expect (! listener.results[notAudio.getFileName()].succeeded);
+            expectEquals (listener.results[notAudio.getFileName()].numFinishedCallbacks, 1);
+
+            auto stats = decoder.getStatistics();
+            expectEquals (stats.size(), 2);
+
+            for (auto& s : stats)
+            {
+                if (s.formatName.isEmpty())
+                {
+                    expectEquals (s.numFailures, 1);
+                }
+                else
+                {
+                    expectEquals (s.numFilesDecoded, files.size());
+                    expectEquals (s.numFailures, 0);
+                    expectEquals (s.numSamplesDecoded, totalSamples);
+                    expect (s.getSamplesPerSecond() > 0);
+                }
+            }
+        }
+
+        beginTest ("Cancelling");
+        {
+            AudioFileBatchDecoder::Options options;
+            options.numThreads = 2;
+            options.samplesPerBlock = 100;
+
+            TestListener listener;
+
+            {
+                AudioFileBatchDecoder decoder (formatManager, options);
+
+                for (int i = 0; i < 20; ++i)
+                    decoder.addFiles (files, listener);
+            }
+
+            expectEquals ((int) listener.results.size(), files.size());
+
+            for (auto& result : listener.results)
+                expectEquals (result.second.numFinishedCallbacks, 20);
+        }
+
+        directory.getFile().deleteRecursively();
+    }
+
+    static void writeWavFile (const File& file, int numSamples)
+    {
+        AudioBuffer<float> buffer (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer.setSample (0, i, expectedSample (i));
+            buffer.setSample (1, i, -expectedSample (i));
+        }
+
+        WavAudioFormat format;
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new FileOutputStream (file), 44100.0, 2, 16, {}, 0));
+        writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+    }
+};
+
+static AudioFileBatchDecoderTests audioFileBatchDecoderTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Decodes large numbers of audio files on a pool of background threads.
+
+    Files are added with addFile() or addFiles(), and each one is opened with the
+    AudioFormatManager that you supply and decoded in blocks, which are passed to a
+    Listener as they become available. The decoder keeps track of how much memory
+    its block buffers are using, and won't start decoding another file if that
+    would take it over the limit that you give it, so the amount of memory that it
+    uses doesn't depend on how many files are queued or how long they are.
+
+    It also keeps some statistics about the files that it has decoded for each
+    audio format, which can be used to see how long the different formats are
+    taking to decode.
+
+    The AudioFormatManager will be used from several threads at once, so you mustn't
+    register any new formats with it while the decoder is running.
+
+    @code
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    AudioFileBatchDecoder decoder (formatManager, {});
+    decoder.addFiles (filesToAnalyse, myListener);
+    decoder.waitUntilFinished();
+
+    for (auto& stats : decoder.getStatistics())
+        DBG (stats.formatName << ": " << stats.getSamplesPerSecond() << " samples per second");
+    @endcode
+
+    @see AudioFormatManager
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioFileBatchDecoder
+{
+public:
+    //==============================================================================
+    /** The settings for an AudioFileBatchDecoder. */
+    struct Options
+    {
+        /** The number of threads to decode files on. */
+        int numThreads = jmax (1, SystemStats::getNumCpus() - 1);
+
+        /** The number of samples that are decoded and passed to the listener at a time. */
+        int samplesPerBlock = 65536;
+
+        /** The maximum number of bytes that the block buffers can use between them.
+            A file which needs a bigger buffer than this on its own is only decoded
+            when no other files are being decoded.
+        */
+        size_t maxMemoryBytes = 64 * 1024 * 1024;
+    };
+
+    //==============================================================================
+    /** Receives the results of decoding files.
+
+        These callbacks are made on the decoder's threads, and different files will be
+        decoded concurrently, so your implementations must be thread-safe. The callbacks
+        for any one file are made in order, on the same thread.
+
+        The only exception is a file that's cancelled before a thread has started to
+        decode it: its fileFinished() callback is made on the thread that called
+        cancelAll() or deleted the decoder.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() = default;
+
+        /** Called when a file has been opened, before any of it is decoded.
+            If this returns false, the file will be skipped, but fileFinished()
+            will still be called for it.
+        */
+        virtual bool fileOpened (const File& file, const AudioFormatReader& reader);
+
+        /** Called with each block of samples, in order.
+            The buffer is only valid for the duration of the callback.
+        */
+        virtual void blockDecoded (const File& file, const AudioBuffer<float>& block, int64 startSampleInFile) = 0;
+
+        /** Called when a file has been decoded, skipped, or couldn't be opened or read.
+            This is called exactly once for every file that is added to the decoder,
+            including ones that are cancelled before they are started.
+        */
+        virtual void fileFinished (const File& file, bool decodedSuccessfully) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a decoder.
+        The AudioFormatManager must not be deleted before the decoder.
+    */
+    AudioFileBatchDecoder (AudioFormatManager& formatManager, const Options& options);
+
+    /** Destructor.
+        This cancels any files that haven't been decoded yet, and waits for the ones
+        that are being decoded to stop. See cancelAll().
+    */
+    ~AudioFileBatchDecoder();
+
+    //==============================================================================
+    /** Adds a file to the end of the queue.
+        The listener must not be deleted until its fileFinished() callback has been made.
+    */
+    void addFile (const File& file, Listener& listener);
+
+    /** Adds some files to the end of the queue. */
+    void addFiles (const Array<File>& files, Listener& listener);
+
+    /** Returns the number of files which have been added, but whose fileFinished()
+        callbacks haven't been made yet.
+    */
+    int getNumPendingFiles() const noexcept             { return numPendingFiles.load(); }
+
+    /** Waits until all the files that have been added are finished.
+        Returns false if the timeout expired first.
+    */
+    bool waitUntilFinished (int timeoutMilliseconds = -1);
+
+    /** Stops decoding all the files that have been added, waiting for any that are
+        being decoded to stop. Their listeners' fileFinished() callbacks will be made
+        with decodedSuccessfully set to false.
+
+        The callbacks for files which hadn't been started yet are made synchronously,
+        on the thread that calls this method, before it returns.
+    */
+    void cancelAll();
+
+    //==============================================================================
+    /** Statistics for the files of one audio format. */
+    struct FormatStatistics
+    {
+        /** The name of the format, or an empty string for files which couldn't be opened. */
+        String formatName;
+
+        /** The number of files which were decoded without errors. */
+        int numFilesDecoded = 0;
+
+        /** The number of files which couldn't be opened, or failed part-way through. */
+        int numFailures = 0;
+
+        /** The total number of sample frames that were decoded. */
+        int64 numSamplesDecoded = 0;
+
+        /** The total size of the files that were decoded. */
+        int64 numBytesDecoded = 0;
+
+        /** The total time spent opening and decoding the files, added up across all threads.
+            This doesn't include the time spent waiting for memory to become available.
+        */
+        double decodingSeconds = 0;
+
+        /** Returns the number of sample frames decoded per second of decoding time. */
+        double getSamplesPerSecond() const noexcept     { return decodingSeconds > 0 ? (double) numSamplesDecoded / decodingSeconds : 0.0; }
+
+        /** Returns the number of bytes of the files decoded per second of decoding time. */
+        double getBytesPerSecond() const noexcept       { return decodingSeconds > 0 ? (double) numBytesDecoded / decodingSeconds : 0.0; }
+    };
+
+    /** Returns the statistics for each of the formats that have been used so far. */
+    Array<FormatStatistics> getStatistics() const;
+
+    /** Clears the statistics. */
+    void resetStatistics();
+
+private:
+    //==============================================================================
+    class DecodeJob;
+
+    bool reserveMemory (size_t numBytes, ThreadPoolJob&);
+    void releaseMemory (size_t numBytes);
+    void jobFinished (const File&, Listener&, const FormatStatistics&, bool);
+
+    AudioFormatManager& formatManager;
+    const Options options;
+
+    CriticalSection memoryLock;
+    size_t memoryInUse = 0;
+    WaitableEvent memoryReleased;
+
+    CriticalSection statsLock;
+    Array<FormatStatistics> statistics;
+
+    std::atomic<int> numPendingFiles { 0 };
+    WaitableEvent allFinished;
+
+    ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFileBatchDecoder)
+};
+
+} // namespace juce
@@ -125,13 +125,26 @@ AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
 
     for (auto* af : knownFormats)
         if (af->canHandleFile (file))
-            if (auto in = file.createInputStream())
+            if (auto in = createInputStreamFor (file))
                 if (auto* r = af->createReaderFor (in.release(), true))
                     return r;
 
     return nullptr;
 }
 
+std::unique_ptr<InputStream> AudioFormatManager::createInputStreamFor (const File& file) const
+{
+    if (useMemoryMappedFiles)
+    {
+        auto mappedStream = std::make_unique<MemoryMappedFileInputStream> (file);
+
+        if (mappedStream->openedOk())
+            return mappedStream;
+    }
+
+    return file.createInputStream();
+}
+
 AudioFormatReader* AudioFormatManager::createReaderFor (std::unique_ptr<InputStream> audioFileStream)
 {
     // you need to actually register some formats before the manager can
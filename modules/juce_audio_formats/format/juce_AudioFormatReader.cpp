@@ -274,6 +274,11 @@ void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples
     highestRight = levels[1].getEnd();
 }
 
+bool AudioFormatReader::canReadMaxLevelsQuickly() const
+{
+    return false;
+}
+
 int64 AudioFormatReader::searchForLevel (int64 startSample,
                                          int64 numSamplesToSearch,
                                          double magnitudeRangeMinimum,
@@ -187,6 +187,16 @@ public:
                                 float& lowestLeft,  float& highestLeft,
                                 float& lowestRight, float& highestRight);
 
+    /** Returns true if readMaxLevels() can find the levels without reading all the samples.
+
+        The default readMaxLevels() just reads the samples and scans them, so if you need
+        the levels of a lot of consecutive sections, it's quicker to read larger blocks and
+        scan them yourself. Readers whose readMaxLevels() can do better than that, e.g. by
+        scanning a memory-mapped file, or using stored peak data, should override this to
+        return true.
+    */
+    virtual bool canReadMaxLevelsQuickly() const;
+
     /** Scans the source looking for a sample whose magnitude is in a specified range.
 
         This will read from the source, either forwards or backwards between two sample
@@ -210,6 +210,71 @@ bool AudioFormatWriter::flush()
     return false;
 }
 
+//==============================================================================
+struct AudioFormatWriter::ThreadedWriter::SpillBuffer::Block
+{
+    Block (int numChannels, int numSamples)  : buffer (numChannels, numSamples) {}
+
+    AudioBuffer<float> buffer;
+    std::atomic<int> numSamplesReady { 0 };
+    int numSamplesWritten = 0;
+    std::atomic<bool> isInUse { false };
+};
+
+AudioFormatWriter::ThreadedWriter::SpillBuffer::SpillBuffer (int maxNumChannels, int samplesPerBlock, int numBlocks)
+    : maxChannels (maxNumChannels), blockSize (samplesPerBlock)
+{
+    jassert (maxNumChannels > 0 && samplesPerBlock > 0 && numBlocks > 0);
+
+    for (int i = 0; i < numBlocks; ++i)
+        blocks.add (new Block (maxNumChannels, samplesPerBlock));
+}
+
+AudioFormatWriter::ThreadedWriter::SpillBuffer::~SpillBuffer()
+{
+    // The writers that use this spill buffer must be deleted before it is!
+    jassert (getNumFreeBlocks() == getNumBlocks());
+}
+
+int AudioFormatWriter::ThreadedWriter::SpillBuffer::getNumFreeBlocks() const noexcept
+{
+    int numFree = 0;
+
+    for (auto* b : blocks)
+        if (! b->isInUse.load())
+            ++numFree;
+
+    return numFree;
+}
+
+AudioFormatWriter::ThreadedWriter::SpillBuffer::Block* AudioFormatWriter::ThreadedWriter::SpillBuffer::allocateBlock() noexcept
+{
+    auto numBlocks = blocks.size();
+    auto first = nextBlock.load();
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        auto index = (first + i) % numBlocks;
+        auto* b = blocks.getUnchecked (index);
+        bool wasInUse = false;
+
+        if (b->isInUse.compare_exchange_strong (wasInUse, true))
+        {
+            nextBlock = (index + 1) % numBlocks;
+            return b;
+        }
+    }
+
+    return nullptr;
+}
+
+void AudioFormatWriter::ThreadedWriter::SpillBuffer::releaseBlock (Block* b) noexcept
+{
+    b->numSamplesReady = 0;
+    b->numSamplesWritten = 0;
+    b->isInUse = false;
+}
+
 //==============================================================================
 class AudioFormatWriter::ThreadedWriter::Buffer   : private TimeSliceClient
 {
@@ -226,6 +291,7 @@ public:
     ~Buffer() override
     {
         isRunning = false;
+        spaceAvailable.signal();
         timeSliceThread.removeTimeSliceClient (this);
 
         while (writePendingData() == 0)
@@ -239,19 +305,38 @@ public:
 
         jassert (timeSliceThread.isThreadRunning());  // you need to get your thread running before pumping data into this!
 
-        int start1, size1, start2, size2;
-        fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+        for (;;)
+        {
+            if (spillQueue.getNumReady() == 0)
+            {
+                currentSpillBlock = nullptr;
 
-        if (size1 + size2 < numSamples)
-            return false;
+                if (writeToFifo (data, numSamples))
+                    break;
+            }
 
-        for (int i = buffer.getNumChannels(); --i >= 0;)
-        {
-            buffer.copyFrom (i, start1, data[i], size1);
-            buffer.copyFrom (i, start2, data[i] + size1, size2);
+            if (writeToSpillBuffer (data, numSamples))
+                break;
+
+            if (backpressureMode == BackpressureMode::waitForSpace && isRunning)
+            {
+                // This block is bigger than the FIFO and spill buffer could ever hold, so waiting
+                // for space would never finish. You'll need a bigger FIFO, or to write smaller blocks.
+                jassert (couldEverHold (numSamples));
+
+                if (couldEverHold (numSamples))
+                {
+                    timeSliceThread.notify();
+                    spaceAvailable.wait (10);
+                    continue;
+                }
+            }
+
+            ++numOverruns;
+            numSamplesDropped += numSamples;
+            return false;
         }
 
-        fifo.finishedWrite (size1 + size2);
         timeSliceThread.notify();
         return true;
     }
@@ -263,47 +348,27 @@ public:
 
     int writePendingData()
     {
-        auto numToDo = fifo.getTotalSize() / 4;
+        auto numReady = fifo.getNumReady();
 
-        int start1, size1, start2, size2;
-        fifo.prepareToRead (numToDo, start1, size1, start2, size2);
-
-        if (size1 <= 0)
-            return 10;
-
-        writer->writeFromAudioSampleBuffer (buffer, start1, size1);
-
-        const ScopedLock sl (thumbnailLock);
-
-        if (receiver != nullptr)
-            receiver->addBlock (samplesWritten, buffer, start1, size1);
-
-        samplesWritten += size1;
-
-        if (size2 > 0)
+        // While the FIFO holds data that arrived before anything was spilled, that has to go first
+        if (numReady > 0 && (numReady >= minimumWriteSize || spillQueue.getNumReady() > 0 || ! isRunning))
         {
-            writer->writeFromAudioSampleBuffer (buffer, start2, size2);
+            auto numToDo = jmax (fifo.getTotalSize() / 4, minimumWriteSize.load());
 
-            if (receiver != nullptr)
-                receiver->addBlock (samplesWritten, buffer, start2, size2);
+            int start1, size1, start2, size2;
+            fifo.prepareToRead (numToDo, start1, size1, start2, size2);
 
-            samplesWritten += size2;
-        }
+            writeBlock (buffer, start1, size1);
 
-        fifo.finishedRead (size1 + size2);
+            if (size2 > 0)
+                writeBlock (buffer, start2, size2);
 
-        if (samplesPerFlush > 0)
-        {
-            flushSampleCounter -= size1 + size2;
-
-            if (flushSampleCounter <= 0)
-            {
-                flushSampleCounter = samplesPerFlush;
-                writer->flush();
-            }
+            fifo.finishedRead (size1 + size2);
+            spaceAvailable.signal();
+            return 0;
         }
 
-        return 0;
+        return writeSpilledData() ? 0 : 10;
     }
 
     void setDataReceiver (IncomingDataReceiver* newReceiver)
@@ -321,7 +386,47 @@ public:
         samplesPerFlush = numSamples;
     }
 
+    void setSpillBuffer (SpillBuffer* newSpillBuffer)
+    {
+        // This can't be changed while there's still spilled data waiting to be written!
+        jassert (spillQueue.getNumReady() == 0);
+
+        // The spill buffer needs at least as many channels as the writer
+        jassert (newSpillBuffer == nullptr || newSpillBuffer->getMaxNumChannels() >= buffer.getNumChannels());
+
+        if (newSpillBuffer != nullptr && newSpillBuffer->getMaxNumChannels() < buffer.getNumChannels())
+            newSpillBuffer = nullptr;
+
+        auto numBlocks = newSpillBuffer != nullptr ? newSpillBuffer->getNumBlocks() : 0;
+
+        spillQueueBlocks.calloc ((size_t) numBlocks + 1);
+        newSpillBlocks.calloc ((size_t) numBlocks + 1);
+        spillQueue.setTotalSize (numBlocks + 1);
+        currentSpillBlock = nullptr;
+        currentSpillBlockSize = 0;
+        spillBuffer = newSpillBuffer;
+    }
+
+    void setBackpressureMode (BackpressureMode newMode) noexcept      { backpressureMode = newMode; }
+
+    void setMinimumWriteSize (int numSamples) noexcept
+    {
+        jassert (numSamples < fifo.getTotalSize());
+        minimumWriteSize = jlimit (0, fifo.getTotalSize() - 1, numSamples);
+    }
+
+    int getNumOverruns() const noexcept                 { return numOverruns; }
+    int64 getNumSamplesDropped() const noexcept         { return numSamplesDropped; }
+
+    void resetOverrunCounters() noexcept
+    {
+        numOverruns = 0;
+        numSamplesDropped = 0;
+    }
+
 private:
+    using Block = SpillBuffer::Block;
+
     AbstractFifo fifo;
     AudioBuffer<float> buffer;
     TimeSliceThread& timeSliceThread;
@@ -332,6 +437,166 @@ private:
     int samplesPerFlush = 0, flushSampleCounter = 0;
     std::atomic<bool> isRunning { true };
 
+    SpillBuffer* spillBuffer = nullptr;
+    AbstractFifo spillQueue { 1 };
+    HeapBlock<Block*> spillQueueBlocks, newSpillBlocks;
+    Block* currentSpillBlock = nullptr;
+    int currentSpillBlockSize = 0;
+    WaitableEvent spaceAvailable;
+    BackpressureMode backpressureMode = BackpressureMode::dropIncomingData;
+    std::atomic<int> minimumWriteSize { 0 }, numOverruns { 0 };
+    std::atomic<int64> numSamplesDropped { 0 };
+
+    bool couldEverHold (int numSamples) const noexcept
+    {
+        // The FIFO always keeps one slot empty
+        if (numSamples < fifo.getTotalSize())
+            return true;
+
+        return spillBuffer != nullptr
+                && numSamples <= spillBuffer->getNumBlocks() * spillBuffer->getSamplesPerBlock();
+    }
+
+    bool writeToFifo (const float* const* data, int numSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+        if (size1 + size2 < numSamples)
+            return false;
+
+        for (int i = buffer.getNumChannels(); --i >= 0;)
+        {
+            buffer.copyFrom (i, start1, data[i], size1);
+            buffer.copyFrom (i, start2, data[i] + size1, size2);
+        }
+
+        fifo.finishedWrite (size1 + size2);
+        return true;
+    }
+
+    bool writeToSpillBuffer (const float* const* data, int numSamples)
+    {
+        if (spillBuffer == nullptr)
+            return false;
+
+        auto blockSize = spillBuffer->getSamplesPerBlock();
+        auto spaceInCurrentBlock = currentSpillBlock != nullptr ? blockSize - currentSpillBlockSize : 0;
+        auto numNewBlocks = jmax (0, numSamples - spaceInCurrentBlock + blockSize - 1) / blockSize;
+
+        if (numNewBlocks > spillQueue.getFreeSpace())
+            return false;
+
+        // Claim all the blocks that are needed before touching any of them, so that
+        // a block is either spilled in its entirety or not at all
+        for (int i = 0; i < numNewBlocks; ++i)
+        {
+            newSpillBlocks[i] = spillBuffer->allocateBlock();
+
+            if (newSpillBlocks[i] == nullptr)
+            {
+                while (--i >= 0)
+                    spillBuffer->releaseBlock (newSpillBlocks[i]);
+
+                return false;
+            }
+        }
+
+        int numDone = 0, nextNewBlock = 0;
+
+        while (numDone < numSamples)
+        {
+            // Once a block is full, the background thread may release it at any moment,
+            // so its position is tracked here rather than read back from the block
+            if (currentSpillBlock == nullptr || currentSpillBlockSize == blockSize)
+            {
+                currentSpillBlock = newSpillBlocks[nextNewBlock++];
+                currentSpillBlockSize = 0;
+
+                int start1, size1, start2, size2;
+                spillQueue.prepareToWrite (1, start1, size1, start2, size2);
+                jassert (size1 == 1);
+                spillQueueBlocks[start1] = currentSpillBlock;
+                spillQueue.finishedWrite (1);
+            }
+
+            auto num = jmin (numSamples - numDone, blockSize - currentSpillBlockSize);
+
+            for (int i = buffer.getNumChannels(); --i >= 0;)
+                currentSpillBlock->buffer.copyFrom (i, currentSpillBlockSize, data[i] + numDone, num);
+
+            currentSpillBlockSize += num;
+            currentSpillBlock->numSamplesReady = currentSpillBlockSize;
+            numDone += num;
+        }
+
+        return true;
+    }
+
+    bool writeSpilledData()
+    {
+        int start1, size1, start2, size2;
+        spillQueue.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 <= 0)
+            return false;
+
+        auto* b = spillQueueBlocks[start1];
+        auto numReady = b->numSamplesReady.load();
+        auto numToWrite = numReady - b->numSamplesWritten;
+        auto isFull = (numReady == spillBuffer->getSamplesPerBlock());
+
+        if (numToWrite <= 0 && isRunning && ! isFull)
+            return false;
+
+        if (numToWrite > 0)
+        {
+            if (isRunning && ! isFull && numToWrite < minimumWriteSize)
+                return false;
+
+            AudioBuffer<float> data (b->buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                     b->numSamplesWritten, numToWrite);
+            writeBlock (data, 0, numToWrite);
+            b->numSamplesWritten = numReady;
+        }
+
+        // A block can only be finished with once the audio thread has moved on from it,
+        // or has stopped writing altogether
+        if (isFull || ! isRunning)
+        {
+            spillQueue.finishedRead (1);
+            spillBuffer->releaseBlock (b);
+            spaceAvailable.signal();
+        }
+
+        return true;
+    }
+
+    void writeBlock (const AudioBuffer<float>& source, int startSample, int numSamples)
+    {
+        writer->writeFromAudioSampleBuffer (source, startSample, numSamples);
+
+        {
+            const ScopedLock sl (thumbnailLock);
+
+            if (receiver != nullptr)
+                receiver->addBlock (samplesWritten, source, startSample, numSamples);
+
+            samplesWritten += numSamples;
+        }
+
+        if (samplesPerFlush > 0)
+        {
+            flushSampleCounter -= numSamples;
+
+            if (flushSampleCounter <= 0)
+            {
+                flushSampleCounter = samplesPerFlush;
+                writer->flush();
+            }
+        }
+    }
+
     JUCE_DECLARE_NON_COPYABLE (Buffer)
 };
 
@@ -359,4 +624,244 @@ void AudioFormatWriter::ThreadedWriter::setFlushInterval (int numSamplesPerFlush
     buffer->setFlushInterval (numSamplesPerFlush);
 }
 
+void AudioFormatWriter::ThreadedWriter::setSpillBuffer (SpillBuffer* spillBufferToUse)
+{
+    buffer->setSpillBuffer (spillBufferToUse);
+}
+
+void AudioFormatWriter::ThreadedWriter::setBackpressureMode (BackpressureMode newMode) noexcept
+{
+    buffer->setBackpressureMode (newMode);
+}
+
+void AudioFormatWriter::ThreadedWriter::setMinimumWriteSize (int numSamples) noexcept
+{
+    buffer->setMinimumWriteSize (numSamples);
+}
+
+int AudioFormatWriter::ThreadedWriter::getNumOverruns() const noexcept
+{
+    return buffer->getNumOverruns();
+}
+
+int64 AudioFormatWriter::ThreadedWriter::getNumSamplesDropped() const noexcept
+{
+    return buffer->getNumSamplesDropped();
+}
+
+void AudioFormatWriter::ThreadedWriter::resetOverrunCounters() noexcept
+{
+    buffer->resetOverrunCounters();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ThreadedWriterTests  : public UnitTest
+{
+    ThreadedWriterTests()
+        : UnitTest ("AudioFormatWriter::ThreadedWriter", UnitTestCategories::audio)
+    {}
+
+    // Collects the samples that it's given, and can be made to stall like a busy disk
+    struct RecordingWriter  : public AudioFormatWriter
+    {
+        RecordingWriter (Array<float>& s, Array<int>& sizes)
+            : AudioFormatWriter (nullptr, "Test", 44100.0, 1, 32), samples (s), writeSizes (sizes)
+        {
+            usesFloatingPointData = true;
+        }
+
+        bool write (const int** data, int numSamples) override
+        {
+            if (isStalled)
+                resumed.wait (-1);
+
+            samples.addArray (reinterpret_cast<const float*> (data[0]), numSamples);
+            writeSizes.add (numSamples);
+            return true;
+        }
+
+        void stall()    { isStalled = true; }
+        void resume()   { isStalled = false; resumed.signal(); }
+
+        Array<float>& samples;
+        Array<int>& writeSizes;
+        std::atomic<bool> isStalled { false };
+        WaitableEvent resumed { true };
+    };
+
+    struct Source
+    {
+        bool writeBlock (AudioFormatWriter::ThreadedWriter& writer, int numSamples)
+        {
+            HeapBlock<float> block ((size_t) numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                block[i] = (float) (nextValue + i);
+
+            const float* channels[] = { block.get() };
+
+            if (! writer.write (channels, numSamples))
+                return false;
+
+            expected.addArray (block.get(), numSamples);
+            nextValue += numSamples;
+            return true;
+        }
+
+        Array<float> expected;
+        int nextValue = 0;
+    };
+
+    void runTest() override
+    {
+        TimeSliceThread thread ("ThreadedWriter test");
+        thread.startThread();
+
+        beginTest ("Overruns are counted");
+        {
+            Array<float> written;
+            Array<int> writeSizes;
+            Source source;
+
+            {
+                auto* recorder = new RecordingWriter (written, writeSizes);
+                AudioFormatWriter::ThreadedWriter writer (recorder, thread, 1024);
+                recorder->stall();
+
+                for (int i = 0; i < 3; ++i)
+                    expect (source.writeBlock (writer, 256));
+
+                expect (! source.writeBlock (writer, 256));
+                expect (! source.writeBlock (writer, 256));
+                expectEquals (writer.getNumOverruns(), 2);
+                expectEquals (writer.getNumSamplesDropped(), (int64) 512);
+
+                writer.resetOverrunCounters();
+                expectEquals (writer.getNumOverruns(), 0);
+                recorder->resume();
+            }
+
+            expect (written == source.expected);
+        }
+
+        beginTest ("A spill buffer absorbs stalls without losing data");
+        {
+            AudioFormatWriter::ThreadedWriter::SpillBuffer spill (2, 256, 8);
+            Array<float> written1, written2;
+            Array<int> writeSizes1, writeSizes2;
+            Source source1, source2;
+
+            {
+                auto* recorder1 = new RecordingWriter (written1, writeSizes1);
+                auto* recorder2 = new RecordingWriter (written2, writeSizes2);
+                AudioFormatWriter::ThreadedWriter writer1 (recorder1, thread, 1024);
+                AudioFormatWriter::ThreadedWriter writer2 (recorder2, thread, 1024);
+                writer1.setSpillBuffer (&spill);
+                writer2.setSpillBuffer (&spill);
+
+                recorder1->stall();
+                recorder2->stall();
+
+                // Fill both FIFOs, then share out the spill blocks between the writers
+                for (auto size : { 256, 256, 256, 255 })
+                {
+                    expect (source1.writeBlock (writer1, size));
+                    expect (source2.writeBlock (writer2, size));
+                }
+
+                for (int i = 0; i < 10; ++i)
+                    expect (source1.writeBlock (writer1, 100));
+
+                for (int i = 0; i < 4; ++i)
+                    expect (source2.writeBlock (writer2, 256));
+
+                expectEquals (spill.getNumFreeBlocks(), 0);
+                expect (! source2.writeBlock (writer2, 256));
+                expect (source1.writeBlock (writer1, 24));  // fits in writer1's last block
+                expect (! source1.writeBlock (writer1, 1));
+                expectEquals (writer1.getNumOverruns(), 1);
+                expectEquals (writer2.getNumOverruns(), 1);
+
+                // Keep writing while the backlog drains, so that new data has to be queued behind the spilled data
+                writer1.setBackpressureMode (AudioFormatWriter::ThreadedWriter::BackpressureMode::waitForSpace);
+                writer2.setBackpressureMode (AudioFormatWriter::ThreadedWriter::BackpressureMode::waitForSpace);
+                recorder1->resume();
+                recorder2->resume();
+
+                auto random = getRandom();
+
+                for (int i = 0; i < 200; ++i)
+                {
+                    expect (source1.writeBlock (writer1, 1 + random.nextInt (300)));
+                    expect (source2.writeBlock (writer2, 1 + random.nextInt (300)));
+                }
+            }
+
+            expectEquals (spill.getNumFreeBlocks(), spill.getNumBlocks());
+            expect (written1 == source1.expected);
+            expect (written2 == source2.expected);
+        }
+
+        beginTest ("Writes are batched");
+        {
+            Array<float> written;
+            Array<int> writeSizes;
+            Source source;
+
+            {
+                AudioFormatWriter::ThreadedWriter writer (new RecordingWriter (written, writeSizes), thread, 8192);
+                writer.setMinimumWriteSize (2048);
+                writer.setBackpressureMode (AudioFormatWriter::ThreadedWriter::BackpressureMode::waitForSpace);
+
+                for (int i = 0; i < 256; ++i)
+                {
+                    expect (source.writeBlock (writer, 64));
+
+                    if (i % 16 == 0)
+                        Thread::sleep (1);
+                }
+            }
+
+            expect (written == source.expected);
+
+            // Each batch may be split in two where it wraps around the FIFO, and the
+            // remainder is written when the writer is deleted
+            expect (writeSizes.size() <= 2 * (256 * 64 / 2048) + 1);
+        }
+
+        beginTest ("Blocks that could never fit are dropped rather than waited for");
+        {
+            AudioFormatWriter::ThreadedWriter::SpillBuffer spill (1, 256, 8);
+            Array<float> written;
+            Array<int> writeSizes;
+            Source source;
+
+            {
+                AudioFormatWriter::ThreadedWriter writer (new RecordingWriter (written, writeSizes), thread, 1024);
+                writer.setBackpressureMode (AudioFormatWriter::ThreadedWriter::BackpressureMode::waitForSpace);
+
+                expect (source.writeBlock (writer, 1023));
+                expect (! source.writeBlock (writer, 1024));  // this will also hit an assertion
+                expectEquals (writer.getNumOverruns(), 1);
+                expectEquals (writer.getNumSamplesDropped(), (int64) 1024);
+
+                // A spill buffer that's big enough lets the block through, once there's room
+                writer.setSpillBuffer (&spill);
+                expect (source.writeBlock (writer, 2048));
+                expect (! source.writeBlock (writer, 2049));  // this will also hit an assertion
+                expectEquals (writer.getNumOverruns(), 2);
+            }
+
+            expect (written == source.expected);
+        }
+    }
+};
+
+static ThreadedWriterTests threadedWriterTests;
+
+#endif
+
 } // namespace juce
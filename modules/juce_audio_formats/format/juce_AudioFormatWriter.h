@@ -179,10 +179,69 @@ public:
     /**
         Provides a FIFO for an AudioFormatWriter, allowing you to push incoming
         data into a buffer which will be flushed to disk by a background thread.
+
+        Any number of ThreadedWriters can share the same TimeSliceThread, so when
+        recording many tracks at once, a single I/O thread can service all of them.
+        To cope with disk stalls without giving each track an enormous FIFO, the
+        writers can also share a SpillBuffer, which holds incoming data whenever a
+        writer's own FIFO fills up.
     */
     class ThreadedWriter
     {
     public:
+        //==============================================================================
+        /**
+            A pool of pre-allocated memory that a set of ThreadedWriters can share,
+            to absorb incoming data when their FIFOs are full.
+
+            The memory is divided into fixed-size blocks, which writers claim and
+            release without locking, so writing into the spill buffer is safe on the
+            audio thread. Once a writer has started spilling, it keeps doing so until
+            the background thread has caught up, so the data always reaches the file
+            in the order in which it was written.
+
+            The SpillBuffer must outlive all the writers that are using it.
+
+            @see ThreadedWriter::setSpillBuffer
+        */
+        class JUCE_API  SpillBuffer
+        {
+        public:
+            /** Allocates a pool of numBlocks blocks, each holding samplesPerBlock
+                samples for up to maxNumChannels channels.
+            */
+            SpillBuffer (int maxNumChannels, int samplesPerBlock, int numBlocks);
+
+            /** Destructor. */
+            ~SpillBuffer();
+
+            /** Returns the maximum number of channels that a block can hold. */
+            int getMaxNumChannels() const noexcept          { return maxChannels; }
+
+            /** Returns the number of samples in each block. */
+            int getSamplesPerBlock() const noexcept         { return blockSize; }
+
+            /** Returns the total number of blocks in the pool. */
+            int getNumBlocks() const noexcept               { return blocks.size(); }
+
+            /** Returns the number of blocks that aren't currently being used by a writer. */
+            int getNumFreeBlocks() const noexcept;
+
+        private:
+            struct Block;
+            friend class ThreadedWriter;
+
+            Block* allocateBlock() noexcept;
+            void releaseBlock (Block*) noexcept;
+
+            OwnedArray<Block> blocks;
+            int maxChannels, blockSize;
+            std::atomic<int> nextBlock { 0 };
+
+            JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpillBuffer)
+        };
+
+        //==============================================================================
         /** Creates a ThreadedWriter for a given writer and a thread.
 
             The writer object which is passed in here will be owned and deleted by
@@ -201,16 +260,67 @@ public:
 
             If there's enough free space in the buffer, this will add the data to it,
 
-            If the FIFO is too full to accept this many samples, the method will return
+            If the FIFO is too full to accept this many samples, the data will go into
+            the spill buffer, if one has been set. If there's no room there either, what
+            happens depends on the backpressure mode: by default the method will return
             false - then you could either wait until the background thread has had time to
             consume some of the buffered data and try again, or you can give up
-            and lost this block.
+            and lose this block. Any block that is rejected is counted as an overrun.
 
             The data must be an array containing the same number of channels as the
             AudioFormatWriter object is using. None of these channels can be null.
+
+            @see getNumOverruns, setSpillBuffer, setBackpressureMode
         */
         bool write (const float* const* data, int numSamples);
 
+        //==============================================================================
+        /** Gives the writer a shared pool of memory to use when its FIFO is full.
+
+            The spill buffer must have enough channels for this writer, and must not be
+            deleted while the writer is using it. This allocates memory, so call it before
+            you start writing, and never while write() may be called on another thread.
+            Pass nullptr to stop using a spill buffer.
+        */
+        void setSpillBuffer (SpillBuffer* spillBufferToUse);
+
+        /** The ways in which write() can behave when there's no room for the incoming data. */
+        enum class BackpressureMode
+        {
+            dropIncomingData,   /**< write() returns false straight away, and the block is lost. This is the
+                                     default, and the only mode that is safe to use on the audio thread. */
+            waitForSpace        /**< write() blocks until the background thread has made enough room. This is
+                                     useful when the data isn't coming from a real-time source, e.g. when
+                                     rendering offline. A block that's too big to ever fit in the FIFO, or in
+                                     the whole spill buffer, will trigger an assertion and be dropped in the
+                                     same way as with dropIncomingData, rather than waiting forever. */
+        };
+
+        /** Chooses what write() should do when the FIFO and spill buffer are both full. */
+        void setBackpressureMode (BackpressureMode newMode) noexcept;
+
+        /** Sets the minimum number of samples that the background thread should write in one go.
+
+            Writing a few large chunks is usually much kinder to the disk than writing many
+            small ones, particularly when a lot of tracks are being recorded at once. While
+            fewer samples than this are waiting, the background thread will leave them in the
+            FIFO, unless the writer is being deleted. This must be less than the FIFO size,
+            and the default is 0, which writes whatever is available.
+        */
+        void setMinimumWriteSize (int numSamples) noexcept;
+
+        /** Returns the number of times that write() has had to reject a block because
+            there wasn't enough room for it.
+        */
+        int getNumOverruns() const noexcept;
+
+        /** Returns the total number of samples that have been lost because of overruns. */
+        int64 getNumSamplesDropped() const noexcept;
+
+        /** Resets the overrun counters. */
+        void resetOverrunCounters() noexcept;
+
+        //==============================================================================
         /** Receiver for incoming data. */
         class JUCE_API  IncomingDataReceiver
         {
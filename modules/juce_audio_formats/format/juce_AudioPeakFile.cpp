@@ -0,0 +1,539 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace PeakFileHelpers
+{
+    static constexpr const char* magic = "jpkf";
+    static constexpr int version = 1;
+    static constexpr int headerSize = 40, levelHeaderSize = 24;
+    static constexpr int levelScaleFactor = 4;
+
+    static int8 toPeakValue (float value) noexcept
+    {
+        return (int8) jlimit (-127, 127, roundToInt (value * 127.0f));
+    }
+
+    static uint8 toRMSValue (float meanSquare) noexcept
+    {
+        return (uint8) jlimit (0, 255, roundToInt (std::sqrt (meanSquare) * 255.0f));
+    }
+}
+
+//==============================================================================
+struct AudioPeakFile::Builder::ChannelLevels
+{
+    std::vector<float> minimums, maximums, meanSquares;
+    float currentMin = 0, currentMax = 0;
+    double currentSumOfSquares = 0;
+};
+
+AudioPeakFile::Builder::Builder (int numChans, double rate, int64 hash, int numSamplesPerPeak)
+    : channels ((size_t) numChans), sampleRate (rate), hashCode (hash), samplesPerPeak (numSamplesPerPeak)
+{
+    jassert (numChans > 0 && numSamplesPerPeak > 0);
+}
+
+AudioPeakFile::Builder::~Builder() = default;
+
+void AudioPeakFile::Builder::addBlock (const AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert (buffer.getNumChannels() >= (int) channels.size());
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    while (numSamples > 0)
+    {
+        auto numToDo = jmin (numSamples, samplesPerPeak - numInCurrentPeak);
+
+        for (size_t i = 0; i < channels.size(); ++i)
+        {
+            auto& c = channels[i];
+            auto* data = buffer.getReadPointer ((int) i, startSample);
+            auto range = FloatVectorOperations::findMinAndMax (data, numToDo);
+
+            double sumOfSquares = 0;
+
+            for (int j = 0; j < numToDo; ++j)
+                sumOfSquares += data[j] * data[j];
+
+            if (numInCurrentPeak == 0)
+            {
+                c.currentMin = range.getStart();
+                c.currentMax = range.getEnd();
+                c.currentSumOfSquares = sumOfSquares;
+            }
+            else
+            {
+                c.currentMin = jmin (c.currentMin, range.getStart());
+                c.currentMax = jmax (c.currentMax, range.getEnd());
+                c.currentSumOfSquares += sumOfSquares;
+            }
+        }
+
+        numInCurrentPeak += numToDo;
+        numSamplesAdded += numToDo;
+        startSample += numToDo;
+        numSamples -= numToDo;
+
+        if (numInCurrentPeak == samplesPerPeak)
+        {
+            for (auto& c : channels)
+            {
+                c.minimums.push_back (c.currentMin);
+                c.maximums.push_back (c.currentMax);
+                c.meanSquares.push_back ((float) (c.currentSumOfSquares / samplesPerPeak));
+            }
+
+            numInCurrentPeak = 0;
+        }
+    }
+}
+
+bool AudioPeakFile::Builder::writeTo (const File& peakFile) const
+{
+    using namespace PeakFileHelpers;
+
+    auto numChans = (int) channels.size();
+
+    // Start with the finest level, including the partly-filled peak at the end
+    std::vector<ChannelLevels> current (channels);
+
+    if (numInCurrentPeak > 0)
+    {
+        for (auto& c : current)
+        {
+            c.minimums.push_back (c.currentMin);
+            c.maximums.push_back (c.currentMax);
+            c.meanSquares.push_back ((float) (c.currentSumOfSquares / numInCurrentPeak));
+        }
+    }
+
+    std::vector<std::vector<Peak>> levelData;
+    std::vector<int64> levelScales;
+    int64 scale = samplesPerPeak;
+
+    for (;;)
+    {
+        auto numPeaks = current.front().minimums.size();
+        levelData.emplace_back (numPeaks * (size_t) numChans);
+        levelScales.push_back (scale);
+        auto& peaks = levelData.back();
+
+        for (size_t i = 0; i < numPeaks; ++i)
+        {
+            for (int chan = 0; chan < numChans; ++chan)
+            {
+                auto& c = current[(size_t) chan];
+                auto& p = peaks[i * (size_t) numChans + (size_t) chan];
+
+                p.minValue = toPeakValue (c.minimums[i]);
+                p.maxValue = toPeakValue (c.maximums[i]);
+                p.rms = toRMSValue (c.meanSquares[i]);
+                p.reserved = 0;
+            }
+        }
+
+        if (numPeaks <= 1)
+            break;
+
+        // Each coarser level summarises a group of peaks from the level below it
+        std::vector<ChannelLevels> next ((size_t) numChans);
+
+        for (int chan = 0; chan < numChans; ++chan)
+        {
+            auto& src = current[(size_t) chan];
+            auto& dst = next[(size_t) chan];
+
+            for (size_t i = 0; i < numPeaks; i += levelScaleFactor)
+            {
+                auto end = jmin (numPeaks, i + levelScaleFactor);
+                auto mn = src.minimums[i], mx = src.maximums[i];
+                float sum = 0;
+
+                for (auto j = i; j < end; ++j)
+                {
+                    mn = jmin (mn, src.minimums[j]);
+                    mx = jmax (mx, src.maximums[j]);
+                    sum += src.meanSquares[j];
+                }
+
+                dst.minimums.push_back (mn);
+                dst.maximums.push_back (mx);
+                dst.meanSquares.push_back (sum / (float) (end - i));
+            }
+        }
+
+        current = std::move (next);
+        scale *= levelScaleFactor;
+    }
+
+    if (! peakFile.getParentDirectory().createDirectory())
+        return false;
+
+    TemporaryFile temp (peakFile);
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (! out.openedOk())
+            return false;
+
+        auto numLevels = (int) levelData.size();
+
+        out.write (magic, 4);
+        out.writeInt (version);
+        out.writeInt64 (hashCode);
+        out.writeInt64 (numSamplesAdded);
+        out.writeDouble (sampleRate);
+        out.writeInt (numChans);
+        out.writeInt (numLevels);
+
+        auto offset = (int64) (headerSize + levelHeaderSize * numLevels);
+
+        for (int i = 0; i < numLevels; ++i)
+        {
+            auto numPeaks = (int) (levelData[(size_t) i].size() / (size_t) numChans);
+
+            out.writeInt64 (levelScales[(size_t) i]);
+            out.writeInt (numPeaks);
+            out.writeInt (0);
+            out.writeInt64 (offset);
+
+            offset += (int64) levelData[(size_t) i].size() * (int64) sizeof (Peak);
+        }
+
+        for (auto& peaks : levelData)
+            if (! out.write (peaks.data(), peaks.size() * sizeof (Peak)))
+                return false;
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+std::unique_ptr<AudioPeakFile> AudioPeakFile::open (const File& file, int64 expectedHashCode)
+{
+    using namespace PeakFileHelpers;
+    static_assert (sizeof (Peak) == 4, "Peaks are stored in the file as 4 bytes");
+
+    if (! file.existsAsFile())
+        return {};
+
+    auto mapped = std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly);
+    auto* data = static_cast<const char*> (mapped->getData());
+    auto size = (int64) mapped->getSize();
+
+    if (data == nullptr || size < headerSize || memcmp (data, magic, 4) != 0)
+        return {};
+
+    MemoryInputStream header (data, (size_t) size, false);
+    header.skipNextBytes (4);
+
+    if (header.readInt() != version || header.readInt64() != expectedHashCode)
+        return {};
+
+    std::unique_ptr<AudioPeakFile> peakFile (new AudioPeakFile());
+    peakFile->hashCode = expectedHashCode;
+    peakFile->lengthInSamples = header.readInt64();
+    peakFile->sampleRate = header.readDouble();
+    peakFile->numChannels = header.readInt();
+    auto numLevels = header.readInt();
+
+    if (peakFile->lengthInSamples < 0 || peakFile->sampleRate <= 0
+         || ! isPositiveAndBelow (peakFile->numChannels, 1024)
+         || ! isPositiveAndBelow (numLevels, 64)
+         || size < headerSize + (int64) levelHeaderSize * numLevels)
+        return {};
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        Level level;
+        level.samplesPerPeak = header.readInt64();
+        level.numPeaks = header.readInt();
+        header.skipNextBytes (4);
+        auto offset = header.readInt64();
+
+        if (level.samplesPerPeak <= 0 || level.numPeaks < 0 || offset < 0
+             || offset + (int64) level.numPeaks * peakFile->numChannels * (int64) sizeof (Peak) > size)
+            return {};
+
+        level.peaks = reinterpret_cast<const Peak*> (data + offset);
+        peakFile->levels.push_back (level);
+    }
+
+    peakFile->mappedFile = std::move (mapped);
+    return peakFile;
+}
+
+bool AudioPeakFile::create (AudioFormatReader& reader, const File& peakFileToCreate,
+                            int64 hashCode, int samplesPerPeak)
+{
+    if (reader.numChannels == 0 || reader.sampleRate <= 0)
+        return false;
+
+    Builder builder ((int) reader.numChannels, reader.sampleRate, hashCode, samplesPerPeak);
+
+    // Keep the blocks a whole number of peaks long, so that they fill peaks exactly
+    auto blockSize = jmax (1, 65536 / samplesPerPeak) * samplesPerPeak;
+    AudioBuffer<float> buffer ((int) reader.numChannels, blockSize);
+
+    for (int64 pos = 0; pos < reader.lengthInSamples;)
+    {
+        auto numToDo = (int) jmin ((int64) blockSize, reader.lengthInSamples - pos);
+        reader.read (&buffer, 0, numToDo, pos, true, true);
+        builder.addBlock (buffer, 0, numToDo);
+        pos += numToDo;
+    }
+
+    return builder.writeTo (peakFileToCreate);
+}
+
+AudioPeakFile::~AudioPeakFile() = default;
+
+//==============================================================================
+int64 AudioPeakFile::getSamplesPerPeak (int level) const noexcept
+{
+    jassert (isPositiveAndBelow (level, getNumLevels()));
+    return levels[(size_t) level].samplesPerPeak;
+}
+
+int AudioPeakFile::getNumPeaks (int level) const noexcept
+{
+    jassert (isPositiveAndBelow (level, getNumLevels()));
+    return levels[(size_t) level].numPeaks;
+}
+
+const AudioPeakFile::Peak& AudioPeakFile::getPeak (int level, int channel, int index) const noexcept
+{
+    jassert (isPositiveAndBelow (level, getNumLevels()) && isPositiveAndBelow (channel, numChannels));
+    jassert (isPositiveAndBelow (index, levels[(size_t) level].numPeaks));
+
+    return levels[(size_t) level].peaks[index * numChannels + channel];
+}
+
+AudioPeakFile::Peak AudioPeakFile::getLevels (int channel, Range<int64> sampleRange) const noexcept
+{
+    if (! isPositiveAndBelow (channel, numChannels) || levels.empty())
+        return {};
+
+    auto numSamples = jmax ((int64) 1, sampleRange.getLength());
+    size_t levelIndex = 0;
+
+    while (levelIndex + 1 < levels.size() && levels[levelIndex + 1].samplesPerPeak <= numSamples)
+        ++levelIndex;
+
+    auto& level = levels[levelIndex];
+    auto first = sampleRange.getStart() / level.samplesPerPeak;
+    auto last  = jmin ((int64) level.numPeaks - 1, (sampleRange.getStart() + numSamples - 1) / level.samplesPerPeak);
+
+    if (first < 0 || first > last)
+        return {};
+
+    return combine (level.peaks + first * numChannels + channel, (int) (last - first + 1), numChannels);
+}
+
+float AudioPeakFile::getHighestLevel() const noexcept
+{
+    if (levels.empty())
+        return 0.0f;
+
+    auto& level = levels.back();
+    int highest = 0;
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        auto p = combine (level.peaks + chan, level.numPeaks, numChannels);
+        highest = jmax (highest, std::abs ((int) p.minValue), std::abs ((int) p.maxValue));
+    }
+
+    return (float) highest / 127.0f;
+}
+
+AudioPeakFile::Peak AudioPeakFile::combine (const Peak* peaks, int numPeaks, int stride) noexcept
+{
+    if (numPeaks <= 0)
+        return {};
+
+    auto result = *peaks;
+    double sumOfSquares = 0;
+
+    for (int i = 0; i < numPeaks; ++i)
+    {
+        auto& p = peaks[i * stride];
+        result.minValue = jmin (result.minValue, p.minValue);
+        result.maxValue = jmax (result.maxValue, p.maxValue);
+        sumOfSquares += (double) p.rms * p.rms;
+    }
+
+    result.rms = (uint8) jlimit (0, 255, roundToInt (std::sqrt (sumOfSquares / numPeaks)));
+    return result;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioPeakFileTests  : public UnitTest
+{
+    AudioPeakFileTests()
+        : UnitTest ("AudioPeakFile", UnitTestCategories::audio)
+    {}
+
+    static AudioBuffer<float> createTestSignal (Random& random, int numChannels, int numSamples)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            auto* data = buffer.getWritePointer (chan);
+            auto gain = 0.2f + 0.3f * (float) chan;
+
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = gain * std::sin ((float) i * 0.01f * (float) (chan + 1)) * (0.5f + 0.5f * random.nextFloat());
+        }
+
+        return buffer;
+    }
+
+    void expectLevelsMatch (const AudioPeakFile& peakFile, const AudioBuffer<float>& signal,
+                            int channel, Range<int64> range)
+    {
+        auto p = peakFile.getLevels (channel, range);
+        auto expected = FloatVectorOperations::findMinAndMax (signal.getReadPointer (channel, (int) range.getStart()),
+                                                              (int) range.getLength());
+
+        // The peaks that are used can cover a little more than the requested range,
+        // so the levels may be slightly wider than the exact ones, but never narrower
+        auto tolerance = 1.0f / 127.0f;
+        expectLessOrEqual (p.getMinimum(), expected.getStart() + tolerance);
+        expectGreaterOrEqual (p.getMaximum(), expected.getEnd() - tolerance);
+        expectGreaterOrEqual (p.getMinimum(), signal.getMagnitude (channel, 0, signal.getNumSamples()) * -1.0f - tolerance);
+        expectLessOrEqual (p.getMaximum(), signal.getMagnitude (channel, 0, signal.getNumSamples()) + tolerance);
+    }
+
+    void runTest() override
+    {
+        auto random = getRandom();
+        const int numChannels = 2, numSamples = 100000, samplesPerPeak = 64;
+        auto signal = createTestSignal (random, numChannels, numSamples);
+
+        TemporaryFile temp (".peaks");
+        auto file = temp.getFile();
+
+        beginTest ("Building and opening");
+        {
+            AudioPeakFile::Builder builder (numChannels, 44100.0, 1234, samplesPerPeak);
+
+            // Add the signal in awkwardly-sized blocks
+            for (int pos = 0; pos < numSamples;)
+            {
+                auto num = jmin (numSamples - pos, 1 + random.nextInt (5000));
+                builder.addBlock (signal, pos, num);
+                pos += num;
+            }
+
+            expectEquals (builder.getNumSamplesAdded(), (int64) numSamples);
+            expect (builder.writeTo (file));
+
+            expect (AudioPeakFile::open (file, 4321) == nullptr);
+
+            auto peakFile = AudioPeakFile::open (file, 1234);
+            expect (peakFile != nullptr);
+
+            expectEquals (peakFile->getNumChannels(), numChannels);
+            expectEquals (peakFile->getLengthInSamples(), (int64) numSamples);
+            expectEquals (peakFile->getSampleRate(), 44100.0);
+            expectEquals (peakFile->getSamplesPerPeak (0), (int64) samplesPerPeak);
+            expectEquals (peakFile->getNumPeaks (0), (numSamples + samplesPerPeak - 1) / samplesPerPeak);
+            expectEquals (peakFile->getNumPeaks (peakFile->getNumLevels() - 1), 1);
+
+            for (int level = 1; level < peakFile->getNumLevels(); ++level)
+                expectEquals (peakFile->getSamplesPerPeak (level), peakFile->getSamplesPerPeak (level - 1) * 4);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    auto length = 1 + random.nextInt (numSamples / (1 + random.nextInt (100)));
+                    auto start = random.nextInt (numSamples - length + 1);
+                    expectLevelsMatch (*peakFile, signal, chan, Range<int64>::withStartAndLength (start, length));
+                }
+
+                auto p = peakFile->getLevels (chan, { 0, (int64) numSamples });
+                auto rms = signal.getRMSLevel (chan, 0, numSamples);
+                expectWithinAbsoluteError (p.getRMS(), rms, 0.01f);
+            }
+
+            expectWithinAbsoluteError (peakFile->getHighestLevel(),
+                                       signal.getMagnitude (0, numSamples), 1.0f / 127.0f);
+        }
+
+        beginTest ("Creating from a reader");
+        {
+            MemoryBlock wavData;
+
+            {
+                WavAudioFormat format;
+                std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (wavData, false),
+                                                                                   48000.0, (unsigned int) numChannels, 32, {}, 0));
+                expect (writer != nullptr);
+                writer->writeFromAudioSampleBuffer (signal, 0, numSamples);
+            }
+
+            WavAudioFormat format;
+            std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (wavData, false), true));
+            expect (reader != nullptr);
+            expect (AudioPeakFile::create (*reader, file, 5678, samplesPerPeak));
+
+            auto peakFile = AudioPeakFile::open (file, 5678);
+            expect (peakFile != nullptr);
+            expectEquals (peakFile->getSampleRate(), 48000.0);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                auto length = 1 + random.nextInt (10000);
+                auto start = random.nextInt (numSamples - length + 1);
+                expectLevelsMatch (*peakFile, signal, i % numChannels, Range<int64>::withStartAndLength (start, length));
+            }
+        }
+
+        beginTest ("Invalid files are rejected");
+        {
+            expect (file.replaceWithText ("not a peak file"));
+            expect (AudioPeakFile::open (file, 5678) == nullptr);
+            expect (AudioPeakFile::open (File(), 5678) == nullptr);
+        }
+    }
+};
+
+static AudioPeakFileTests audioPeakFileTests;
+
+#endif
+
+} // namespace juce
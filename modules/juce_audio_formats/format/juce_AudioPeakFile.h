@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A multi-resolution file of waveform levels, used to draw an overview of an
+    audio file without having to read the audio itself.
+
+    A peak file holds several levels of detail. At the finest level, each peak
+    summarises getSamplesPerPeak (0) samples of each channel, and each level
+    after that summarises four times as many samples as the one before it, so
+    any zoom level can be drawn by looking at no more than a few peaks per pixel.
+    Each peak holds the minimum, maximum and RMS level of the samples it covers.
+
+    Peak files are created once with create(), or with a Builder if the audio is
+    already being read for some other reason. After that, open() memory-maps the
+    file, so opening one is almost free, however long the audio is.
+
+    @see AudioThumbnail, AudioThumbnailCache::setPeakFileDirectory
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioPeakFile
+{
+public:
+    //==============================================================================
+    /** The levels for a range of samples in one channel. */
+    struct Peak
+    {
+        int8 minValue, maxValue;    /**< The lowest and highest sample values, scaled to the range -127 to 127. */
+        uint8 rms;                  /**< The RMS level, scaled to the range 0 to 255. */
+        uint8 reserved;
+
+        /** Returns the lowest sample value, in the range -1 to 1. */
+        float getMinimum() const noexcept       { return (float) minValue / 127.0f; }
+
+        /** Returns the highest sample value, in the range -1 to 1. */
+        float getMaximum() const noexcept       { return (float) maxValue / 127.0f; }
+
+        /** Returns the RMS level, in the range 0 to 1. */
+        float getRMS() const noexcept           { return (float) rms / 255.0f; }
+    };
+
+    /** The number of source samples in each peak of the finest level, if you don't specify one. */
+    static constexpr int defaultSamplesPerPeak = 256;
+
+    //==============================================================================
+    /** Memory-maps an existing peak file.
+
+        If the file doesn't exist, isn't a valid peak file, or was created from a source
+        with a different hash code, this returns nullptr.
+    */
+    static std::unique_ptr<AudioPeakFile> open (const File& peakFile, int64 expectedHashCode);
+
+    /** Reads all of the audio from a reader, and writes a peak file for it.
+
+        The hash code is stored in the file, and is normally the one that identifies the
+        source, e.g. InputSource::hashCode(). Returns true if the file was written.
+    */
+    static bool create (AudioFormatReader& source, const File& peakFileToCreate,
+                        int64 hashCode, int samplesPerPeak = defaultSamplesPerPeak);
+
+    /** Destructor. */
+    ~AudioPeakFile();
+
+    //==============================================================================
+    /** Returns the number of channels. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the sample rate of the source. */
+    double getSampleRate() const noexcept               { return sampleRate; }
+
+    /** Returns the length of the source, in samples. */
+    int64 getLengthInSamples() const noexcept           { return lengthInSamples; }
+
+    /** Returns the hash code of the source that the file was created from. */
+    int64 getHashCode() const noexcept                  { return hashCode; }
+
+    /** Returns the number of levels of detail in the file. */
+    int getNumLevels() const noexcept                   { return (int) levels.size(); }
+
+    /** Returns the number of source samples that each peak in a level covers. */
+    int64 getSamplesPerPeak (int level) const noexcept;
+
+    /** Returns the number of peaks in a level. */
+    int getNumPeaks (int level) const noexcept;
+
+    /** Returns one of the peaks in a level. */
+    const Peak& getPeak (int level, int channel, int index) const noexcept;
+
+    /** Returns the combined levels of a channel over a range of source samples.
+
+        This uses the coarsest level of detail that is still fine enough to
+        resolve the range, so it's fast enough to call for every pixel of a
+        waveform display at any zoom level.
+    */
+    Peak getLevels (int channel, Range<int64> sampleRange) const noexcept;
+
+    /** Returns the highest level found in any of the channels, in the range 0 to 1. */
+    float getHighestLevel() const noexcept;
+
+    //==============================================================================
+    /**
+        Calculates the contents of a peak file from audio that is passed to it in blocks.
+
+        This is useful if you're already reading or recording the audio, and want to
+        create its peak file at the same time.
+    */
+    class JUCE_API  Builder
+    {
+    public:
+        /** Creates a builder for some audio with the given format. */
+        Builder (int numChannels, double sampleRate, int64 hashCode,
+                 int samplesPerPeak = defaultSamplesPerPeak);
+
+        /** Destructor. */
+        ~Builder();
+
+        /** Adds the next block of audio.
+
+            The blocks must be added in order, and can be any size.
+        */
+        void addBlock (const AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+        /** Returns the number of samples that have been added so far. */
+        int64 getNumSamplesAdded() const noexcept           { return numSamplesAdded; }
+
+        /** Writes the peak file for all the audio that was added.
+
+            The file is written to a temporary file which then replaces the target,
+            so a reader will never see a partly-written peak file. Returns true if
+            this succeeded.
+        */
+        bool writeTo (const File& peakFile) const;
+
+    private:
+        struct ChannelLevels;
+        std::vector<ChannelLevels> channels;
+        double sampleRate;
+        int64 hashCode, numSamplesAdded = 0;
+        int samplesPerPeak, numInCurrentPeak = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Builder)
+    };
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        int64 samplesPerPeak;
+        int numPeaks;
+        const Peak* peaks;
+    };
+
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    std::vector<Level> levels;
+    double sampleRate = 0;
+    int64 lengthInSamples = 0, hashCode = 0;
+    int numChannels = 0;
+
+    AudioPeakFile() = default;
+    static Peak combine (const Peak*, int numPeaks, int stride) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPeakFile)
+};
+
+} // namespace juce
@@ -68,4 +68,9 @@ void AudioSubsectionReader::readMaxLevels (int64 startSampleInFile, int64 numSam
     source->readMaxLevels (startSampleInFile + startSample, numSamples, results, numChannelsToRead);
 }
 
+bool AudioSubsectionReader::canReadMaxLevelsQuickly() const
+{
+    return source->canReadMaxLevelsQuickly();
+}
+
 } // namespace juce
@@ -74,6 +74,8 @@ public:
 
     using AudioFormatReader::readMaxLevels;
 
+    bool canReadMaxLevelsQuickly() const override;
+
 private:
     //==============================================================================
     AudioFormatReader* const source;
@@ -0,0 +1,426 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+AudioBlockCache::AudioBlockCache (size_t maxMemoryBytes, int numSamplesPerBlock)
+    : samplesPerBlock (numSamplesPerBlock), maxMemory (maxMemoryBytes)
+{
+    jassert (numSamplesPerBlock > 0);
+}
+
+AudioBlockCache::~AudioBlockCache()
+{
+    clear();
+}
+
+void AudioBlockCache::setMaxMemory (size_t maxMemoryBytes)
+{
+    const ScopedLock sl (lock);
+    maxMemory = maxMemoryBytes;
+    removeExcessBlocks();
+}
+
+size_t AudioBlockCache::getMaxMemory() const noexcept
+{
+    const ScopedLock sl (lock);
+    return maxMemory;
+}
+
+size_t AudioBlockCache::getMemoryUsed() const noexcept
+{
+    const ScopedLock sl (lock);
+    return memoryUsed;
+}
+
+int AudioBlockCache::getNumBlocks() const noexcept
+{
+    const ScopedLock sl (lock);
+    return (int) blocks.size();
+}
+
+void AudioBlockCache::clear()
+{
+    const ScopedLock sl (lock);
+    index.clear();
+    blocks.clear();
+    memoryUsed = 0;
+}
+
+void AudioBlockCache::removeSource (int64 sourceId)
+{
+    const ScopedLock sl (lock);
+
+    for (auto i = index.lower_bound ({ sourceId, std::numeric_limits<int64>::min() });
+         i != index.end() && i->first.first == sourceId;)
+    {
+        memoryUsed -= getBlockSize (**i->second);
+        blocks.erase (i->second);
+        i = index.erase (i);
+    }
+}
+
+void AudioBlockCache::resetStatistics() noexcept
+{
+    numHits = 0;
+    numMisses = 0;
+}
+
+AudioBlockCache::BlockPtr AudioBlockCache::findBlock (int64 sourceId, int64 blockIndex)
+{
+    const ScopedLock sl (lock);
+    auto i = index.find ({ sourceId, blockIndex });
+
+    if (i == index.end())
+        return {};
+
+    // Move the block to the front of the list, to mark it as the most recently used
+    blocks.splice (blocks.begin(), blocks, i->second);
+    return *i->second;
+}
+
+AudioBlockCache::BlockPtr AudioBlockCache::addBlock (BlockPtr newBlock)
+{
+    const ScopedLock sl (lock);
+    Key key { newBlock->sourceId, newBlock->blockIndex };
+    auto i = index.find (key);
+
+    // Another reader for the same source may have got there first
+    if (i != index.end())
+        return *i->second;
+
+    blocks.push_front (newBlock);
+    index[key] = blocks.begin();
+    memoryUsed += getBlockSize (*newBlock);
+    removeExcessBlocks();
+    return newBlock;
+}
+
+void AudioBlockCache::removeExcessBlocks()
+{
+    // Blocks that are still being read from stay alive until the reader lets go of them,
+    // so it's safe to drop them from the cache at any time
+    while (memoryUsed > maxMemory && ! blocks.empty())
+    {
+        auto& oldest = blocks.back();
+        memoryUsed -= getBlockSize (*oldest);
+        index.erase ({ oldest->sourceId, oldest->blockIndex });
+        blocks.pop_back();
+    }
+}
+
+size_t AudioBlockCache::getBlockSize (const Block& b) noexcept
+{
+    return (size_t) b.buffer.getNumChannels() * (size_t) b.buffer.getNumSamples() * sizeof (float);
+}
+
+//==============================================================================
+CachingAudioFormatReader::CachingAudioFormatReader (AudioFormatReader* sourceReader,
+                                                    AudioBlockCache& cacheToUse,
+                                                    int64 sourceIdToUse)
+    : AudioFormatReader (nullptr, sourceReader->getFormatName()),
+      source (sourceReader), cache (cacheToUse), sourceId (sourceIdToUse)
+{
+    sampleRate            = source->sampleRate;
+    lengthInSamples       = source->lengthInSamples;
+    numChannels           = source->numChannels;
+    metadataValues        = source->metadataValues;
+    bitsPerSample         = 32;
+    usesFloatingPointData = true;
+}
+
+CachingAudioFormatReader::~CachingAudioFormatReader() = default;
+
+AudioBlockCache::BlockPtr CachingAudioFormatReader::getBlock (int64 blockIndex)
+{
+    if (auto block = cache.findBlock (sourceId, blockIndex))
+    {
+        ++cache.numHits;
+        return block;
+    }
+
+    const ScopedLock sl (readerLock);
+
+    // Another thread may have decoded this block while we were waiting for the lock
+    if (auto block = cache.findBlock (sourceId, blockIndex))
+    {
+        ++cache.numHits;
+        return block;
+    }
+
+    auto blockSize = cache.getSamplesPerBlock();
+    auto start = blockIndex * blockSize;
+    auto numSamples = (int) jmin ((int64) blockSize, lengthInSamples - start);
+
+    AudioBlockCache::BlockPtr block (new AudioBlockCache::Block (sourceId, blockIndex, (int) numChannels, numSamples));
+    source->read (&block->buffer, 0, numSamples, start, true, true);
+
+    ++cache.numMisses;
+    return cache.addBlock (block);
+}
+
+bool CachingAudioFormatReader::readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                            int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, lengthInSamples);
+
+    auto blockSize = cache.getSamplesPerBlock();
+
+    while (numSamples > 0)
+    {
+        auto blockIndex = startSampleInFile / blockSize;
+        auto block = getBlock (blockIndex);
+        auto offset = (int) (startSampleInFile - blockIndex * blockSize);
+        auto numToDo = jmin (numSamples, block->buffer.getNumSamples() - offset);
+
+        if (numToDo <= 0)
+            break;
+
+        for (int j = 0; j < numDestChannels; ++j)
+        {
+            if (auto* dest = reinterpret_cast<float*> (destSamples[j]))
+            {
+                dest += startOffsetInDestBuffer;
+
+                if (j < (int) numChannels)
+                    FloatVectorOperations::copy (dest, block->buffer.getReadPointer (j, offset), numToDo);
+                else
+                    FloatVectorOperations::clear (dest, numToDo);
+            }
+        }
+
+        startOffsetInDestBuffer += numToDo;
+        startSampleInFile += numToDo;
+        numSamples -= numToDo;
+    }
+
+    return true;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CachingAudioFormatReaderTests  : public UnitTest
+{
+public:
+    CachingAudioFormatReaderTests()
+        : UnitTest ("CachingAudioFormatReader", UnitTestCategories::audio)
+    {}
+
+    // Generates a predictable signal, and counts how much of it has been decoded
+    struct CountingReader  : public AudioFormatReader
+    {
+        CountingReader (int64 length, std::atomic<int64>& counter)
+            : AudioFormatReader (nullptr, "Test"), numSamplesDecoded (counter)
+        {
+            sampleRate            = 44100.0;
+            bitsPerSample         = 32;
+            usesFloatingPointData = true;
+            lengthInSamples       = length;
+            numChannels           = 2;
+        }
+
+        bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                               startSampleInFile, numSamples, lengthInSamples);
+
+            numSamplesDecoded += numSamples;
+
+            for (int j = 0; j < numDestChannels; ++j)
+                if (auto* dest = reinterpret_cast<float*> (destSamples[j]))
+                    for (int i = 0; i < numSamples; ++i)
+                        dest[startOffsetInDestBuffer + i] = getSample (j, startSampleInFile + i);
+
+            return true;
+        }
+
+        static float getSample (int channel, int64 position) noexcept
+        {
+            return (float) ((position * 7 + channel * 1000) % 65536) / 65536.0f;
+        }
+
+        std::atomic<int64>& numSamplesDecoded;
+    };
+
+    bool readMatchesSource (AudioFormatReader& reader, int64 start, int numSamples)
+    {
+        AudioBuffer<float> buffer (2, numSamples);
+        reader.read (&buffer, 0, numSamples, start, true, true);
+
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto pos = start + i;
+                auto inRange = pos >= 0 && pos < reader.lengthInSamples;
+                auto expected = inRange ? CountingReader::getSample (chan, pos) : 0.0f;
+
+                if (buffer.getSample (chan, i) != expected)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    void runTest() override
+    {
+        auto random = getRandom();
+        const int64 length = 100000;
+        const int blockSize = 4096;
+
+        beginTest ("Reads match the source");
+        {
+            std::atomic<int64> numDecoded { 0 };
+            AudioBlockCache cache (1 << 24, blockSize);
+            CachingAudioFormatReader reader (new CountingReader (length, numDecoded), cache, 1);
+
+            expect (readMatchesSource (reader, 0, (int) length));
+            expect (readMatchesSource (reader, -100, 500));
+            expect (readMatchesSource (reader, length - 100, 500));
+
+            for (int i = 0; i < 50; ++i)
+                expect (readMatchesSource (reader, random.nextInt ((int) length), 1 + random.nextInt (20000)));
+        }
+
+        beginTest ("Overlapping subsections decode each block once");
+        {
+            std::atomic<int64> numDecoded { 0 };
+            AudioBlockCache cache (1 << 24, blockSize);
+            CachingAudioFormatReader reader (new CountingReader (length, numDecoded), cache, 1);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                auto start = random.nextInt ((int) length / 2);
+                AudioSubsectionReader region (&reader, start, length / 2, false);
+
+                AudioBuffer<float> buffer (2, (int) region.lengthInSamples);
+                region.read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+                bool matches = true;
+
+                for (int j = 0; j < buffer.getNumSamples(); ++j)
+                    matches = matches && buffer.getSample (1, j) == CountingReader::getSample (1, start + j);
+
+                expect (matches);
+            }
+
+            expectEquals (cache.getNumMisses(), (int64) cache.getNumBlocks());
+            expectLessOrEqual (numDecoded.load(), length);
+            expect (cache.getNumHits() > 0);
+        }
+
+        beginTest ("Readers with the same source ID share blocks");
+        {
+            std::atomic<int64> numDecoded1 { 0 }, numDecoded2 { 0 };
+            AudioBlockCache cache (1 << 24, blockSize);
+            CachingAudioFormatReader reader1 (new CountingReader (length, numDecoded1), cache, 42);
+            CachingAudioFormatReader reader2 (new CountingReader (length, numDecoded2), cache, 42);
+
+            expect (readMatchesSource (reader1, 0, (int) length));
+            expect (readMatchesSource (reader2, 0, (int) length));
+            expectEquals (numDecoded1.load(), length);
+            expectEquals (numDecoded2.load(), (int64) 0);
+
+            cache.removeSource (42);
+            expectEquals (cache.getNumBlocks(), 0);
+            expectEquals (cache.getMemoryUsed(), (size_t) 0);
+
+            expect (readMatchesSource (reader2, 0, 10));
+            expectEquals (numDecoded2.load(), (int64) blockSize);
+        }
+
+        beginTest ("The memory limit is respected");
+        {
+            std::atomic<int64> numDecoded { 0 };
+            const size_t bytesPerBlock = 2 * blockSize * sizeof (float);
+            AudioBlockCache cache (bytesPerBlock * 4, blockSize);
+            CachingAudioFormatReader reader (new CountingReader (length, numDecoded), cache, 1);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                expect (readMatchesSource (reader, random.nextInt ((int) length), 1 + random.nextInt (3 * blockSize)));
+                expectLessOrEqual (cache.getMemoryUsed(), cache.getMaxMemory());
+            }
+
+            // The most recently used block should still be there
+            cache.clear();
+            numDecoded = 0;
+            expect (readMatchesSource (reader, 0, blockSize));
+            expect (readMatchesSource (reader, 0, blockSize));
+            expectEquals (numDecoded.load(), (int64) blockSize);
+
+            cache.setMaxMemory (bytesPerBlock);
+            expectEquals (cache.getNumBlocks(), 1);
+        }
+
+        beginTest ("Reading from several threads");
+        {
+            std::atomic<int64> numDecoded { 0 };
+            AudioBlockCache cache (1 << 24, blockSize);
+            CachingAudioFormatReader reader (new CountingReader (length, numDecoded), cache, 1);
+
+            struct ReaderThread  : public Thread
+            {
+                ReaderThread (CachingAudioFormatReaderTests& t, AudioFormatReader& r, int64 seed)
+                    : Thread ("reader"), test (t), reader (r), random (seed) {}
+
+                void run() override
+                {
+                    for (int i = 0; i < 100; ++i)
+                        if (! test.readMatchesSource (reader, random.nextInt (100000), 1 + random.nextInt (5000)))
+                            ++numFailures;
+                }
+
+                CachingAudioFormatReaderTests& test;
+                AudioFormatReader& reader;
+                Random random;
+                int numFailures = 0;
+            };
+
+            OwnedArray<ReaderThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new ReaderThread (*this, reader, random.nextInt64()))->startThread();
+
+            for (auto* t : threads)
+            {
+                t->stopThread (-1);
+                expectEquals (t->numFailures, 0);
+            }
+
+            expectEquals (cache.getNumMisses(), (int64) cache.getNumBlocks());
+            expectLessOrEqual (numDecoded.load(), length);
+        }
+    }
+};
+
+static CachingAudioFormatReaderTests cachingAudioFormatReaderTests;
+
+#endif
+
+} // namespace juce
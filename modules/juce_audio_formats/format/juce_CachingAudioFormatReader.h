@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pool of decoded audio, shared between a set of CachingAudioFormatReaders.
+
+    The cache holds fixed-size blocks of decoded floating-point samples, keyed by
+    an ID for the audio that they came from and their position in it. When the
+    total size of the blocks goes over the memory limit, the least recently used
+    blocks are thrown away.
+
+    Sharing a cache between all the readers that are used to play or draw clips
+    from the same files means that, however many overlapping regions of a file
+    are being read, each block of it only has to be decoded once.
+
+    The cache is thread-safe, and must outlive all the readers that use it.
+
+    @see CachingAudioFormatReader
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioBlockCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache.
+
+        @param maxMemoryBytes   the amount of decoded audio that the cache can hold
+        @param samplesPerBlock  the number of samples in each block that is decoded
+    */
+    explicit AudioBlockCache (size_t maxMemoryBytes, int samplesPerBlock = 32768);
+
+    /** Destructor. */
+    ~AudioBlockCache();
+
+    //==============================================================================
+    /** Returns the number of samples in each block. */
+    int getSamplesPerBlock() const noexcept             { return samplesPerBlock; }
+
+    /** Changes the amount of memory that the cache can use, discarding blocks if needed. */
+    void setMaxMemory (size_t maxMemoryBytes);
+
+    /** Returns the amount of memory that the cache can use. */
+    size_t getMaxMemory() const noexcept;
+
+    /** Returns the amount of memory that the cached blocks are currently using. */
+    size_t getMemoryUsed() const noexcept;
+
+    /** Returns the number of blocks that are currently cached. */
+    int getNumBlocks() const noexcept;
+
+    /** Discards all the cached blocks. */
+    void clear();
+
+    /** Discards all the cached blocks for a particular source.
+        Call this if the audio with this ID has changed.
+    */
+    void removeSource (int64 sourceId);
+
+    //==============================================================================
+    /** Returns the number of reads that have been satisfied by cached blocks. */
+    int64 getNumHits() const noexcept                   { return numHits; }
+
+    /** Returns the number of blocks that have had to be decoded. */
+    int64 getNumMisses() const noexcept                 { return numMisses; }
+
+    /** Resets the hit and miss counters. */
+    void resetStatistics() noexcept;
+
+private:
+    //==============================================================================
+    friend class CachingAudioFormatReader;
+
+    struct Block  : public ReferenceCountedObject
+    {
+        Block (int64 source, int64 index, int numChannels, int numSamples)
+            : sourceId (source), blockIndex (index), buffer (numChannels, numSamples) {}
+
+        const int64 sourceId, blockIndex;
+        AudioBuffer<float> buffer;
+    };
+
+    using BlockPtr = ReferenceCountedObjectPtr<Block>;
+    using Key = std::pair<int64, int64>;
+
+    BlockPtr findBlock (int64 sourceId, int64 blockIndex);
+    BlockPtr addBlock (BlockPtr);
+    void removeExcessBlocks();
+    static size_t getBlockSize (const Block&) noexcept;
+
+    const int samplesPerBlock;
+    size_t maxMemory, memoryUsed = 0;
+    std::list<BlockPtr> blocks; // most recently used first
+    std::map<Key, std::list<BlockPtr>::iterator> index;
+    CriticalSection lock;
+    std::atomic<int64> numHits { 0 }, numMisses { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioBlockCache)
+};
+
+//==============================================================================
+/**
+    An AudioFormatReader that decodes its source in blocks, and keeps them in a
+    shared AudioBlockCache.
+
+    Reads that land on blocks which are already in the cache just copy the samples
+    out of it, without touching the source reader, so any number of threads and
+    AudioSubsectionReaders can read from the same CachingAudioFormatReader at once.
+    Readers for the same audio can also share blocks by using the same cache and
+    source ID, even if they have separate source readers.
+
+    @see AudioBlockCache, AudioSubsectionReader
+
+    @tags{Audio}
+*/
+class JUCE_API  CachingAudioFormatReader  : public AudioFormatReader
+{
+public:
+    /** Creates a reader.
+
+        @param sourceReader     the reader to decode blocks from. This object will
+                                take ownership of it, and delete it later when no
+                                longer needed
+        @param cacheToUse       the cache to keep the decoded blocks in. This must
+                                not be deleted while the reader still exists
+        @param sourceId         identifies the audio that the source reader reads,
+                                e.g. the hash code of its InputSource. All the readers
+                                that use the same cache and ID must read the same audio
+    */
+    CachingAudioFormatReader (AudioFormatReader* sourceReader,
+                              AudioBlockCache& cacheToUse,
+                              int64 sourceId);
+
+    /** Destructor. */
+    ~CachingAudioFormatReader() override;
+
+    /** Returns the ID that is used to identify this reader's blocks in the cache. */
+    int64 getSourceId() const noexcept                  { return sourceId; }
+
+    //==============================================================================
+    bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples) override;
+
+private:
+    AudioBlockCache::BlockPtr getBlock (int64 blockIndex);
+
+    std::unique_ptr<AudioFormatReader> source;
+    AudioBlockCache& cache;
+    const int64 sourceId;
+    CriticalSection readerLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachingAudioFormatReader)
+};
+
+} // namespace juce
@@ -59,6 +59,9 @@
 #include "format/juce_AudioFormatWriter.cpp"
 #include "format/juce_AudioSubsectionReader.cpp"
 #include "format/juce_BufferingAudioFormatReader.cpp"
+#include "format/juce_CachingAudioFormatReader.cpp"
+#include "format/juce_AudioFileBatchDecoder.cpp"
+#include "format/juce_AudioPeakFile.cpp"
 #include "sampler/juce_Sampler.cpp"
 #include "codecs/juce_AiffAudioFormat.cpp"
 #include "codecs/juce_CoreAudioFormat.cpp"
@@ -119,6 +119,9 @@
 #include "format/juce_AudioFormatReaderSource.h"
 #include "format/juce_AudioSubsectionReader.h"
 #include "format/juce_BufferingAudioFormatReader.h"
+#include "format/juce_CachingAudioFormatReader.h"
+#include "format/juce_AudioFileBatchDecoder.h"
+#include "format/juce_AudioPeakFile.h"
 #include "codecs/juce_AiffAudioFormat.h"
 #include "codecs/juce_CoreAudioFormat.h"
 #include "codecs/juce_FlacAudioFormat.h"
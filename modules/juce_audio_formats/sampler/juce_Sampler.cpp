@@ -26,6 +26,251 @@
 namespace juce
 {
 
+//==============================================================================
+struct SamplerDiskStreamer::Stream
+{
+    Stream (int numChannels, int bufferSize)
+        : buffer (numChannels, bufferSize)
+    {
+        buffer.clear();
+    }
+
+    // The generation of the note being played is packed alongside the end of the valid
+    // data, so a read that finishes after the voice has restarted can't publish stale data
+    static uint64 makeState (uint32 generation, int64 validEnd) noexcept   { return ((uint64) (generation & 0xffff) << 48) | (uint64) validEnd; }
+    static uint32 getGeneration (uint64 state) noexcept                    { return (uint32) (state >> 48); }
+    static int64 getValidEnd (uint64 state) noexcept                       { return (int64) (state & ((((uint64) 1) << 48) - 1)); }
+
+    AudioBuffer<float> buffer;
+    std::atomic<SamplerSound*> sound { nullptr };
+    std::atomic<uint64> state { 0 };
+    std::atomic<int64> readPosition { 0 }, startTime { 0 };
+    bool isBeingFilled = false; // guarded by the streamer's lock
+};
+
+//==============================================================================
+class SamplerDiskStreamer::ReaderThread  : public Thread
+{
+public:
+    explicit ReaderThread (SamplerDiskStreamer& s)
+        : Thread ("Sampler disk streamer"), owner (s)
+    {
+        startThread (7);
+    }
+
+    ~ReaderThread() override
+    {
+        stopThread (5000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (owner.serviceNextRead())
+                continue;
+
+            // Signalling an event would mean taking a lock on the audio thread, so voices
+            // only set a flag, and the threads poll for it
+            if (! owner.readRequested.exchange (false))
+                wait (pollIntervalMs);
+        }
+    }
+
+    static constexpr int pollIntervalMs = 2;
+
+private:
+    SamplerDiskStreamer& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (ReaderThread)
+};
+
+//==============================================================================
+SamplerDiskStreamer::SamplerDiskStreamer (int numThreads, int maxReads, int maxSamplesPerRead)
+    : maxQueuedReads (jmax (1, maxReads)),
+      samplesPerRead (jmax (256, maxSamplesPerRead))
+{
+    queue.ensureStorageAllocated (maxQueuedReads);
+
+    for (int i = 0; i < numThreads; ++i)
+        threads.add (new ReaderThread (*this));
+}
+
+SamplerDiskStreamer::~SamplerDiskStreamer()
+{
+    threads.clear();
+
+    // All the sounds and voices using this streamer must be deleted before it is!
+    jassert (sounds.isEmpty() && streams.isEmpty());
+}
+
+void SamplerDiskStreamer::addSound (SamplerSound* sound)
+{
+    const ScopedLock sl (lock);
+    sounds.add (sound);
+}
+
+void SamplerDiskStreamer::removeSound (SamplerSound* sound)
+{
+    {
+        const ScopedLock sl (lock);
+        sounds.removeFirstMatchingValue (sound);
+    }
+
+    // wait for any read that's still using the sound's reader
+    const ScopedLock sl (sound->readerLock);
+}
+
+void SamplerDiskStreamer::addStream (Stream* stream)
+{
+    const ScopedLock sl (lock);
+    streams.add (stream);
+}
+
+void SamplerDiskStreamer::removeStream (Stream* stream)
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (! stream->isBeingFilled)
+            {
+                streams.removeFirstMatchingValue (stream);
+                return;
+            }
+        }
+
+        Thread::sleep (1);
+    }
+}
+
+bool SamplerDiskStreamer::isReadPending() const
+{
+    const ScopedLock sl (lock);
+
+    for (auto* stream : streams)
+    {
+        if (stream->isBeingFilled)
+            return true;
+
+        if (auto* sound = stream->sound.load())
+            if (sounds.contains (sound) && needsReading (*stream, *sound))
+                return true;
+    }
+
+    return false;
+}
+
+bool SamplerDiskStreamer::needsReading (const Stream& stream, const SamplerSound& sound) const noexcept
+{
+    auto validEnd = Stream::getValidEnd (stream.state.load());
+    auto endOfSound = (int64) sound.length + 4;
+
+    if (validEnd >= endOfSound)
+        return false;
+
+    // avoid lots of tiny reads when the buffer is already almost full
+    auto space = stream.readPosition.load() + stream.buffer.getNumSamples() - 2 - validEnd;
+    return space >= jmin ((int64) samplesPerRead / 4, endOfSound - validEnd);
+}
+
+void SamplerDiskStreamer::fillQueue()
+{
+    for (auto* stream : streams)
+    {
+        if (stream->isBeingFilled)
+            continue;
+
+        if (auto* sound = stream->sound.load())
+            if (sounds.contains (sound) && needsReading (*stream, *sound))
+                queue.add ({ stream, Stream::getGeneration (stream->state.load()), stream->startTime.load() });
+    }
+
+    // The voices that started first will be the first to run out of preloaded audio
+    std::sort (queue.begin(), queue.end(),
+               [] (const Request& a, const Request& b) { return a.startTime < b.startTime; });
+
+    if (queue.size() > maxQueuedReads)
+        queue.removeLast (queue.size() - maxQueuedReads);
+}
+
+bool SamplerDiskStreamer::serviceNextRead()
+{
+    Stream* stream = nullptr;
+    SamplerSound* sound = nullptr;
+    uint32 generation = 0;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (queue.isEmpty())
+            fillQueue();
+
+        while (stream == nullptr && ! queue.isEmpty())
+        {
+            auto request = queue.removeAndReturn (0);
+            auto* candidate = request.stream;
+
+            if (! streams.contains (candidate) || candidate->isBeingFilled)
+                continue;
+
+            auto* candidateSound = candidate->sound.load();
+
+            if (candidateSound == nullptr
+                 || ! sounds.contains (candidateSound)
+                 || Stream::getGeneration (candidate->state.load()) != request.generation
+                 || ! needsReading (*candidate, *candidateSound)
+                 || ! candidateSound->readerLock.tryEnter())
+                continue;
+
+            stream = candidate;
+            sound = candidateSound;
+            generation = request.generation;
+            stream->isBeingFilled = true;
+        }
+    }
+
+    if (stream == nullptr)
+        return false;
+
+    readIntoStream (*stream, *sound, generation);
+    sound->readerLock.exit();
+
+    const ScopedLock sl (lock);
+    stream->isBeingFilled = false;
+    return true;
+}
+
+void SamplerDiskStreamer::readIntoStream (Stream& stream, SamplerSound& sound, uint32 generation)
+{
+    auto oldState = stream.state.load (std::memory_order_acquire);
+
+    if (Stream::getGeneration (oldState) != generation)
+        return;
+
+    auto validEnd = Stream::getValidEnd (oldState);
+    auto bufferSize = stream.buffer.getNumSamples();
+
+    auto endOfRead = jmin ((int64) sound.length + 4,
+                           stream.readPosition.load() + bufferSize - 2,
+                           validEnd + samplesPerRead);
+
+    for (auto pos = validEnd; pos < endOfRead;)
+    {
+        auto bufferPos = (int) (pos % bufferSize);
+        auto numThisTime = (int) jmin (endOfRead - pos, (int64) (bufferSize - bufferPos));
+
+        sound.streamReader->read (&stream.buffer, bufferPos, numThisTime, pos, true, true);
+        pos += numThisTime;
+    }
+
+    // If the voice has started a new note in the meantime, this will fail and the data is ignored
+    stream.state.compare_exchange_strong (oldState, Stream::makeState (Stream::getGeneration (oldState), endOfRead),
+                                          std::memory_order_release);
+}
+
+//==============================================================================
 SamplerSound::SamplerSound (const String& soundName,
                             AudioFormatReader& source,
                             const BigInteger& notes,
@@ -43,17 +288,58 @@ SamplerSound::SamplerSound (const String& soundName,
         length = jmin ((int) source.lengthInSamples,
                        (int) (maxSampleLengthSeconds * sourceSampleRate));
 
-        data.reset (new AudioBuffer<float> (jmin (2, (int) source.numChannels), length + 4));
+        numPreloadedSamples = length + 4;
+        data.reset (new AudioBuffer<float> (jmin (2, (int) source.numChannels), numPreloadedSamples));
 
-        source.read (data.get(), 0, length + 4, 0, true, true);
+        source.read (data.get(), 0, numPreloadedSamples, 0, true, true);
 
         params.attack  = static_cast<float> (attackTimeSecs);
         params.release = static_cast<float> (releaseTimeSecs);
     }
 }
 
+SamplerSound::SamplerSound (const String& soundName,
+                            std::unique_ptr<AudioFormatReader> source,
+                            SamplerDiskStreamer& streamerToUse,
+                            const BigInteger& notes,
+                            int midiNoteForNormalPitch,
+                            double attackTimeSecs,
+                            double releaseTimeSecs,
+                            double maxSampleLengthSeconds,
+                            double preloadSeconds)
+    : name (soundName),
+      sourceSampleRate (source != nullptr ? source->sampleRate : 0.0),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch),
+      streamReader (std::move (source)),
+      streamer (&streamerToUse)
+{
+    jassert (streamReader != nullptr);
+
+    if (sourceSampleRate > 0 && streamReader->lengthInSamples > 0)
+    {
+        if (auto* mapped = dynamic_cast<MemoryMappedAudioFormatReader*> (streamReader.get()))
+            mapped->mapEntireFile();
+
+        length = jmin ((int) streamReader->lengthInSamples,
+                       (int) (maxSampleLengthSeconds * sourceSampleRate));
+
+        numPreloadedSamples = jmin (length + 4, jmax (0, (int) (preloadSeconds * sourceSampleRate)));
+        data.reset (new AudioBuffer<float> (jmin (2, (int) streamReader->numChannels), numPreloadedSamples));
+
+        streamReader->read (data.get(), 0, numPreloadedSamples, 0, true, true);
+
+        params.attack  = static_cast<float> (attackTimeSecs);
+        params.release = static_cast<float> (releaseTimeSecs);
+    }
+
+    streamer->addSound (this);
+}
+
 SamplerSound::~SamplerSound()
 {
+    if (streamer != nullptr)
+        streamer->removeSound (this);
 }
 
 bool SamplerSound::appliesToNote (int midiNoteNumber)
@@ -68,16 +354,31 @@ bool SamplerSound::appliesToChannel (int /*midiChannel*/)
 
 //==============================================================================
 SamplerVoice::SamplerVoice() {}
-SamplerVoice::~SamplerVoice() {}
+
+SamplerVoice::SamplerVoice (SamplerDiskStreamer& streamerToUse, int streamBufferSize)
+    : streamer (&streamerToUse),
+      stream (new SamplerDiskStreamer::Stream (2, jmax (streamBufferSize, 1024)))
+{
+    streamer->addStream (stream.get());
+}
+
+SamplerVoice::~SamplerVoice()
+{
+    if (streamer != nullptr)
+        streamer->removeStream (stream.get());
+}
 
 bool SamplerVoice::canPlaySound (SynthesiserSound* sound)
 {
-    return dynamic_cast<const SamplerSound*> (sound) != nullptr;
+    if (auto* samplerSound = dynamic_cast<const SamplerSound*> (sound))
+        return samplerSound->streamer == nullptr || samplerSound->streamer == streamer;
+
+    return false;
 }
 
 void SamplerVoice::startNote (int midiNoteNumber, float velocity, SynthesiserSound* s, int /*currentPitchWheelPosition*/)
 {
-    if (auto* sound = dynamic_cast<const SamplerSound*> (s))
+    if (auto* sound = dynamic_cast<SamplerSound*> (s))
     {
         pitchRatio = std::pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
                         * sound->sourceSampleRate / getSampleRate();
@@ -90,6 +391,22 @@ void SamplerVoice::startNote (int midiNoteNumber, float velocity, SynthesiserSou
         adsr.setParameters (sound->params);
 
         adsr.noteOn();
+
+        if (stream != nullptr)
+        {
+            auto generation = SamplerDiskStreamer::Stream::getGeneration (stream->state.load()) + 1;
+
+            stream->sound = nullptr;
+            stream->readPosition = 0;
+            stream->state = SamplerDiskStreamer::Stream::makeState (generation, sound->numPreloadedSamples);
+
+            if (sound->isStreaming())
+            {
+                stream->startTime = streamer->nextStartTime++;
+                stream->sound = sound;
+                streamer->notify();
+            }
+        }
     }
     else
     {
@@ -105,6 +422,9 @@ void SamplerVoice::stopNote (float /*velocity*/, bool allowTailOff)
     }
     else
     {
+        if (stream != nullptr)
+            stream->sound = nullptr;
+
         clearCurrentNote();
         adsr.reset();
     }
@@ -114,52 +434,305 @@ void SamplerVoice::pitchWheelMoved (int /*newValue*/) {}
 void SamplerVoice::controllerMoved (int /*controllerNumber*/, int /*newValue*/) {}
 
 //==============================================================================
+namespace SamplerHelpers
+{
+    struct InMemorySource
+    {
+        explicit InMemorySource (const AudioBuffer<float>& data)
+            : left (data.getReadPointer (0)),
+              right (data.getNumChannels() > 1 ? data.getReadPointer (1) : nullptr)
+        {}
+
+        bool isStereo() const noexcept                  { return right != nullptr; }
+        float getLeft (int64 index) const noexcept      { return left[index]; }
+        float getRight (int64 index) const noexcept     { return right[index]; }
+
+        const float* left;
+        const float* right;
+    };
+
+    /*  Reads from the preloaded head of a sound, and then from the part of the
+        voice's ring buffer which the streamer has filled.
+    */
+    struct StreamingSource
+    {
+        StreamingSource (const AudioBuffer<float>& head, const AudioBuffer<float>& ring, int64 validEndOfRing)
+            : headLeft (head.getNumSamples() > 0 ? head.getReadPointer (0) : nullptr),
+              headRight (head.getNumSamples() > 0 && head.getNumChannels() > 1 ? head.getReadPointer (1) : nullptr),
+              ringLeft (ring.getReadPointer (0)),
+              ringRight (ring.getReadPointer (1)),
+              headSize (head.getNumSamples()),
+              ringSize (ring.getNumSamples()),
+              validEnd (validEndOfRing),
+              stereo (head.getNumChannels() > 1)
+        {}
+
+        bool isStereo() const noexcept                  { return stereo; }
+        float getLeft (int64 index) const noexcept      { return get (headLeft, ringLeft, index); }
+        float getRight (int64 index) const noexcept     { return get (headRight, ringRight, index); }
+
+        float get (const float* head, const float* ring, int64 index) const noexcept
+        {
+            if (index < headSize)
+                return head[index];
+
+            if (index < validEnd)
+                return ring[index % ringSize];
+
+            hasUnderrun = true;
+            return 0.0f;
+        }
+
+        const float* headLeft;
+        const float* headRight;
+        const float* ringLeft;
+        const float* ringRight;
+        int64 headSize, ringSize, validEnd;
+        bool stereo;
+        mutable bool hasUnderrun = false;
+    };
+}
+
+//==============================================================================
+template <typename SampleSource>
+bool SamplerVoice::renderSamples (const SampleSource& source, const SamplerSound& sound,
+                                  AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    float* outL = outputBuffer.getWritePointer (0, startSample);
+    float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+
+    while (--numSamples >= 0)
+    {
+        auto pos = (int) sourceSamplePosition;
+        auto alpha = (float) (sourceSamplePosition - pos);
+        auto invAlpha = 1.0f - alpha;
+
+        // just using a very simple linear interpolation here..
+        float l = (source.getLeft (pos) * invAlpha + source.getLeft (pos + 1) * alpha);
+        float r = source.isStereo() ? (source.getRight (pos) * invAlpha + source.getRight (pos + 1) * alpha)
+                                    : l;
+
+        auto envelopeValue = adsr.getNextSample();
+
+        l *= lgain * envelopeValue;
+        r *= rgain * envelopeValue;
+
+        if (outR != nullptr)
+        {
+            *outL++ += l;
+            *outR++ += r;
+        }
+        else
+        {
+            *outL++ += (l + r) * 0.5f;
+        }
+
+        sourceSamplePosition += pitchRatio;
+
+        if (sourceSamplePosition > sound.length)
+        {
+            stopNote (0.0f, false);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void SamplerVoice::renderNextBlock (AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
 {
     if (auto* playingSound = static_cast<SamplerSound*> (getCurrentlyPlayingSound().get()))
     {
-        auto& data = *playingSound->data;
-        const float* const inL = data.getReadPointer (0);
-        const float* const inR = data.getNumChannels() > 1 ? data.getReadPointer (1) : nullptr;
+        if (! playingSound->isStreaming())
+        {
+            renderSamples (SamplerHelpers::InMemorySource (*playingSound->data),
+                           *playingSound, outputBuffer, startSample, numSamples);
+            return;
+        }
+
+        auto validEnd = SamplerDiskStreamer::Stream::getValidEnd (stream->state.load (std::memory_order_acquire));
+        SamplerHelpers::StreamingSource source (*playingSound->data, stream->buffer, validEnd);
+
+        if (renderSamples (source, *playingSound, outputBuffer, startSample, numSamples))
+        {
+            auto position = (int64) sourceSamplePosition;
+            stream->readPosition.store (position);
+
+            // wake the streamer once a decent amount of the ring has been used up
+            if (validEnd - position < stream->buffer.getNumSamples() / 2 && validEnd < playingSound->length + 4)
+                streamer->notify();
+        }
+
+        if (source.hasUnderrun)
+            ++(streamer->numUnderruns);
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SamplerStreamingTests  : public UnitTest
+{
+public:
+    SamplerStreamingTests()
+        : UnitTest ("Sampler streaming", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        constexpr int numSamples = 20000, blockSize = 256;
+
+        AudioBuffer<float> source (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            source.setSample (0, i, std::sin ((float) i * 0.01f) * 0.5f);
+            source.setSample (1, i, std::cos ((float) i * 0.003f) * 0.5f);
+        }
+
+        MemoryBlock wavData;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (WavAudioFormat().createWriterFor (new MemoryOutputStream (wavData, false),
+                                                                                         44100.0, 2, 24, {}, 0));
+            writer->writeFromAudioSampleBuffer (source, 0, numSamples);
+        }
+
+        auto createReader = [&wavData]
+        {
+            return std::unique_ptr<AudioFormatReader> (WavAudioFormat().createReaderFor (new MemoryInputStream (wavData, false), true));
+        };
 
-        float* outL = outputBuffer.getWritePointer (0, startSample);
-        float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+        BigInteger notes;
+        notes.setRange (0, 128, true);
 
-        while (--numSamples >= 0)
+        auto renderNote = [&] (Synthesiser& synth, SamplerDiskStreamer* streamer, int numBlocks)
         {
-            auto pos = (int) sourceSamplePosition;
-            auto alpha = (float) (sourceSamplePosition - pos);
-            auto invAlpha = 1.0f - alpha;
+            AudioBuffer<float> output (2, numBlocks * blockSize);
+            output.clear();
+
+            synth.setCurrentPlaybackSampleRate (44100.0);
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                if (streamer != nullptr)
+                    while (streamer->serviceNextRead()) {}
+
+                MidiBuffer midi;
 
-            // just using a very simple linear interpolation here..
-            float l = (inL[pos] * invAlpha + inL[pos + 1] * alpha);
-            float r = (inR != nullptr) ? (inR[pos] * invAlpha + inR[pos + 1] * alpha)
-                                       : l;
+                if (block == 0)
+                    midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 0);
 
-            auto envelopeValue = adsr.getNextSample();
+                synth.renderNextBlock (output, midi, block * blockSize, blockSize);
+            }
+
+            return output;
+        };
+
+        AudioBuffer<float> reference;
+
+        {
+            Synthesiser synth;
+            synth.addVoice (new SamplerVoice());
+
+            auto reader = createReader();
+            synth.addSound (new SamplerSound ("ref", *reader, notes, 60, 0.0, 0.1, 10.0));
+            reference = renderNote (synth, nullptr, numSamples / blockSize);
+        }
 
-            l *= lgain * envelopeValue;
-            r *= rgain * envelopeValue;
+        beginTest ("Streamed sounds play the same audio as preloaded sounds");
+        {
+            SamplerDiskStreamer streamer (0, 4, 1024);
 
-            if (outR != nullptr)
             {
-                *outL++ += l;
-                *outR++ += r;
+                Synthesiser synth;
+                synth.addVoice (new SamplerVoice (streamer, 4096));
+                synth.addSound (new SamplerSound ("streamed", createReader(), streamer, notes, 60, 0.0, 0.1, 10.0, 0.01));
+
+                auto output = renderNote (synth, &streamer, numSamples / blockSize);
+
+                for (int channel = 0; channel < 2; ++channel)
+                    for (int i = 0; i < output.getNumSamples(); ++i)
+                        expectEquals (output.getSample (channel, i), reference.getSample (channel, i));
             }
-            else
+
+            expectEquals (streamer.getNumUnderruns(), 0);
+        }
+
+        beginTest ("Streaming voices can play sounds held in memory");
+        {
+            SamplerDiskStreamer streamer (0);
+
+            Synthesiser synth;
+            synth.addVoice (new SamplerVoice (streamer));
+
+            auto reader = createReader();
+            synth.addSound (new SamplerSound ("ref", *reader, notes, 60, 0.0, 0.1, 10.0));
+
+            auto output = renderNote (synth, nullptr, 8);
+
+            for (int i = 0; i < output.getNumSamples(); ++i)
+                expectEquals (output.getSample (0, i), reference.getSample (0, i));
+        }
+
+        beginTest ("Voices which run out of streamed audio play silence");
+        {
+            SamplerDiskStreamer streamer (0);
+
             {
-                *outL++ += (l + r) * 0.5f;
+                Synthesiser synth;
+                synth.addVoice (new SamplerVoice (streamer));
+                synth.addSound (new SamplerSound ("streamed", createReader(), streamer, notes, 60, 0.0, 0.1, 10.0, 0.01));
+
+                // nothing is servicing the streamer, so only the preloaded head is available
+                auto output = renderNote (synth, nullptr, 8);
+                expect (output.getMagnitude (0, 0, 256) > 0.0f);
+                expectEquals (output.getMagnitude (0, 1024, 1024), 0.0f);
             }
 
-            sourceSamplePosition += pitchRatio;
+            expect (streamer.getNumUnderruns() > 0);
+        }
+
+        beginTest ("Background threads keep voices supplied");
+        {
+            SamplerDiskStreamer streamer (2);
 
-            if (sourceSamplePosition > playingSound->length)
             {
-                stopNote (0.0f, false);
-                break;
+                Synthesiser synth;
+
+                for (int i = 0; i < 4; ++i)
+                    synth.addVoice (new SamplerVoice (streamer, 16384));
+
+                synth.addSound (new SamplerSound ("streamed", createReader(), streamer, notes, 60, 0.0, 0.1, 10.0, 0.1));
+                synth.setCurrentPlaybackSampleRate (44100.0);
+
+                AudioBuffer<float> output (2, blockSize);
+
+                for (int block = 0; block < numSamples / blockSize; ++block)
+                {
+                    MidiBuffer midi;
+
+                    if (block % 8 == 0)
+                        midi.addEvent (MidiMessage::noteOn (1, 60 + (block / 8) % 4, 1.0f), 0);
+
+                    synth.renderNextBlock (output, midi, 0, blockSize);
+
+                    // Wait for the threads to catch up, as they would between real-time callbacks
+                    // (the timeout is only there so that a broken streamer can't hang the tests)
+                    for (int i = 0; i < 10000 && streamer.isReadPending(); ++i)
+                        Thread::sleep (1);
+
+                    expect (! streamer.isReadPending());
+                }
             }
+
+            expectEquals (streamer.getNumUnderruns(), 0);
         }
     }
-}
+};
+
+static SamplerStreamingTests samplerStreamingTests;
+
+#endif
 
 } // namespace juce
@@ -26,12 +26,111 @@
 namespace juce
 {
 
+class SamplerSound;
+class SamplerVoice;
+
+//==============================================================================
+/**
+    Streams the audio for SamplerSounds from disk while they're being played.
+
+    A streaming SamplerSound only keeps the start of its sample in memory. When a
+    SamplerVoice that was created with a streamer starts playing one, the voice
+    plays from that preloaded head while the streamer's background threads read
+    the rest of the sample into a ring buffer belonging to the voice.
+
+    The streamer keeps a bounded queue of reads. When it refills the queue, the
+    voices that started earliest come first, as they're the ones that will run
+    out of preloaded audio soonest. The audio thread never blocks on the streamer:
+    it just sets a flag that the background threads check every few milliseconds, and
+    if a voice's buffer runs dry, it plays silence and the underrun is counted.
+
+    The streamer must outlive all the sounds and voices that use it.
+
+    @see SamplerSound, SamplerVoice
+
+    @tags{Audio}
+*/
+class JUCE_API  SamplerDiskStreamer
+{
+public:
+    //==============================================================================
+    /** Creates a streamer.
+
+        @param numThreads       the number of background threads to read with. If this
+                                is 0, no threads are started and you must call
+                                serviceNextRead() yourself, e.g. when rendering offline
+        @param maxQueuedReads   the maximum number of reads that are scheduled at once
+        @param samplesPerRead   the largest number of samples that will be read from a
+                                sound's reader in one go
+    */
+    explicit SamplerDiskStreamer (int numThreads = 1,
+                                  int maxQueuedReads = 32,
+                                  int samplesPerRead = 8192);
+
+    /** Destructor. */
+    ~SamplerDiskStreamer();
+
+    //==============================================================================
+    /** Performs the most urgent pending read on the calling thread.
+        Returns false if none of the voices needed any more audio.
+    */
+    bool serviceNextRead();
+
+    /** Returns true if any of the voices need more audio, or a read is in progress.
+
+        When rendering offline with background threads, you can use this to wait for
+        them to catch up before rendering the next block.
+    */
+    bool isReadPending() const;
+
+    /** Returns the number of times that a voice ran out of streamed audio. */
+    int getNumUnderruns() const noexcept            { return numUnderruns.load(); }
+
+private:
+    //==============================================================================
+    friend class SamplerSound;
+    friend class SamplerVoice;
+
+    struct Stream;
+    class ReaderThread;
+
+    struct Request
+    {
+        Stream* stream;
+        uint32 generation;
+        int64 startTime;
+    };
+
+    void addSound (SamplerSound*);
+    void removeSound (SamplerSound*);
+    void addStream (Stream*);
+    void removeStream (Stream*);
+    void fillQueue();
+    bool needsReading (const Stream&, const SamplerSound&) const noexcept;
+    void readIntoStream (Stream&, SamplerSound&, uint32 generation);
+    void notify() noexcept                          { readRequested.store (true); }
+
+    CriticalSection lock;
+    Array<SamplerSound*> sounds;
+    Array<Stream*> streams;
+    Array<Request> queue;
+    OwnedArray<ReaderThread> threads;
+    std::atomic<bool> readRequested { false };
+    std::atomic<int64> nextStartTime { 0 };
+    std::atomic<int> numUnderruns { 0 };
+    const int maxQueuedReads, samplesPerRead;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerDiskStreamer)
+};
+
 //==============================================================================
 /**
     A subclass of SynthesiserSound that represents a sampled audio clip.
 
-    This is a pretty basic sampler, and just attempts to load the whole audio stream
-    into memory.
+    This is a pretty basic sampler. By default it just attempts to load the whole audio
+    stream into memory, but it can also stream the sample from disk, in which case only
+    the first part of it is loaded, and the rest is read by a SamplerDiskStreamer as
+    the sound plays.
 
     To use it, create a Synthesiser, add some SamplerVoice objects to it, then
     give it some SampledSound objects to play.
@@ -70,6 +169,38 @@ public:
                   double releaseTimeSecs,
                   double maxSampleLengthSeconds);
 
+    /** Creates a sampled sound which streams its audio from disk.
+
+        Only the first preloadSeconds of the audio are loaded into memory. The reader is
+        kept open, and the rest of the audio is read from it by the streamer when the
+        sound is played by a SamplerVoice that uses the same streamer.
+
+        Passing a MemoryMappedAudioFormatReader (see AudioFormat::createMemoryMappedReader)
+        lets the streamer copy straight out of the mapped file instead of going through
+        the format's stream.
+
+        @param name         a name for the sample
+        @param source       the reader to stream the audio from
+        @param streamer     the streamer that will read the audio. This must outlive the sound
+        @param midiNotes    the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param maxSampleLengthSeconds   a maximum length of audio to read from the audio
+                                        source, in seconds
+        @param preloadSeconds   the length of audio to keep in memory, in seconds
+    */
+    SamplerSound (const String& name,
+                  std::unique_ptr<AudioFormatReader> source,
+                  SamplerDiskStreamer& streamer,
+                  const BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  double maxSampleLengthSeconds,
+                  double preloadSeconds = 0.5);
+
     /** Destructor. */
     ~SamplerSound() override;
 
@@ -79,9 +210,13 @@ public:
 
     /** Returns the audio sample data.
         This could return nullptr if there was a problem loading the data.
+        If the sound is streamed, this only contains the preloaded part of the sample.
     */
     AudioBuffer<float>* getAudioData() const noexcept       { return data.get(); }
 
+    /** Returns true if this sound streams its audio from disk. */
+    bool isStreaming() const noexcept                       { return streamer != nullptr; }
+
     //==============================================================================
     /** Changes the parameters of the ADSR envelope which will be applied to the sample. */
     void setEnvelopeParameters (ADSR::Parameters parametersToUse)    { params = parametersToUse; }
@@ -94,11 +229,17 @@ private:
     //==============================================================================
     friend class SamplerVoice;
 
+    friend class SamplerDiskStreamer;
+
     String name;
     std::unique_ptr<AudioBuffer<float>> data;
     double sourceSampleRate;
     BigInteger midiNotes;
-    int length = 0, midiRootNote = 0;
+    int length = 0, midiRootNote = 0, numPreloadedSamples = 0;
+
+    std::unique_ptr<AudioFormatReader> streamReader;
+    SamplerDiskStreamer* streamer = nullptr;
+    CriticalSection readerLock;
 
     ADSR::Parameters params;
 
@@ -121,9 +262,18 @@ class JUCE_API  SamplerVoice    : public SynthesiserVoice
 {
 public:
     //==============================================================================
-    /** Creates a SamplerVoice. */
+    /** Creates a SamplerVoice, which can only play sounds that are held in memory. */
     SamplerVoice();
 
+    /** Creates a SamplerVoice which can also play sounds that are streamed by the given streamer.
+
+        @param streamer             the streamer that will read audio for this voice. This
+                                    must outlive the voice
+        @param streamBufferSize     the size of the voice's ring buffer, in samples. This
+                                    should be a good deal larger than the streamer's read size
+    */
+    explicit SamplerVoice (SamplerDiskStreamer& streamer, int streamBufferSize = 65536);
+
     /** Destructor. */
     ~SamplerVoice() override;
 
@@ -147,6 +297,12 @@ private:
 
     ADSR adsr;
 
+    SamplerDiskStreamer* streamer = nullptr;
+    std::unique_ptr<SamplerDiskStreamer::Stream> stream;
+
+    template <typename SampleSource>
+    bool renderSamples (const SampleSource&, const SamplerSound&, AudioBuffer<float>&, int startSample, int numSamples);
+
     JUCE_LEAK_DETECTOR (SamplerVoice)
 };
 
@@ -1533,6 +1533,8 @@ namespace AAXClasses
                     }
                 }
 
+                const ScopedNoAllocation noAllocation ("AAX process");
+
                 if (bypass && pluginInstance->getBypassParameter() == nullptr)
                     pluginInstance->processBlockBypassed (buffer, midiBuffer);
                 else
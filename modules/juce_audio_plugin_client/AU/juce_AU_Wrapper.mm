@@ -1688,6 +1688,7 @@ private:
     void processBlock (juce::AudioBuffer<float>& buffer, MidiBuffer& midiBuffer) noexcept
     {
         const ScopedLock sl (juceFilter->getCallbackLock());
+        const ScopedNoAllocation noAllocation ("AU processBlock");
 
         if (juceFilter->isSuspended())
         {
@@ -1423,6 +1423,19 @@ private:
                     if (auto* p = getJuceParameterForAUAddress (paramEvent.parameterAddress))
                     {
                         auto normalisedValue = paramEvent.value / getMaximumParameterValue (p);
+
+                        if (getAudioProcessor().isParameterAutomationEnabled())
+                        {
+                            // A ramp reaches its value at the end of its duration, which may lie in a later block
+                            auto position = paramEvent.eventSampleTime - startTime;
+
+                            if (event->head.eventType == AURenderEventParameterRamp)
+                                position += (AUEventSampleTime) paramEvent.rampDurationSampleFrames;
+
+                            position = jlimit ((AUEventSampleTime) 0, (AUEventSampleTime) std::numeric_limits<int>::max(), position);
+                            getAudioProcessor().getParameterAutomation().addPoint (p->getParameterIndex(), static_cast<int> (position), normalisedValue);
+                        }
+
                         setAudioProcessorParameter (p, normalisedValue);
                     }
                 }
@@ -1448,6 +1461,7 @@ private:
         {
             // process params and incoming midi (only once for a given timestamp)
             midiMessages.clear();
+            processor.getParameterAutomation().clear();
 
             const int numParams = juceParameters.getNumParameters();
             processEvents (realtimeEventListHead, numParams, static_cast<AUEventSampleTime> (timestamp->mSampleTime));
@@ -1565,6 +1579,7 @@ private:
     {
         auto& processor = getAudioProcessor();
         const ScopedLock sl (processor.getCallbackLock());
+        const ScopedNoAllocation noAllocation ("AUv3 processBlock");
 
         if (processor.isSuspended())
             buffer.clear();
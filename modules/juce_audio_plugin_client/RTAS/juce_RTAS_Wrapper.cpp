@@ -587,6 +587,7 @@ public:
                 }
 
                 AudioBuffer<float> chans (channels, totalChans, numSamples);
+                const ScopedNoAllocation noAllocation ("RTAS RenderAudio");
 
                 if (mBypassed && juceFilter->getBypassParameter() == nullptr)
                     juceFilter->processBlockBypassed (chans, midiEvents);
@@ -456,6 +456,7 @@ private:
             else
             {
                 MidiBuffer mb;
+                const ScopedNoAllocation noAllocation ("Unity process");
 
                 if (isBypassed && pluginInstance->getBypassParameter() == nullptr)
                     pluginInstance->processBlockBypassed (scratchBuffer, mb);
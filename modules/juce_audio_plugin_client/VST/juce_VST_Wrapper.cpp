@@ -435,6 +435,7 @@ public:
                 {
                     const int numChannels = jmax (numIn, numOut);
                     AudioBuffer<FloatType> chans (tmpBuffers.channels, isMidiEffect ? 0 : numChannels, numSamples);
+                    const ScopedNoAllocation noAllocation ("VST processReplacing");
 
                     if (isBypassed && processor->getBypassParameter() == nullptr)
                         processor->processBlockBypassed (chans, midiEvents);
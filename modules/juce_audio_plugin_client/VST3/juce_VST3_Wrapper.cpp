@@ -2505,13 +2505,33 @@ public:
                    #endif
                     {
                         if (auto* param = comPluginInstance->getParamForVSTParamID (vstParamID))
+                        {
+                            if (pluginInstance->isParameterAutomationEnabled())
+                                addParameterChangesToAutomation (*paramQueue, param->getParameterIndex());
+
                             setValueAndNotifyIfChanged (*param, (float) value);
+                        }
                     }
                 }
             }
         }
     }
 
+    void addParameterChangesToAutomation (Vst::IParamValueQueue& paramQueue, int parameterIndex)
+    {
+        auto& automation = pluginInstance->getParameterAutomation();
+        auto numPoints = paramQueue.getPointCount();
+
+        for (Steinberg::int32 i = 0; i < numPoints; ++i)
+        {
+            Steinberg::int32 offsetSamples = 0;
+            double value = 0.0;
+
+            if (paramQueue.getPoint (i, offsetSamples, value) == kResultTrue)
+                automation.addPoint (parameterIndex, (int) offsetSamples, (float) value);
+        }
+    }
+
     void addParameterChangeToMidiBuffer (const Steinberg::int32 offsetSamples, const Vst::ParamID id, const double value)
     {
         // If the parameter is mapped to a MIDI CC message then insert it into the midiBuffer.
@@ -2556,6 +2576,7 @@ public:
         }
 
         midiBuffer.clear();
+        pluginInstance->getParameterAutomation().clear();
 
         if (data.inputParameterChanges != nullptr)
             processParameterChanges (*data.inputParameterChanges);
@@ -2794,6 +2815,8 @@ private:
                 if (totalInputChans == pluginInstance->getTotalNumInputChannels()
                  && totalOutputChans == pluginInstance->getTotalNumOutputChannels())
                 {
+                    const ScopedNoAllocation noAllocation ("VST3 process");
+
                     // processBlockBypassed should only ever be called if the AudioProcessor doesn't
                     // return a valid parameter from getBypassParameter
                     if (pluginInstance->getBypassParameter() == nullptr && comPluginInstance->getBypassParameter()->getValue() >= 0.5f)
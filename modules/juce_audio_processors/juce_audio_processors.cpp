@@ -194,6 +194,7 @@ private:
 #include "format/juce_AudioPluginFormatManager.cpp"
 #include "format_types/juce_LegacyAudioParameter.cpp"
 #include "processors/juce_AudioProcessor.cpp"
+#include "processors/juce_ParameterAutomationBuffer.cpp"
 #include "processors/juce_AudioPluginInstance.cpp"
 #if JUCE_MODULE_AVAILABLE_juce_gui_extra
 # include "processors/juce_AudioProcessorEditor.cpp"
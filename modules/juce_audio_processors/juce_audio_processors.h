@@ -125,6 +125,7 @@
 #include "utilities/juce_WebViewConfiguration.h"
 #include "processors/juce_AudioProcessorParameter.h"
 #include "processors/juce_HostedAudioProcessorParameter.h"
+#include "processors/juce_ParameterAutomationBuffer.h"
 #if JUCE_MODULE_AVAILABLE_juce_gui_extra
  #include "processors/juce_AudioProcessorEditorHostContext.h"
  #include "processors/juce_AudioProcessorEditor.h"
@@ -520,6 +520,7 @@ void AudioProcessor::addParameter (AudioProcessorParameter* param)
     flatParameterList.add (param);
 
     checkForUnsafeParamID (param);
+    checkParameterAutomationLanes();
 }
 
 void AudioProcessor::addParameterGroup (std::unique_ptr<AudioProcessorParameterGroup> group)
@@ -540,6 +541,7 @@ void AudioProcessor::addParameterGroup (std::unique_ptr<AudioProcessorParameterG
     }
 
     parameterTree.addChild (std::move (group));
+    checkParameterAutomationLanes();
 }
 
 void AudioProcessor::setParameterTree (AudioProcessorParameterGroup&& newTree)
@@ -562,10 +564,29 @@ void AudioProcessor::setParameterTree (AudioProcessorParameterGroup&& newTree)
 
         checkForUnsafeParamID (p);
     }
+
+    // The old lanes point to parameters which have just been deleted
+    if (isParameterAutomationEnabled())
+        parameterAutomation.setParameters (flatParameterList, parameterAutomation.getMaxPointsPerParameter());
 }
 
 void AudioProcessor::refreshParameterList() {}
 
+void AudioProcessor::setParameterAutomationEnabled (bool shouldBeEnabled, int maxPointsPerParameter)
+{
+    if (shouldBeEnabled)
+        parameterAutomation.setParameters (flatParameterList, maxPointsPerParameter);
+    else
+        parameterAutomation.reset();
+}
+
+void AudioProcessor::checkParameterAutomationLanes()
+{
+    // If you hit this assertion, you've added a parameter after calling setParameterAutomationEnabled(),
+    // so it won't get a lane. Add all your parameters first, or call setParameterAutomationEnabled() again.
+    jassert (! isParameterAutomationEnabled());
+}
+
 int AudioProcessor::getDefaultNumParameterSteps() noexcept
 {
     return 0x7fffffff;
@@ -1058,6 +1058,46 @@ public:
     /** Returns a flat list of the parameters in the current tree. */
     const Array<AudioProcessorParameter*>& getParameters() const;
 
+    //==============================================================================
+    /** Asks the host to deliver sample-accurate parameter automation to this processor.
+
+        When this is enabled, hosts that know the sample positions of parameter changes
+        will add them to the buffer returned by getParameterAutomation() before each
+        call to processBlock(). Your processBlock() can then read the points for each
+        parameter, or fill a per-sample ramp, instead of smoothing the single value that
+        AudioProcessorParameter::getValue() returns. Parameters will still be set to
+        their final value for the block in the normal way.
+
+        This allocates storage for maxPointsPerParameter points for each parameter, so it
+        should be called from your constructor or another non-realtime context, after
+        you've added all your parameters. The lanes aren't resized when you add parameters
+        later on, so if you do that, you'll need to call this method again.
+
+        At the moment, only the VST3 and AUv3 wrappers deliver automation. The AU, VST2
+        and AAX wrappers, AudioProcessorPlayer and AudioProcessorGraph leave the buffer
+        empty, so a processor must still work correctly when it contains no points.
+
+        @see getParameterAutomation, ParameterAutomationBuffer
+    */
+    void setParameterAutomationEnabled (bool shouldBeEnabled, int maxPointsPerParameter = 32);
+
+    /** Returns true if setParameterAutomationEnabled() has been used to turn on
+        sample-accurate automation.
+    */
+    bool isParameterAutomationEnabled() const noexcept          { return parameterAutomation.getMaxPointsPerParameter() > 0; }
+
+    /** Returns the automation for the current block.
+
+        Inside processBlock(), this contains the parameter changes that the host has
+        delivered for the block being processed. If you're hosting a processor, you
+        should clear() this and add the changes for the next block before calling
+        processBlock(), but only if isParameterAutomationEnabled() returns true.
+    */
+    ParameterAutomationBuffer& getParameterAutomation() noexcept                 { return parameterAutomation; }
+
+    /** Returns the automation for the current block. */
+    const ParameterAutomationBuffer& getParameterAutomation() const noexcept     { return parameterAutomation; }
+
     //==============================================================================
     /** Returns the number of preset programs the processor supports.
 
@@ -1515,6 +1555,7 @@ private:
 
     AudioProcessorParameterGroup parameterTree;
     Array<AudioProcessorParameter*> flatParameterList;
+    ParameterAutomationBuffer parameterAutomation;
     
     std::unique_ptr<NativeWebView> nativeWebView;
     std::weak_ptr<std::function<void (NativeWebView&, Rectangle<int> const&)>> resizeCb;
@@ -1536,6 +1577,7 @@ private:
     void checkForDuplicateTrimmedParamID (AudioProcessorParameter*);
     void checkForUnsafeParamID (AudioProcessorParameter*);
     void checkForDuplicateParamID (AudioProcessorParameter*);
+    void checkParameterAutomationLanes();
     void checkForDuplicateGroupIDs (const AudioProcessorParameterGroup&);
 
     AudioProcessorListener* getListenerLocked (int) const noexcept;
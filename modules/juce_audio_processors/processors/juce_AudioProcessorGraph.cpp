@@ -274,10 +274,15 @@ private:
                 buffer.clear();
             else
                 callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+
+            // Any automation that was added to this node on the audio thread only applies to the block that's just been rendered
+            processor.getParameterAutomation().clear();
         }
 
         void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
         {
+            const ScopedNoAllocation noAllocation ("AudioProcessorGraph node");
+
             if (processor.isUsingDoublePrecision())
             {
                 tempBufferDouble.makeCopyOf (buffer, true);
@@ -300,6 +305,8 @@ private:
 
         void callProcess (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
         {
+            const ScopedNoAllocation noAllocation ("AudioProcessorGraph node");
+
             if (processor.isUsingDoublePrecision())
             {
                 if (node->isBypassed())
@@ -1398,6 +1405,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
     else
     {
         const ScopedLock sl (graph.getCallbackLock());
+        const ScopedNoAllocation noAllocation ("AudioProcessorGraph::processBlock");
 
         if (isPrepared)
         {
@@ -40,6 +40,14 @@ namespace juce
     To play back a graph through an audio device, you might want to use an
     AudioProcessorPlayer object.
 
+    The graph doesn't generate any sample-accurate automation for its nodes itself.
+    If a node's processor has it enabled, you can add points to its
+    AudioProcessor::getParameterAutomation() buffer, but only on the audio thread,
+    immediately before calling the graph's processBlock() - for example, in the
+    processBlock() of a processor which wraps the graph. Adding points from the message
+    thread while the graph is rendering isn't safe. The graph clears each node's buffer
+    after the node has rendered, so the points only apply to that one block.
+
     @tags{Audio}
 */
 class JUCE_API  AudioProcessorGraph   : public AudioProcessor,
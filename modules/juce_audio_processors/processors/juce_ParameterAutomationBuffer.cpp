@@ -0,0 +1,375 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+ParameterAutomationBuffer::ParameterAutomationBuffer() noexcept {}
+ParameterAutomationBuffer::~ParameterAutomationBuffer() {}
+
+void ParameterAutomationBuffer::setParameters (const Array<AudioProcessorParameter*>& newParameters,
+                                               int maxPointsPerParameter)
+{
+    jassert (maxPointsPerParameter > 0);
+
+    parameters = newParameters;
+    maxPointsPerLane = jmax (1, maxPointsPerParameter);
+
+    auto numParameters = (size_t) parameters.size();
+    points.malloc (numParameters * (size_t) maxPointsPerLane);
+    lanes.calloc (numParameters);
+    automatedParameters.malloc (numParameters);
+    numAutomatedParameters = 0;
+}
+
+void ParameterAutomationBuffer::reset()
+{
+    parameters.clear();
+    points.free();
+    lanes.free();
+    automatedParameters.free();
+    maxPointsPerLane = 0;
+    numAutomatedParameters = 0;
+}
+
+//==============================================================================
+void ParameterAutomationBuffer::clear() noexcept
+{
+    for (int i = 0; i < numAutomatedParameters; ++i)
+        lanes[automatedParameters[i]].numPoints = 0;
+
+    numAutomatedParameters = 0;
+}
+
+void ParameterAutomationBuffer::addPoint (int parameterIndex, int samplePosition, float normalisedValue) noexcept
+{
+    if (! isPositiveAndBelow (parameterIndex, parameters.size()))
+        return;
+
+    auto& lane = lanes[parameterIndex];
+    auto* lanePoints = points + (size_t) parameterIndex * (size_t) maxPointsPerLane;
+
+    if (lane.numPoints == 0)
+    {
+        lane.startValue = parameters.getUnchecked (parameterIndex)->getValue();
+        lanePoints[0] = { samplePosition, normalisedValue };
+        lane.numPoints = 1;
+        automatedParameters[numAutomatedParameters++] = parameterIndex;
+        return;
+    }
+
+    auto& last = lanePoints[lane.numPoints - 1];
+
+    // Hosts almost always deliver points in order, so check the end of the lane first
+    if (samplePosition >= last.samplePosition)
+    {
+        if (samplePosition == last.samplePosition || lane.numPoints == maxPointsPerLane)
+            last = { samplePosition, normalisedValue };
+        else
+            lanePoints[lane.numPoints++] = { samplePosition, normalisedValue };
+
+        return;
+    }
+
+    auto insertIndex = lane.numPoints - 1;
+
+    while (insertIndex > 0 && lanePoints[insertIndex - 1].samplePosition > samplePosition)
+        --insertIndex;
+
+    if (insertIndex > 0 && lanePoints[insertIndex - 1].samplePosition == samplePosition)
+    {
+        lanePoints[insertIndex - 1].value = normalisedValue;
+        return;
+    }
+
+    // When the lane is full, an out-of-order point is dropped rather than losing the final value
+    if (lane.numPoints == maxPointsPerLane)
+        return;
+
+    std::memmove (lanePoints + insertIndex + 1, lanePoints + insertIndex,
+                  (size_t) (lane.numPoints - insertIndex) * sizeof (Point));
+
+    lanePoints[insertIndex] = { samplePosition, normalisedValue };
+    ++lane.numPoints;
+}
+
+int ParameterAutomationBuffer::getAutomatedParameterIndex (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, numAutomatedParameters));
+    return automatedParameters[index];
+}
+
+bool ParameterAutomationBuffer::isAutomated (int parameterIndex) const noexcept
+{
+    return isPositiveAndBelow (parameterIndex, parameters.size())
+            && lanes[parameterIndex].numPoints > 0;
+}
+
+ParameterAutomationBuffer::Lane ParameterAutomationBuffer::getLane (int parameterIndex) const noexcept
+{
+    if (isAutomated (parameterIndex))
+    {
+        auto& lane = lanes[parameterIndex];
+        return { points + (size_t) parameterIndex * (size_t) maxPointsPerLane, lane.numPoints, lane.startValue };
+    }
+
+    if (isPositiveAndBelow (parameterIndex, parameters.size()))
+        return { nullptr, 0, parameters.getUnchecked (parameterIndex)->getValue() };
+
+    jassertfalse;
+    return { nullptr, 0, 0.0f };
+}
+
+void ParameterAutomationBuffer::fillRamp (int parameterIndex, float* destination, int numSamples,
+                                          Interpolation interpolation) const noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    auto lane = getLane (parameterIndex);
+    auto currentValue = lane.getStartValue();
+    int position = 0;
+
+    for (auto& point : lane)
+    {
+        auto pointPosition = jlimit (0, numSamples - 1, point.samplePosition);
+        auto numToFill = pointPosition - position;
+
+        if (numToFill > 0)
+        {
+            if (interpolation == Interpolation::linear && point.value != currentValue)
+            {
+                auto increment = (point.value - currentValue) / (float) numToFill;
+
+                for (int i = 0; i < numToFill; ++i)
+                    destination[position + i] = currentValue + increment * (float) i;
+            }
+            else
+            {
+                FloatVectorOperations::fill (destination + position, currentValue, numToFill);
+            }
+
+            position = pointPosition;
+        }
+
+        currentValue = point.value;
+    }
+
+    FloatVectorOperations::fill (destination + position, currentValue, numSamples - position);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParameterAutomationBufferTests  : public UnitTest
+{
+public:
+    ParameterAutomationBufferTests()
+        : UnitTest ("ParameterAutomationBuffer", UnitTestCategories::audioProcessorParameters)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("A buffer without lanes ignores points");
+        {
+            ParameterAutomationBuffer buffer;
+            buffer.addPoint (0, 10, 0.5f);
+            expect (buffer.isEmpty());
+        }
+
+        beginTest ("Lanes capture the value before the first point");
+        {
+            TestProcessor processor (3, 4);
+            auto& buffer = processor.getParameterAutomation();
+            auto& params = processor.getParameters();
+
+            params[1]->setValue (0.25f);
+            buffer.addPoint (1, 8, 0.75f);
+            params[1]->setValue (0.75f);
+
+            expectEquals (buffer.getNumAutomatedParameters(), 1);
+            expectEquals (buffer.getAutomatedParameterIndex (0), 1);
+            expect (! buffer.isAutomated (0));
+            expect (buffer.isAutomated (1));
+
+            auto lane = buffer.getLane (1);
+            expectEquals (lane.size(), 1);
+            expectEquals (lane.getStartValue(), 0.25f);
+            expectEquals (lane.getEndValue(), 0.75f);
+
+            auto emptyLane = buffer.getLane (2);
+            expect (emptyLane.isEmpty());
+            expectEquals (emptyLane.getStartValue(), params[2]->getValue());
+
+            buffer.clear();
+            expect (buffer.isEmpty());
+            expect (! buffer.isAutomated (1));
+        }
+
+        beginTest ("Points are kept in order");
+        {
+            TestProcessor processor (1, 8);
+            auto& buffer = processor.getParameterAutomation();
+
+            buffer.addPoint (0, 20, 0.2f);
+            buffer.addPoint (0, 5, 0.1f);
+            buffer.addPoint (0, 40, 0.4f);
+            buffer.addPoint (0, 30, 0.3f);
+            buffer.addPoint (0, 30, 0.35f);
+
+            auto lane = buffer.getLane (0);
+            expectEquals (lane.size(), 4);
+
+            const int expectedPositions[] = { 5, 20, 30, 40 };
+            const float expectedValues[]  = { 0.1f, 0.2f, 0.35f, 0.4f };
+
+            for (int i = 0; i < lane.size(); ++i)
+            {
+                expectEquals (lane[i].samplePosition, expectedPositions[i]);
+                expectEquals (lane[i].value, expectedValues[i]);
+            }
+        }
+
+        beginTest ("A full lane keeps the final value");
+        {
+            TestProcessor processor (1, 4);
+            auto& buffer = processor.getParameterAutomation();
+
+            for (int i = 0; i < 16; ++i)
+                buffer.addPoint (0, i, (float) i / 16.0f);
+
+            buffer.addPoint (0, 0, 1.0f);
+
+            auto lane = buffer.getLane (0);
+            expectEquals (lane.size(), 4);
+            expectEquals (lane[3].samplePosition, 15);
+            expectEquals (lane.getEndValue(), 15.0f / 16.0f);
+        }
+
+        beginTest ("Step ramps");
+        {
+            TestProcessor processor (1, 4);
+            auto& buffer = processor.getParameterAutomation();
+            processor.getParameters()[0]->setValue (0.0f);
+
+            buffer.addPoint (0, 2, 0.5f);
+            buffer.addPoint (0, 5, 1.0f);
+
+            float ramp[8];
+            buffer.fillRamp (0, ramp, 8, ParameterAutomationBuffer::Interpolation::step);
+
+            const float expected[] = { 0.0f, 0.0f, 0.5f, 0.5f, 0.5f, 1.0f, 1.0f, 1.0f };
+
+            for (int i = 0; i < 8; ++i)
+                expectEquals (ramp[i], expected[i]);
+        }
+
+        beginTest ("Linear ramps");
+        {
+            TestProcessor processor (1, 4);
+            auto& buffer = processor.getParameterAutomation();
+            processor.getParameters()[0]->setValue (0.0f);
+
+            buffer.addPoint (0, 4, 1.0f);
+            buffer.addPoint (0, 100, 0.5f);
+
+            float ramp[8];
+            buffer.fillRamp (0, ramp, 8);
+
+            for (int i = 0; i <= 4; ++i)
+                expectWithinAbsoluteError (ramp[i], (float) i / 4.0f, 1.0e-6f);
+
+            // the last point lies beyond the block, so it's reached at the final sample
+            expectWithinAbsoluteError (ramp[5], 1.0f - 0.5f / 3.0f, 1.0e-6f);
+            expectWithinAbsoluteError (ramp[7], 0.5f, 1.0e-6f);
+        }
+
+        beginTest ("Parameters without points produce a flat ramp");
+        {
+            TestProcessor processor (1, 4);
+            processor.getParameters()[0]->setValue (0.25f);
+
+            float ramp[16];
+            processor.getParameterAutomation().fillRamp (0, ramp, 16);
+
+            for (auto v : ramp)
+                expectEquals (v, 0.25f);
+        }
+
+        beginTest ("Enabling automation again adds lanes for new parameters");
+        {
+            TestProcessor processor (2, 4);
+            processor.setParameterAutomationEnabled (false);
+            processor.addParameter (new AudioParameterFloat ("late", "late", 0.0f, 1.0f, 0.5f));
+            processor.setParameterAutomationEnabled (true, 4);
+
+            auto& buffer = processor.getParameterAutomation();
+            expectEquals (buffer.getNumParameters(), 3);
+
+            buffer.addPoint (2, 0, 1.0f);
+            expect (buffer.isAutomated (2));
+
+            processor.setParameterAutomationEnabled (false);
+            expect (! processor.isParameterAutomationEnabled());
+            expectEquals (buffer.getNumParameters(), 0);
+        }
+    }
+
+private:
+    struct TestProcessor  : public AudioProcessor
+    {
+        TestProcessor (int numParameters, int maxPoints)
+        {
+            for (int i = 0; i < numParameters; ++i)
+                addParameter (new AudioParameterFloat ("p" + String (i), "p" + String (i), 0.0f, 1.0f, 0.5f));
+
+            setParameterAutomationEnabled (true, maxPoints);
+        }
+
+        const String getName() const override                                   { return {}; }
+        void prepareToPlay (double, int) override                               {}
+        void releaseResources() override                                        {}
+        void processBlock (AudioBuffer<float>&, MidiBuffer&) override           {}
+        using AudioProcessor::processBlock;
+        double getTailLengthSeconds() const override                            { return 0.0; }
+        bool acceptsMidi() const override                                       { return false; }
+        bool producesMidi() const override                                      { return false; }
+        AudioProcessorEditor* createEditor() override                           { return nullptr; }
+        bool hasEditor() const override                                         { return false; }
+        int getNumPrograms() override                                           { return 1; }
+        int getCurrentProgram() override                                        { return 0; }
+        void setCurrentProgram (int) override                                   {}
+        const String getProgramName (int) override                              { return {}; }
+        void changeProgramName (int, const String&) override                    {}
+        void getStateInformation (MemoryBlock&) override                        {}
+        void setStateInformation (const void*, int) override                    {}
+    };
+};
+
+static ParameterAutomationBufferTests parameterAutomationBufferTests;
+
+#endif
+
+} // namespace juce
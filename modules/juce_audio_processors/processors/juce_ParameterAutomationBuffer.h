@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds the timestamped parameter changes that a host delivers for a single
+    processing block.
+
+    Each parameter of an AudioProcessor gets its own lane of points, where a point
+    is a normalised value together with the sample position within the block at
+    which the parameter reaches that value. Lanes are sorted by sample position,
+    and remember the value that the parameter had before the block started, so
+    that a processor can either walk the points of a lane and split its processing
+    at each one, or ask for a dense per-sample ramp with fillRamp().
+
+    All the storage is allocated up-front by AudioProcessor::setParameterAutomationEnabled(),
+    so adding points, clearing the buffer and reading lanes never allocate and
+    are safe to do on the audio thread. If a lane runs out of space, the last
+    point is replaced, so the value at the end of the block is always correct.
+
+    Hosts fill the buffer immediately before calling processBlock(), and must
+    add a point before they pass the new value to AudioProcessorParameter::setValue(),
+    because the first point added to a lane captures the parameter's current value
+    as the lane's starting value.
+
+    The buffer isn't thread-safe. Points must only be added, and the buffer cleared,
+    on the audio thread, in between the calls to processBlock() which read it. If you
+    want to automate a processor from another thread, pass the changes to the audio
+    thread through a lock-free queue, such as an AbstractFifo, and add them to the
+    buffer there.
+
+    @see AudioProcessor::getParameterAutomation, AudioProcessor::setParameterAutomationEnabled
+
+    @tags{Audio}
+*/
+class JUCE_API  ParameterAutomationBuffer
+{
+public:
+    //==============================================================================
+    /** Creates an empty buffer which has no storage and ignores any points added to it. */
+    ParameterAutomationBuffer() noexcept;
+
+    /** Destructor. */
+    ~ParameterAutomationBuffer();
+
+    //==============================================================================
+    /** A single automation point. */
+    struct Point
+    {
+        /** The position within the block, in samples. */
+        int samplePosition;
+
+        /** The normalised value of the parameter at this position. */
+        float value;
+    };
+
+    /** A read-only view of the points that have been added for one parameter. */
+    class JUCE_API  Lane
+    {
+    public:
+        /** Returns the number of points in the lane. */
+        int size() const noexcept                   { return numPoints; }
+
+        /** Returns true if the parameter wasn't automated during this block. */
+        bool isEmpty() const noexcept               { return numPoints == 0; }
+
+        /** Returns the parameter's value before the first point of this block. */
+        float getStartValue() const noexcept        { return startValue; }
+
+        /** Returns the value of the last point, or the start value if the lane is empty. */
+        float getEndValue() const noexcept          { return numPoints > 0 ? points[numPoints - 1].value : startValue; }
+
+        const Point& operator[] (int index) const noexcept    { jassert (isPositiveAndBelow (index, numPoints)); return points[index]; }
+        const Point* begin() const noexcept         { return points; }
+        const Point* end() const noexcept           { return points + numPoints; }
+
+    private:
+        friend class ParameterAutomationBuffer;
+
+        Lane (const Point* p, int num, float start) noexcept
+            : points (p), numPoints (num), startValue (start) {}
+
+        const Point* points;
+        int numPoints;
+        float startValue;
+    };
+
+    //==============================================================================
+    /** Allocates a lane for each of the given parameters.
+
+        This will allocate memory, so must not be called on the audio thread. It's
+        called for you by AudioProcessor::setParameterAutomationEnabled(), and by
+        AudioProcessor::setParameterTree() if automation is enabled.
+    */
+    void setParameters (const Array<AudioProcessorParameter*>& parameters,
+                        int maxPointsPerParameter);
+
+    /** Frees all the storage, after which any points added will be ignored. */
+    void reset();
+
+    /** Returns the number of parameters for which lanes have been allocated. */
+    int getNumParameters() const noexcept               { return parameters.size(); }
+
+    /** Returns the maximum number of points that each lane can hold in one block. */
+    int getMaxPointsPerParameter() const noexcept       { return maxPointsPerLane; }
+
+    //==============================================================================
+    /** Removes all the points from the buffer.
+
+        This only touches the lanes that were automated, so it's cheap to call
+        for every block, even for processors with a large number of parameters.
+    */
+    void clear() noexcept;
+
+    /** Adds a point to the lane for the parameter with the given index.
+
+        Points should normally be added in order of sample position. A point
+        added at the same position as an existing one replaces its value.
+        Indexes which don't refer to a parameter that has a lane are ignored.
+    */
+    void addPoint (int parameterIndex, int samplePosition, float normalisedValue) noexcept;
+
+    /** Returns true if no points have been added since the last call to clear(). */
+    bool isEmpty() const noexcept                       { return numAutomatedParameters == 0; }
+
+    /** Returns the number of parameters that have at least one point in this block. */
+    int getNumAutomatedParameters() const noexcept      { return numAutomatedParameters; }
+
+    /** Returns the index of one of the parameters that have points in this block.
+
+        Use this with getNumAutomatedParameters() to visit the lanes that contain points,
+        without having to look at every parameter.
+    */
+    int getAutomatedParameterIndex (int index) const noexcept;
+
+    /** Returns true if the given parameter has points in this block. */
+    bool isAutomated (int parameterIndex) const noexcept;
+
+    /** Returns the lane for a parameter.
+
+        If the parameter has no points, the lane that's returned will be empty and
+        its start value will be the parameter's current value.
+    */
+    Lane getLane (int parameterIndex) const noexcept;
+
+    //==============================================================================
+    /** The ways in which fillRamp() can join the points of a lane. */
+    enum class Interpolation
+    {
+        step,       /**< The value jumps to each point's value at its sample position. */
+        linear      /**< The value moves in a straight line from each point to the next. */
+    };
+
+    /** Writes the value of a parameter for each sample of the block.
+
+        If the parameter has no points, the destination is filled with its current value.
+        Points beyond the end of the destination are treated as though they were at
+        its last sample.
+    */
+    void fillRamp (int parameterIndex, float* destination, int numSamples,
+                   Interpolation interpolation = Interpolation::linear) const noexcept;
+
+private:
+    //==============================================================================
+    struct LaneState
+    {
+        int numPoints;
+        float startValue;
+    };
+
+    Array<AudioProcessorParameter*> parameters;
+    HeapBlock<Point> points;
+    HeapBlock<LaneState> lanes;
+    HeapBlock<int> automatedParameters;
+    int maxPointsPerLane = 0, numAutomatedParameters = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterAutomationBuffer)
+};
+
+} // namespace juce
@@ -99,7 +99,7 @@ public:
 
     ~LevelDataSource() override
     {
-        owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
+        owner.cache.removeScanningClient (this);
     }
 
     enum { timeBeforeDeletingReader = 3000 };
@@ -119,12 +119,41 @@ public:
             sampleRate = reader->sampleRate;
 
             if (lengthInSamples <= 0 || isFullyLoaded())
+            {
                 reader.reset();
+            }
             else
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+            {
+                if (peakFileToCreate != File() && numSamplesFinished == 0)
+                    peakFileBuilder = std::make_unique<AudioPeakFile::Builder> ((int) numChannels, sampleRate, hashCode);
+
+                owner.cache.addScanningClient (this, owner.priority);
+            }
         }
     }
 
+    void setPeakFileToCreate (const File& file)
+    {
+        const ScopedLock sl (readerLock);
+        peakFileToCreate = file;
+    }
+
+    bool matches (const AudioPeakFile& peakFile)
+    {
+        const ScopedLock sl (readerLock);
+        createReader();
+
+        auto result = reader != nullptr
+                       && reader->lengthInSamples == peakFile.getLengthInSamples()
+                       && (int) reader->numChannels == peakFile.getNumChannels()
+                       && reader->sampleRate == peakFile.getSampleRate();
+
+        if (source != nullptr)
+            reader.reset();
+
+        return result;
+    }
+
     void getLevels (int64 startSample, int numSamples, Array<Range<float>>& levels)
     {
         const ScopedLock sl (readerLock);
@@ -136,7 +165,7 @@ public:
             if (reader != nullptr)
             {
                 lastReaderUseTime = Time::getMillisecondCounter();
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                owner.cache.addScanningClient (this, owner.priority);
             }
         }
 
@@ -212,14 +241,23 @@ private:
     AudioThumbnail& owner;
     std::unique_ptr<InputSource> source;
     std::unique_ptr<AudioFormatReader> reader;
+    std::unique_ptr<AudioPeakFile::Builder> peakFileBuilder;
+    File peakFileToCreate;
+    AudioBuffer<float> levelBuffer;
     CriticalSection readerLock;
+    bool readerHasFastMaxLevels = false;
     std::atomic<uint32> lastReaderUseTime { 0 };
 
     void createReader()
     {
         if (reader == nullptr && source != nullptr)
+        {
             if (auto* audioFileStream = source->createInputStream())
+            {
                 reader.reset (owner.formatManagerToUse.createReaderFor (std::unique_ptr<InputStream> (audioFileStream)));
+                readerHasFastMaxLevels = reader != nullptr && reader->canReadMaxLevelsQuickly();
+            }
+        }
     }
 
     bool readNextBlock()
@@ -234,39 +272,73 @@ private:
             {
                 auto startSample = numSamplesFinished;
 
-                auto firstThumbIndex = sampleToThumbSample (startSample);
-                auto lastThumbIndex  = sampleToThumbSample (startSample + numToDo);
-                auto numThumbSamps = lastThumbIndex - firstThumbIndex;
-
-                HeapBlock<MinMaxValue> levelData ((unsigned int) numThumbSamps * numChannels);
-                HeapBlock<MinMaxValue*> levels (numChannels);
-
-                for (int i = 0; i < (int) numChannels; ++i)
-                    levels[i] = levelData + i * numThumbSamps;
+                // A peak file needs the samples themselves, but otherwise some readers can
+                // find the levels without decoding everything
+                if (readerHasFastMaxLevels && peakFileBuilder == nullptr)
+                    readMaxLevels (startSample, numToDo);
+                else
+                    readAndScanBlock (startSample, numToDo);
 
-                HeapBlock<Range<float>> levelsRead (numChannels);
+                numSamplesFinished += numToDo;
+                lastReaderUseTime = Time::getMillisecondCounter();
 
-                for (int i = 0; i < numThumbSamps; ++i)
+                if (isFullyLoaded())
                 {
-                    reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
-                                           owner.samplesPerThumbSample, levelsRead, (int) numChannels);
-
-                    for (int j = 0; j < (int) numChannels; ++j)
-                        levels[j][i].setFloat (levelsRead[j]);
-                }
+                    if (peakFileBuilder != nullptr)
+                    {
+                        peakFileBuilder->writeTo (peakFileToCreate);
+                        peakFileBuilder.reset();
+                    }
 
-                {
-                    const ScopedUnlock su (readerLock);
-                    owner.setLevels (levels, firstThumbIndex, (int) numChannels, numThumbSamps);
+                    // The buffer is only needed while scanning, so there's no point keeping it
+                    levelBuffer.setSize (0, 0);
                 }
-
-                numSamplesFinished += numToDo;
-                lastReaderUseTime = Time::getMillisecondCounter();
             }
         }
 
         return isFullyLoaded();
     }
+
+    void readMaxLevels (int64 startSample, int numSamples)
+    {
+        auto firstThumbIndex = sampleToThumbSample (startSample);
+        auto lastThumbIndex = sampleToThumbSample (startSample + numSamples + owner.samplesPerThumbSample - 1);
+        auto numThumbSamps = lastThumbIndex - firstThumbIndex;
+
+        HeapBlock<MinMaxValue> levelData ((size_t) numThumbSamps * numChannels);
+        HeapBlock<MinMaxValue*> levels (numChannels);
+
+        for (int i = 0; i < (int) numChannels; ++i)
+            levels[i] = levelData + i * numThumbSamps;
+
+        HeapBlock<Range<float>> levelsRead (numChannels);
+
+        for (int i = 0; i < numThumbSamps; ++i)
+        {
+            reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
+                                   owner.samplesPerThumbSample, levelsRead, (int) numChannels);
+
+            for (int j = 0; j < (int) numChannels; ++j)
+                levels[j][i].setFloat (levelsRead[j]);
+        }
+
+        const ScopedUnlock su (readerLock);
+        owner.setLevels (levels, firstThumbIndex, (int) numChannels, numThumbSamps);
+    }
+
+    // Reading the whole block in one go and reducing it with findMinAndMax is much
+    // quicker than asking the default readMaxLevels() for each thumbnail sample in turn
+    void readAndScanBlock (int64 startSample, int numSamples)
+    {
+        levelBuffer.setSize ((int) numChannels, numSamples, false, false, true);
+        reader->read (&levelBuffer, 0, numSamples, startSample, true, true);
+
+        if (peakFileBuilder != nullptr)
+            peakFileBuilder->addBlock (levelBuffer, 0, numSamples);
+
+        const ScopedUnlock su (readerLock);
+        owner.addBlock (startSample, levelBuffer, 0, numSamples);
+    }
 };
 
 //==============================================================================
@@ -380,10 +452,11 @@ public:
                       const double startTime, const double endTime,
                       const int channelNum, const float verticalZoomFactor,
                       const double rate, const int numChans, const int sampsPerThumbSample,
-                      LevelDataSource* levelData, const OwnedArray<ThumbData>& chans)
+                      LevelDataSource* levelData, const AudioPeakFile* peakFile,
+                      const OwnedArray<ThumbData>& chans)
     {
         if (refillCache (area.getWidth(), startTime, endTime, rate,
-                         numChans, sampsPerThumbSample, levelData, chans)
+                         numChans, sampsPerThumbSample, levelData, peakFile, chans)
              && isPositiveAndBelow (channelNum, numChannelsCached))
         {
             auto clip = g.getClipBounds().getIntersection (area.withWidth (jmin (numSamplesCached, area.getWidth())));
@@ -429,7 +502,8 @@ private:
 
     bool refillCache (int numSamples, double startTime, double endTime,
                       double rate, int numChans, int sampsPerThumbSample,
-                      LevelDataSource* levelData, const OwnedArray<ThumbData>& chans)
+                      LevelDataSource* levelData, const AudioPeakFile* peakFile,
+                      const OwnedArray<ThumbData>& chans)
     {
         auto timePerPixel = (endTime - startTime) / numSamples;
 
@@ -456,7 +530,10 @@ private:
 
         ensureSize (numSamples);
 
-        if (timePerPixel * rate <= sampsPerThumbSample && levelData != nullptr)
+        auto finestStoredScale = peakFile != nullptr ? (double) peakFile->getSamplesPerPeak (0)
+                                                     : (double) sampsPerThumbSample;
+
+        if (timePerPixel * rate <= finestStoredScale && levelData != nullptr)
         {
             auto sample = roundToInt (startTime * rate);
             Array<Range<float>> levels;
@@ -490,6 +567,37 @@ private:
 
             numSamplesCached = i;
         }
+        else if (peakFile != nullptr)
+        {
+            auto length = peakFile->getLengthInSamples();
+
+            for (int channelNum = 0; channelNum < numChannelsCached; ++channelNum)
+            {
+                MinMaxValue* cacheData = getData (channelNum, 0);
+
+                startTime = cachedStart;
+                auto sample = (int64) std::floor (startTime * rate + 0.5);
+
+                for (int i = numSamples; --i >= 0;)
+                {
+                    auto nextSample = (int64) std::floor ((startTime + timePerPixel) * rate + 0.5);
+
+                    if (sample >= 0 && sample < length)
+                    {
+                        auto levels = peakFile->getLevels (channelNum, { sample, jmax (sample + 1, nextSample) });
+                        cacheData->setFloat ({ levels.getMinimum(), levels.getMaximum() });
+                    }
+                    else
+                    {
+                        *cacheData = MinMaxValue();
+                    }
+
+                    ++cacheData;
+                    startTime += timePerPixel;
+                    sample = nextSample;
+                }
+            }
+        }
         else
         {
             jassert (chans.size() == numChannelsCached);
@@ -564,6 +672,7 @@ void AudioThumbnail::clearChannelData()
 {
     window->invalidate();
     channels.clear();
+    peakFile.reset();
     totalSamples = numSamplesFinished = 0;
     numChannels = 0;
     sampleRate = 0;
@@ -646,6 +755,19 @@ bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
     numSamplesFinished = 0;
     auto wasSuccessful = [&] { return sampleRate > 0 && totalSamples > 0; };
 
+    if (openPeakFile (*newSource))
+    {
+        source.reset (newSource);
+
+        const ScopedLock sl (lock);
+        source->lengthInSamples = totalSamples;
+        source->sampleRate = sampleRate;
+        source->numChannels = (unsigned int) numChannels;
+        source->numSamplesFinished = numSamplesFinished;
+
+        return wasSuccessful();
+    }
+
     if (cache.loadThumb (*this, newSource->hashCode) && isFullyLoaded())
     {
         source.reset (newSource); // (make sure this isn't done before loadThumb is called)
@@ -659,6 +781,7 @@ bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
     }
 
     source.reset (newSource);
+    source->setPeakFileToCreate (cache.getPeakFileFor (source->hashCode));
 
     const ScopedLock sl (lock);
     source->initialise (numSamplesFinished);
@@ -672,6 +795,29 @@ bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
     return wasSuccessful();
 }
 
+bool AudioThumbnail::openPeakFile (LevelDataSource& newSource)
+{
+    auto file = cache.getPeakFileFor (newSource.hashCode);
+
+    if (file == File())
+        return false;
+
+    auto newPeakFile = AudioPeakFile::open (file, newSource.hashCode);
+
+    // The hash code might not change when a file is edited, so make sure that the
+    // peak file still describes the source before trusting it
+    if (newPeakFile == nullptr || ! newSource.matches (*newPeakFile))
+        return false;
+
+    const ScopedLock sl (lock);
+    peakFile = std::move (newPeakFile);
+    totalSamples = numSamplesFinished = peakFile->getLengthInSamples();
+    sampleRate = peakFile->getSampleRate();
+    numChannels = peakFile->getNumChannels();
+    window->invalidate();
+    return true;
+}
+
 bool AudioThumbnail::setSource (InputSource* const newSource)
 {
     clear();
@@ -692,6 +838,25 @@ int64 AudioThumbnail::getHashCode() const
     return source == nullptr ? 0 : source->hashCode;
 }
 
+void AudioThumbnail::setPriority (int newPriority)
+{
+    priority = newPriority;
+
+    if (source != nullptr)
+        cache.setScanningClientPriority (source.get(), newPriority);
+}
+
+int AudioThumbnail::getPriority() const noexcept
+{
+    return priority;
+}
+
+bool AudioThumbnail::isUsingPeakFile() const noexcept
+{
+    const ScopedLock sl (lock);
+    return peakFile != nullptr;
+}
+
 void AudioThumbnail::addBlock (int64 startSample, const AudioBuffer<float>& incoming,
                                int startOffsetInBuffer, int numSamples)
 {
@@ -779,6 +944,10 @@ int64 AudioThumbnail::getNumSamplesFinished() const noexcept
 float AudioThumbnail::getApproximatePeak() const
 {
     const ScopedLock sl (lock);
+
+    if (peakFile != nullptr)
+        return peakFile->getHighestLevel();
+
     int peak = 0;
 
     for (auto* c : channels)
@@ -794,7 +963,13 @@ void AudioThumbnail::getApproximateMinMax (double startTime, double endTime, int
     MinMaxValue result;
     auto* data = channels [channelIndex];
 
-    if (data != nullptr && sampleRate > 0)
+    if (peakFile != nullptr && isPositiveAndBelow (channelIndex, numChannels))
+    {
+        auto start = (int64) (startTime * sampleRate);
+        auto levels = peakFile->getLevels (channelIndex, { start, jmax (start + 1, (int64) (endTime * sampleRate)) });
+        result.set (levels.minValue, levels.maxValue);
+    }
+    else if (data != nullptr && sampleRate > 0)
     {
         auto firstThumbIndex = (int) ((startTime * sampleRate) / samplesPerThumbSample);
         auto lastThumbIndex  = (int) (((endTime * sampleRate) + samplesPerThumbSample - 1) / samplesPerThumbSample);
@@ -812,7 +987,7 @@ void AudioThumbnail::drawChannel (Graphics& g, const Rectangle<int>& area, doubl
     const ScopedLock sl (lock);
 
     window->drawChannel (g, area, startTime, endTime, channelNum, verticalZoomFactor,
-                         sampleRate, numChannels, samplesPerThumbSample, source.get(), channels);
+                         sampleRate, numChannels, samplesPerThumbSample, source.get(), peakFile.get(), channels);
 }
 
 void AudioThumbnail::drawChannels (Graphics& g, const Rectangle<int>& area, double startTimeSeconds,
@@ -41,7 +41,9 @@ namespace juce
     listeners should repaint themselves.
 
     The thumbnail stores an internal low-res version of the wave data, and this can
-    be loaded and saved to avoid having to scan the file again.
+    be loaded and saved to avoid having to scan the file again. If the cache has a
+    peak file directory, the thumbnail will also write an AudioPeakFile when it scans
+    a source, and will draw from that file instead the next time it's opened.
 
     @see AudioThumbnailCache, AudioThumbnailBase
 
@@ -190,6 +192,25 @@ public:
     /** Returns the hash code that was set by setSource() or setReader(). */
     int64 getHashCode() const override;
 
+    /** Sets the priority with which this thumbnail should be scanned.
+
+        When the cache has more than one scanning thread, thumbnails with a higher
+        priority are scanned before those with a lower one, so you could e.g. raise
+        the priority of the thumbnails that are visible on screen, and lower it again
+        when they're scrolled out of view. The default priority is 0.
+
+        @see AudioThumbnailCache::setNumScanningThreads
+    */
+    void setPriority (int newPriority);
+
+    /** Returns the priority that was set with setPriority(). */
+    int getPriority() const noexcept;
+
+    /** Returns true if the thumbnail is drawing its data from an AudioPeakFile.
+        @see AudioThumbnailCache::setPeakFileDirectory
+    */
+    bool isUsingPeakFile() const noexcept;
+
 private:
     //==============================================================================
     AudioFormatManager& formatManagerToUse;
@@ -202,6 +223,7 @@ private:
 
     std::unique_ptr<LevelDataSource> source;
     std::unique_ptr<CachedWindow> window;
+    std::unique_ptr<AudioPeakFile> peakFile;
     OwnedArray<ThumbData> channels;
 
     int32 samplesPerThumbSample = 0;
@@ -209,10 +231,12 @@ private:
     int64 numSamplesFinished = 0;
     int32 numChannels = 0;
     double sampleRate = 0;
+    std::atomic<int> priority { 0 };
     CriticalSection lock;
 
     void clearChannelData();
     bool setDataSource (LevelDataSource* newSource);
+    bool openPeakFile (LevelDataSource& newSource);
     void setLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues);
     void createChannels (int length);
 
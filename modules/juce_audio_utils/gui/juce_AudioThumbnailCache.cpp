@@ -58,6 +58,210 @@ private:
     JUCE_LEAK_DETECTOR (ThumbnailCacheEntry)
 };
 
+//==============================================================================
+class AudioThumbnailCache::ScanningThreads
+{
+public:
+    ScanningThreads (int numThreads)
+    {
+        for (int i = 0; i < numThreads; ++i)
+        {
+            auto* worker = workers.add (new Worker (*this, i));
+            worker->startThread (2);
+        }
+    }
+
+    ~ScanningThreads()
+    {
+        jassert (clients.isEmpty()); // all the thumbnails should have been deleted before their cache!
+
+        for (auto* worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (auto* worker : workers)
+            worker->stopThread (5000);
+    }
+
+    int getNumThreads() const noexcept      { return workers.size(); }
+
+    void addClient (TimeSliceClient* client, int priority)
+    {
+        {
+            const ScopedLock sl (listLock);
+
+            if (auto* c = findClient (client))
+            {
+                c->nextCallTime = 0;
+                c->priority = priority;
+            }
+            else
+            {
+                clients.add ({ client, priority, 0 });
+            }
+        }
+
+        notifyAll();
+    }
+
+    void setPriority (TimeSliceClient* client, int newPriority)
+    {
+        const ScopedLock sl (listLock);
+
+        if (auto* c = findClient (client))
+            c->priority = newPriority;
+    }
+
+    void removeClient (TimeSliceClient* client)
+    {
+        const ScopedLock sl (listLock);
+
+        // Stop any other thread from picking up the client while we wait for the one
+        // that might be calling it
+        if (auto* c = findClient (client))
+            c->isBeingRemoved = true;
+
+        // If one of the threads is in the middle of calling this client, we need to wait
+        // for it to finish by taking its callback lock, and then check all the threads again
+        while (auto* worker = findWorkerCalling (client))
+        {
+            const ScopedUnlock ul (listLock);
+            const ScopedLock sl2 (worker->callbackLock);
+        }
+
+        removeFromList (client);
+    }
+
+private:
+    struct ClientInfo
+    {
+        TimeSliceClient* client;
+        int priority;
+        uint32 nextCallTime;
+        bool isBeingCalled = false, isBeingRemoved = false;
+    };
+
+    struct Worker  : public Thread
+    {
+        Worker (ScanningThreads& o, int index)
+            : Thread ("thumb scanner " + String (index + 1)), owner (o)
+        {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                int timeToWait = 500;
+
+                {
+                    const ScopedLock sl (callbackLock);
+
+                    {
+                        const ScopedLock sl2 (owner.listLock);
+                        clientBeingCalled = owner.getNextClient (timeToWait);
+                    }
+
+                    if (clientBeingCalled != nullptr)
+                    {
+                        auto msUntilNextCall = clientBeingCalled->useTimeSlice();
+
+                        const ScopedLock sl2 (owner.listLock);
+                        owner.finishedCalling (clientBeingCalled, msUntilNextCall);
+                        clientBeingCalled = nullptr;
+                        timeToWait = 0;
+                    }
+                }
+
+                if (timeToWait > 0)
+                    wait (timeToWait);
+            }
+        }
+
+        ScanningThreads& owner;
+        CriticalSection callbackLock;
+        TimeSliceClient* clientBeingCalled = nullptr;
+    };
+
+    OwnedArray<Worker> workers;
+    Array<ClientInfo> clients;
+    CriticalSection listLock;
+
+    ClientInfo* findClient (TimeSliceClient* client) noexcept
+    {
+        for (auto& c : clients)
+            if (c.client == client)
+                return &c;
+
+        return nullptr;
+    }
+
+    Worker* findWorkerCalling (TimeSliceClient* client) const noexcept
+    {
+        for (auto* worker : workers)
+            if (worker->clientBeingCalled == client && worker != Thread::getCurrentThread())
+                return worker;
+
+        return nullptr;
+    }
+
+    void removeFromList (TimeSliceClient* client)
+    {
+        for (int i = clients.size(); --i >= 0;)
+            if (clients.getReference (i).client == client)
+                clients.remove (i);
+    }
+
+    // Picks the highest-priority client that's due to be called, and isn't already
+    // being called by another thread. Clients with equal priorities take turns.
+    TimeSliceClient* getNextClient (int& timeToWait)
+    {
+        auto now = Time::getMillisecondCounter();
+        ClientInfo* best = nullptr;
+
+        for (auto& c : clients)
+        {
+            if (c.isBeingCalled || c.isBeingRemoved)
+                continue;
+
+            if (c.nextCallTime > now)
+            {
+                timeToWait = jmin (timeToWait, (int) (c.nextCallTime - now));
+                continue;
+            }
+
+            if (best == nullptr || c.priority > best->priority
+                 || (c.priority == best->priority && c.nextCallTime < best->nextCallTime))
+                best = &c;
+        }
+
+        if (best == nullptr)
+            return nullptr;
+
+        best->isBeingCalled = true;
+        return best->client;
+    }
+
+    void finishedCalling (TimeSliceClient* client, int msUntilNextCall)
+    {
+        if (auto* c = findClient (client))
+        {
+            c->isBeingCalled = false;
+
+            if (msUntilNextCall < 0)
+                removeFromList (client);
+            else
+                c->nextCallTime = Time::getMillisecondCounter() + (uint32) msUntilNextCall;
+        }
+    }
+
+    void notifyAll()
+    {
+        for (auto* worker : workers)
+            worker->notify();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ScanningThreads)
+};
+
 //==============================================================================
 AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs)
     : thread ("thumb cache"),
@@ -69,6 +273,7 @@ AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs)
 
 AudioThumbnailCache::~AudioThumbnailCache()
 {
+    scanningThreads.reset();
 }
 
 AudioThumbnailCache::ThumbnailCacheEntry* AudioThumbnailCache::findThumbFor (const int64 hash) const
@@ -185,6 +390,68 @@ void AudioThumbnailCache::writeToStream (OutputStream& out)
         thumbs.getUnchecked(i)->write (out);
 }
 
+//==============================================================================
+void AudioThumbnailCache::setNumScanningThreads (int numThreads)
+{
+    if (numThreads == getNumScanningThreads())
+        return;
+
+    scanningThreads.reset();
+
+    if (numThreads > 0)
+        scanningThreads = std::make_unique<ScanningThreads> (numThreads);
+}
+
+int AudioThumbnailCache::getNumScanningThreads() const noexcept
+{
+    return scanningThreads != nullptr ? scanningThreads->getNumThreads() : 0;
+}
+
+void AudioThumbnailCache::addScanningClient (TimeSliceClient* client, int priority)
+{
+    if (scanningThreads != nullptr)
+        scanningThreads->addClient (client, priority);
+    else
+        thread.addTimeSliceClient (client);
+}
+
+void AudioThumbnailCache::setScanningClientPriority (TimeSliceClient* client, int newPriority)
+{
+    if (scanningThreads != nullptr)
+        scanningThreads->setPriority (client, newPriority);
+}
+
+void AudioThumbnailCache::removeScanningClient (TimeSliceClient* client)
+{
+    if (scanningThreads != nullptr)
+        scanningThreads->removeClient (client);
+    else
+        thread.removeTimeSliceClient (client);
+}
+
+//==============================================================================
+void AudioThumbnailCache::setPeakFileDirectory (const File& directory)
+{
+    const ScopedLock sl (lock);
+    peakFileDirectory = directory;
+}
+
+File AudioThumbnailCache::getPeakFileDirectory() const
+{
+    const ScopedLock sl (lock);
+    return peakFileDirectory;
+}
+
+File AudioThumbnailCache::getPeakFileFor (int64 hashCode) const
+{
+    const ScopedLock sl (lock);
+
+    if (peakFileDirectory == File())
+        return {};
+
+    return peakFileDirectory.getChildFile (String::toHexString (hashCode) + ".peaks");
+}
+
 void AudioThumbnailCache::saveNewlyFinishedThumbnail (const AudioThumbnailBase&, int64)
 {
 }
@@ -194,4 +461,116 @@ bool AudioThumbnailCache::loadNewThumb (AudioThumbnailBase&, int64)
     return false;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioThumbnailCacheTests  : public UnitTest
+{
+    AudioThumbnailCacheTests()
+        : UnitTest ("AudioThumbnailCache", UnitTestCategories::audio) {}
+
+    struct Client  : public TimeSliceClient
+    {
+        explicit Client (int numCallsWanted)  : numCallsLeft (numCallsWanted) {}
+
+        int useTimeSlice() override
+        {
+            if (hasBeenRemoved)
+                ++numCallsAfterRemoval;
+
+            if (isBeingCalled.exchange (true))
+                ++numOverlappingCalls;
+
+            ++numCalls;
+            Thread::yield();
+            isBeingCalled = false;
+
+            return --numCallsLeft > 0 ? 0 : -1;
+        }
+
+        std::atomic<int> numCalls { 0 }, numCallsLeft, numCallsAfterRemoval { 0 }, numOverlappingCalls { 0 };
+        std::atomic<bool> isBeingCalled { false }, hasBeenRemoved { false };
+    };
+
+    void runTest() override
+    {
+        beginTest ("Scanning threads call each client until it's finished");
+        {
+            AudioThumbnailCache cache (10);
+            cache.setNumScanningThreads (4);
+            expectEquals (cache.getNumScanningThreads(), 4);
+
+            OwnedArray<Client> clients;
+
+            for (int i = 0; i < 16; ++i)
+                cache.addScanningClient (clients.add (new Client (20)), i % 3);
+
+            for (int i = 0; i < 500 && ! allFinished (clients); ++i)
+                Thread::sleep (10);
+
+            expect (allFinished (clients));
+
+            for (auto* c : clients)
+            {
+                expectEquals (c->numCalls.load(), 20);
+                expectEquals (c->numOverlappingCalls.load(), 0);
+                cache.removeScanningClient (c);
+            }
+        }
+
+        beginTest ("Clients can be added and removed while the scanning threads are running");
+        {
+            AudioThumbnailCache cache (10);
+            cache.setNumScanningThreads (4);
+
+            Random r (1234);
+            OwnedArray<Client> clients;
+            int numCallsAfterRemoval = 0, numOverlappingCalls = 0;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                cache.addScanningClient (clients.add (new Client (std::numeric_limits<int>::max())), r.nextInt (3));
+
+                if (clients.size() > 8 || r.nextBool())
+                {
+                    auto index = r.nextInt (clients.size());
+                    std::unique_ptr<Client> c (clients.removeAndReturn (index));
+
+                    if (r.nextBool())
+                        Thread::yield();
+
+                    cache.removeScanningClient (c.get());
+                    c->hasBeenRemoved = true;
+                    expect (! c->isBeingCalled);
+
+                    // Give the other threads a chance to call the client if they still could
+                    Thread::yield();
+                    numCallsAfterRemoval += c->numCallsAfterRemoval;
+                    numOverlappingCalls += c->numOverlappingCalls;
+                }
+            }
+
+            for (auto* c : clients)
+                cache.removeScanningClient (c);
+
+            expectEquals (numCallsAfterRemoval, 0);
+            expectEquals (numOverlappingCalls, 0);
+        }
+    }
+
+    static bool allFinished (const OwnedArray<Client>& clients)
+    {
+        for (auto* c : clients)
+            if (c->numCallsLeft > 0 || c->isBeingCalled)
+                return false;
+
+        return true;
+    }
+};
+
+static AudioThumbnailCacheTests audioThumbnailCacheTests;
+
+#endif
+
 } // namespace juce
@@ -34,6 +34,10 @@ namespace juce
     that need it, and it maintains a set of low-res previews in memory, to avoid
     having to re-scan audio files too often.
 
+    When a lot of files need scanning at once, e.g. after importing a batch of
+    files, you can use setNumScanningThreads() to have several thumbnails scanned
+    concurrently, with the ones that have the highest priority scanned first.
+
     @see AudioThumbnail
 
     @tags{Audio}
@@ -89,6 +93,66 @@ public:
     /** Returns the thread that client thumbnails can use. */
     TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
 
+    //==============================================================================
+    /** Sets the number of threads that should be used to scan thumbnails.
+
+        By default this is 0, which means that all the thumbnails are scanned in turn
+        by the cache's TimeSliceThread. With one or more scanning threads, the thumbnails
+        are scanned by a pool of threads, and those with the highest priority are always
+        given a thread first.
+
+        This must be called before any of the thumbnails that use this cache start scanning.
+
+        @see AudioThumbnail::setPriority
+    */
+    void setNumScanningThreads (int numThreads);
+
+    /** Returns the number of threads that were set by setNumScanningThreads(). */
+    int getNumScanningThreads() const noexcept;
+
+    /** Registers an object that needs time to scan a thumbnail.
+
+        Depending on the number of scanning threads, the client is either added to the
+        TimeSliceThread, or will be called by the next free scanning thread, with higher
+        priority clients being called before lower priority ones. Clients with the same
+        priority are called in turn.
+
+        This is called automatically by the AudioThumbnail class, so you shouldn't
+        normally need to call it directly.
+    */
+    void addScanningClient (TimeSliceClient* client, int priority);
+
+    /** Changes the priority of a client that was registered with addScanningClient(). */
+    void setScanningClientPriority (TimeSliceClient* client, int newPriority);
+
+    /** Removes a client that was registered with addScanningClient().
+        If the client is currently being called, this will wait until it has returned.
+    */
+    void removeScanningClient (TimeSliceClient* client);
+
+    //==============================================================================
+    /** Sets a directory in which AudioPeakFiles should be kept for the thumbnails
+        that use this cache.
+
+        Once this is set, a thumbnail that has to scan its source will also write a
+        peak file for it, and the next time a thumbnail is given the same source, it
+        will memory-map that file instead of reading any audio. This makes it quick
+        to re-open a large number of files, e.g. when loading a session.
+
+        Pass File() to stop using peak files, which is the default.
+
+        @see AudioPeakFile
+    */
+    void setPeakFileDirectory (const File& directory);
+
+    /** Returns the directory set by setPeakFileDirectory(). */
+    File getPeakFileDirectory() const;
+
+    /** Returns the peak file that's used for the source with the given hash code,
+        or File() if there's no peak file directory.
+    */
+    File getPeakFileFor (int64 hashCode) const;
+
 protected:
     /** This can be overridden to provide a custom callback for saving thumbnails
         once they have finished being loaded.
@@ -104,10 +168,14 @@ private:
     //==============================================================================
     TimeSliceThread thread;
 
+    class ScanningThreads;
+    std::unique_ptr<ScanningThreads> scanningThreads;
+
     class ThumbnailCacheEntry;
     OwnedArray<ThumbnailCacheEntry> thumbs;
     CriticalSection lock;
     int maxNumThumbsToStore;
+    File peakFileDirectory;
 
     ThumbnailCacheEntry* findThumbFor (int64 hash) const;
     int findOldestThumb() const;
@@ -268,6 +268,8 @@ void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChann
 
         if (! processor->isSuspended())
         {
+            const ScopedNoAllocation noAllocation ("AudioProcessorPlayer::audioDeviceIOCallback");
+
             if (processor->isUsingDoublePrecision())
             {
                 conversionBuffer.makeCopyOf (buffer, true);
@@ -0,0 +1,584 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, stored in a single flat
+    table rather than in separately-allocated entries.
+
+    This has the same interface as HashMap, and can be used as a drop-in replacement
+    for it in most code, but it's much faster for large maps. Rather than giving each
+    slot a linked list of entries, the keys and values are stored directly in the
+    table, and collisions are resolved by putting entries in the following slots
+    ("open addressing"). The table uses Robin Hood hashing, which keeps every entry
+    close to the slot that its hash selects, so a lookup only needs to look at a
+    few neighbouring slots, and adding an item never allocates unless the table
+    needs to grow.
+
+    There are a few differences from HashMap to be aware of:
+    - The number of slots is always a power of two, and the table grows when it's
+      seven-eighths full, so there are always more slots than items.
+    - Adding or removing items can move other items around in the table, so a
+      reference returned by getReference() or a pointer returned by find() is only
+      valid until the map is next modified.
+    - The hash function is called with an upperLimit that's much larger than the
+      number of slots, and the result is then scrambled to choose a slot. This means
+      that any hash function written for HashMap will work, and simple ones like the
+      DefaultHashFunctions still spread keys evenly across the table.
+
+    The find() method can look up keys using a different type to KeyType, as long as
+    the key type can be compared with it, and the hash function produces the same hash
+    for equal values of both types. For example, a FlatHashMap<String, int> that uses
+    DefaultHashFunctions can be searched with a StringRef, without creating a String.
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+    map.set ("two", 2);
+
+    DBG (map["one"]);      // prints "1"
+
+    if (auto* value = map.find (StringRef ("two")))
+        *value += 10;
+
+    for (FlatHashMap<String, int>::Iterator i (map); i.next();)
+        DBG (i.getKey() << " -> " << i.getValue());
+    @endcode
+
+    @tparam HashFunctionType The class of hash function, which must be copy-constructible.
+    @see HashMap, DefaultHashFunctions
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    using KeyTypeParameter   = typename TypeHelpers::ParameterType<KeyType>::type;
+    using ValueTypeParameter = typename TypeHelpers::ParameterType<ValueType>::type;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param numberOfSlots The initial number of slots in the table, which will be
+                             rounded up to a power of two. The table will grow
+                             automatically when necessary, or it can be resized
+                             manually using remapTable().
+        @param hashFunction  An instance of HashFunctionType, which will be copied and
+                             stored to use with the map. This parameter can be omitted
+                             if HashFunctionType has a default constructor.
+    */
+    explicit FlatHashMap (int numberOfSlots = defaultNumSlots,
+                          HashFunctionType hashFunction = HashFunctionType())
+       : hashFunctionToUse (hashFunction)
+    {
+        allocateSlots (getNumSlotsFor (numberOfSlots));
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Removes all values from the map.
+        Note that this will clear the content, but won't affect the number of slots (see
+        remapTable and getNumSlots).
+    */
+    void clear()
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            if (distances[i] != 0)
+            {
+                getEntry (i).~Entry();
+                distances[i] = 0;
+            }
+        }
+
+        totalNumItems = 0;
+    }
+
+    //==============================================================================
+    /** Returns the current number of items in the map. */
+    inline int size() const noexcept
+    {
+        return totalNumItems;
+    }
+
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+        @param keyToLookFor    the key of the item being requested
+    */
+    inline ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+
+        return index >= 0 ? getEntry (index).value : ValueType();
+    }
+
+    /** Returns a reference to the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is
+        added to the map and a reference to this is returned.
+
+        Note that the reference is only valid until the map is next modified.
+        @param keyToLookFor    the key of the item being requested
+    */
+    inline ValueType& getReference (KeyTypeParameter keyToLookFor)
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+
+        if (index < 0)
+            index = insert (Entry { keyToLookFor, ValueType() });
+
+        return getEntry (index).value;
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the
+        map doesn't contain the key.
+
+        The key can be of any type which can be compared with KeyType using operator==,
+        provided that the map's hash function will generate the same hash for it as
+        for the equivalent KeyType value.
+
+        Note that the pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    ValueType* find (const OtherKeyType& keyToLookFor)
+    {
+        checkLookupType<OtherKeyType>();
+
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+
+        return index >= 0 ? &(getEntry (index).value) : nullptr;
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the
+        map doesn't contain the key.
+        @see find
+    */
+    template <typename OtherKeyType>
+    const ValueType* find (const OtherKeyType& keyToLookFor) const
+    {
+        checkLookupType<OtherKeyType>();
+
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (keyToLookFor);
+
+        return index >= 0 ? &(getEntry (index).value) : nullptr;
+    }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the specified key. */
+    bool contains (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        return findIndex (keyToLookFor) >= 0;
+    }
+
+    /** Returns true if the map contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots; ++i)
+            if (distances[i] != 0 && getEntry (i).value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an element in the map.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (newKey);
+
+        // Inserting can move the other entries around, so the new key and value are copied
+        // into an entry first in case either of them refers to something inside the map
+        if (index >= 0)
+            getEntry (index).value = newValue;
+        else
+            insert (Entry { newKey, newValue });
+    }
+
+    /** Removes an item with the given key. */
+    void remove (KeyTypeParameter keyToRemove)
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (keyToRemove);
+
+        if (index >= 0)
+            removeEntry (index);
+    }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots;)
+        {
+            // removing an entry moves the following ones back, so the same
+            // slot needs checking again
+            if (distances[i] != 0 && getEntry (i).value == valueToRemove)
+                removeEntry (i);
+            else
+                ++i;
+        }
+    }
+
+    /** Changes the number of slots in the table.
+        The new size will be rounded up to a power of two, and will be increased if
+        necessary so that it can hold all the items in the map.
+        @see getNumSlots()
+    */
+    void remapTable (int newNumberOfSlots)
+    {
+        const ScopedLockType sl (getLock());
+
+        auto newNumSlots = getNumSlotsFor (newNumberOfSlots);
+
+        while (getMaxNumItems (newNumSlots) < totalNumItems)
+            newNumSlots *= 2;
+
+        rehash (newNumSlots);
+    }
+
+    /** Returns the number of slots in the table, which is always a power of two.
+        @see remapTable()
+    */
+    inline int getNumSlots() const noexcept
+    {
+        return numSlots;
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    template <class OtherHashMapType>
+    void swapWith (OtherHashMapType& otherHashMap) noexcept
+    {
+        const ScopedLockType lock1 (getLock());
+        const typename OtherHashMapType::ScopedLockType lock2 (otherHashMap.getLock());
+
+        distances.swapWith (otherHashMap.distances);
+        entries.swapWith (otherHashMap.entries);
+        std::swap (numSlots, otherHashMap.numSlots);
+        std::swap (hashShift, otherHashMap.hashShift);
+        std::swap (totalNumItems, otherHashMap.totalNumItems);
+    }
+
+    //==============================================================================
+    /** Returns the CriticalSection that locks this structure.
+        To lock, you can call getLock().enter() and getLock().exit(), or preferably use
+        an object of ScopedLockType as an RAII lock for it.
+    */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** Returns the type of scoped lock to use for locking this array */
+    using ScopedLockType = typename TypeOfCriticalSectionToUse::ScopedLockType;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        KeyType key;
+        ValueType value;
+    };
+
+public:
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        To use it, repeatedly call next() until it returns false, e.g.
+        @code
+        FlatHashMap<String, String> myMap;
+
+        FlatHashMap<String, String>::Iterator i (myMap);
+
+        while (i.next())
+        {
+            DBG (i.getKey() << " -> " << i.getValue());
+        }
+        @endcode
+
+        The order in which items are iterated bears no resemblance to the order in which
+        they were originally added!
+
+        Obviously as soon as you call any non-const methods on the original map, any
+        iterators that were created beforehand will cease to be valid, and should not be used.
+
+        @see FlatHashMap
+    */
+    struct Iterator
+    {
+        Iterator (const FlatHashMap& hashMapToIterate) noexcept
+            : hashMap (hashMapToIterate)
+        {}
+
+        Iterator (const Iterator& other) noexcept
+            : hashMap (other.hashMap), index (other.index)
+        {}
+
+        /** Moves to the next item, if one is available.
+            When this returns true, you can get the item's key and value using getKey() and
+            getValue(). If it returns false, the iteration has finished and you should stop.
+        */
+        bool next() noexcept
+        {
+            while (++index < hashMap.numSlots)
+                if (hashMap.distances[index] != 0)
+                    return true;
+
+            index = hashMap.numSlots;
+            return false;
+        }
+
+        /** Returns the current item's key.
+            This should only be called when a call to next() has just returned true.
+        */
+        KeyType getKey() const
+        {
+            return isPositiveAndBelow (index, hashMap.numSlots) ? hashMap.getEntry (index).key : KeyType();
+        }
+
+        /** Returns the current item's value.
+            This should only be called when a call to next() has just returned true.
+        */
+        ValueType getValue() const
+        {
+            return isPositiveAndBelow (index, hashMap.numSlots) ? hashMap.getEntry (index).value : ValueType();
+        }
+
+        /** Resets the iterator to its starting position. */
+        void reset() noexcept
+        {
+            index = -1;
+        }
+
+        Iterator& operator++() noexcept                         { next(); return *this; }
+        ValueType operator*() const                             { return getValue(); }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+        void resetToEnd() noexcept                              { index = hashMap.numSlots; }
+
+    private:
+        //==============================================================================
+        const FlatHashMap& hashMap;
+        int index = -1;
+
+        // using the copy constructor is ok, but you cannot assign iterators
+        Iterator& operator= (const Iterator&) = delete;
+
+        JUCE_LEAK_DETECTOR (Iterator)
+    };
+
+    /** Returns a start iterator for the values in this map. */
+    Iterator begin() const noexcept             { Iterator i (*this); i.next(); return i; }
+
+    /** Returns an end iterator for the values in this map. */
+    Iterator end() const noexcept               { Iterator i (*this); i.resetToEnd(); return i; }
+
+private:
+    //==============================================================================
+    enum { defaultNumSlots = 16, minNumSlots = 8, maxDistance = 0xffff };
+    friend struct Iterator;
+    template <typename, typename, class, class> friend class FlatHashMap;
+
+    using EntryStorage = typename std::aligned_storage<sizeof (Entry), alignof (Entry)>::type;
+
+    HashFunctionType hashFunctionToUse;
+    HeapBlock<uint16> distances;     // 0 for an empty slot, otherwise 1 + the entry's distance from its ideal slot
+    HeapBlock<EntryStorage> entries;
+    int numSlots = 0, totalNumItems = 0;
+    uint32 hashShift = 0;
+    TypeOfCriticalSectionToUse lock;
+
+    Entry& getEntry (int index) const noexcept          { return *reinterpret_cast<Entry*> (entries.get() + index); }
+    int getNextSlot (int index) const noexcept          { return (index + 1) & (numSlots - 1); }
+    int getPreviousSlot (int index) const noexcept      { return (index - 1) & (numSlots - 1); }
+
+    static int getNumSlotsFor (int numberOfSlots) noexcept      { return nextPowerOfTwo (jmax ((int) minNumSlots, numberOfSlots)); }
+    static int getMaxNumItems (int numberOfSlots) noexcept      { return numberOfSlots - numberOfSlots / 8; }
+
+    template <typename OtherKeyType>
+    static void checkLookupType() noexcept
+    {
+        // Looking up a key with a pointer would use a hash of the pointer's address, rather
+        // than of the thing it points to. If you're using a string literal, wrap it in a StringRef.
+        static_assert (std::is_pointer<KeyType>::value || ! std::is_pointer<typename std::decay<OtherKeyType>::type>::value,
+                       "This key type can't be looked up using a pointer");
+    }
+
+    template <typename OtherKeyType>
+    int getIdealSlot (const OtherKeyType& key) const
+    {
+        const int hash = hashFunctionToUse.generateHash (key, std::numeric_limits<int>::max());
+        jassert (hash >= 0); // your hash function is generating out-of-range numbers!
+
+        // Multiplying by 2^32 / phi and taking the top bits spreads out keys whose hashes
+        // only differ in their upper bits, which a power-of-two table would otherwise ignore
+        return (int) (((uint32) hash * 2654435769u) >> hashShift);
+    }
+
+    template <typename OtherKeyType>
+    int findIndex (const OtherKeyType& keyToLookFor) const
+    {
+        auto index = getIdealSlot (keyToLookFor);
+
+        for (int distance = 1;; ++distance)
+        {
+            const int d = distances[index];
+
+            // an entry that's closer to its ideal slot than we are to ours means that
+            // the key would have displaced it if it were in the table
+            if (d < distance)
+                return -1;
+
+            if (d == distance && getEntry (index).key == keyToLookFor)
+                return index;
+
+            index = getNextSlot (index);
+        }
+    }
+
+    int insert (Entry&& newEntry)
+    {
+        for (;;)
+        {
+            if (totalNumItems >= getMaxNumItems (numSlots))
+            {
+                rehash (numSlots * 2);
+                continue;
+            }
+
+            auto index = getIdealSlot (newEntry.key);
+            int distance = 1;
+
+            while (distances[index] >= distance)
+            {
+                index = getNextSlot (index);
+                ++distance;
+            }
+
+            // The new entry goes in this slot, and the rest of the run gets moved along by one
+            auto emptySlot = index;
+            auto canShift = distance <= maxDistance;
+
+            for (; canShift && distances[emptySlot] != 0; emptySlot = getNextSlot (emptySlot))
+                canShift = distances[emptySlot] < maxDistance;
+
+            if (! canShift)
+            {
+                // This should only happen if your hash function gives the same hash to lots of keys
+                jassert (numSlots < (1 << 24));
+                rehash (numSlots * 2);
+                continue;
+            }
+
+            for (auto i = emptySlot; i != index;)
+            {
+                auto previous = getPreviousSlot (i);
+                new (entries.get() + i) Entry (std::move (getEntry (previous)));
+                getEntry (previous).~Entry();
+                distances[i] = (uint16) (distances[previous] + 1);
+                i = previous;
+            }
+
+            new (entries.get() + index) Entry (std::move (newEntry));
+            distances[index] = (uint16) distance;
+            ++totalNumItems;
+            return index;
+        }
+    }
+
+    void removeEntry (int index)
+    {
+        getEntry (index).~Entry();
+
+        // move the following entries back, until one is found that's already in its ideal slot
+        for (auto next = getNextSlot (index); distances[next] > 1; next = getNextSlot (next))
+        {
+            new (entries.get() + index) Entry (std::move (getEntry (next)));
+            getEntry (next).~Entry();
+            distances[index] = (uint16) (distances[next] - 1);
+            index = next;
+        }
+
+        distances[index] = 0;
+        --totalNumItems;
+    }
+
+    void allocateSlots (int newNumSlots)
+    {
+        jassert (isPowerOfTwo (newNumSlots));
+
+        distances.calloc ((size_t) newNumSlots);
+        entries.malloc ((size_t) newNumSlots);
+        numSlots = newNumSlots;
+        hashShift = 32;
+
+        for (auto n = newNumSlots; n > 1; n >>= 1)
+            --hashShift;
+    }
+
+    void rehash (int newNumSlots)
+    {
+        auto oldDistances = std::move (distances);
+        auto oldEntries = std::move (entries);
+        auto oldNumSlots = numSlots;
+
+        allocateSlots (newNumSlots);
+        totalNumItems = 0;
+
+        for (int i = 0; i < oldNumSlots; ++i)
+        {
+            if (oldDistances[i] != 0)
+            {
+                auto& entry = *reinterpret_cast<Entry*> (oldEntries.get() + i);
+                insert (std::move (entry));
+                entry.~Entry();
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlatHashMap)
+};
+
+} // namespace juce
@@ -43,6 +43,12 @@ struct DefaultHashFunctions
     static int generateHash (int64 key, int upperLimit) noexcept            { return generateHash ((uint64) key, upperLimit); }
     /** Generates a simple hash from a string. */
     static int generateHash (const String& key, int upperLimit) noexcept    { return generateHash ((uint32) key.hashCode(), upperLimit); }
+    /** Generates a simple hash from a StringRef, which matches the hash of the same text in a String.
+        This only accepts actual StringRef objects, so that types which can be converted to either
+        a String or a StringRef don't become ambiguous.
+    */
+    template <typename StringRefType, typename std::enable_if<std::is_same<StringRefType, StringRef>::value, int>::type = 0>
+    static int generateHash (StringRefType key, int upperLimit) noexcept    { return generateHash ((uint32) key.hashCode(), upperLimit); }
     /** Generates a simple hash from a variant. */
     static int generateHash (const var& key, int upperLimit) noexcept       { return generateHash (key.toString(), upperLimit); }
     /** Generates a simple hash from a void ptr. */
@@ -31,20 +31,23 @@ struct HashMapTest : public UnitTest
 
     void runTest() override
     {
-        doTest<AddElementsTest> ("AddElementsTest");
-        doTest<AccessTest> ("AccessTest");
-        doTest<RemoveTest> ("RemoveTest");
-        doTest<PersistantMemoryLocationOfValues> ("PersistantMemoryLocationOfValues");
+        doTest<AddElementsTest, DefaultHashMap> ("AddElementsTest");
+        doTest<AccessTest, DefaultHashMap> ("AccessTest");
+        doTest<RemoveTest, DefaultHashMap> ("RemoveTest");
+        doTest<PersistantMemoryLocationOfValues, DefaultHashMap> ("PersistantMemoryLocationOfValues");
     }
 
+    template <typename KeyType, typename ValueType>
+    using DefaultHashMap = HashMap<KeyType, ValueType>;
+
     //==============================================================================
     struct AddElementsTest
     {
-        template <typename KeyType>
+        template <typename KeyType, template <typename, typename> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -70,11 +73,11 @@ struct HashMapTest : public UnitTest
 
     struct AccessTest
     {
-        template <typename KeyType>
+        template <typename KeyType, template <typename, typename> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
 
@@ -85,11 +88,11 @@ struct HashMapTest : public UnitTest
 
     struct RemoveTest
     {
-        template <typename KeyType>
+        template <typename KeyType, template <typename, typename> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
             auto n = groundTruth.size();
@@ -117,11 +120,11 @@ struct HashMapTest : public UnitTest
     {
         struct AddressAndValue { int value; const int* valueAddress; };
 
-        template <typename KeyType>
+        template <typename KeyType, template <typename, typename> class MapType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, AddressAndValue> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -175,14 +178,14 @@ struct HashMapTest : public UnitTest
     };
 
     //==============================================================================
-    template <class Test>
+    template <class Test, template <typename, typename> class MapType>
     void doTest (const String& testName)
     {
         beginTest (testName);
 
-        Test::template run<int> (*this);
-        Test::template run<void*> (*this);
-        Test::template run<String> (*this);
+        Test::template run<int, MapType> (*this);
+        Test::template run<void*, MapType> (*this);
+        Test::template run<String, MapType> (*this);
     }
 
     //==============================================================================
@@ -219,8 +222,8 @@ struct HashMapTest : public UnitTest
         Array<KeyValuePair> pairs;
     };
 
-    template <typename KeyType, typename ValueType>
-    static void fillWithRandomValues (HashMap<KeyType, int>& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
+    template <typename KeyType, typename ValueType, typename MapType>
+    static void fillWithRandomValues (MapType& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
     {
         RandomKeys<KeyType> keyOracle (300, 3827829);
         Random valueOracle (48735);
@@ -275,4 +278,220 @@ template <> String HashMapTest::RandomKeys<String>::generateRandomKey (Random& r
 
 static HashMapTest hashMapTest;
 
+//==============================================================================
+struct FlatHashMapTest : public UnitTest
+{
+    FlatHashMapTest()
+        : UnitTest ("FlatHashMap", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        doTest<HashMapTest::AddElementsTest> ("AddElementsTest");
+        doTest<HashMapTest::AccessTest> ("AccessTest");
+        doTest<HashMapTest::RemoveTest> ("RemoveTest");
+
+        beginTest ("Large numbers of items");
+        {
+            FlatHashMap<int64, int> map;
+
+            // these keys would all land in the same slot if the table used the hash directly
+            for (int i = 0; i < 100000; ++i)
+                map.set ((int64) i << 20, i);
+
+            expectEquals (map.size(), 100000);
+            expect (isPowerOfTwo (map.getNumSlots()) && map.getNumSlots() > map.size());
+
+            bool allFound = true;
+
+            for (int i = 0; i < 100000; ++i)
+                allFound = allFound && map[(int64) i << 20] == i;
+
+            expect (allFound);
+
+            for (int i = 0; i < 100000; i += 2)
+                map.remove ((int64) i << 20);
+
+            expectEquals (map.size(), 50000);
+
+            bool correctAfterRemoving = true;
+
+            for (int i = 0; i < 100000; ++i)
+                correctAfterRemoving = correctAfterRemoving && map.contains ((int64) i << 20) == ((i & 1) != 0);
+
+            expect (correctAfterRemoving);
+        }
+
+        beginTest ("Colliding hashes");
+        {
+            struct CollidingHash
+            {
+                int generateHash (int key, int upperLimit) const noexcept    { return (key % 3) % upperLimit; }
+            };
+
+            FlatHashMap<int, int, CollidingHash> map;
+
+            for (int i = 0; i < 2000; ++i)
+                map.set (i, -i);
+
+            expectEquals (map.size(), 2000);
+
+            for (int i = 0; i < 2000; i += 3)
+                map.remove (i);
+
+            bool allCorrect = true;
+
+            for (int i = 0; i < 2000; ++i)
+                allCorrect = allCorrect && map.contains (i) == (i % 3 != 0) && (i % 3 == 0 || map[i] == -i);
+
+            expect (allCorrect);
+        }
+
+        beginTest ("Heterogeneous lookup");
+        {
+            expectEquals (StringRef ("hello world").hashCode(), String ("hello world").hashCode());
+
+            FlatHashMap<String, int> map;
+            map.set ("one", 1);
+            map.set ("two", 2);
+
+            if (auto* two = map.find (StringRef ("two")))
+                *two = 22;
+
+            const auto& constMap = map;
+            expect (constMap.find (StringRef ("one")) != nullptr && *constMap.find (StringRef ("one")) == 1);
+            expect (map.find (StringRef ("three")) == nullptr);
+            expect (map.find (String ("two")) != nullptr);
+            expectEquals (map["two"], 22);
+        }
+
+        beginTest ("Iteration, clearing and remapping");
+        {
+            FlatHashMap<int, int> map;
+            int64 expectedTotal = 0;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                map.set (i, i % 10);
+                expectedTotal += i % 10;
+            }
+
+            int64 total = 0;
+
+            for (auto value : map)
+                total += value;
+
+            expectEquals (total, expectedTotal);
+
+            map.removeValue (3);
+            expectEquals (map.size(), 900);
+            expect (! map.containsValue (3));
+
+            map.remapTable (10);
+            expectEquals (map.size(), 900);
+            expect (map.getNumSlots() >= 1024);
+            expectEquals (map[999], 9);
+
+            map.clear();
+            expectEquals (map.size(), 0);
+            expect (! (map.begin() != map.end()));
+        }
+
+        beginTest ("Objects are destroyed");
+        {
+            auto sharedValue = std::make_shared<int> (0);
+
+            {
+                FlatHashMap<int, std::shared_ptr<int>> map;
+
+                for (int i = 0; i < 500; ++i)
+                    map.set (i, sharedValue);
+
+                expectEquals ((int) sharedValue.use_count(), 501);
+
+                for (int i = 0; i < 100; ++i)
+                    map.remove (i);
+
+                expectEquals ((int) sharedValue.use_count(), 401);
+
+                FlatHashMap<int, std::shared_ptr<int>> other;
+                other.set (1000, sharedValue);
+                map.swapWith (other);
+
+                expectEquals (map.size(), 1);
+                expectEquals (other.size(), 400);
+            }
+
+            expectEquals ((int) sharedValue.use_count(), 1);
+        }
+
+        beginTest ("Setting a value from a reference into the map");
+        {
+            FlatHashMap<int, String> map;
+            map.set (0, "zero");
+
+            // Each of these insertions may move the existing entries or grow the table
+            for (int i = 1; i < 200; ++i)
+                map.set (i, map.getReference (i - 1));
+
+            expectEquals (map.size(), 200);
+
+            for (int i = 0; i < 200; ++i)
+                expectEquals (map[i], String ("zero"));
+        }
+
+        beginTest ("Agrees with HashMap and std::unordered_map");
+        {
+            Random r (1234);
+            HashMap<int, int> chainedMap;
+            FlatHashMap<int, int> flatMap;
+            std::unordered_map<int, int> stdMap;
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                auto key = r.nextInt (1000);
+                auto value = r.nextInt();
+
+                if (r.nextInt (4) == 0)
+                {
+                    chainedMap.remove (key);
+                    flatMap.remove (key);
+                    stdMap.erase (key);
+                }
+                else
+                {
+                    chainedMap.set (key, value);
+                    flatMap.set (key, value);
+                    stdMap[key] = value;
+                }
+            }
+
+            expectEquals (flatMap.size(), chainedMap.size());
+            expectEquals (flatMap.size(), (int) stdMap.size());
+
+            for (auto& pair : stdMap)
+            {
+                expect (flatMap.contains (pair.first));
+                expectEquals (flatMap[pair.first], pair.second);
+                expectEquals (chainedMap[pair.first], pair.second);
+            }
+        }
+    }
+
+    template <class Test>
+    void doTest (const String& testName)
+    {
+        beginTest (testName);
+
+        Test::template run<int, DefaultFlatHashMap> (*this);
+        Test::template run<void*, DefaultFlatHashMap> (*this);
+        Test::template run<String, DefaultFlatHashMap> (*this);
+    }
+
+    template <typename KeyType, typename ValueType>
+    using DefaultFlatHashMap = FlatHashMap<KeyType, ValueType>;
+};
+
+static FlatHashMapTest flatHashMapTest;
+
 } // namespace juce
@@ -33,7 +33,8 @@ enum VariantStreamMarkers
     varMarker_Int64     = 6,
     varMarker_Array     = 7,
     varMarker_Binary    = 8,
-    varMarker_Undefined = 9
+    varMarker_Undefined = 9,
+    varMarker_Object    = 10
 };
 
 //==============================================================================
@@ -282,11 +283,9 @@ struct var::VariantType
     {
         auto* s = getString (data);
         const size_t len = s->getNumBytesAsUTF8() + 1;
-        HeapBlock<char> temp (len);
-        s->copyToUTF8 (temp, len);
         output.writeCompressedInt ((int) (len + 1));
         output.writeByte (varMarker_String);
-        output.write (temp, len);
+        output.write (s->toRawUTF8(), len);
     }
 
     constexpr explicit VariantType (StringTag) noexcept
@@ -334,9 +333,28 @@ struct var::VariantType
         return otherType.toObject (otherData) == data.objectValue;
     }
 
-    static void objectWriteToStream (const ValueUnion&, OutputStream& output)
+    static void objectWriteToStream (const ValueUnion& data, OutputStream& output)
     {
-        jassertfalse; // Can't write an object to a stream!
+        if (auto* object = dynamic_cast<DynamicObject*> (data.objectValue))
+        {
+            auto& properties = object->getProperties();
+
+            MemoryOutputStream buffer (512);
+            buffer.writeCompressedInt (properties.size());
+
+            for (auto& property : properties)
+            {
+                buffer.writeString (property.name.toString());
+                property.value.writeToStream (buffer);
+            }
+
+            output.writeCompressedInt (1 + (int) buffer.getDataSize());
+            output.writeByte (varMarker_Object);
+            output << buffer;
+            return;
+        }
+
+        jassertfalse; // Only DynamicObjects can be written to a stream!
         output.writeCompressedInt (0);
     }
 
@@ -880,6 +898,23 @@ var var::readFromStream (InputStream& input)
                 return v;
             }
 
+            case varMarker_Object:
+            {
+                auto* object = new DynamicObject();
+                var v (object);
+
+                for (int i = input.readCompressedInt(); --i >= 0;)
+                {
+                    auto name = input.readString();
+                    auto value = readFromStream (input);
+
+                    if (name.isNotEmpty())
+                        object->setProperty (name, value);
+                }
+
+                return v;
+            }
+
             default:
                 input.skipNextBytes (numBytes - 1); break;
         }
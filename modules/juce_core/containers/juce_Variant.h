@@ -270,7 +270,12 @@ public:
 
     //==============================================================================
     /** Writes a binary representation of this value to a stream.
-        The data can be read back later using readFromStream().
+
+        The data can be read back later using readFromStream(). Primitive values, strings,
+        arrays, binary data and DynamicObjects can all be written, so this is a quicker and
+        more compact alternative to JSON for passing a var between processes. Methods and
+        other kinds of object can't be written.
+
         @see JSON
     */
     void writeToStream (OutputStream& output) const;
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+MemoryMappedFileInputStream::MemoryMappedFileInputStream (const File& f)  : file (f)
+{
+    if (file.getSize() > 0)
+    {
+        mappedFile.reset (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+
+        if (mappedFile->getData() != nullptr)
+        {
+            data = mappedFile->getData();
+            dataSize = mappedFile->getSize();
+        }
+        else
+        {
+            mappedFile.reset();
+        }
+    }
+}
+
+MemoryMappedFileInputStream::~MemoryMappedFileInputStream() = default;
+
+int64 MemoryMappedFileInputStream::getTotalLength()
+{
+    // You should always check that a stream opened successfully before using it!
+    jassert (openedOk());
+
+    return (int64) dataSize;
+}
+
+int MemoryMappedFileInputStream::read (void* buffer, int bytesToRead)
+{
+    // You should always check that a stream opened successfully before using it!
+    jassert (openedOk());
+
+    // The buffer should never be null, and a negative size is probably a
+    // sign that something is broken!
+    jassert (buffer != nullptr && bytesToRead >= 0);
+
+    if (bytesToRead <= 0 || position >= dataSize)
+        return 0;
+
+    auto num = jmin ((size_t) bytesToRead, dataSize - position);
+    memcpy (buffer, addBytesToPointer (data, position), num);
+    position += num;
+
+    return (int) num;
+}
+
+bool MemoryMappedFileInputStream::isExhausted()
+{
+    return position >= dataSize;
+}
+
+int64 MemoryMappedFileInputStream::getPosition()
+{
+    return (int64) position;
+}
+
+bool MemoryMappedFileInputStream::setPosition (int64 pos)
+{
+    position = (size_t) jlimit ((int64) 0, (int64) dataSize, pos);
+    return (int64) position == pos;
+}
+
+void MemoryMappedFileInputStream::skipNextBytes (int64 numBytesToSkip)
+{
+    if (numBytesToSkip > 0)
+        setPosition (getPosition() + numBytesToSkip);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MemoryMappedFileInputStreamTests   : public UnitTest
+{
+    MemoryMappedFileInputStreamTests()
+        : UnitTest ("MemoryMappedFileInputStream", UnitTestCategories::streams)
+    {}
+
+    void runTest() override
+    {
+        const MemoryBlock data ("abcdefghijklmnopqrstuvwxyz", 26);
+
+        TemporaryFile tempFile;
+        tempFile.getFile().replaceWithData (data.getData(), data.getSize());
+
+        beginTest ("Read");
+        {
+            MemoryMappedFileInputStream stream (tempFile.getFile());
+
+            expect (stream.openedOk());
+            expectEquals (stream.getTotalLength(), (int64) data.getSize());
+            expectEquals ((int64) stream.getDataSize(), (int64) data.getSize());
+            expect (memcmp (stream.getData(), data.getData(), data.getSize()) == 0);
+
+            char buffer[40] = {};
+            expectEquals (stream.read (buffer, 10), 10);
+            expect (memcmp (buffer, data.getData(), 10) == 0);
+            expectEquals (stream.getPosition(), (int64) 10);
+
+            expectEquals (stream.read (buffer, 40), 16);
+            expect (memcmp (buffer, addBytesToPointer (data.getData(), 10), 16) == 0);
+            expect (stream.isExhausted());
+            expectEquals (stream.read (buffer, 1), 0);
+        }
+
+        beginTest ("Seek");
+        {
+            MemoryMappedFileInputStream stream (tempFile.getFile());
+
+            expect (stream.setPosition (20));
+            expectEquals ((int) stream.readByte(), (int) 'u');
+
+            stream.skipNextBytes (2);
+            expectEquals ((int) stream.readByte(), (int) 'x');
+
+            expect (! stream.setPosition (100));
+            expect (stream.isExhausted());
+
+            expect (! stream.setPosition (-1));
+            expectEquals (stream.getPosition(), (int64) 0);
+        }
+
+        beginTest ("Missing and empty files");
+        {
+            expect (MemoryMappedFileInputStream (tempFile.getFile().getSiblingFile ("doesNotExist")).failedToOpen());
+
+            TemporaryFile emptyFile;
+            emptyFile.getFile().create();
+            expect (MemoryMappedFileInputStream (emptyFile.getFile()).failedToOpen());
+        }
+    }
+};
+
+static MemoryMappedFileInputStreamTests memoryMappedFileInputStreamTests;
+
+#endif
+
+} // namespace juce
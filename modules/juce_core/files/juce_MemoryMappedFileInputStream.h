@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An input stream that reads from a local file by mapping it into memory.
+
+    Reads are simple copies from the mapped pages, so they don't need a system
+    call or a file lock, and the OS can share the pages between any number of
+    streams which have the same file open. This makes it a good choice when a
+    large number of files need to be read at once, e.g. by a sampler or when
+    decoding a batch of compressed audio files.
+
+    Code which knows about this class can also use getData() to read the file's
+    contents in place, without copying them at all.
+
+    The whole file is mapped when the stream is created, so the file mustn't be
+    truncated while the stream is open. Empty files and files which can't be
+    mapped will fail to open, in which case a FileInputStream can be used instead.
+
+    @see FileInputStream, MemoryMappedFile, MemoryInputStream
+
+    @tags{Core}
+*/
+class JUCE_API  MemoryMappedFileInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a stream to read from the given file.
+
+        After creating the stream, you should use openedOk() or failedToOpen()
+        to make sure that it's OK before trying to read from it!
+    */
+    explicit MemoryMappedFileInputStream (const File& fileToRead);
+
+    /** Destructor. */
+    ~MemoryMappedFileInputStream() override;
+
+    //==============================================================================
+    /** Returns the file that this stream is reading from. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns true if the file couldn't be mapped. */
+    bool failedToOpen() const noexcept                  { return data == nullptr; }
+
+    /** Returns true if the file was mapped without problems. */
+    bool openedOk() const noexcept                      { return data != nullptr; }
+
+    /** Returns a pointer to the file's contents, or nullptr if it couldn't be opened. */
+    const void* getData() const noexcept                { return data; }
+
+    /** Returns the number of bytes that can be read from getData(). */
+    size_t getDataSize() const noexcept                 { return dataSize; }
+
+    //==============================================================================
+    int64 getTotalLength() override;
+    int read (void*, int) override;
+    bool isExhausted() override;
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    void skipNextBytes (int64) override;
+
+private:
+    //==============================================================================
+    const File file;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const void* data = nullptr;
+    size_t dataSize = 0, position = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryMappedFileInputStream)
+};
+
+} // namespace juce
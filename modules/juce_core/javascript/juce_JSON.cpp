@@ -23,12 +23,92 @@
 namespace juce
 {
 
+//==============================================================================
+/*  Scans runs of UTF-8 text a word at a time, which is where most of the time goes
+    when parsing large documents. These only ever read within [start, end), so the
+    caller must know where its text ends.
+*/
+struct JSONTextScanner
+{
+    static constexpr bool canScanText = std::is_same<String::CharPointerType, CharPointer_UTF8>::value;
+
+    static uint64 repeatByte (uint8 b) noexcept             { return 0x0101010101010101ull * b; }
+    static bool containsZeroByte (uint64 word) noexcept     { return ((word - repeatByte (1)) & ~word & repeatByte (0x80)) != 0; }
+
+    static uint64 readWord (const char* p) noexcept
+    {
+        uint64 word;
+        memcpy (&word, p, sizeof (word));
+        return word;
+    }
+
+    /*  Returns the first character in the range that is either the quote character,
+        a backslash or a null, or the end of the range if there isn't one.
+    */
+    static const char* findEndOfPlainText (const char* p, const char* end, char quote) noexcept
+    {
+        auto quotes = repeatByte ((uint8) quote);
+        auto backslashes = repeatByte ((uint8) '\\');
+
+        while (end - p >= 8)
+        {
+            auto word = readWord (p);
+
+            if (containsZeroByte (word) || containsZeroByte (word ^ quotes) || containsZeroByte (word ^ backslashes))
+                break;
+
+            p += 8;
+        }
+
+        while (p < end && *p != quote && *p != '\\' && *p != 0)
+            ++p;
+
+        return p;
+    }
+
+    static bool isWhitespace (char c) noexcept
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    /*  Skips any ASCII whitespace, returning the first character that isn't whitespace,
+        or the end of the range.
+    */
+    static const char* skipWhitespace (const char* p, const char* end) noexcept
+    {
+        auto spaces = repeatByte ((uint8) ' ');
+
+        while (p < end)
+        {
+            if (end - p >= 8 && readWord (p) == spaces)
+                p += 8;
+            else if (isWhitespace (*p))
+                ++p;
+            else
+                break;
+        }
+
+        return p;
+    }
+};
+
+//==============================================================================
 struct JSONParser
 {
-    JSONParser (String::CharPointerType text) : startLocation (text), currentLocation (text) {}
+    JSONParser (String::CharPointerType text)
+        : startLocation (text), currentLocation (text)
+    {}
+
+    JSONParser (String::CharPointerType text, String::CharPointerType end)
+        : startLocation (text), currentLocation (text), endLocation (end.getAddress())
+    {}
 
     String::CharPointerType startLocation, currentLocation;
 
+    // Where the text ends, if it's known. When it is, whitespace and strings can be
+    // scanned a word at a time, rather than character by character.
+    const void* endLocation = nullptr;
+
     struct ErrorException
     {
         String message;
@@ -52,7 +132,41 @@ struct JSONParser
         throw e;
     }
 
-    void skipWhitespace()             { currentLocation = currentLocation.findEndOfWhitespace(); }
+    void skipWhitespace()
+    {
+        if (JSONTextScanner::canScanText && endLocation != nullptr)
+        {
+            auto* p = JSONTextScanner::skipWhitespace (getCurrentAddress(), getEndAddress());
+            currentLocation = String::CharPointerType (reinterpret_cast<const String::CharPointerType::CharType*> (p));
+
+            // anything non-ASCII might be some other kind of unicode whitespace
+            if (static_cast<uint8> (*p) < 0x80)
+                return;
+        }
+
+        currentLocation = currentLocation.findEndOfWhitespace();
+    }
+
+    const char* getCurrentAddress() const noexcept    { return reinterpret_cast<const char*> (currentLocation.getAddress()); }
+    const char* getEndAddress() const noexcept        { return static_cast<const char*> (endLocation); }
+
+    // If the rest of a string contains no escape sequences, this returns a pointer to its
+    // closing quote, otherwise nullptr.
+    const char* findEndOfUnescapedString (juce_wchar quoteChar) const noexcept
+    {
+        if (! JSONTextScanner::canScanText || endLocation == nullptr)
+            return nullptr;
+
+        auto* end = JSONTextScanner::findEndOfPlainText (getCurrentAddress(), getEndAddress(), (char) quoteChar);
+        return end < getEndAddress() && (juce_wchar) *end == quoteChar ? end : nullptr;
+    }
+
+    String::CharPointerType advanceTo (const char* p) noexcept
+    {
+        auto start = currentLocation;
+        currentLocation = String::CharPointerType (reinterpret_cast<const String::CharPointerType::CharType*> (p));
+        return start;
+    }
     juce_wchar readChar()             { return currentLocation.getAndAdvance(); }
     juce_wchar peekChar() const       { return *currentLocation; }
     bool matchIf (char c)             { if (peekChar() == (juce_wchar) c) { ++currentLocation; return true; } return false; }
@@ -82,6 +196,12 @@ struct JSONParser
 
     String parseString (const juce_wchar quoteChar)
     {
+        if (auto* end = findEndOfUnescapedString (quoteChar))
+        {
+            auto start = advanceTo (end + 1);
+            return String (start, String::CharPointerType (reinterpret_cast<const String::CharPointerType::CharType*> (end)));
+        }
+
         MemoryOutputStream buffer (256);
 
         for (;;)
@@ -140,6 +260,22 @@ struct JSONParser
         return buffer.toUTF8();
     }
 
+    Identifier parsePropertyName()
+    {
+        // This avoids creating a String for names that are already in the pool
+        if (auto* end = findEndOfUnescapedString ('"'))
+        {
+            auto start = advanceTo (end + 1);
+
+            if (start.getAddress() == end)
+                return {};
+
+            return Identifier (start, String::CharPointerType (reinterpret_cast<const String::CharPointerType::CharType*> (end)));
+        }
+
+        return Identifier (parseString ('"'));
+    }
+
     var parseAny()
     {
         skipWhitespace();
@@ -192,6 +328,7 @@ struct JSONParser
 
         int64 intValue = readChar() - '0';
         jassert (intValue >= 0 && intValue < 10);
+        int numDigits = 1;
 
         for (;;)
         {
@@ -202,13 +339,20 @@ struct JSONParser
             if (isPositiveAndBelow (digit, 10))
             {
                 intValue = intValue * 10 + digit;
+                ++numDigits;
                 continue;
             }
 
             if (c == 'e' || c == 'E' || c == '.')
             {
-                currentLocation = originalPos;
-                auto asDouble = CharacterFunctions::readDoubleValue (currentLocation);
+                double asDouble;
+
+                if (! readExactDouble (c, intValue, numDigits, asDouble))
+                {
+                    currentLocation = originalPos;
+                    asDouble = CharacterFunctions::readDoubleValue (currentLocation);
+                }
+
                 return var (isNegative ? -asDouble : asDouble);
             }
 
@@ -228,6 +372,90 @@ struct JSONParser
                                      : var ((int) correctedValue);
     }
 
+    /*  Most numbers in real documents have few enough digits, and a small enough exponent,
+        that they can be converted by a single multiplication or division which gives exactly
+        the same result as strtod, but much more quickly. This returns false for anything else.
+    */
+    bool readExactDouble (juce_wchar c, int64 mantissa, int numDigits, double& result)
+    {
+        static const double exactPowersOf10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        const int maxExactDigits = 15;
+        const int maxExactExponent = numElementsInArray (exactPowersOf10) - 1;
+
+        if (numDigits > maxExactDigits)
+            return false;
+
+        auto p = currentLocation;
+        int exponent = 0;
+
+        if (c == '.')
+        {
+            auto firstDigit = p;
+
+            for (;;)
+            {
+                auto digit = ((int) *p) - '0';
+
+                if (! isPositiveAndBelow (digit, 10))
+                    break;
+
+                if (++numDigits > maxExactDigits)
+                    return false;
+
+                mantissa = mantissa * 10 + digit;
+                --exponent;
+                ++p;
+            }
+
+            if (p == firstDigit)
+                return false;
+
+            c = *p;
+
+            if (c == 'e' || c == 'E')
+                ++p;
+        }
+
+        if (c == 'e' || c == 'E')
+        {
+            auto isNegativeExponent = (*p == '-');
+
+            if (*p == '-' || *p == '+')
+                ++p;
+
+            auto firstDigit = p;
+            int explicitExponent = 0;
+
+            for (;;)
+            {
+                auto digit = ((int) *p) - '0';
+
+                if (! isPositiveAndBelow (digit, 10))
+                    break;
+
+                if (explicitExponent > maxExactExponent + maxExactDigits)
+                    return false;
+
+                explicitExponent = explicitExponent * 10 + digit;
+                ++p;
+            }
+
+            if (p == firstDigit)
+                return false;
+
+            exponent += isNegativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (exponent < -maxExactExponent || exponent > maxExactExponent)
+            return false;
+
+        result = exponent < 0 ? (double) mantissa / exactPowersOf10[-exponent]
+                              : (double) mantissa * exactPowersOf10[exponent];
+        currentLocation = p;
+        return true;
+    }
+
     var parseObject()
     {
         auto resultObject = new DynamicObject();
@@ -251,7 +479,7 @@ struct JSONParser
                 throwError ("Expected a property name in double-quotes", errorLocation);
 
             errorLocation = currentLocation;
-            Identifier propertyName (parseString ('"'));
+            auto propertyName = parsePropertyName();
 
             if (! propertyName.isValid())
                 throwError ("Invalid property name", errorLocation);
@@ -327,13 +555,17 @@ struct JSONFormatter
         {
             out << (static_cast<bool> (v) ? "true" : "false");
         }
+        else if (v.isInt() || v.isInt64())
+        {
+            writeInteger (out, static_cast<int64> (v));
+        }
         else if (v.isDouble())
         {
             auto d = static_cast<double> (v);
 
             if (juce_isfinite (d))
             {
-                out << serialiseDouble (d);
+                writeDouble (out, d);
             }
             else
             {
@@ -360,15 +592,167 @@ struct JSONFormatter
         }
     }
 
+    static void writeInteger (OutputStream& out, int64 value)
+    {
+        char buffer[NumberToStringConverters::charsNeededForInt];
+        auto* end = buffer + numElementsInArray (buffer);
+        auto* start = NumberToStringConverters::numberToString (end, value);
+        out.write (start, (size_t) (end - start - 1));
+    }
+
+    /*  Finds the fewest significant digits which will read back as exactly the same
+        double, so that the value is d[0].d[1]d[2]... x 10^exponent. The value must be
+        positive and finite.
+    */
+    static int findShortestDigits (double value, char* digits, int& exponent)
+    {
+        char buffer[NumberToStringConverters::charsNeededForDouble + 1];
+        size_t length = 0;
+
+       #if defined (__cpp_lib_to_chars)
+        length = (size_t) (std::to_chars (buffer, buffer + sizeof (buffer) - 1, value, std::chars_format::scientific).ptr - buffer);
+       #else
+        // Without std::to_chars, try 15, 16 and then 17 significant digits. These round-trip
+        // through the same strtod that the parser uses, so it'll never lose any precision.
+        for (int numDecimalPlaces = 14; numDecimalPlaces <= 16; ++numDecimalPlaces)
+        {
+            NumberToStringConverters::doubleToString (buffer, value, numDecimalPlaces, true, length);
+            buffer[length] = 0;
+
+            CharPointer_ASCII p (buffer);
+
+            if (CharacterFunctions::readDoubleValue (p) == value)
+                break;
+        }
+       #endif
+
+        buffer[length] = 0;
+        int numDigits = 0;
+        auto* p = buffer;
+
+        for (; *p != 0 && *p != 'e'; ++p)
+            if (*p != '.')
+                digits[numDigits++] = *p;
+
+        while (numDigits > 1 && digits[numDigits - 1] == '0')
+            --numDigits;
+
+        exponent = (*p == 'e') ? atoi (p + 1) : 0;
+        return numDigits;
+    }
+
+    /*  Writes a double using the fewest digits that will read back as the same value,
+        laid out in the same way as the rest of the library's serialised doubles.
+    */
+    static void writeDouble (OutputStream& out, double value)
+    {
+        char buffer[64];
+        auto* d = buffer;
+
+        if (std::signbit (value))
+            *d++ = '-';
+
+        auto absValue = std::abs (value);
+
+        if (absValue == 0)
+        {
+            *d++ = '0';
+            *d++ = '.';
+            *d++ = '0';
+            out.write (buffer, (size_t) (d - buffer));
+            return;
+        }
+
+        char digits[24];
+        int exponent = 0;
+        auto numDigits = findShortestDigits (absValue, digits, exponent);
+
+        auto writeDigits = [&d, &digits] (int start, int end)
+        {
+            for (int i = start; i < end; ++i)
+                *d++ = digits[i];
+        };
+
+        if (absValue >= 1.0e6 || absValue <= 1.0e-5)
+        {
+            *d++ = digits[0];
+            *d++ = '.';
+
+            if (numDigits > 1)
+                writeDigits (1, numDigits);
+            else
+                *d++ = '0';
+
+            char exponentDigits[NumberToStringConverters::charsNeededForInt];
+            auto* end = exponentDigits + numElementsInArray (exponentDigits);
+            auto* start = NumberToStringConverters::numberToString (end, exponent);
+
+            *d++ = 'e';
+            d = std::copy (start, end - 1, d);
+        }
+        else if (exponent >= 0)
+        {
+            writeDigits (0, jmin (numDigits, exponent + 1));
+
+            for (int i = numDigits; i <= exponent; ++i)
+                *d++ = '0';
+
+            *d++ = '.';
+
+            if (numDigits > exponent + 1)
+                writeDigits (exponent + 1, numDigits);
+            else
+                *d++ = '0';
+        }
+        else
+        {
+            *d++ = '0';
+            *d++ = '.';
+
+            for (int i = -1; i > exponent; --i)
+                *d++ = '0';
+
+            writeDigits (0, numDigits);
+        }
+
+        out.write (buffer, (size_t) (d - buffer));
+    }
+
     static void writeEscapedChar (OutputStream& out, const unsigned short value)
     {
-        out << "\\u" << String::toHexString ((int) value).paddedLeft ('0', 4);
+        char buffer[6] = { '\\', 'u' };
+
+        for (int i = 0; i < 4; ++i)
+            buffer[2 + i] = "0123456789abcdef"[(value >> (12 - 4 * i)) & 15];
+
+        out.write (buffer, sizeof (buffer));
+    }
+
+    static bool isPlainChar (char c) noexcept
+    {
+        return c >= 32 && c < 127 && c != '"' && c != '\\';
     }
 
     static void writeString (OutputStream& out, String::CharPointerType t)
     {
         for (;;)
         {
+            // Write runs of characters that don't need escaping in one go
+            if (JSONTextScanner::canScanText)
+            {
+                auto* start = reinterpret_cast<const char*> (t.getAddress());
+                auto* end = start;
+
+                while (isPlainChar (*end))
+                    ++end;
+
+                if (end != start)
+                {
+                    out.write (start, (size_t) (end - start));
+                    t = String::CharPointerType (reinterpret_cast<const String::CharPointerType::CharType*> (end));
+                }
+            }
+
             auto c = t.getAndAdvance();
 
             switch (c)
@@ -451,6 +835,40 @@ struct JSONFormatter
         out << ']';
     }
 
+    /*  Makes a rough guess at the number of bytes that write() will produce, so that
+        the output can be allocated in one go.
+    */
+    static size_t estimateSize (const var& v, int indentLevel, bool allOnOneLine)
+    {
+        if (v.isString())
+            return v.toString().getNumBytesAsUTF8() + 2;
+
+        auto childIndentSize = (size_t) (allOnOneLine ? 2 : indentLevel + indentSize + 2);
+
+        if (auto* array = v.getArray())
+        {
+            size_t total = 2 + (size_t) indentLevel;
+
+            for (auto& child : *array)
+                total += childIndentSize + estimateSize (child, indentLevel + indentSize, allOnOneLine);
+
+            return total;
+        }
+
+        if (auto* object = v.getDynamicObject())
+        {
+            size_t total = 2 + (size_t) indentLevel;
+
+            for (auto& property : object->getProperties())
+                total += childIndentSize + 4 + property.name.toString().getNumBytesAsUTF8()
+                           + estimateSize (property.value, indentLevel + indentSize, allOnOneLine);
+
+            return total;
+        }
+
+        return v.isDouble() ? 20 : 8;
+    }
+
     enum { indentSize = 2 };
 };
 
@@ -469,7 +887,7 @@ var JSON::fromString (StringRef text)
 {
     try
     {
-        return JSONParser (text.text).parseAny();
+        return JSONParser (text.text, text.text.findTerminatingNull()).parseAny();
     }
     catch (const JSONParser::ErrorException&) {}
 
@@ -490,7 +908,8 @@ Result JSON::parse (const String& text, var& result)
 {
     try
     {
-        result = JSONParser (text.getCharPointer()).parseObjectOrArray();
+        auto t = text.getCharPointer();
+        result = JSONParser (t, t.findTerminatingNull()).parseObjectOrArray();
     }
     catch (const JSONParser::ErrorException& error)
     {
@@ -502,7 +921,7 @@ Result JSON::parse (const String& text, var& result)
 
 String JSON::toString (const var& data, const bool allOnOneLine, int maximumDecimalPlaces)
 {
-    MemoryOutputStream mo (1024);
+    MemoryOutputStream mo (JSONFormatter::estimateSize (data, 0, allOnOneLine));
     JSONFormatter::write (mo, data, 0, allOnOneLine, maximumDecimalPlaces);
     return mo.toUTF8();
 }
@@ -661,6 +1080,27 @@ public:
             }
         }
 
+        {
+            beginTest ("Numbers and strings");
+
+            auto r = getRandom();
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto d = r.nextDouble() * std::pow (10.0, r.nextInt ({ -30, 30 }));
+                auto text = String (d, 1 + r.nextInt (18), r.nextBool());
+                expectEquals ((double) JSON::parse ("[" + text + "]")[0], text.getDoubleValue(), text);
+            }
+
+            auto parsed = JSON::parse ("{ \"plain\": \"abc\", \"esc\\taped\": \"a\\\"b\\u00e9\", \"\": 1 }");
+            expect (parsed.isVoid());
+
+            parsed = JSON::parse ("{ \"plain\": \"abcdefghijklmnopqrstuvwxyz\", \"esc\\taped\": \"a\\\"b\\u00e9\", \"single\": 'x' }");
+            expectEquals (parsed["plain"].toString(), String ("abcdefghijklmnopqrstuvwxyz"));
+            expectEquals (parsed["esc\taped"].toString(), String (CharPointer_UTF8 ("a\"b\xc3\xa9")));
+            expectEquals (parsed["single"].toString(), String ("x"));
+        }
+
         {
             beginTest ("Float formatting");
 
@@ -674,7 +1114,7 @@ public:
             tests[0.0123] = "0.0123";
             tests[-3.7e-27] = "-3.7e-27";
             tests[1e+40] = "1.0e40";
-            tests[-12345678901234567.0] = "-1.234567890123457e16";
+            tests[-12345678901234567.0] = "-1.2345678901234568e16";
             tests[192000] = "192000.0";
             tests[1234567] = "1.234567e6";
             tests[0.00006] = "0.00006";
@@ -682,6 +1122,36 @@ public:
 
             for (auto& test : tests)
                 expectEquals (JSON::toString (test.first), test.second);
+
+            auto r = getRandom();
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto d = (r.nextDouble() - 0.5) * std::pow (10.0, r.nextInt ({ -300, 300 }));
+                auto text = JSON::toString (d);
+                expectEquals ((double) JSON::fromString (text), d, text);
+                expect (text.length() <= 24, text);
+            }
+        }
+
+        {
+            beginTest ("Binary encoding");
+
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto v = createRandomVar (r, 0);
+
+                MemoryOutputStream out;
+                v.writeToStream (out);
+
+                MemoryInputStream in (out.getData(), out.getDataSize(), false);
+                auto restored = var::readFromStream (in);
+
+                expectEquals (JSON::toString (restored), JSON::toString (v));
+                expect (in.isExhausted());
+            }
         }
     }
 };
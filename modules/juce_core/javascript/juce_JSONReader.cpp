@@ -0,0 +1,675 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static const int jsonReaderBufferSize = 32768;
+
+JSONReader::JSONReader (InputStream& source)
+    : input (source), buffer ((size_t) jsonReaderBufferSize)
+{
+    readPosition = bufferEnd = buffer.get();
+}
+
+JSONReader::~JSONReader() {}
+
+//==============================================================================
+bool JSONReader::fillBuffer()
+{
+    bufferStartPosition += bufferEnd - buffer.get();
+    auto numRead = input.read (buffer.get(), jsonReaderBufferSize);
+
+    readPosition = buffer.get();
+    bufferEnd = readPosition + jmax (0, numRead);
+    return numRead > 0;
+}
+
+int JSONReader::peekByte()
+{
+    if (readPosition == bufferEnd && ! fillBuffer())
+        return -1;
+
+    return (uint8) *readPosition;
+}
+
+void JSONReader::skipWhitespace()
+{
+    for (;;)
+    {
+        readPosition = JSONTextScanner::skipWhitespace (readPosition, bufferEnd);
+
+        if (readPosition < bufferEnd)
+        {
+            if (! CharacterFunctions::isWhitespace (*readPosition))
+                return;
+
+            ++readPosition;
+        }
+        else if (! fillBuffer())
+        {
+            return;
+        }
+    }
+}
+
+int64 JSONReader::getPosition() const noexcept
+{
+    return bufferStartPosition + (readPosition - buffer.get());
+}
+
+JSONReader::Token JSONReader::fail (const String& message)
+{
+    error = Result::fail ("byte " + String (getPosition()) + ": error: " + message);
+    return currentToken = Token::error;
+}
+
+//==============================================================================
+JSONReader::Token JSONReader::next()
+{
+    if (currentToken == Token::error || currentToken == Token::endOfStream)
+        return currentToken;
+
+    if (currentToken == Token::none && fillBuffer() && bufferEnd - readPosition >= 3
+         && memcmp (readPosition, "\xef\xbb\xbf", 3) == 0)
+        readPosition += 3;
+
+    for (;;)
+    {
+        skipWhitespace();
+        auto c = peekByte();
+
+        switch (state)
+        {
+            case State::colon:
+                if (c != ':')
+                    return fail ("Expected ':'");
+
+                ++readPosition;
+                state = State::value;
+                break;
+
+            case State::separatorOrEnd:
+            {
+                auto isObject = (containers.getLast() == '{');
+
+                if (c == (isObject ? '}' : ']'))
+                    return closeContainer (isObject ? Token::endObject : Token::endArray);
+
+                if (c != ',')
+                    return fail (isObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+
+                // (like JSON::parse(), this allows a trailing comma before the closing bracket)
+                ++readPosition;
+                state = isObject ? State::firstPropertyOrEnd : State::firstValueOrEnd;
+                break;
+            }
+
+            case State::firstPropertyOrEnd:
+                if (c == '}')
+                    return closeContainer (Token::endObject);
+
+                JUCE_FALLTHROUGH
+
+            case State::property:
+                if (c != '"')
+                    return fail (c < 0 ? "Unexpected EOF in object declaration"
+                                       : "Expected a property name in double-quotes");
+
+                ++readPosition;
+
+                if (! readString ('"'))
+                    return currentToken;
+
+                state = State::colon;
+                return currentToken = Token::propertyName;
+
+            case State::firstValueOrEnd:
+                if (c == ']')
+                    return closeContainer (Token::endArray);
+
+                JUCE_FALLTHROUGH
+
+            case State::value:
+                return readValueToken (c);
+        }
+    }
+}
+
+JSONReader::Token JSONReader::readValueToken (int c)
+{
+    switch (c)
+    {
+        case '{':   ++readPosition; return openContainer ('{', Token::startObject);
+        case '[':   ++readPosition; return openContainer ('[', Token::startArray);
+
+        case '"':
+        case '\'':
+            ++readPosition;
+            return readString ((char) c) ? finishValue (Token::string) : currentToken;
+
+        case 't':   return matchLiteral ("true")  ? finishValue (Token::boolean) : fail ("Syntax error");
+        case 'f':   return matchLiteral ("false") ? finishValue (Token::boolean) : fail ("Syntax error");
+        case 'n':   return matchLiteral ("null")  ? finishValue (Token::null)    : fail ("Syntax error");
+
+        case -1:
+            if (containers.isEmpty())
+                return currentToken = Token::endOfStream;
+
+            return fail ("Unexpected EOF in " + String (containers.getLast() == '{' ? "object" : "array") + " declaration");
+
+        default:
+            if (c == '-' || isPositiveAndBelow (c - '0', 10))
+                return readNumber() ? finishValue (Token::number) : fail ("Syntax error in number");
+
+            return fail ("Syntax error");
+    }
+}
+
+JSONReader::Token JSONReader::openContainer (char type, Token token)
+{
+    containers.add (type);
+    state = (type == '{') ? State::firstPropertyOrEnd : State::firstValueOrEnd;
+    return currentToken = token;
+}
+
+JSONReader::Token JSONReader::closeContainer (Token token)
+{
+    ++readPosition;
+    containers.removeLast();
+    return finishValue (token);
+}
+
+JSONReader::Token JSONReader::finishValue (Token token)
+{
+    state = containers.isEmpty() ? State::value : State::separatorOrEnd;
+    return currentToken = token;
+}
+
+//==============================================================================
+bool JSONReader::readString (char quote)
+{
+    tokenText.reset();
+
+    for (;;)
+    {
+        if (readPosition == bufferEnd && ! fillBuffer())
+        {
+            fail ("Unexpected EOF in string constant");
+            return false;
+        }
+
+        auto* end = JSONTextScanner::findEndOfPlainText (readPosition, bufferEnd, quote);
+
+        if (! isSkipping)
+            tokenText.write (readPosition, (size_t) (end - readPosition));
+
+        readPosition = end;
+
+        if (end == bufferEnd)
+            continue;
+
+        auto c = *readPosition++;
+
+        if (c == quote)
+            break;
+
+        if (c == 0)
+        {
+            fail ("Unexpected EOF in string constant");
+            return false;
+        }
+
+        if (! readEscapeSequence())
+            return false;
+    }
+
+    tokenText.writeByte (0);
+    return true;
+}
+
+bool JSONReader::readEscapeSequence()
+{
+    auto c = (juce_wchar) peekByte();
+
+    if (peekByte() < 0)
+    {
+        fail ("Unexpected EOF in string constant");
+        return false;
+    }
+
+    ++readPosition;
+
+    switch (c)
+    {
+        case 'a':  c = '\a'; break;
+        case 'b':  c = '\b'; break;
+        case 'f':  c = '\f'; break;
+        case 'n':  c = '\n'; break;
+        case 'r':  c = '\r'; break;
+        case 't':  c = '\t'; break;
+
+        case 'u':
+        {
+            c = 0;
+
+            for (int i = 4; --i >= 0;)
+            {
+                auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) jmax (0, peekByte()));
+
+                if (digitValue < 0)
+                {
+                    fail ("Syntax error in unicode escape sequence");
+                    return false;
+                }
+
+                ++readPosition;
+                c = (juce_wchar) ((c << 4) + static_cast<juce_wchar> (digitValue));
+            }
+
+            break;
+        }
+
+        default:  break;
+    }
+
+    if (c == 0)
+    {
+        fail ("Unexpected EOF in string constant");
+        return false;
+    }
+
+    if (! isSkipping)
+        tokenText.appendUTF8Char (c);
+
+    return true;
+}
+
+bool JSONReader::readNumber()
+{
+    tokenText.reset();
+
+    auto readDigits = [this]
+    {
+        bool anyDigits = false;
+
+        while (isPositiveAndBelow (peekByte() - '0', 10))
+        {
+            auto* start = readPosition;
+
+            while (readPosition < bufferEnd && isPositiveAndBelow (*readPosition - '0', 10))
+                ++readPosition;
+
+            tokenText.write (start, (size_t) (readPosition - start));
+            anyDigits = true;
+        }
+
+        return anyDigits;
+    };
+
+    if (peekByte() == '-')
+    {
+        tokenText.writeByte (*readPosition++);
+        skipWhitespace();
+    }
+
+    if (! readDigits())
+        return false;
+
+    if (peekByte() == '.')
+    {
+        tokenText.writeByte (*readPosition++);
+
+        if (! readDigits())
+            return false;
+    }
+
+    if (peekByte() == 'e' || peekByte() == 'E')
+    {
+        tokenText.writeByte (*readPosition++);
+
+        if (peekByte() == '+' || peekByte() == '-')
+            tokenText.writeByte (*readPosition++);
+
+        if (! readDigits())
+            return false;
+    }
+
+    auto c = peekByte();
+
+    if (c >= 0 && c != ',' && c != '}' && c != ']' && ! CharacterFunctions::isWhitespace ((char) c))
+        return false;
+
+    tokenText.writeByte (0);
+    return true;
+}
+
+bool JSONReader::matchLiteral (const char* literal)
+{
+    tokenText.reset();
+
+    for (auto* t = literal; *t != 0; ++t)
+    {
+        if (peekByte() != *t)
+            return false;
+
+        tokenText.writeByte (*readPosition++);
+    }
+
+    tokenText.writeByte (0);
+    return true;
+}
+
+//==============================================================================
+StringRef JSONReader::getText() const noexcept
+{
+    switch (currentToken)
+    {
+        case Token::propertyName:
+        case Token::string:
+        case Token::number:
+        case Token::boolean:
+        case Token::null:
+            return static_cast<const char*> (tokenText.getData());
+
+        case Token::none:
+        case Token::startObject:
+        case Token::endObject:
+        case Token::startArray:
+        case Token::endArray:
+        case Token::endOfStream:
+        case Token::error:
+        default:
+            return {};
+    }
+}
+
+String::CharPointerType JSONReader::getEndOfText() const noexcept
+{
+    // the text always ends with a null, which isn't part of it
+    return String::CharPointerType (static_cast<const char*> (tokenText.getData()) + tokenText.getDataSize() - 1);
+}
+
+var JSONReader::getValue() const
+{
+    switch (currentToken)
+    {
+        case Token::string:
+            return String (getText().text, getEndOfText());
+
+        case Token::number:
+        {
+            // This makes sure that numbers get the same types and values as they would from JSON::parse()
+            try
+            {
+                return JSONParser (getText().text, getEndOfText()).parseAny();
+            }
+            catch (const JSONParser::ErrorException&) {}
+
+            return {};
+        }
+
+        case Token::boolean:
+            return var (*getText().text == 't');
+
+        case Token::none:
+        case Token::startObject:
+        case Token::endObject:
+        case Token::startArray:
+        case Token::endArray:
+        case Token::propertyName:
+        case Token::null:
+        case Token::endOfStream:
+        case Token::error:
+        default:
+            return {};
+    }
+}
+
+var JSONReader::readValue()
+{
+    if (currentToken == Token::startObject)
+    {
+        auto* object = new DynamicObject();
+        var result (object);
+
+        while (next() == Token::propertyName)
+        {
+            if (getText().isEmpty())
+            {
+                fail ("Invalid property name");
+                return {};
+            }
+
+            Identifier name (getText().text, getEndOfText());
+            next();
+            auto value = readValue();
+
+            if (currentToken == Token::error)
+                return {};
+
+            object->setProperty (name, std::move (value));
+        }
+
+        return currentToken == Token::endObject ? result : var();
+    }
+
+    if (currentToken == Token::startArray)
+    {
+        Array<var> items;
+
+        for (;;)
+        {
+            auto token = next();
+
+            if (token == Token::endArray)
+                return items;
+
+            if (token == Token::error || token == Token::endOfStream)
+                return {};
+
+            items.add (readValue());
+
+            if (currentToken == Token::error)
+                return {};
+        }
+    }
+
+    return getValue();
+}
+
+void JSONReader::skip()
+{
+    if (currentToken != Token::startObject && currentToken != Token::startArray)
+        return;
+
+    auto depth = containers.size();
+    const ScopedValueSetter<bool> svs (isSkipping, true);
+
+    while (containers.size() >= depth)
+    {
+        auto token = next();
+
+        if (token == Token::error || token == Token::endOfStream)
+            break;
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONReaderTests  : public UnitTest
+{
+public:
+    JSONReaderTests()
+        : UnitTest ("JSONReader", UnitTestCategories::json)
+    {}
+
+    // Hands out its data a few bytes at a time, so that tokens get split between reads
+    struct TrickleInputStream  : public MemoryInputStream
+    {
+        TrickleInputStream (const String& text, Random& r)
+            : MemoryInputStream (text.toRawUTF8(), text.getNumBytesAsUTF8(), true), random (r)
+        {}
+
+        int read (void* dest, int maxBytes) override
+        {
+            return MemoryInputStream::read (dest, jmin (maxBytes, 1 + random.nextInt (7)));
+        }
+
+        Random& random;
+    };
+
+    static MemoryBlock toMemoryBlock (const String& text)
+    {
+        return { text.toRawUTF8(), text.getNumBytesAsUTF8() };
+    }
+
+    static Array<JSONReader::Token> readAllTokens (const String& text)
+    {
+        MemoryInputStream in (toMemoryBlock (text), true);
+        JSONReader reader (in);
+        Array<JSONReader::Token> tokens;
+
+        for (;;)
+        {
+            tokens.add (reader.next());
+
+            if (tokens.getLast() == JSONReader::Token::endOfStream || tokens.getLast() == JSONReader::Token::error)
+                return tokens;
+        }
+    }
+
+    static var readWholeValue (InputStream& in, Result& result)
+    {
+        JSONReader reader (in);
+        reader.next();
+        auto v = reader.readValue();
+        result = reader.getError();
+        return v;
+    }
+
+    void runTest() override
+    {
+        using Token = JSONReader::Token;
+
+        beginTest ("Tokens");
+        {
+            MemoryInputStream in (toMemoryBlock (CharPointer_UTF8 ("\xef\xbb\xbf { \"a\\u0041\": [1, -2.5e3, \"x\\ny\", true, false, null, {}], \"b\": 12345678901234 }")), true);
+            JSONReader reader (in);
+
+            expect (reader.next() == Token::startObject);
+            expectEquals (reader.getDepth(), 1);
+            expect (reader.next() == Token::propertyName);
+            expectEquals (String (reader.getText()), String ("aA"));
+            expect (reader.next() == Token::startArray);
+            expectEquals (reader.getDepth(), 2);
+            expect (reader.next() == Token::number);
+            expect (reader.getValue().isInt() && (int) reader.getValue() == 1);
+            expect (reader.next() == Token::number);
+            expectEquals (String (reader.getText()), String ("-2.5e3"));
+            expect (reader.getValue().isDouble() && (double) reader.getValue() == -2500.0);
+            expect (reader.next() == Token::string);
+            expectEquals (reader.getValue().toString(), String ("x\ny"));
+            expect (reader.next() == Token::boolean && (bool) reader.getValue());
+            expect (reader.next() == Token::boolean && ! (bool) reader.getValue());
+            expect (reader.next() == Token::null && reader.getValue().isVoid());
+            expect (reader.next() == Token::startObject);
+            expect (reader.next() == Token::endObject);
+            expect (reader.next() == Token::endArray);
+            expectEquals (reader.getDepth(), 1);
+            expect (reader.next() == Token::propertyName);
+            expect (reader.next() == Token::number && reader.getValue().isInt64());
+            expect (reader.next() == Token::endObject);
+            expectEquals (reader.getDepth(), 0);
+            expect (reader.next() == Token::endOfStream);
+            expect (reader.next() == Token::endOfStream);
+            expect (reader.getError().wasOk());
+        }
+
+        beginTest ("Multiple values");
+        {
+            auto tokens = readAllTokens ("{\"a\": 1}\n[2]\n\"three\" 4");
+            expect (tokens == Array<Token> { Token::startObject, Token::propertyName, Token::number, Token::endObject,
+                                             Token::startArray, Token::number, Token::endArray,
+                                             Token::string, Token::number, Token::endOfStream });
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto* badJSON : { "{", "[1, 2", "[1 2]", "{\"a\" 1}", "{a: 1}", "[\"abc", "[tru]", "[1x]", "[1,,]", "{\"a\": 1,,}", "]" })
+            {
+                auto tokens = readAllTokens (badJSON);
+                expect (tokens.getLast() == Token::error, badJSON);
+                expect (JSON::parse (badJSON).isVoid(), badJSON);
+            }
+
+            MemoryInputStream in (toMemoryBlock ("[1, {\"a\": [}]"), true);
+            Result result (Result::ok());
+            expect (readWholeValue (in, result).isVoid());
+            expect (result.failed());
+        }
+
+        beginTest ("Values match JSON::parse");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto v = JSONTests::createRandomVar (r, 0);
+                auto text = JSON::toString (v, r.nextBool());
+
+                TrickleInputStream in (text, r);
+                Result result (Result::ok());
+                auto parsed = readWholeValue (in, result);
+
+                expect (result.wasOk(), result.getErrorMessage());
+                expectEquals (JSON::toString (parsed), JSON::toString (JSON::fromString (text)));
+            }
+        }
+
+        beginTest ("Skipping");
+        {
+            MemoryInputStream in (toMemoryBlock ("{\"skipped\": {\"a\": [1, 2, {\"b\": \"c\\\"}\"}]}, \"kept\": [3, 4]}"), true);
+            JSONReader reader (in);
+
+            expect (reader.next() == Token::startObject);
+            expect (reader.next() == Token::propertyName);
+            reader.next();
+            reader.skip();
+            expect (reader.getCurrentToken() == Token::endObject);
+            expect (reader.next() == Token::propertyName);
+            expectEquals (String (reader.getText()), String ("kept"));
+            reader.next();
+            expectEquals (JSON::toString (reader.readValue(), true), String ("[3, 4]"));
+            expect (reader.next() == Token::endObject);
+            expect (reader.next() == Token::endOfStream);
+        }
+    }
+};
+
+static JSONReaderTests jsonReaderTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads JSON-formatted data from a stream one token at a time, without building
+    a tree of var objects.
+
+    JSON::parse() has to load the whole document into memory and then turn every
+    value in it into a var, which can take a lot of time and memory for large files.
+    A JSONReader only ever holds a small block of the stream and the current token,
+    so you can pick out the parts of a document that you need, skip over the rest,
+    and only turn the bits that you want to keep into vars.
+
+    @code
+    FileInputStream in (presetFile);
+    JSONReader reader (in);
+
+    if (reader.next() == JSONReader::Token::startObject)
+    {
+        while (reader.next() == JSONReader::Token::propertyName)
+        {
+            auto name = reader.getText();
+            reader.next();
+
+            if (name == "parameters")
+                loadParameters (reader.readValue());
+            else
+                reader.skip();
+        }
+    }
+
+    if (reader.getError().failed())
+        DBG (reader.getError().getErrorMessage());
+    @endcode
+
+    The reader accepts the same syntax as JSON::parse(), and the values that it returns
+    from getValue() and readValue() are of the same types. A stream may contain several
+    top-level values one after another, as in a log file with a JSON object on each line.
+
+    @see JSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a stream.
+        The stream isn't owned by the reader, so must remain valid until the reader is deleted.
+    */
+    explicit JSONReader (InputStream& source);
+
+    /** Destructor. */
+    ~JSONReader();
+
+    //==============================================================================
+    /** The kinds of token that the reader can find. */
+    enum class Token
+    {
+        none,           /**< next() hasn't been called yet. */
+        startObject,    /**< The opening brace of an object. */
+        endObject,      /**< The closing brace of an object. */
+        startArray,     /**< The opening bracket of an array. */
+        endArray,       /**< The closing bracket of an array. */
+        propertyName,   /**< The name of a property in an object. The value follows it. */
+        string,         /**< A string value. */
+        number,         /**< A numeric value. */
+        boolean,        /**< true or false. */
+        null,           /**< null. */
+        endOfStream,    /**< There's nothing left to read. */
+        error           /**< The data wasn't valid JSON. Use getError() for the details. */
+    };
+
+    /** Reads the next token from the stream, and returns its type.
+        Once the end of the stream or an error has been reached, this will keep returning
+        the same thing.
+    */
+    Token next();
+
+    /** Returns the token that the last call to next() returned. */
+    Token getCurrentToken() const noexcept              { return currentToken; }
+
+    /** Returns the number of objects and arrays that the current token is inside.
+        The start token of an object or array counts as being inside it, but its end token doesn't.
+    */
+    int getDepth() const noexcept                       { return containers.size(); }
+
+    //==============================================================================
+    /** Returns the text of the current token.
+
+        For strings and property names, this is the unescaped string, and for numbers it's
+        the number as it appeared in the stream. The text is only valid until the next call
+        to next(), so make a copy if you need to keep it.
+    */
+    StringRef getText() const noexcept;
+
+    /** Returns the current token's value, if it's a string, number, boolean or null.
+
+        Numbers are returned as an int if they fit into one, or an int64 or a double
+        otherwise, in the same way as JSON::parse(). For other tokens, this returns var().
+    */
+    var getValue() const;
+
+    /** Reads the whole of the value that starts with the current token.
+
+        If the current token begins an object or array, this will read everything up to
+        and including its end token, and return it as a var. Otherwise it returns the same
+        as getValue(). If an error is found, it returns var(), and getError() will describe it.
+    */
+    var readValue();
+
+    /** Skips over the value that starts with the current token.
+
+        If the current token begins an object or array, this reads up to and including its
+        end token without keeping any of the text inside it, which is quicker than reading it.
+        For any other token, this does nothing.
+    */
+    void skip();
+
+    //==============================================================================
+    /** Returns the number of bytes of the stream that have been read so far. */
+    int64 getPosition() const noexcept;
+
+    /** Returns an error if the stream contained invalid JSON, or Result::ok() otherwise. */
+    Result getError() const                             { return error; }
+
+private:
+    //==============================================================================
+    enum class State
+    {
+        value,
+        firstValueOrEnd,
+        firstPropertyOrEnd,
+        property,
+        colon,
+        separatorOrEnd
+    };
+
+    InputStream& input;
+    HeapBlock<char> buffer;
+    const char* readPosition = nullptr;
+    const char* bufferEnd = nullptr;
+    int64 bufferStartPosition = 0;
+    MemoryOutputStream tokenText;
+    Array<char> containers;
+    Token currentToken = Token::none;
+    State state = State::value;
+    bool isSkipping = false;
+    Result error { Result::ok() };
+
+    bool fillBuffer();
+    int peekByte();
+    void skipWhitespace();
+    Token readValueToken (int firstByte);
+    Token openContainer (char type, Token token);
+    Token closeContainer (Token token);
+    Token finishValue (Token token);
+    Token fail (const String& message);
+    bool readString (char quote);
+    bool readEscapeSequence();
+    bool readNumber();
+    bool matchLiteral (const char* literal);
+    String::CharPointerType getEndOfText() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONReader)
+};
+
+} // namespace juce
@@ -41,6 +41,12 @@
 #include <locale>
 #include <thread>
 
+#if JUCE_CXX17_IS_AVAILABLE && defined (__has_include)
+ #if __has_include (<charconv>)
+  #include <charconv>
+ #endif
+#endif
+
 #if ! JUCE_ANDROID
  #include <sys/timeb.h>
  #include <cwctype>
@@ -139,6 +145,7 @@
 #include "files/juce_FileInputStream.cpp"
 #include "files/juce_FileOutputStream.cpp"
 #include "files/juce_FileSearchPath.cpp"
+#include "files/juce_MemoryMappedFileInputStream.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
@@ -146,7 +153,11 @@
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
 #include "memory/juce_MemoryBlock.cpp"
+#include "memory/juce_ScopedNoAllocation.cpp"
 #include "memory/juce_AllocationHooks.cpp"
+#include "memory/juce_MonotonicArena.cpp"
+#include "memory/juce_ObjectPool.cpp"
+#include "memory/juce_RealtimeMemoryPool.cpp"
 #include "misc/juce_RuntimePermissions.cpp"
 #include "misc/juce_Result.cpp"
 #include "misc/juce_Uuid.cpp"
@@ -166,6 +177,7 @@
 #include "text/juce_Identifier.cpp"
 #include "text/juce_LocalisedStrings.cpp"
 #include "text/juce_String.cpp"
+#include "text/juce_StringBuilder.cpp"
 #include "streams/juce_OutputStream.cpp"
 #include "text/juce_StringArray.cpp"
 #include "text/juce_StringPairArray.cpp"
@@ -175,6 +187,7 @@
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
+#include "threads/juce_ParallelAlgorithms.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
 #include "time/juce_RelativeTime.cpp"
@@ -182,10 +195,13 @@
 #include "unit_tests/juce_UnitTest.cpp"
 #include "containers/juce_Variant.cpp"
 #include "javascript/juce_JSON.cpp"
+#include "javascript/juce_JSONReader.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlReader.cpp"
+#include "xml/juce_XmlArenaDocument.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
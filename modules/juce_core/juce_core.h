@@ -181,6 +181,8 @@
 /** Config: JUCE_ENABLE_ALLOCATION_HOOKS
     If enabled, this will add global allocation functions with built-in assertions, which may
     help when debugging allocations in unit tests.
+    It's also needed for ScopedNoAllocation to be able to record calls to new and delete
+    in the RealtimeAllocationLog.
 */
 #ifndef JUCE_ENABLE_ALLOCATION_HOOKS
  #define JUCE_ENABLE_ALLOCATION_HOOKS 0
@@ -247,6 +249,9 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "containers/juce_ScopedValueSetter.h"
 #include "memory/juce_Singleton.h"
 #include "memory/juce_WeakReference.h"
+#include "memory/juce_MonotonicArena.h"
+#include "memory/juce_ObjectPool.h"
+#include "memory/juce_RealtimeMemoryPool.h"
 #include "threads/juce_ScopedLock.h"
 #include "threads/juce_CriticalSection.h"
 #include "maths/juce_Range.h"
@@ -265,6 +270,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "containers/juce_AbstractFifo.h"
 #include "containers/juce_SingleThreadedAbstractFifo.h"
 #include "text/juce_NewLine.h"
+#include "text/juce_StringBuilder.h"
 #include "text/juce_StringPool.h"
 #include "text/juce_Identifier.h"
 #include "text/juce_StringArray.h"
@@ -282,6 +288,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "containers/juce_NamedValueSet.h"
 #include "containers/juce_DynamicObject.h"
 #include "containers/juce_HashMap.h"
+#include "containers/juce_FlatHashMap.h"
 #include "time/juce_RelativeTime.h"
 #include "time/juce_Time.h"
 #include "streams/juce_InputStream.h"
@@ -298,12 +305,14 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "files/juce_FileOutputStream.h"
 #include "files/juce_FileSearchPath.h"
 #include "files/juce_MemoryMappedFile.h"
+#include "files/juce_MemoryMappedFileInputStream.h"
 #include "files/juce_TemporaryFile.h"
 #include "files/juce_FileFilter.h"
 #include "files/juce_WildcardFileFilter.h"
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONReader.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -320,6 +329,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
+#include "threads/juce_ParallelAlgorithms.h"
 #include "threads/juce_TimeSliceThread.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
@@ -335,12 +345,15 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlReader.h"
+#include "xml/juce_XmlArenaDocument.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
 #include "containers/juce_PropertySet.h"
 #include "memory/juce_SharedResourcePointer.h"
 #include "memory/juce_AllocationHooks.h"
+#include "memory/juce_ScopedNoAllocation.h"
 #include "memory/juce_Reservoir.h"
 
 #if JUCE_CORE_INCLUDE_OBJC_HELPERS && (JUCE_MAC || JUCE_IOS)
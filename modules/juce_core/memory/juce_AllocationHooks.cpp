@@ -44,36 +44,42 @@ void notifyAllocationHooksForThread()
 void* operator new (size_t s)
 {
     juce::notifyAllocationHooksForThread();
+    juce::notifyNoAllocationScopeForThread (s, false);
     return std::malloc (s);
 }
 
 void* operator new[] (size_t s)
 {
     juce::notifyAllocationHooksForThread();
+    juce::notifyNoAllocationScopeForThread (s, false);
     return std::malloc (s);
 }
 
 void operator delete (void* p) noexcept
 {
     juce::notifyAllocationHooksForThread();
+    juce::notifyNoAllocationScopeForThread (0, true);
     std::free (p);
 }
 
 void operator delete[] (void* p) noexcept
 {
     juce::notifyAllocationHooksForThread();
+    juce::notifyNoAllocationScopeForThread (0, true);
     std::free (p);
 }
 
 void operator delete (void* p, size_t) noexcept
 {
     juce::notifyAllocationHooksForThread();
+    juce::notifyNoAllocationScopeForThread (0, true);
     std::free (p);
 }
 
 void operator delete[] (void* p, size_t) noexcept
 {
     juce::notifyAllocationHooksForThread();
+    juce::notifyNoAllocationScopeForThread (0, true);
     std::free (p);
 }
 
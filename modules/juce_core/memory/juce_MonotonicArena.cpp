@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+MonotonicArena::MonotonicArena (size_t initialBlockSize, size_t maxSize)
+    : nextBlockSize (jmax ((size_t) 64, initialBlockSize)),
+      maxBlockSize (jmax (nextBlockSize, maxSize))
+{
+}
+
+MonotonicArena::MonotonicArena (void* buffer, size_t bufferSize, size_t maxSize)
+    : initialBuffer (static_cast<char*> (buffer)),
+      initialBufferSize (bufferSize),
+      nextBlockSize (jmax ((size_t) 4096, bufferSize)),
+      maxBlockSize (jmax (nextBlockSize, maxSize))
+{
+    useBlock (initialBuffer, initialBufferSize);
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    reset();
+}
+
+void MonotonicArena::useBlock (char* start, size_t size) noexcept
+{
+    blockStart = nextFreeByte = start;
+    blockEnd = start + size;
+}
+
+void* MonotonicArena::allocateInNewBlock (size_t numBytes, size_t alignment)
+{
+    numBytesUsedInEarlierBlocks += (size_t) (nextFreeByte - blockStart);
+    auto sizeNeeded = jmax ((size_t) 1, numBytes) + alignment - 1;
+
+    // After a reset, the blocks that were allocated before are used again in order,
+    // skipping any that are too small for this request
+    while (++currentBlock < (int) blocks.size())
+    {
+        auto& block = blocks[(size_t) currentBlock];
+
+        if (block.size >= sizeNeeded)
+        {
+            useBlock (block.data.get(), block.size);
+            return allocate (numBytes, alignment);
+        }
+    }
+
+    auto size = jmax (sizeNeeded, nextBlockSize);
+    nextBlockSize = jmin (nextBlockSize * 2, maxBlockSize);
+
+    blocks.push_back ({ HeapBlock<char> (size), size });
+    currentBlock = (int) blocks.size() - 1;
+    useBlock (blocks.back().data.get(), size);
+    return allocate (numBytes, alignment);
+}
+
+void MonotonicArena::reset() noexcept
+{
+    for (auto* d = lastDestructor; d != nullptr; d = d->previous)
+        d->destroy (d->object);
+
+    lastDestructor = nullptr;
+    numBytesUsedInEarlierBlocks = 0;
+    currentBlock = -1;
+
+    if (initialBuffer != nullptr)
+        useBlock (initialBuffer, initialBufferSize);
+    else
+        useBlock (nullptr, 0);
+}
+
+size_t MonotonicArena::getCapacity() const noexcept
+{
+    auto total = initialBufferSize;
+
+    for (auto& block : blocks)
+        total += block.size;
+
+    return total;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MonotonicArenaTests  : public UnitTest
+{
+public:
+    MonotonicArenaTests()
+        : UnitTest ("MonotonicArena", UnitTestCategories::memory)
+    {}
+
+    struct Tracked
+    {
+        Tracked (Array<int>& log, int n)  : destroyed (log), number (n) {}
+        ~Tracked()  { destroyed.add (number); }
+
+        Array<int>& destroyed;
+        int number;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Alignment and growth");
+        {
+            MonotonicArena arena (256, 1024);
+            auto r = getRandom();
+            Array<std::pair<uint8*, size_t>> allocations;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto size = (size_t) r.nextInt (300);
+                auto alignment = (size_t) 1 << r.nextInt (7);
+                auto* p = static_cast<uint8*> (arena.allocate (size, alignment));
+
+                expect (p != nullptr);
+                expect (((pointer_sized_int) p & (pointer_sized_int) (alignment - 1)) == 0);
+
+                memset (p, (int) (i & 0xff), size);
+                allocations.add ({ p, size });
+            }
+
+            // check that none of the allocations overlap
+            for (int i = 0; i < allocations.size(); ++i)
+            {
+                auto& a = allocations.getReference (i);
+
+                for (size_t j = 0; j < a.second; ++j)
+                    expect (a.first[j] == (uint8) (i & 0xff));
+            }
+
+            expect (arena.getNumBytesUsed() <= arena.getCapacity());
+
+            // a reset arena should reuse its blocks rather than allocating more
+            auto capacity = arena.getCapacity();
+            arena.reset();
+            expectEquals ((int) arena.getNumBytesUsed(), 0);
+
+            for (int i = 0; i < 100; ++i)
+                arena.allocate (64, 16);
+
+            expectEquals ((int) arena.getCapacity(), (int) capacity);
+
+            // large requests get a block of their own
+            expect (arena.allocate (100000, 8) != nullptr);
+            expect (arena.getCapacity() >= capacity + 100000);
+        }
+
+        beginTest ("Destructors");
+        {
+            Array<int> destroyed;
+
+            {
+                MonotonicArena arena;
+
+                for (int i = 0; i < 5; ++i)
+                    expectEquals (arena.create<Tracked> (destroyed, i)->number, i);
+
+                arena.create<int> (123);
+                arena.reset();
+                expect (destroyed == Array<int> { 4, 3, 2, 1, 0 });
+
+                arena.create<Tracked> (destroyed, 5);
+                arena.create<String> ("a string that's long enough to need an allocation");
+            }
+
+            expect (destroyed == Array<int> { 4, 3, 2, 1, 0, 5 });
+        }
+
+        beginTest ("Initial buffer");
+        {
+            alignas (16) char buffer[1024];
+            MonotonicArena arena (buffer, sizeof (buffer));
+
+            {
+               #if JUCE_ENABLE_ALLOCATION_HOOKS
+                UnitTestAllocationChecker checker (*this);
+               #endif
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    auto* p = static_cast<char*> (arena.allocate (100, 4));
+                    expect (p >= buffer && p + 100 <= buffer + sizeof (buffer));
+                }
+            }
+
+            expectEquals ((int) arena.getCapacity(), (int) sizeof (buffer));
+            arena.allocate (100, 4);
+            expect (arena.getCapacity() > sizeof (buffer));
+
+            arena.reset();
+            auto* p = static_cast<char*> (arena.allocate (100, 4));
+            expect (p == buffer);
+        }
+
+        beginTest ("Standard library containers");
+        {
+            MonotonicArena arena;
+
+            std::vector<int, MonotonicArena::Allocator<int>> values (arena);
+
+            for (int i = 0; i < 1000; ++i)
+                values.push_back (i);
+
+            expectEquals (values[999], 999);
+
+            std::map<int, String, std::less<int>, MonotonicArena::Allocator<std::pair<const int, String>>> map (arena);
+
+            for (int i = 0; i < 100; ++i)
+                map[i] = String (i);
+
+            expectEquals (map[42], String ("42"));
+            expect (arena.getNumBytesUsed() > 1000 * sizeof (int));
+        }
+    }
+};
+
+static MonotonicArenaTests monotonicArenaTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A fast allocator which hands out memory from a sequence of large blocks, and
+    only frees it all at once.
+
+    Allocating from an arena is just a matter of moving a pointer along, so it's
+    much quicker than going to the heap when a structure is made up of lots of
+    small objects that all have the same lifetime, such as the nodes of a tree that's
+    being parsed from a file. Nothing is freed until the arena is reset or deleted.
+
+    Objects which are created with create() have their destructors called, in the
+    reverse order to their creation, when the arena is reset or deleted. If their
+    type doesn't need a destructor, this costs nothing.
+
+    @code
+    MonotonicArena arena;
+
+    auto* node = arena.create<Node> (parent, "name");
+
+    std::vector<int, MonotonicArena::Allocator<int>> values (arena);
+    values.push_back (123);
+    @endcode
+
+    The first block can be a buffer that you supply, for example on the stack, so
+    that small workloads don't need any heap allocations at all.
+
+    An arena isn't thread-safe, so it should only be used by one thread at a time.
+
+    @see ObjectPool, RealtimeMemoryPool
+
+    @tags{Core}
+*/
+class JUCE_API  MonotonicArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena which allocates blocks from the heap as it needs them.
+
+        The first block will be initialBlockSize bytes, and each block after it will
+        be twice the size of the one before, up to maxBlockSize. Requests which are too
+        large for a block get a block of their own.
+    */
+    explicit MonotonicArena (size_t initialBlockSize = 4096,
+                             size_t maxBlockSize = 1024 * 1024);
+
+    /** Creates an arena which uses a buffer that you supply before it allocates any
+        blocks from the heap.
+
+        The buffer isn't owned by the arena, so it must remain valid until the arena is deleted.
+    */
+    MonotonicArena (void* initialBuffer, size_t initialBufferSize,
+                    size_t maxBlockSize = 1024 * 1024);
+
+    /** Destructor.
+        This calls the destructors of all the objects that were created with create(),
+        and frees all the memory.
+    */
+    ~MonotonicArena();
+
+    //==============================================================================
+    /** Returns some uninitialised memory with the given size and alignment.
+        The alignment must be a power of two.
+    */
+    void* allocate (size_t numBytes, size_t alignment = alignof (std::max_align_t))
+    {
+        jassert (isPowerOfTwo (alignment));
+        auto padding = (size_t) (-(pointer_sized_int) nextFreeByte) & (alignment - 1);
+
+        if (numBytes + padding > (size_t) (blockEnd - nextFreeByte) || nextFreeByte == nullptr)
+            return allocateInNewBlock (numBytes, alignment);
+
+        auto* result = nextFreeByte + padding;
+        nextFreeByte = result + numBytes;
+        return result;
+    }
+
+    /** Creates an object in the arena, passing the given arguments to its constructor.
+        If the object has a destructor, it'll be called when the arena is reset or deleted.
+    */
+    template <typename ObjectType, typename... Args>
+    ObjectType* create (Args&&... args)
+    {
+        return createObject<ObjectType> (std::is_trivially_destructible<ObjectType>(), std::forward<Args> (args)...);
+    }
+
+    /** Destroys all the objects that were created with create(), and makes all the
+        memory available to be used again.
+
+        Any blocks that were allocated are kept for reuse, so an arena that gets reset
+        after each job will quickly stop needing to allocate any memory.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Returns the number of bytes that have been handed out since the arena was
+        created or last reset, including any padding that was needed for alignment.
+    */
+    size_t getNumBytesUsed() const noexcept                 { return numBytesUsedInEarlierBlocks + (size_t) (nextFreeByte - blockStart); }
+
+    /** Returns the total size of the blocks that the arena is using, including the
+        initial buffer if one was supplied.
+    */
+    size_t getCapacity() const noexcept;
+
+    //==============================================================================
+    /** An allocator which lets standard library containers use a MonotonicArena.
+
+        Memory that the container frees isn't reused until the arena is reset, so this
+        works best for containers which are filled once, or whose size is reserved
+        up-front. The arena must outlive the container.
+    */
+    template <typename ElementType>
+    class Allocator
+    {
+    public:
+        using value_type = ElementType;
+
+        Allocator (MonotonicArena& arenaToUse) noexcept  : arena (&arenaToUse) {}
+
+        template <typename OtherType>
+        Allocator (const Allocator<OtherType>& other) noexcept  : arena (other.arena) {}
+
+        ElementType* allocate (size_t numElements)
+        {
+            return static_cast<ElementType*> (arena->allocate (numElements * sizeof (ElementType), alignof (ElementType)));
+        }
+
+        void deallocate (ElementType*, size_t) noexcept {}
+
+        template <typename OtherType>
+        bool operator== (const Allocator<OtherType>& other) const noexcept    { return arena == other.arena; }
+
+        template <typename OtherType>
+        bool operator!= (const Allocator<OtherType>& other) const noexcept    { return arena != other.arena; }
+
+    private:
+        template <typename OtherType>
+        friend class Allocator;
+
+        MonotonicArena* arena;
+    };
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        HeapBlock<char> data;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        Destructor* previous;
+        void (*destroy) (void*);
+        void* object;
+    };
+
+    char* initialBuffer = nullptr;
+    size_t initialBufferSize = 0;
+    std::vector<Block> blocks;
+    int currentBlock = -1;
+    char* blockStart = nullptr;
+    char* nextFreeByte = nullptr;
+    char* blockEnd = nullptr;
+    size_t nextBlockSize, maxBlockSize, numBytesUsedInEarlierBlocks = 0;
+    Destructor* lastDestructor = nullptr;
+
+    void* allocateInNewBlock (size_t numBytes, size_t alignment);
+    void useBlock (char* start, size_t size) noexcept;
+
+    template <typename ObjectType, typename... Args>
+    ObjectType* createObject (std::true_type, Args&&... args)
+    {
+        return new (allocate (sizeof (ObjectType), alignof (ObjectType))) ObjectType (std::forward<Args> (args)...);
+    }
+
+    template <typename ObjectType, typename... Args>
+    ObjectType* createObject (std::false_type, Args&&... args)
+    {
+        auto* destructor = static_cast<Destructor*> (allocate (sizeof (Destructor), alignof (Destructor)));
+        auto* object = new (allocate (sizeof (ObjectType), alignof (ObjectType))) ObjectType (std::forward<Args> (args)...);
+
+        destructor->previous = lastDestructor;
+        destructor->destroy = [] (void* o) { static_cast<ObjectType*> (o)->~ObjectType(); };
+        destructor->object = object;
+        lastDestructor = destructor;
+        return object;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MonotonicArena)
+};
+
+} // namespace juce
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_UNIT_TESTS
+
+class ObjectPoolTests  : public UnitTest
+{
+public:
+    ObjectPoolTests()
+        : UnitTest ("ObjectPool", UnitTestCategories::memory)
+    {}
+
+    struct Voice
+    {
+        Voice (int n, float v) : note (n), velocity (v)     { ++numAlive; }
+        ~Voice()                                            { --numAlive; }
+
+        int note;
+        float velocity;
+
+        static int numAlive;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Creating and destroying");
+        {
+            ObjectPool<Voice> pool (4);
+            Array<Voice*> voices;
+
+            for (int i = 0; i < 10; ++i)
+                voices.add (pool.create (i, (float) i * 0.1f));
+
+            expectEquals (Voice::numAlive, 10);
+            expectEquals (pool.getNumLiveObjects(), 10);
+            expectEquals (pool.getCapacity(), 12);
+
+            for (int i = 0; i < 10; ++i)
+                expectEquals (voices[i]->note, i);
+
+            auto* removed = voices.removeAndReturn (3);
+            pool.destroy (removed);
+            expectEquals (Voice::numAlive, 9);
+
+            // the most recently freed slot gets reused first
+            expect (pool.create (100, 1.0f) == removed);
+            voices.add (removed);
+
+            for (auto* v : voices)
+                pool.destroy (v);
+
+            expectEquals (Voice::numAlive, 0);
+            expectEquals (pool.getNumLiveObjects(), 0);
+            expectEquals (pool.getCapacity(), 12);
+        }
+
+        beginTest ("Reserving");
+        {
+            ObjectPool<Voice> pool;
+            pool.reserve (100);
+            expectEquals (pool.getCapacity(), 100);
+
+            Array<Voice*> voices;
+            voices.ensureStorageAllocated (100);
+
+            {
+               #if JUCE_ENABLE_ALLOCATION_HOOKS
+                UnitTestAllocationChecker checker (*this);
+               #endif
+
+                for (int i = 0; i < 100; ++i)
+                    voices.add (pool.create (i, 0.0f));
+            }
+
+            expectEquals (pool.getCapacity(), 100);
+
+            for (auto* v : voices)
+                pool.destroy (v);
+        }
+
+        beginTest ("Unique pointers");
+        {
+            ObjectPool<Voice> pool;
+
+            {
+                auto v = pool.createUnique (60, 0.5f);
+                expectEquals (v->note, 60);
+                expectEquals (pool.getNumLiveObjects(), 1);
+            }
+
+            expectEquals (pool.getNumLiveObjects(), 0);
+            expectEquals (Voice::numAlive, 0);
+        }
+
+        beginTest ("Per-thread pools");
+        {
+            std::atomic<int> numErrors { 0 };
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back ([&numErrors, t]
+                {
+                    auto& pool = ObjectPool<std::pair<int, int>>::getForCurrentThread();
+                    Array<std::pair<int, int>*> items;
+
+                    for (int i = 0; i < 1000; ++i)
+                        items.add (pool.create (t, i));
+
+                    for (int i = 0; i < 1000; ++i)
+                        if (items[i]->first != t || items[i]->second != i)
+                            ++numErrors;
+
+                    for (auto* item : items)
+                        pool.destroy (item);
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            expectEquals (numErrors.load(), 0);
+        }
+    }
+};
+
+int ObjectPoolTests::Voice::numAlive = 0;
+
+static ObjectPoolTests objectPoolTests;
+
+#endif
+
+} // namespace juce
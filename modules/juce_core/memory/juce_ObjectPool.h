@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Creates objects of one type in recycled slots of memory, so that creating and
+    deleting them doesn't need to use the heap.
+
+    The pool allocates slots in blocks of a fixed number, and keeps the slots of
+    deleted objects in a list so that they can be reused. Once the pool has grown
+    to the largest number of objects that are alive at one time, creating and
+    deleting objects never allocates any memory, and only costs a couple of pointer
+    operations. You can call reserve() to make sure that this is true from the start.
+
+    @code
+    ObjectPool<Voice> voicePool;
+    voicePool.reserve (64);
+
+    auto* voice = voicePool.create (noteNumber, velocity);
+    ...
+    voicePool.destroy (voice);
+    @endcode
+
+    A pool isn't thread-safe. Each thread can use its own pool by calling
+    getForCurrentThread(), in which case the objects must be deleted on the same
+    thread that created them.
+
+    If a pool is deleted while some of its objects are still alive, it'll assert,
+    and the objects' destructors won't be called. For types which use
+    JUCE_LEAK_DETECTOR, the leak detector will also report them when the app shuts down.
+
+    @see MonotonicArena, RealtimeMemoryPool
+
+    @tags{Core}
+*/
+template <typename ObjectType>
+class ObjectPool
+{
+public:
+    //==============================================================================
+    /** Creates an empty pool which will allocate space for the given number of
+        objects each time that it needs more.
+    */
+    explicit ObjectPool (int numObjectsPerBlock = 64)
+        : blockSize (jmax (1, numObjectsPerBlock))
+    {
+    }
+
+    /** Destructor.
+        All the objects should have been deleted before the pool is deleted.
+    */
+    ~ObjectPool()
+    {
+       #if JUCE_CHECK_MEMORY_LEAKS
+        if (numLiveObjects > 0)
+        {
+            DBG ("*** Leaked objects detected: " << numLiveObjects << " object(s) still alive in an ObjectPool");
+
+            /** If you hit this, then you've deleted a pool while some of the objects that
+                it created were still in use, so they'll now be pointing at freed memory.
+            */
+            jassertfalse;
+        }
+       #endif
+    }
+
+    //==============================================================================
+    /** Creates an object in the pool, passing the given arguments to its constructor. */
+    template <typename... Args>
+    ObjectType* create (Args&&... args)
+    {
+        if (firstFreeSlot == nullptr)
+            addBlock (blockSize);
+
+        auto* slot = firstFreeSlot;
+        firstFreeSlot = slot->nextFreeSlot;
+        ++numLiveObjects;
+
+        return new (&slot->storage) ObjectType (std::forward<Args> (args)...);
+    }
+
+    /** Deletes an object that was created by this pool, and makes its slot available to be reused. */
+    void destroy (ObjectType* object) noexcept
+    {
+        if (object == nullptr)
+            return;
+
+        jassert (numLiveObjects > 0); // this object can't have come from this pool!
+
+        object->~ObjectType();
+
+        auto* slot = reinterpret_cast<Slot*> (object);
+        slot->nextFreeSlot = firstFreeSlot;
+        firstFreeSlot = slot;
+        --numLiveObjects;
+    }
+
+    /** Makes sure that there are enough slots for the given number of objects to be
+        alive at once, without the pool needing to allocate any more memory.
+    */
+    void reserve (int numObjects)
+    {
+        if (numObjects > capacity)
+            addBlock (numObjects - capacity);
+    }
+
+    //==============================================================================
+    /** A deleter which returns objects to the pool that they came from. */
+    struct Deleter
+    {
+        void operator() (ObjectType* object) const noexcept     { pool->destroy (object); }
+        ObjectPool* pool;
+    };
+
+    /** A unique_ptr which returns its object to the pool when it's deleted. */
+    using Ptr = std::unique_ptr<ObjectType, Deleter>;
+
+    /** Creates an object in the pool, and returns a unique_ptr which will give it back
+        to the pool when it's deleted.
+    */
+    template <typename... Args>
+    Ptr createUnique (Args&&... args)
+    {
+        return Ptr (create (std::forward<Args> (args)...), Deleter { this });
+    }
+
+    //==============================================================================
+    /** Returns the number of objects that have been created and not yet deleted. */
+    int getNumLiveObjects() const noexcept      { return numLiveObjects; }
+
+    /** Returns the number of objects that the pool can hold without allocating more memory. */
+    int getCapacity() const noexcept            { return capacity; }
+
+    /** Returns a pool that belongs to the calling thread.
+
+        The pool is created the first time that each thread calls this, and deleted when
+        the thread exits. Objects must be deleted on the same thread that created them.
+    */
+    static ObjectPool& getForCurrentThread()
+    {
+        thread_local ObjectPool pool;
+        return pool;
+    }
+
+private:
+    //==============================================================================
+    union Slot
+    {
+        Slot* nextFreeSlot;
+        typename std::aligned_storage<sizeof (ObjectType), alignof (ObjectType)>::type storage;
+    };
+
+    std::vector<HeapBlock<Slot>> blocks;
+    Slot* firstFreeSlot = nullptr;
+    int blockSize, capacity = 0, numLiveObjects = 0;
+
+    void addBlock (int numSlots)
+    {
+        HeapBlock<Slot> block ((size_t) numSlots);
+
+        for (int i = numSlots; --i >= 0;)
+        {
+            block[i].nextFreeSlot = firstFreeSlot;
+            firstFreeSlot = block + i;
+        }
+
+        blocks.push_back (std::move (block));
+        capacity += numSlots;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ObjectPool)
+};
+
+} // namespace juce
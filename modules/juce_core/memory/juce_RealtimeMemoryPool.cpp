@@ -0,0 +1,379 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// Each size class keeps its free blocks in a lock-free linked list. The list's head
+// holds the index of the first free block in its low 32 bits and a counter in the
+// high 32 bits which changes with every update, so that a thread whose view of the
+// list has gone stale can't mistake a block that was taken and put back for the
+// same list state (the ABA problem).
+struct RealtimeMemoryPool::SizeClass
+{
+    static constexpr uint32 endOfList = 0xffffffff;
+
+    void initialise (char* startOfBlocks, size_t sizeOfBlocks, uint32 numBlocksInClass)
+    {
+        start = startOfBlocks;
+        blockSize = sizeOfBlocks;
+        numBlocks = numBlocksInClass;
+
+        while (((size_t) 1 << blockSizeShift) < blockSize)
+            ++blockSizeShift;
+
+        nextFreeBlock.reset (new std::atomic<uint32>[numBlocks]);
+
+        for (uint32 i = 0; i < numBlocks; ++i)
+            nextFreeBlock[i].store (i + 1 < numBlocks ? i + 1 : endOfList);
+
+        head.store (numBlocks > 0 ? 0 : endOfList);
+    }
+
+    void* pop() noexcept
+    {
+        auto oldHead = head.load (std::memory_order_acquire);
+
+        for (;;)
+        {
+            auto index = (uint32) oldHead;
+
+            if (index == endOfList)
+                return nullptr;
+
+            auto newHead = withNewCount (oldHead, nextFreeBlock[index].load (std::memory_order_relaxed));
+
+            if (head.compare_exchange_weak (oldHead, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+                return start + ((size_t) index << blockSizeShift);
+        }
+    }
+
+    void push (uint32 index) noexcept
+    {
+        auto oldHead = head.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            nextFreeBlock[index].store ((uint32) oldHead, std::memory_order_relaxed);
+
+            if (head.compare_exchange_weak (oldHead, withNewCount (oldHead, index), std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    static uint64 withNewCount (uint64 oldHead, uint32 newIndex) noexcept
+    {
+        return (((oldHead >> 32) + 1) << 32) | newIndex;
+    }
+
+    char* start = nullptr;
+    size_t blockSize = 0;
+    int blockSizeShift = 0;
+    uint32 numBlocks = 0;
+    std::unique_ptr<std::atomic<uint32>[]> nextFreeBlock;
+    std::atomic<uint64> head { endOfList };
+};
+
+//==============================================================================
+RealtimeMemoryPool::RealtimeMemoryPool (size_t totalSizeInBytes, size_t largestAllocationSize)
+{
+    static constexpr size_t smallestBlockSize = 16, classAlignment = 64;
+
+    numSizeClasses = 1;
+
+    while ((smallestBlockSize << (numSizeClasses - 1)) < largestAllocationSize)
+        ++numSizeClasses;
+
+    auto bytesPerClass = totalSizeInBytes / (size_t) numSizeClasses;
+    size_t totalSize = classAlignment;
+
+    for (int i = 0; i < numSizeClasses; ++i)
+        totalSize += jmax ((size_t) 1, bytesPerClass / (smallestBlockSize << i)) * (smallestBlockSize << i) + classAlignment;
+
+    memory.malloc (totalSize);
+    zeromem (memory, totalSize);
+
+    auto alignUp = [] (char* p) { return p + ((classAlignment - ((size_t) (pointer_sized_int) p & (classAlignment - 1))) & (classAlignment - 1)); };
+
+    memoryStart = alignUp (memory);
+    auto* nextClassStart = memoryStart;
+    sizeClasses.reset (new SizeClass[(size_t) numSizeClasses]);
+
+    for (int i = 0; i < numSizeClasses; ++i)
+    {
+        auto blockSize = smallestBlockSize << i;
+        auto numBlocks = jmax ((size_t) 1, bytesPerClass / blockSize);
+
+        sizeClasses[(size_t) i].initialise (nextClassStart, blockSize, (uint32) numBlocks);
+        memoryEnd = nextClassStart + numBlocks * blockSize;
+        nextClassStart = alignUp (memoryEnd);
+    }
+}
+
+RealtimeMemoryPool::~RealtimeMemoryPool()
+{
+   #if JUCE_CHECK_MEMORY_LEAKS
+    if (numAllocatedBlocks.load() > 0)
+    {
+        DBG ("*** Leaked objects detected: " << numAllocatedBlocks.load() << " block(s) still allocated from a RealtimeMemoryPool");
+
+        /** If you hit this, then you've deleted a pool while some of the blocks that
+            it allocated were still in use, so they'll now be pointing at freed memory.
+        */
+        jassertfalse;
+    }
+   #endif
+}
+
+void* RealtimeMemoryPool::allocate (size_t numBytes, size_t alignment) noexcept
+{
+    jassert (isPowerOfTwo (alignment) && alignment <= 64);
+    auto sizeNeeded = jmax (numBytes, alignment);
+
+    for (int i = 0; i < numSizeClasses; ++i)
+    {
+        auto& sizeClass = sizeClasses[(size_t) i];
+
+        if (sizeClass.blockSize >= sizeNeeded)
+        {
+            if (auto* block = sizeClass.pop())
+            {
+                ++numAllocatedBlocks;
+                return block;
+            }
+        }
+    }
+
+    ++numFailedAllocations;
+    return nullptr;
+}
+
+void RealtimeMemoryPool::deallocate (void* block) noexcept
+{
+    if (block == nullptr)
+        return;
+
+    jassert (owns (block)); // this block didn't come from this pool!
+
+    auto* p = static_cast<char*> (block);
+
+    for (int i = numSizeClasses; --i >= 0;)
+    {
+        auto& sizeClass = sizeClasses[(size_t) i];
+
+        if (p >= sizeClass.start)
+        {
+            auto offset = (size_t) (p - sizeClass.start);
+            jassert ((offset & (sizeClass.blockSize - 1)) == 0); // this isn't the start of a block!
+
+            sizeClass.push ((uint32) (offset >> sizeClass.blockSizeShift));
+            --numAllocatedBlocks;
+            return;
+        }
+    }
+}
+
+bool RealtimeMemoryPool::owns (const void* pointer) const noexcept
+{
+    auto* p = static_cast<const char*> (pointer);
+    return p >= memoryStart && p < memoryEnd;
+}
+
+size_t RealtimeMemoryPool::getLargestAllocationSize() const noexcept
+{
+    return sizeClasses[(size_t) numSizeClasses - 1].blockSize;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RealtimeMemoryPoolTests  : public UnitTest
+{
+public:
+    RealtimeMemoryPoolTests()
+        : UnitTest ("RealtimeMemoryPool", UnitTestCategories::memory)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Allocating");
+        {
+            RealtimeMemoryPool pool (1024 * 1024, 1000);
+            expectEquals ((int) pool.getLargestAllocationSize(), 1024);
+
+            auto r = getRandom();
+            Array<std::pair<uint8*, size_t>> blocks;
+
+            {
+               #if JUCE_ENABLE_ALLOCATION_HOOKS
+                UnitTestAllocationChecker checker (*this);
+               #endif
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    auto size = (size_t) r.nextInt (1025);
+                    auto alignment = (size_t) 1 << r.nextInt (7);
+                    auto* p = static_cast<uint8*> (pool.allocate (size, alignment));
+
+                    expect (p != nullptr && pool.owns (p));
+                    expect (((pointer_sized_int) p & (pointer_sized_int) (alignment - 1)) == 0);
+                    memset (p, i, size);
+                    blocks.add ({ p, size });
+                }
+            }
+
+            expectEquals (pool.getNumAllocatedBlocks(), 100);
+
+            for (int i = 0; i < blocks.size(); ++i)
+            {
+                for (size_t j = 0; j < blocks[i].second; ++j)
+                    expect (blocks[i].first[j] == (uint8) i);
+
+                pool.deallocate (blocks[i].first);
+            }
+
+            expectEquals (pool.getNumAllocatedBlocks(), 0);
+            expect (pool.allocate (2000) == nullptr);
+            expectEquals (pool.getNumFailedAllocations(), 1);
+        }
+
+        beginTest ("Running out of space");
+        {
+            // 7 classes from 16 to 1024 bytes, each with 1024 bytes
+            RealtimeMemoryPool pool (7 * 1024, 1024);
+            Array<void*> blocks;
+
+            // when the smallest class is full, the next class up gets used
+            for (;;)
+            {
+                auto* p = pool.allocate (16);
+
+                if (p == nullptr)
+                    break;
+
+                blocks.add (p);
+            }
+
+            expectEquals (blocks.size(), 64 + 32 + 16 + 8 + 4 + 2 + 1);
+            expectEquals (pool.getNumFailedAllocations(), 1);
+
+            for (auto* p : blocks)
+                pool.deallocate (p);
+
+            auto* largest = pool.allocate (1024);
+            expect (largest != nullptr);
+            expect (pool.allocate (1024) == nullptr);
+            pool.deallocate (largest);
+        }
+
+        beginTest ("Objects and containers");
+        {
+            RealtimeMemoryPool pool (256 * 1024);
+
+            auto* s = pool.create<String> ("a string");
+            expectEquals (*s, String ("a string"));
+            pool.destroy (s);
+
+            {
+                std::list<int, RealtimeMemoryPool::Allocator<int>> list (pool);
+                std::map<int, int, std::less<int>, RealtimeMemoryPool::Allocator<std::pair<const int, int>>> map (pool);
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    list.push_back (i);
+                    map[i] = i * 2;
+                }
+
+                expectEquals (pool.getNumAllocatedBlocks(), 200);
+                expectEquals (map[50], 100);
+            }
+
+            expectEquals (pool.getNumAllocatedBlocks(), 0);
+        }
+
+        beginTest ("Multiple threads");
+        {
+            RealtimeMemoryPool pool (1024 * 1024, 256);
+            std::atomic<int> numErrors { 0 };
+
+            // Blocks are allocated by each thread and freed either by the same thread or by
+            // the next one along, which picks them up from a shared slot
+            constexpr int numThreads = 4;
+            std::atomic<void*> handover[numThreads] = {};
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&, t]
+                {
+                    Random r (t);
+                    Array<std::pair<uint8*, int>> blocks;
+
+                    for (int i = 0; i < 20000; ++i)
+                    {
+                        if (blocks.size() < 50 && r.nextBool())
+                        {
+                            auto size = 1 + r.nextInt (256);
+
+                            if (auto* p = static_cast<uint8*> (pool.allocate ((size_t) size)))
+                            {
+                                memset (p, t + 1, (size_t) size);
+                                blocks.add ({ p, size });
+                            }
+                        }
+                        else if (! blocks.isEmpty())
+                        {
+                            auto block = blocks.removeAndReturn (r.nextInt (blocks.size()));
+
+                            for (int j = 0; j < block.second; ++j)
+                                if (block.first[j] != (uint8) (t + 1))
+                                    ++numErrors;
+
+                            if (auto* old = handover[(t + 1) % numThreads].exchange (block.first))
+                                pool.deallocate (old);
+                        }
+                    }
+
+                    for (auto& block : blocks)
+                        pool.deallocate (block.first);
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            for (auto& slot : handover)
+                pool.deallocate (slot.load());
+
+            expectEquals (numErrors.load(), 0);
+            expectEquals (pool.getNumAllocatedBlocks(), 0);
+        }
+    }
+};
+
+static RealtimeMemoryPoolTests realtimeMemoryPoolTests;
+
+#endif
+
+} // namespace juce
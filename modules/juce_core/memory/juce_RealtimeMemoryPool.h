@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pool of preallocated memory that can be used to allocate and free blocks of
+    different sizes on a real-time thread, such as the audio thread.
+
+    All the memory is allocated when the pool is created, and divided up into
+    size classes, where each class holds blocks whose size is a power of two, from
+    16 bytes up to the largest allocation size. Allocating finds the smallest class
+    that's big enough and takes a block from it, trying the larger classes if it's
+    empty, and freeing puts the block back. Both operations are lock-free and never
+    call the system allocator, so they can be used on any thread, and memory that's
+    allocated on one thread can be freed on another.
+
+    If there isn't a free block that's big enough, allocate() returns nullptr, and
+    the failure is counted so that you can check whether the pool needs to be bigger.
+
+    @code
+    RealtimeMemoryPool pool (1024 * 1024);   // done when preparing to play
+
+    // on the audio thread..
+    if (auto* event = pool.create<MidiEvent> (message, samplePosition))
+    {
+        ...
+        pool.destroy (event);
+    }
+    @endcode
+
+    If the pool is deleted while any of its blocks are still allocated, it'll assert.
+
+    @see MonotonicArena, ObjectPool
+
+    @tags{Core}
+*/
+class JUCE_API  RealtimeMemoryPool
+{
+public:
+    //==============================================================================
+    /** Allocates the pool's memory.
+
+        The total size is shared equally between the size classes, so each class can
+        hold totalSizeInBytes / numSizeClasses bytes. The largest allocation size is
+        rounded up to a power of two. The memory is written to here, so that the system
+        has to map it in before the pool is used on a real-time thread.
+    */
+    explicit RealtimeMemoryPool (size_t totalSizeInBytes, size_t largestAllocationSize = 4096);
+
+    /** Destructor. All the blocks should have been freed before the pool is deleted. */
+    ~RealtimeMemoryPool();
+
+    //==============================================================================
+    /** Returns a block of at least the given size, or nullptr if the pool doesn't have a
+        free block that's big enough.
+
+        The alignment must be a power of two, and no larger than 64 bytes.
+        This is lock-free, and can be called on any thread.
+    */
+    void* allocate (size_t numBytes, size_t alignment = alignof (std::max_align_t)) noexcept;
+
+    /** Returns a block that was allocated by this pool. Passing nullptr does nothing.
+        This is lock-free, and can be called on any thread.
+    */
+    void deallocate (void* block) noexcept;
+
+    /** Returns true if this pointer is inside the pool's memory. */
+    bool owns (const void* pointer) const noexcept;
+
+    /** Creates an object in the pool, or returns nullptr if there isn't enough space. */
+    template <typename ObjectType, typename... Args>
+    ObjectType* create (Args&&... args)
+    {
+        if (auto* space = allocate (sizeof (ObjectType), alignof (ObjectType)))
+            return new (space) ObjectType (std::forward<Args> (args)...);
+
+        return nullptr;
+    }
+
+    /** Deletes an object that was created with create(). */
+    template <typename ObjectType>
+    void destroy (ObjectType* object) noexcept
+    {
+        if (object != nullptr)
+        {
+            object->~ObjectType();
+            deallocate (object);
+        }
+    }
+
+    //==============================================================================
+    /** Returns the largest number of bytes that can be allocated in one go. */
+    size_t getLargestAllocationSize() const noexcept;
+
+    /** Returns the number of blocks that are currently allocated. */
+    int getNumAllocatedBlocks() const noexcept          { return numAllocatedBlocks.load(); }
+
+    /** Returns the number of times that allocate() couldn't find a block. */
+    int getNumFailedAllocations() const noexcept        { return numFailedAllocations.load(); }
+
+    //==============================================================================
+    /** An allocator which lets standard library containers use a RealtimeMemoryPool.
+
+        If the pool runs out of space, this throws std::bad_alloc, or asserts and returns
+        nullptr if exceptions are disabled. Containers that need a single block which is
+        bigger than the pool's largest allocation size, such as a large std::vector, will
+        fail, so this is best suited to node-based containers like std::list and std::map,
+        or to vectors whose size is reserved up-front.
+    */
+    template <typename ElementType>
+    class Allocator
+    {
+    public:
+        using value_type = ElementType;
+
+        Allocator (RealtimeMemoryPool& poolToUse) noexcept  : pool (&poolToUse) {}
+
+        template <typename OtherType>
+        Allocator (const Allocator<OtherType>& other) noexcept  : pool (other.pool) {}
+
+        ElementType* allocate (size_t numElements)
+        {
+            auto* block = pool->allocate (numElements * sizeof (ElementType), alignof (ElementType));
+
+           #if JUCE_EXCEPTIONS_DISABLED
+            jassert (block != nullptr); // the pool has run out of space!
+           #else
+            if (block == nullptr)
+                throw std::bad_alloc();
+           #endif
+
+            return static_cast<ElementType*> (block);
+        }
+
+        void deallocate (ElementType* block, size_t) noexcept   { pool->deallocate (block); }
+
+        template <typename OtherType>
+        bool operator== (const Allocator<OtherType>& other) const noexcept    { return pool == other.pool; }
+
+        template <typename OtherType>
+        bool operator!= (const Allocator<OtherType>& other) const noexcept    { return pool != other.pool; }
+
+    private:
+        template <typename OtherType>
+        friend class Allocator;
+
+        RealtimeMemoryPool* pool;
+    };
+
+private:
+    //==============================================================================
+    struct SizeClass;
+
+    HeapBlock<char> memory;
+    char* memoryStart = nullptr;
+    char* memoryEnd = nullptr;
+    std::unique_ptr<SizeClass[]> sizeClasses;
+    int numSizeClasses = 0;
+    std::atomic<int> numAllocatedBlocks { 0 }, numFailedAllocations { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeMemoryPool)
+};
+
+} // namespace juce
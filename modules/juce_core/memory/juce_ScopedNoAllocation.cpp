@@ -0,0 +1,372 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// The log is a bounded multi-producer queue, in which each slot has a sequence number
+// that tells writers and readers whose turn it is to use it. The sequence numbers are
+// stored relative to the slot's index, so that everything here starts out as zero and
+// the log can be used before any constructors have run.
+struct RealtimeAllocationLogState
+{
+    struct Slot
+    {
+        std::atomic<uint32> sequence { 0 };
+        RealtimeAllocationLog::Entry entry;
+    };
+
+    static constexpr uint32 mask = (uint32) RealtimeAllocationLog::capacity - 1;
+
+    static_assert (isPowerOfTwo (RealtimeAllocationLog::capacity), "The capacity must be a power of two");
+
+    void write (const RealtimeAllocationLog::Entry& entry) noexcept
+    {
+        auto position = writePosition.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& slot = slots[position & mask];
+            auto turn = (int32) (slot.sequence.load (std::memory_order_acquire) + (position & mask) - position);
+
+            if (turn == 0)
+            {
+                if (writePosition.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.entry = entry;
+                    slot.sequence.store (position + 1 - (position & mask), std::memory_order_release);
+                    return;
+                }
+            }
+            else if (turn < 0)
+            {
+                ++numDroppedEntries;
+                return;
+            }
+            else
+            {
+                position = writePosition.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool read (RealtimeAllocationLog::Entry& result) noexcept
+    {
+        const SpinLock::ScopedLockType sl (readLock);
+
+        auto& slot = slots[readPosition & mask];
+
+        if (slot.sequence.load (std::memory_order_acquire) + (readPosition & mask) != readPosition + 1)
+            return false;
+
+        result = slot.entry;
+        slot.sequence.store (readPosition + RealtimeAllocationLog::capacity - (readPosition & mask), std::memory_order_release);
+        ++readPosition;
+        return true;
+    }
+
+    Slot slots[RealtimeAllocationLog::capacity];
+    std::atomic<uint32> writePosition { 0 };
+    uint32 readPosition = 0;
+    SpinLock readLock;
+
+    std::atomic<bool> enabled { false };
+    std::atomic<int64> totalNumCalls { 0 }, numDroppedEntries { 0 };
+    std::atomic<size_t> largestStackDepth { 0 };
+};
+
+static RealtimeAllocationLogState realtimeAllocationLog;
+
+#if JUCE_ENABLE_ALLOCATION_HOOKS
+ static thread_local ScopedNoAllocation* currentNoAllocationScope = nullptr;
+
+ void notifyNoAllocationScopeForThread (size_t numBytes, bool isDelete) noexcept
+ {
+     auto* scope = currentNoAllocationScope;
+
+     if (scope == nullptr)
+         return;
+
+     char stackPosition = 0;
+     auto stackDepth = (size_t) std::abs (scope->stackStart - &stackPosition);
+
+     RealtimeAllocationLog::Entry entry;
+     entry.context = scope->context;
+     entry.threadId = Thread::getCurrentThreadId();
+     entry.timeTicks = Time::getHighResolutionTicks();
+     entry.numBytes = numBytes;
+     entry.stackDepth = stackDepth;
+     entry.callNumber = ++(scope->numCalls);
+     entry.isDelete = isDelete;
+
+     auto& log = realtimeAllocationLog;
+     ++log.totalNumCalls;
+
+     auto largest = log.largestStackDepth.load (std::memory_order_relaxed);
+
+     while (stackDepth > largest && ! log.largestStackDepth.compare_exchange_weak (largest, stackDepth, std::memory_order_relaxed))
+     {}
+
+     log.write (entry);
+ }
+#endif
+
+//==============================================================================
+bool RealtimeAllocationLog::isSupported() noexcept
+{
+    return JUCE_ENABLE_ALLOCATION_HOOKS != 0;
+}
+
+void RealtimeAllocationLog::setEnabled (bool shouldBeEnabled) noexcept
+{
+    // Allocations can only be logged if JUCE_ENABLE_ALLOCATION_HOOKS is enabled
+    jassert (isSupported() || ! shouldBeEnabled);
+
+    realtimeAllocationLog.enabled = shouldBeEnabled && isSupported();
+}
+
+bool RealtimeAllocationLog::isEnabled() noexcept                { return realtimeAllocationLog.enabled.load (std::memory_order_relaxed); }
+bool RealtimeAllocationLog::readNextEntry (Entry& result) noexcept  { return realtimeAllocationLog.read (result); }
+int64 RealtimeAllocationLog::getTotalNumCalls() noexcept         { return realtimeAllocationLog.totalNumCalls.load(); }
+int64 RealtimeAllocationLog::getNumDroppedEntries() noexcept     { return realtimeAllocationLog.numDroppedEntries.load(); }
+size_t RealtimeAllocationLog::getLargestStackDepth() noexcept    { return realtimeAllocationLog.largestStackDepth.load(); }
+
+void RealtimeAllocationLog::clear() noexcept
+{
+    Entry unused;
+
+    while (readNextEntry (unused))
+    {}
+
+    realtimeAllocationLog.totalNumCalls = 0;
+    realtimeAllocationLog.numDroppedEntries = 0;
+    realtimeAllocationLog.largestStackDepth = 0;
+}
+
+//==============================================================================
+// The scope stores a pointer to itself, which it removes again in its destructor
+JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wdangling-pointer")
+
+ScopedNoAllocation::ScopedNoAllocation (const char* contextName) noexcept
+    : context (contextName)
+{
+   #if JUCE_ENABLE_ALLOCATION_HOOKS
+    if (RealtimeAllocationLog::isEnabled())
+    {
+        isArmed = true;
+        previous = currentNoAllocationScope;
+        stackStart = previous != nullptr ? previous->stackStart : reinterpret_cast<const char*> (this);
+        currentNoAllocationScope = this;
+    }
+   #endif
+}
+
+JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+
+ScopedNoAllocation::~ScopedNoAllocation() noexcept
+{
+   #if JUCE_ENABLE_ALLOCATION_HOOKS
+    if (isArmed)
+    {
+        jassert (currentNoAllocationScope == this); // scopes must be deleted in the reverse order to their creation!
+        currentNoAllocationScope = previous;
+    }
+   #endif
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_ENABLE_ALLOCATION_HOOKS
+
+class ScopedNoAllocationTests  : public UnitTest
+{
+public:
+    ScopedNoAllocationTests()
+        : UnitTest ("ScopedNoAllocation", UnitTestCategories::memory)
+    {}
+
+    void runTest() override
+    {
+        auto wasEnabled = RealtimeAllocationLog::isEnabled();
+        RealtimeAllocationLog::clear();
+
+        beginTest ("Disabled");
+        {
+            RealtimeAllocationLog::setEnabled (false);
+
+            const ScopedNoAllocation scope ("disabled");
+            allocateAndFree (100);
+
+            expectEquals (scope.getNumCalls(), 0);
+            expectEquals ((int) RealtimeAllocationLog::getTotalNumCalls(), 0);
+        }
+
+        RealtimeAllocationLog::setEnabled (true);
+
+        beginTest ("Logging");
+        {
+            int numOuterCalls = 0, numInnerCalls = 0;
+
+            {
+                const ScopedNoAllocation scope ("outer");
+                allocateAndFree (100);
+
+                {
+                    const ScopedNoAllocation inner ("inner");
+                    allocateAndFree (200);
+                    numInnerCalls = inner.getNumCalls();
+                }
+
+                numOuterCalls = scope.getNumCalls();
+            }
+
+            expectEquals (numOuterCalls, 2);
+            expectEquals (numInnerCalls, 2);
+
+            // outside the scopes, nothing gets logged
+            allocateAndFree (300);
+
+            expectEquals ((int) RealtimeAllocationLog::getTotalNumCalls(), 4);
+
+            RealtimeAllocationLog::Entry entries[4];
+
+            for (auto& entry : entries)
+                expect (RealtimeAllocationLog::readNextEntry (entry));
+
+            RealtimeAllocationLog::Entry unused;
+            expect (! RealtimeAllocationLog::readNextEntry (unused));
+
+            expectEquals (String (entries[0].context), String ("outer"));
+            expect (! entries[0].isDelete);
+            expectEquals ((int) entries[0].numBytes, 100);
+            expectEquals (entries[0].callNumber, 1);
+            expect (entries[0].threadId == Thread::getCurrentThreadId());
+
+            expect (entries[1].isDelete);
+            expectEquals ((int) entries[1].numBytes, 0);
+            expectEquals (entries[1].callNumber, 2);
+
+            expectEquals (String (entries[2].context), String ("inner"));
+            expectEquals ((int) entries[2].numBytes, 200);
+            expectEquals (entries[2].callNumber, 1);
+
+            expect (entries[0].stackDepth > 0);
+            expect (RealtimeAllocationLog::getLargestStackDepth() >= entries[3].stackDepth);
+        }
+
+        beginTest ("Overflow");
+        {
+            RealtimeAllocationLog::clear();
+
+            {
+                const ScopedNoAllocation scope ("overflow");
+
+                for (int i = 0; i < RealtimeAllocationLog::capacity; ++i)
+                    allocateAndFree (8);
+            }
+
+            expectEquals ((int) RealtimeAllocationLog::getTotalNumCalls(), 2 * RealtimeAllocationLog::capacity);
+            expectEquals ((int) RealtimeAllocationLog::getNumDroppedEntries(), RealtimeAllocationLog::capacity);
+
+            RealtimeAllocationLog::Entry entry;
+            int numEntries = 0;
+
+            while (RealtimeAllocationLog::readNextEntry (entry))
+                expectEquals (entry.callNumber, ++numEntries);
+
+            expectEquals (numEntries, RealtimeAllocationLog::capacity);
+        }
+
+        beginTest ("Multiple threads");
+        {
+            RealtimeAllocationLog::clear();
+
+            constexpr int numThreads = 4, numCallsPerThread = 10000;
+            std::atomic<bool> finished { false };
+            int numRead = 0, numErrors = 0;
+
+            std::thread reader ([&]
+            {
+                RealtimeAllocationLog::Entry entry;
+
+                for (;;)
+                {
+                    auto isFinished = finished.load();
+
+                    while (RealtimeAllocationLog::readNextEntry (entry))
+                    {
+                        ++numRead;
+
+                        if (String (entry.context) != "thread" || entry.numBytes != (entry.isDelete ? 0 : 16))
+                            ++numErrors;
+                    }
+
+                    if (isFinished)
+                        break;
+
+                    Thread::yield();
+                }
+            });
+
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([]
+                {
+                    const ScopedNoAllocation scope ("thread");
+
+                    for (int i = 0; i < numCallsPerThread / 2; ++i)
+                        allocateAndFree (16);
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            finished = true;
+            reader.join();
+
+            expectEquals ((int) RealtimeAllocationLog::getTotalNumCalls(), numThreads * numCallsPerThread);
+            expectEquals (numRead + (int) RealtimeAllocationLog::getNumDroppedEntries(), numThreads * numCallsPerThread);
+            expectEquals (numErrors, 0);
+        }
+
+        RealtimeAllocationLog::clear();
+        RealtimeAllocationLog::setEnabled (wasEnabled);
+    }
+
+private:
+    static void allocateAndFree (size_t numBytes)
+    {
+        // the pointer is volatile so that the compiler can't optimise away the new and delete
+        char* volatile block = new char[numBytes];
+        delete[] block;
+    }
+};
+
+static ScopedNoAllocationTests scopedNoAllocationTests;
+
+#endif
+
+} // namespace juce
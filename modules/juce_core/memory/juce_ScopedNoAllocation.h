@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A lock-free record of the calls to new and delete that were made while a
+    ScopedNoAllocation was active.
+
+    This is intended for load-testing: arm the log, run the audio for as long as you
+    like, and then (or periodically, from a background thread) read back the entries
+    to find out which callbacks allocated, how often, and how deep in the stack the
+    calls were made. Nothing asserts, so a test run isn't interrupted by the first
+    offending call.
+
+    Logging needs JUCE_ENABLE_ALLOCATION_HOOKS to be enabled, because that's what
+    replaces the global operator new and delete. Without it, isSupported() returns
+    false, setEnabled() does nothing, and a ScopedNoAllocation costs a function call.
+
+    @code
+    RealtimeAllocationLog::setEnabled (true);
+
+    // ...run the load test...
+
+    RealtimeAllocationLog::Entry entry;
+
+    while (RealtimeAllocationLog::readNextEntry (entry))
+        DBG (entry.context << (entry.isDelete ? ": delete" : ": new ") << (int) entry.numBytes
+               << ", stack depth " << (int) entry.stackDepth);
+    @endcode
+
+    @see ScopedNoAllocation
+
+    @tags{Core}
+*/
+class JUCE_API  RealtimeAllocationLog
+{
+public:
+    //==============================================================================
+    /** Describes a call to new or delete that was made inside a ScopedNoAllocation. */
+    struct Entry
+    {
+        /** The name that was given to the innermost ScopedNoAllocation. */
+        const char* context = nullptr;
+
+        /** The thread that made the call. */
+        Thread::ThreadID threadId = nullptr;
+
+        /** The value of Time::getHighResolutionTicks() when the call was made. */
+        int64 timeTicks = 0;
+
+        /** For a call to new, the number of bytes requested. For delete, this is 0. */
+        size_t numBytes = 0;
+
+        /** The number of bytes of stack between the outermost active ScopedNoAllocation
+            on this thread and the call to new or delete.
+        */
+        size_t stackDepth = 0;
+
+        /** The number of calls that had been made inside this scope, including this one. */
+        int callNumber = 0;
+
+        /** True if this was a call to delete, or false for new. */
+        bool isDelete = false;
+    };
+
+    /** The maximum number of entries that the log can hold before they're read.
+        Entries which arrive when the log is full are counted, but discarded.
+    */
+    static constexpr int capacity = 4096;
+
+    //==============================================================================
+    /** Returns true if allocations can be logged in this build, i.e. if
+        JUCE_ENABLE_ALLOCATION_HOOKS is enabled.
+    */
+    static bool isSupported() noexcept;
+
+    /** Turns logging on or off.
+        ScopedNoAllocation objects only log calls if logging was enabled when they were
+        created, so this takes effect from the next audio callback.
+    */
+    static void setEnabled (bool shouldBeEnabled) noexcept;
+
+    /** Returns true if logging is turned on. */
+    static bool isEnabled() noexcept;
+
+    //==============================================================================
+    /** Removes the oldest entry from the log, and returns false if it was empty.
+        This can be called on any thread, while the log is being written to.
+    */
+    static bool readNextEntry (Entry& result) noexcept;
+
+    /** Returns the total number of calls to new and delete that have been made inside
+        active ScopedNoAllocation objects, including any that were dropped because the
+        log was full.
+    */
+    static int64 getTotalNumCalls() noexcept;
+
+    /** Returns the number of calls which weren't added to the log because it was full. */
+    static int64 getNumDroppedEntries() noexcept;
+
+    /** Returns the largest stackDepth of all the calls that have been logged. */
+    static size_t getLargestStackDepth() noexcept;
+
+    /** Resets the counters, and discards any entries that haven't been read. */
+    static void clear() noexcept;
+
+private:
+    RealtimeAllocationLog() = delete;
+};
+
+//==============================================================================
+/**
+    Marks a region of code, such as an audio callback, which shouldn't use the heap.
+
+    While one of these is in scope, any calls to new or delete made on the same thread
+    are recorded in the RealtimeAllocationLog, if it's enabled. Scopes can be nested,
+    in which case calls are attributed to the innermost one.
+
+    @code
+    void audioDeviceIOCallback (...) override
+    {
+        const ScopedNoAllocation noAllocation ("MyAudioCallback");
+        ...
+    }
+    @endcode
+
+    The context name must be a string literal, or some other string which lives for
+    as long as the log's entries might be read.
+
+    @see RealtimeAllocationLog
+
+    @tags{Core}
+*/
+class JUCE_API  ScopedNoAllocation
+{
+public:
+    /** Starts a region which shouldn't allocate. */
+    explicit ScopedNoAllocation (const char* contextName) noexcept;
+
+    /** Ends the region. */
+    ~ScopedNoAllocation() noexcept;
+
+    /** Returns the number of calls to new or delete that have been made inside
+        this scope so far. This will always be zero if the log wasn't enabled when
+        the scope was created.
+    */
+    int getNumCalls() const noexcept        { return numCalls; }
+
+private:
+    friend void notifyNoAllocationScopeForThread (size_t, bool) noexcept;
+
+    const char* const context;
+    ScopedNoAllocation* previous = nullptr;
+    const char* stackStart = nullptr;
+    int numCalls = 0;
+    bool isArmed = false;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNoAllocation)
+    JUCE_PREVENT_HEAP_ALLOCATION
+};
+
+} // namespace juce
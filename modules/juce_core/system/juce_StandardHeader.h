@@ -49,6 +49,7 @@
 #include <cmath>
 #include <condition_variable>
 #include <cstddef>
+#include <exception>
 #include <functional>
 #include <iomanip>
 #include <iostream>
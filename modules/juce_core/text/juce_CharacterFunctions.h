@@ -328,6 +328,14 @@ public:
                 {
                     if (numSigFigs >= maxSignificantDigits)
                         continue;
+
+                    // zeros before the first significant digit only affect the exponent
+                    if (numSigFigs == 0 && digit == 0)
+                    {
+                        leadingZeros = true;
+                        --extraExponent;
+                        continue;
+                    }
                 }
                 else
                 {
@@ -365,6 +373,13 @@ public:
             return 0.0;
         }
 
+        if (numSigFigs == 0)
+        {
+            // the number was all zeros
+            *writePtr++ = '0';
+            extraExponent = 0;
+        }
+
         auto writeExponentDigits = [] (int exponent, char* destination)
         {
             auto exponentDivisor = 100;
@@ -381,11 +396,11 @@ public:
         };
 
         c = *text;
+        auto exponent = extraExponent;
 
         if (c == 'e' || c == 'E')
         {
             const auto startOfExponent = text;
-            *writePtr++ = 'e';
             bool parsedExponentIsPositive = true;
 
             switch (*++text)
@@ -400,21 +415,26 @@ public:
                     break;
             }
 
-            int exponent = 0;
+            int parsedExponent = 0;
             const auto startOfExponentDigits = text;
 
             while (text.isDigit())
             {
                 auto digit = (int) text.getAndAdvance() - '0';
 
-                if (digit != 0 || exponent != 0)
-                    exponent = (exponent * 10) + digit;
+                if (parsedExponent < 100000)
+                    parsedExponent = (parsedExponent * 10) + digit;
             }
 
             if (text == startOfExponentDigits)
                 text = startOfExponent;
 
-            exponent = extraExponent + (parsedExponentIsPositive ? exponent : -exponent);
+            exponent += parsedExponentIsPositive ? parsedExponent : -parsedExponent;
+        }
+
+        if (exponent != 0)
+        {
+            *writePtr++ = 'e';
 
             if (exponent < 0)
             {
@@ -431,11 +451,6 @@ public:
 
             writeExponentDigits (exponent, writePtr);
         }
-        else if (extraExponent > 0)
-        {
-            *writePtr++ = 'e';
-            writeExponentDigits (extraExponent, writePtr);
-        }
 
        #if JUCE_WINDOWS
         static _locale_t locale = _create_locale (LC_ALL, "C");
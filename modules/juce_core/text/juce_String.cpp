@@ -196,6 +196,18 @@ public:
         return newText;
     }
 
+    static CharPointerType makeUniqueWithRoomToGrow (const CharPointerType text, size_t numBytes)
+    {
+        auto* b = bufferFromText (text);
+
+        // If nothing else is sharing this buffer, then something's probably being appended
+        // to it repeatedly, so grow it geometrically rather than reallocating it every time.
+        if (! isEmptyString (b) && b->refCount.get() <= 0 && b->allocatedNumBytes < numBytes)
+            numBytes = jmax (numBytes, b->allocatedNumBytes + b->allocatedNumBytes / 2);
+
+        return makeUniqueWithByteSize (text, numBytes);
+    }
+
     static size_t getAllocatedNumBytes (const CharPointerType text) noexcept
     {
         return bufferFromText (text)->allocatedNumBytes;
@@ -293,6 +305,11 @@ void String::preallocateBytes (const size_t numBytesNeeded)
     text = StringHolder::makeUniqueWithByteSize (text, numBytesNeeded + sizeof (CharPointerType::CharType));
 }
 
+void String::preallocateBytesForAppending (const size_t numBytesNeeded)
+{
+    text = StringHolder::makeUniqueWithRoomToGrow (text, numBytesNeeded + sizeof (CharPointerType::CharType));
+}
+
 int String::getReferenceCount() const noexcept
 {
     return StringHolder::getReferenceCount (text);
@@ -556,6 +573,7 @@ struct HashGenerator
 int String::hashCode() const noexcept       { return (int) HashGenerator<uint32>    ::calculate (text); }
 int64 String::hashCode64() const noexcept   { return (int64) HashGenerator<uint64>  ::calculate (text); }
 size_t String::hash() const noexcept        { return HashGenerator<size_t>          ::calculate (text); }
+int StringRef::hashCode() const noexcept    { return (int) HashGenerator<uint32>    ::calculate (text); }
 
 //==============================================================================
 JUCE_API bool JUCE_CALLTYPE operator== (const String& s1, const String& s2) noexcept            { return s1.compare (s2) == 0; }
@@ -733,7 +751,7 @@ void String::appendCharPointer (const CharPointerType startOfTextToAppend,
     if (extraBytesNeeded > 0)
     {
         auto byteOffsetOfNull = getByteOffsetOfEnd();
-        preallocateBytes ((size_t) extraBytesNeeded + byteOffsetOfNull);
+        preallocateBytesForAppending ((size_t) extraBytesNeeded + byteOffsetOfNull);
 
         auto* newStringStart = addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull);
         memcpy (newStringStart, startOfTextToAppend.getAddress(), (size_t) extraBytesNeeded);
@@ -767,7 +785,15 @@ String& String::operator+= (const String& other)
 
 String& String::operator+= (StringRef other)
 {
-    return operator+= (String (other));
+    auto* start = text.getAddress();
+    auto* otherStart = other.text.getAddress();
+
+    // appending can reallocate our buffer, so text that points into it needs to be copied first
+    if (otherStart >= start && otherStart <= addBytesToPointer (start, (int) getByteOffsetOfEnd()))
+        return operator+= (String (other));
+
+    appendCharPointer (other.text);
+    return *this;
 }
 
 String& String::operator+= (char ch)
@@ -2964,6 +2990,48 @@ public:
             for (auto c : str)
                 expectEquals (c, parts[index++]);
         }
+
+        {
+            beginTest ("Appending");
+
+            constexpr int numPieces = 1000;
+            String expected;
+
+            {
+                String s;
+
+                for (int i = 0; i < numPieces; ++i)
+                    s += "abcdefgh";
+
+                expectEquals (s.length(), numPieces * 8);
+                expected = s;
+            }
+
+            {
+                StringBuilder builder;
+
+                for (int i = 0; i < numPieces; ++i)
+                    builder << "abcdefgh";
+
+                expectEquals (builder.toString(), expected);
+            }
+
+            {
+                MemoryOutputStream mo;
+
+                for (int i = 0; i < numPieces; ++i)
+                    mo << "abcdefgh";
+
+                expectEquals (mo.toString(), expected);
+            }
+
+            String s ("abc");
+            auto numBytesBefore = s.getCharPointer().sizeInBytes();
+            s += StringRef (s);
+            s += s.substring (1).toRawUTF8();
+            expectEquals (s, String ("abcabcbcabc"));
+            expect (s.getCharPointer().sizeInBytes() > numBytesBefore);
+        }
     }
 };
 
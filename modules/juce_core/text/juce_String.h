@@ -258,7 +258,7 @@ public:
         {
             auto byteOffsetOfNull = getByteOffsetOfEnd();
 
-            preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
+            preallocateBytesForAppending (byteOffsetOfNull + extraBytesNeeded);
             CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull))
                 .writeWithCharLimit (startOfTextToAppend, (int) numChars);
         }
@@ -286,7 +286,7 @@ public:
             {
                 auto byteOffsetOfNull = getByteOffsetOfEnd();
 
-                preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
+                preallocateBytesForAppending (byteOffsetOfNull + extraBytesNeeded);
                 CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull))
                     .writeWithCharLimit (textToAppend, (int) numChars);
             }
@@ -1347,6 +1347,7 @@ private:
 
     explicit String (const PreallocationBytes&); // This constructor preallocates a certain amount of memory
     size_t getByteOffsetOfEnd() const noexcept;
+    void preallocateBytesForAppending (size_t numBytesNeeded);
 
     // This private cast operator should prevent strings being accidentally cast
     // to bools (this is possible because the compiler can add an implicit cast
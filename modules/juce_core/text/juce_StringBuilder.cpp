@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+StringBuilder::StringBuilder() noexcept {}
+
+StringBuilder::StringBuilder (size_t numBytesToPreallocate)
+{
+    preallocateBytes (numBytesToPreallocate);
+}
+
+StringBuilder::~StringBuilder() {}
+
+StringBuilder::StringBuilder (StringBuilder&& other) noexcept
+    : buffer (std::move (other.buffer)),
+      numBytesUsed (other.numBytesUsed),
+      numBytesAllocated (other.numBytesAllocated)
+{
+    other.numBytesUsed = 0;
+    other.numBytesAllocated = 0;
+}
+
+StringBuilder& StringBuilder::operator= (StringBuilder&& other) noexcept
+{
+    buffer.swapWith (other.buffer);
+    std::swap (numBytesUsed, other.numBytesUsed);
+    std::swap (numBytesAllocated, other.numBytesAllocated);
+    return *this;
+}
+
+//==============================================================================
+String::CharPointerType StringBuilder::getEnd() const noexcept
+{
+    return String::CharPointerType (unalignedPointerCast<String::CharPointerType::CharType*> (buffer.get() + numBytesUsed));
+}
+
+void StringBuilder::preallocateBytes (size_t numBytesNeeded)
+{
+    // (this always leaves space for a null terminator, which isn't counted in numBytesAllocated)
+    if (numBytesNeeded > numBytesAllocated)
+    {
+        buffer.realloc (numBytesNeeded + sizeof (String::CharPointerType::CharType));
+        numBytesAllocated = numBytesNeeded;
+        getEnd().writeNull();
+    }
+}
+
+String::CharPointerType StringBuilder::makeSpace (size_t numBytesToAdd)
+{
+    auto numBytesNeeded = numBytesUsed + numBytesToAdd;
+
+    if (numBytesNeeded > numBytesAllocated)
+        preallocateBytes (jmax (numBytesNeeded, numBytesAllocated * 2, (size_t) 64));
+
+    return getEnd();
+}
+
+void StringBuilder::addBytesUsed (size_t numBytes) noexcept
+{
+    // The text is kept null-terminated whenever it changes, so that getCharPointer()
+    // doesn't have to write anything
+    numBytesUsed += numBytes;
+    getEnd().writeNull();
+}
+
+void StringBuilder::clear() noexcept
+{
+    numBytesUsed = 0;
+
+    if (numBytesAllocated > 0)
+        getEnd().writeNull();
+}
+
+//==============================================================================
+StringBuilder& StringBuilder::append (StringRef text)
+{
+    auto numBytes = text.text.sizeInBytes() - sizeof (String::CharPointerType::CharType);
+
+    if (numBytes > 0)
+    {
+        memcpy (makeSpace (numBytes).getAddress(), text.text.getAddress(), numBytes);
+        addBytesUsed (numBytes);
+    }
+
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendCharacter (juce_wchar character)
+{
+    if (character != 0)
+    {
+        auto numBytes = String::CharPointerType::getBytesRequiredFor (character);
+        auto dest = makeSpace (numBytes);
+        dest.write (character);
+        addBytesUsed (numBytes);
+    }
+
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendASCII (const char* text, size_t numChars)
+{
+    auto dest = makeSpace (numChars * sizeof (String::CharPointerType::CharType));
+
+    for (size_t i = 0; i < numChars; ++i)
+        dest.write ((juce_wchar) (uint8) text[i]);
+
+    addBytesUsed (numChars * sizeof (String::CharPointerType::CharType));
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendInteger (int64 number)
+{
+    char digits[NumberToStringConverters::charsNeededForInt];
+    auto* end = digits + numElementsInArray (digits);
+    auto* start = NumberToStringConverters::numberToString (end, number);
+    return appendASCII (start, (size_t) (end - start - 1));
+}
+
+StringBuilder& StringBuilder::appendUnsignedInteger (uint64 number)
+{
+    char digits[NumberToStringConverters::charsNeededForInt];
+    auto* end = digits + numElementsInArray (digits);
+    auto* start = NumberToStringConverters::numberToString (end, number);
+    return appendASCII (start, (size_t) (end - start - 1));
+}
+
+StringBuilder& StringBuilder::appendNumber (double number, int numberOfDecimalPlaces, bool useScientificNotation)
+{
+    char digits[NumberToStringConverters::charsNeededForDouble];
+    size_t length = 0;
+    auto* start = NumberToStringConverters::doubleToString (digits, number, numberOfDecimalPlaces, useScientificNotation, length);
+    return appendASCII (start, length);
+}
+
+//==============================================================================
+String::CharPointerType StringBuilder::getCharPointer() const noexcept
+{
+    if (numBytesAllocated == 0)
+        return StringRef().text;
+
+    return String::CharPointerType (unalignedPointerCast<String::CharPointerType::CharType*> (buffer.get()));
+}
+
+String StringBuilder::toString() const
+{
+    if (numBytesUsed == 0)
+        return {};
+
+    auto start = getCharPointer();
+    return String (start, getEnd());
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringBuilderTests  : public UnitTest
+{
+public:
+    StringBuilderTests()
+        : UnitTest ("StringBuilder", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Appending");
+        {
+            StringBuilder builder;
+            expect (builder.isEmpty());
+            expectEquals (builder.toString(), String());
+            expectEquals (String (builder.getCharPointer()), String());
+
+            builder << "abc" << String ("def") << ' ' << 42 << ' ' << -7 << ' ' << (uint64) 18446744073709551615ull
+                    << ' ' << 1.5 << ' ' << (int64) std::numeric_limits<int64>::min();
+            builder.appendCharacter (0x20ac).appendNumber (3.14159, 2);
+
+            auto expected = String ("abcdef 42 -7 18446744073709551615 ") + String (1.5) + " "
+                              + String (std::numeric_limits<int64>::min()) + String::charToString (0x20ac) + String (3.14159, 2);
+
+            expectEquals (builder.toString(), expected);
+            expectEquals ((int) builder.getNumBytes(), (int) expected.getNumBytesAsUTF8());
+            expectEquals (String (builder.getCharPointer()), expected);
+        }
+
+        beginTest ("Growing and reusing the buffer");
+        {
+            StringBuilder builder;
+            String expected;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                builder << "item " << i << newLine;
+                expected << "item " << i << newLine;
+            }
+
+            expectEquals (builder.toString(), expected);
+
+            auto allocated = builder.getNumBytesAllocated();
+            builder.clear();
+            expect (builder.isEmpty());
+            expectEquals (builder.toString(), String());
+            expectEquals (String (builder.getCharPointer()), String());
+
+            builder << "reused";
+            expectEquals (builder.toString(), String ("reused"));
+            expectEquals (String (builder.getCharPointer()), String ("reused"));
+            expectEquals ((int) builder.getNumBytesAllocated(), (int) allocated);
+
+            StringBuilder moved (std::move (builder));
+            expectEquals (moved.toString(), String ("reused"));
+            expect (builder.isEmpty());
+        }
+    }
+};
+
+static StringBuilderTests stringBuilderTests;
+
+#endif
+
+} // namespace juce
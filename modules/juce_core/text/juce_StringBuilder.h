@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Builds up a String from lots of smaller pieces, with as few allocations as possible.
+
+    Appending to a String with += or << has to reallocate it whenever it runs out of
+    space. A StringBuilder keeps its text in a buffer that doubles in size each time it
+    needs to grow, so appending never allocates once the buffer is large enough, and the
+    finished String is only allocated once, when toString() is called. Calling clear()
+    keeps the buffer, so a single StringBuilder can be reused to build lots of strings
+    without allocating at all.
+
+    @code
+    StringBuilder builder;
+
+    for (auto* param : parameters)
+        builder << param->getName (32) << " = " << param->getValue() << newLine;
+
+    auto text = builder.toString();
+    @endcode
+
+    @see String, MemoryOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  StringBuilder
+{
+public:
+    //==============================================================================
+    /** Creates an empty StringBuilder. This doesn't allocate anything until text is added. */
+    StringBuilder() noexcept;
+
+    /** Creates an empty StringBuilder with space for a number of bytes of text. */
+    explicit StringBuilder (size_t numBytesToPreallocate);
+
+    /** Destructor. */
+    ~StringBuilder();
+
+    StringBuilder (StringBuilder&&) noexcept;
+    StringBuilder& operator= (StringBuilder&&) noexcept;
+
+    //==============================================================================
+    /** Appends some text. */
+    StringBuilder& append (StringRef text);
+
+    /** Appends a character. */
+    StringBuilder& appendCharacter (juce_wchar character);
+
+    /** Appends an integer, written in decimal. */
+    template <typename IntegerType, typename std::enable_if<std::is_integral<IntegerType>::value, int>::type = 0>
+    StringBuilder& appendNumber (IntegerType number)
+    {
+        return std::is_signed<IntegerType>::value ? appendInteger ((int64) number)
+                                                  : appendUnsignedInteger ((uint64) number);
+    }
+
+    /** Appends a floating-point number, formatted in the same way as by the String constructors. */
+    StringBuilder& appendNumber (double number, int numberOfDecimalPlaces = 0, bool useScientificNotation = false);
+
+    /** Appends some text. */
+    StringBuilder& operator<< (StringRef text)                      { return append (text); }
+
+    /** Appends some text. */
+    StringBuilder& operator<< (const String& text)                  { return append (text); }
+
+    /** Appends some text. */
+    StringBuilder& operator<< (const char* text)                    { return append (text); }
+    /** Appends a character. */
+    StringBuilder& operator<< (char character)                      { return appendCharacter ((juce_wchar) (uint8) character); }
+    /** Appends a character. */
+    StringBuilder& operator<< (wchar_t character)                   { return appendCharacter ((juce_wchar) character); }
+    /** Appends a floating-point number. */
+    StringBuilder& operator<< (double number)                       { return appendNumber (number); }
+    /** Appends a floating-point number. */
+    StringBuilder& operator<< (float number)                        { return appendNumber ((double) number); }
+    /** Appends a new-line. */
+    StringBuilder& operator<< (const NewLine&)                      { return append (NewLine::getDefault()); }
+
+    /** Appends an integer. */
+    template <typename IntegerType, typename std::enable_if<std::is_integral<IntegerType>::value
+                                                             && ! std::is_same<IntegerType, char>::value
+                                                             && ! std::is_same<IntegerType, wchar_t>::value
+                                                             && ! std::is_same<IntegerType, bool>::value, int>::type = 0>
+    StringBuilder& operator<< (IntegerType number)                  { return appendNumber (number); }
+
+    //==============================================================================
+    /** Returns the text that has been added, as a String. */
+    String toString() const;
+
+    /** Returns a pointer to the text that has been added.
+        This is null-terminated, and remains valid until the StringBuilder is next changed.
+    */
+    String::CharPointerType getCharPointer() const noexcept;
+
+    /** Returns true if no text has been added. */
+    bool isEmpty() const noexcept                                   { return numBytesUsed == 0; }
+
+    /** Returns the number of bytes of text that have been added, not including a null terminator. */
+    size_t getNumBytes() const noexcept                             { return numBytesUsed; }
+
+    /** Returns the number of bytes that the buffer can hold before it next needs to grow. */
+    size_t getNumBytesAllocated() const noexcept                    { return numBytesAllocated; }
+
+    /** Removes all the text, but keeps the buffer so that it can be reused. */
+    void clear() noexcept;
+
+    /** Makes sure that the buffer has space for at least this many bytes of text. */
+    void preallocateBytes (size_t numBytesNeeded);
+
+private:
+    //==============================================================================
+    HeapBlock<char> buffer;
+    size_t numBytesUsed = 0, numBytesAllocated = 0;
+
+    String::CharPointerType getEnd() const noexcept;
+    String::CharPointerType makeSpace (size_t numBytesToAdd);
+    void addBytesUsed (size_t numBytes) noexcept;
+    StringBuilder& appendASCII (const char* text, size_t numChars);
+    StringBuilder& appendInteger (int64);
+    StringBuilder& appendUnsignedInteger (uint64);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StringBuilder)
+};
+
+} // namespace juce
@@ -25,76 +25,237 @@ namespace juce
 
 static const int minNumberOfStringsForGarbageCollection = 300;
 static const uint32 garbageCollectionInterval = 30000;
+static const int numStringPoolShardBits = 4;
 
-
-StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
-
+//==============================================================================
 struct StartEndString
 {
     StartEndString (String::CharPointerType s, String::CharPointerType e) noexcept : start (s), end (e) {}
-    operator String() const   { return String (start, end); }
 
     String::CharPointerType start, end;
 };
 
-static int compareStrings (const String& s1, const String& s2) noexcept     { return s1.compare (s2); }
-static int compareStrings (CharPointer_UTF8 s1, const String& s2) noexcept  { return s1.compare (s2.getCharPointer()); }
-
-static int compareStrings (const StartEndString& string1, const String& string2) noexcept
+struct PooledStringKey
 {
-    String::CharPointerType s1 (string1.start), s2 (string2.getCharPointer());
+    PooledStringKey (const void* t, size_t n) noexcept
+        : text (static_cast<const char*> (t)), numBytes (n), hash (calculateHash (text, n))
+    {}
 
-    for (;;)
+    static uint32 calculateHash (const char* t, size_t n) noexcept
     {
-        const int c1 = s1 < string1.end ? (int) s1.getAndAdvance() : 0;
-        const int c2 = (int) s2.getAndAdvance();
-        const int diff = c1 - c2;
+        uint32 h = 2166136261u;
 
-        if (diff != 0)  return diff < 0 ? -1 : 1;
-        if (c1 == 0)    break;
+        for (size_t i = 0; i < n; ++i)
+            h = (h ^ (uint8) t[i]) * 16777619u;
+
+        return h;
     }
 
-    return 0;
+    const char* text;
+    size_t numBytes;
+    uint32 hash;
+};
+
+static PooledStringKey makePooledStringKey (const String& s) noexcept
+{
+    auto text = s.getCharPointer();
+    return { text.getAddress(), text.sizeInBytes() - sizeof (String::CharPointerType::CharType) };
 }
 
-template <typename NewStringType>
-static String addPooledString (Array<String>& strings, const NewStringType& newString)
+static PooledStringKey makePooledStringKey (String::CharPointerType text) noexcept
+{
+    return { text.getAddress(), text.sizeInBytes() - sizeof (String::CharPointerType::CharType) };
+}
+
+static PooledStringKey makePooledStringKey (const StartEndString& s) noexcept
 {
-    int start = 0;
-    int end = strings.size();
+    // (the range may stop short of the string's terminator, so this mustn't scan beyond its end)
+    auto* start = s.start.getAddress();
+    auto* p = start;
+
+    while (p < s.end.getAddress() && *p != 0)
+        ++p;
 
-    while (start < end)
+    return { start, (size_t) (p - start) * sizeof (*p) };
+}
+
+static String createPooledString (const String& s)              { return s; }
+static String createPooledString (String::CharPointerType text)  { return String (text); }
+static String createPooledString (const StartEndString& s)       { return String (s.start, s.end); }
+
+//==============================================================================
+struct StringPool::Shard
+{
+    struct Entry
+    {
+        String string;
+        size_t numBytes;
+        uint32 hash;
+    };
+
+    // An open-addressed table of entries. Slots are only ever filled in while the table is
+    // in use, so readers can probe it without locking.
+    struct Table
     {
-        const String& startString = strings.getReference (start);
-        const int startComp = compareStrings (newString, startString);
+        explicit Table (uint32 size)  : slots (new std::atomic<Entry*>[size]()), mask (size - 1) {}
 
-        if (startComp == 0)
-            return startString;
+        Entry* find (const PooledStringKey& key) const noexcept
+        {
+            for (auto i = key.hash & mask;; i = (i + 1) & mask)
+            {
+                auto* e = slots[i].load (std::memory_order_acquire);
 
-        const int halfway = (start + end) / 2;
+                if (e == nullptr)
+                    return nullptr;
 
-        if (halfway == start)
+                if (e->hash == key.hash && e->numBytes == key.numBytes
+                     && memcmp (e->string.getCharPointer().getAddress(), key.text, key.numBytes) == 0)
+                    return e;
+            }
+        }
+
+        void insert (Entry* e) noexcept
         {
-            if (startComp > 0)
-                ++start;
+            for (auto i = e->hash & mask;; i = (i + 1) & mask)
+            {
+                if (slots[i].load (std::memory_order_relaxed) == nullptr)
+                {
+                    slots[i].store (e, std::memory_order_release);
+                    return;
+                }
+            }
+        }
 
-            break;
+        std::unique_ptr<std::atomic<Entry*>[]> slots;
+        const uint32 mask;
+    };
+
+    //==============================================================================
+    bool findWithoutLocking (const PooledStringKey& key, String& result) noexcept
+    {
+        bool found = false;
+        ++numActiveReaders;
+
+        if (! isCollecting)
+        {
+            if (auto* t = table.load (std::memory_order_acquire))
+            {
+                if (auto* e = t->find (key))
+                {
+                    result = e->string;
+                    found = true;
+                }
+            }
+        }
+
+        --numActiveReaders;
+        return found;
+    }
+
+    // must be called with the lock held
+    Entry* find (const PooledStringKey& key) const noexcept
+    {
+        if (auto* t = table.load (std::memory_order_relaxed))
+            return t->find (key);
+
+        return nullptr;
+    }
+
+    // must be called with the lock held
+    const String& add (const PooledStringKey& key, String&& newString)
+    {
+        auto* t = table.load (std::memory_order_relaxed);
+
+        if (t == nullptr || (uint32) (entries.size() + 1) * 2 > t->mask + 1)
+            t = rebuildTable ((uint32) (entries.size() + 1) * 4);
+
+        auto* e = entries.add (new Entry { std::move (newString), key.numBytes, key.hash });
+        t->insert (e);
+        return e->string;
+    }
+
+    int removeUnusedStrings()
+    {
+        const ScopedLock sl (lock);
+
+        // Stop any new lock-free lookups, and wait for the ones in progress to finish,
+        // so that nothing can take a reference to a string while it's being removed.
+        isCollecting = true;
+
+        while (numActiveReaders.load() != 0)
+            Thread::yield();
+
+        OwnedArray<Entry> survivors;
+        survivors.ensureStorageAllocated (entries.size());
+
+        for (auto* e : entries)
+        {
+            if (e->string.getReferenceCount() != 1)
+                survivors.add (e);
+            else
+                delete e;
         }
 
-        const String& halfwayString = strings.getReference (halfway);
-        const int halfwayComp = compareStrings (newString, halfwayString);
+        auto numRemoved = entries.size() - survivors.size();
+        entries.clear (false);
+        entries.swapWith (survivors);
+
+        // nobody can be using the old tables at this point, so they can be thrown away
+        table = nullptr;
+        tables.clear();
 
-        if (halfwayComp == 0)
-            return halfwayString;
+        if (! entries.isEmpty())
+            rebuildTable ((uint32) entries.size() * 4);
 
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
+        isCollecting = false;
+        return numRemoved;
     }
 
-    strings.insert (start, newString);
-    return strings.getReference (start);
+    CriticalSection lock;
+
+private:
+    Table* rebuildTable (uint32 minSize)
+    {
+        auto* t = tables.add (new Table (jmax ((uint32) 16, (uint32) nextPowerOfTwo ((int) minSize))));
+
+        for (auto* e : entries)
+            t->insert (e);
+
+        table.store (t, std::memory_order_release);
+        return t;
+    }
+
+    OwnedArray<Entry> entries;
+    OwnedArray<Table> tables; // includes any old tables that lock-free readers might still be using
+    std::atomic<Table*> table { nullptr };
+    std::atomic<int> numActiveReaders { 0 };
+    std::atomic<bool> isCollecting { false };
+};
+
+//==============================================================================
+StringPool::StringPool()  : shards (new Shard[1 << numStringPoolShardBits]) {}
+StringPool::~StringPool() {}
+
+template <typename NewStringType>
+String StringPool::getOrAdd (const NewStringType& newString)
+{
+    auto key = makePooledStringKey (newString);
+    auto& shard = shards[key.hash >> (32 - numStringPoolShardBits)];
+
+    String result;
+
+    if (shard.findWithoutLocking (key, result))
+        return result;
+
+    garbageCollectIfNeeded();
+
+    const ScopedLock sl (shard.lock);
+
+    if (auto* e = shard.find (key))
+        return e->string;
+
+    ++numStrings;
+    return shard.add (key, createPooledString (newString));
 }
 
 String StringPool::getPooledString (const char* const newString)
@@ -102,9 +263,11 @@ String StringPool::getPooledString (const char* const newString)
     if (newString == nullptr || *newString == 0)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+   #if (JUCE_STRING_UTF_TYPE == 8)
+    return getOrAdd (String::CharPointerType (newString));
+   #else
+    return getOrAdd (String (CharPointer_UTF8 (newString)));
+   #endif
 }
 
 String StringPool::getPooledString (String::CharPointerType start, String::CharPointerType end)
@@ -112,9 +275,7 @@ String StringPool::getPooledString (String::CharPointerType start, String::CharP
     if (start.isEmpty() || start == end)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+    return getOrAdd (StartEndString (start, end));
 }
 
 String StringPool::getPooledString (StringRef newString)
@@ -122,9 +283,7 @@ String StringPool::getPooledString (StringRef newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+    return getOrAdd (newString.text);
 }
 
 String StringPool::getPooledString (const String& newString)
@@ -132,27 +291,27 @@ String StringPool::getPooledString (const String& newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString);
+    return getOrAdd (newString);
+}
+
+int StringPool::size() const noexcept
+{
+    return numStrings.load();
 }
 
 void StringPool::garbageCollectIfNeeded()
 {
-    if (strings.size() > minNumberOfStringsForGarbageCollection
-         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
+    if (numStrings.load() > minNumberOfStringsForGarbageCollection
+         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime.load() + garbageCollectionInterval)
         garbageCollect();
 }
 
 void StringPool::garbageCollect()
 {
-    const ScopedLock sl (lock);
-
-    for (int i = strings.size(); --i >= 0;)
-        if (strings.getReference(i).getReferenceCount() == 1)
-            strings.remove (i);
-
     lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+
+    for (size_t i = 0; i < ((size_t) 1 << numStringPoolShardBits); ++i)
+        numStrings -= shards[i].removeUnusedStrings();
 }
 
 StringPool& StringPool::getGlobalPool() noexcept
@@ -161,4 +320,125 @@ StringPool& StringPool::getGlobalPool() noexcept
     return pool;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests  : public UnitTest
+{
+public:
+    StringPoolTests()
+        : UnitTest ("StringPool", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Pooled strings are shared");
+        {
+            StringPool pool;
+            const String text ("pooled");
+
+            auto s1 = pool.getPooledString (text);
+            auto s2 = pool.getPooledString ("pooled");
+            auto s3 = pool.getPooledString (StringRef ("pooled"));
+            auto s4 = pool.getPooledString (text.getCharPointer(), text.getCharPointer() + 6);
+
+            auto longer = String ("pooled string");
+            auto s5 = pool.getPooledString (longer.getCharPointer(), longer.getCharPointer() + 6);
+
+            expectEquals (s1, text);
+            expect (s1.getCharPointer() == s2.getCharPointer());
+            expect (s1.getCharPointer() == s3.getCharPointer());
+            expect (s1.getCharPointer() == s4.getCharPointer());
+            expect (s1.getCharPointer() == s5.getCharPointer());
+            expect (pool.getPooledString ("pooled!").getCharPointer() != s1.getCharPointer());
+            expectEquals (pool.size(), 2);
+
+            expect (pool.getPooledString (String()).isEmpty());
+            expect (pool.getPooledString ((const char*) nullptr).isEmpty());
+            expectEquals (pool.size(), 2);
+        }
+
+        beginTest ("Garbage collection");
+        {
+            StringPool pool;
+            auto kept = pool.getPooledString ("kept");
+            StringArray others;
+
+            for (int i = 0; i < 1000; ++i)
+                others.add (pool.getPooledString (String (i)));
+
+            expectEquals (pool.size(), 1001);
+            others.clear();
+            pool.garbageCollect();
+            expectEquals (pool.size(), 1);
+            expect (pool.getPooledString ("kept").getCharPointer() == kept.getCharPointer());
+        }
+
+        beginTest ("Concurrent use");
+        {
+            StringPool pool;
+            constexpr int numThreads = 4, numNames = 2000;
+            std::vector<std::vector<String>> results ((size_t) numThreads);
+            std::atomic<bool> finished { false };
+
+            std::thread collector ([&]
+            {
+                while (! finished)
+                {
+                    pool.garbageCollect();
+                    Thread::yield();
+                }
+            });
+
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&results, &pool, t]
+                {
+                    auto& names = results[(size_t) t];
+
+                    for (int repeat = 0; repeat < 3; ++repeat)
+                    {
+                        names.clear();
+
+                        for (int i = 0; i < numNames; ++i)
+                            names.push_back (pool.getPooledString ("name" + String ((i * 7 + t) % numNames)));
+                    }
+                });
+            }
+
+            for (auto& t : threads)
+                t.join();
+
+            finished = true;
+            collector.join();
+
+            HashMap<String, const void*> pointers;
+            auto allShared = true;
+
+            for (auto& names : results)
+            {
+                for (auto& s : names)
+                {
+                    auto* p = s.getCharPointer().getAddress();
+
+                    if (! pointers.contains (s))
+                        pointers.set (s, p);
+                    else if (pointers[s] != p)
+                        allShared = false;
+                }
+            }
+
+            expectEquals (pointers.size(), numNames);
+            expect (allShared);
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
+
 } // namespace juce
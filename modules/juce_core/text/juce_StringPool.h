@@ -34,6 +34,10 @@ namespace juce
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
 
+    The pool is split into a number of independently locked hash tables, and looking up
+    a string that's already in the pool doesn't take any locks at all, so it's cheap to
+    use the same pool from lots of threads at once.
+
     @tags{Core}
 */
 class JUCE_API  StringPool
@@ -41,7 +45,10 @@ class JUCE_API  StringPool
 public:
     //==============================================================================
     /** Creates an empty pool. */
-    StringPool() noexcept;
+    StringPool();
+
+    /** Destructor. */
+    ~StringPool();
 
     //==============================================================================
     /** Returns a pointer to a shared copy of the string that is passed in.
@@ -74,11 +81,17 @@ public:
     /** Returns a shared global pool which is used for things like Identifiers, XML parsing. */
     static StringPool& getGlobalPool() noexcept;
 
+    /** Returns the number of strings that are currently in the pool. */
+    int size() const noexcept;
+
 private:
-    Array<String> strings;
-    CriticalSection lock;
-    uint32 lastGarbageCollectionTime;
+    struct Shard;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<int> numStrings { 0 };
+    std::atomic<uint32> lastGarbageCollectionTime { 0 };
 
+    template <typename NewStringType>
+    String getOrAdd (const NewStringType&);
     void garbageCollectIfNeeded();
 
     JUCE_DECLARE_NON_COPYABLE (StringPool)
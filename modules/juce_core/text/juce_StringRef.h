@@ -107,6 +107,9 @@ public:
     /** Retrieves a character by index. */
     juce_wchar operator[] (int index) const noexcept                    { return text[index]; }
 
+    /** Generates a hash code, which is the same as String::hashCode() would return for this text. */
+    int hashCode() const noexcept;
+
     /** Compares this StringRef with a String. */
     bool operator== (const String& s) const noexcept                    { return text.compare (s.getCharPointer()) == 0; }
     /** Compares this StringRef with a String. */
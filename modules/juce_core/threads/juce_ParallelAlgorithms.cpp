@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace detail
+{
+
+int getNumParallelChunks (const ThreadPool& pool, int64 numItems, int64 grainSize) noexcept
+{
+    if (numItems <= 0)
+        return 0;
+
+    if (grainSize <= 0)
+        return (int) jmin (numItems, (int64) pool.getNumThreads() * 4);
+
+    return (int) jmin ((int64) std::numeric_limits<int>::max(), (numItems + grainSize - 1) / grainSize);
+}
+
+void runInParallel (ThreadPool& pool, int64 numItems, int64 grainSize,
+                    const std::function<void (int, Range<int64>)>& processChunk)
+{
+    auto numChunks = getNumParallelChunks (pool, numItems, grainSize);
+
+    if (numChunks <= 1)
+    {
+        if (numChunks == 1)
+            processChunk (0, { 0, numItems });
+
+        return;
+    }
+
+    // The helper tasks may not get started until after all the chunks have been
+    // done, so they share this state rather than referring to the caller's stack,
+    // and only touch the function if there's still a chunk left for them to do.
+    struct SharedState
+    {
+        bool processNextChunk()
+        {
+            auto chunk = nextChunk++;
+
+            if (chunk >= numChunks)
+                return false;
+
+            try
+            {
+                (*function) (chunk, getParallelChunkRange (numItems, numChunks, chunk));
+            }
+            catch (...)
+            {
+                const SpinLock::ScopedLockType sl (exceptionLock);
+
+                if (exception == nullptr)
+                    exception = std::current_exception();
+            }
+
+            if (++numChunksFinished == numChunks)
+                finished.signal();
+
+            return true;
+        }
+
+        const std::function<void (int, Range<int64>)>* function = nullptr;
+        int64 numItems = 0;
+        int numChunks = 0;
+        std::atomic<int> nextChunk { 0 }, numChunksFinished { 0 };
+        WaitableEvent finished;
+        SpinLock exceptionLock;
+        std::exception_ptr exception;
+    };
+
+    auto state = std::make_shared<SharedState>();
+    state->function = &processChunk;
+    state->numItems = numItems;
+    state->numChunks = numChunks;
+
+    for (int i = jmin (pool.getNumThreads(), numChunks - 1); --i >= 0;)
+        pool.submit ([state] { while (state->processNextChunk()) {} }, ThreadPool::TaskPriority::high);
+
+    while (state->processNextChunk())
+    {}
+
+    // Any chunks that are still unfinished are already being run by other threads,
+    // so it's safe to block here, even if this is one of the pool's own threads.
+    state->finished.wait();
+
+    if (state->exception != nullptr)
+        std::rethrow_exception (state->exception);
+}
+
+} // namespace detail
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelAlgorithmsTests  : public UnitTest
+{
+public:
+    ParallelAlgorithmsTests()
+        : UnitTest ("ParallelAlgorithms", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        ThreadPool pool (4);
+        auto random = getRandom();
+
+        beginTest ("parallelFor");
+        {
+            for (auto grainSize : { 0, 1, 7, 1000, 100000 })
+            {
+                std::vector<std::atomic<int>> counts (10000);
+
+                parallelFor (pool, 0, (int) counts.size(), [&] (int i) { ++counts[(size_t) i]; }, grainSize);
+
+                expect (std::all_of (counts.begin(), counts.end(), [] (const std::atomic<int>& c) { return c.load() == 1; }));
+            }
+
+            int numCalls = 0;
+            parallelFor (pool, 5, 5, [&] (int) { ++numCalls; });
+            parallelFor (pool, 5, 2, [&] (int) { ++numCalls; });
+            expectEquals (numCalls, 0);
+        }
+
+        beginTest ("parallelTransform");
+        {
+            std::vector<double> source (12345), dest (source.size()), expected (source.size());
+
+            for (auto& s : source)
+                s = random.nextDouble();
+
+            auto square = [] (double x) { return x * x; };
+            std::transform (source.begin(), source.end(), expected.begin(), square);
+            auto end = parallelTransform (pool, source.begin(), source.end(), dest.begin(), square);
+
+            expect (end == dest.end());
+            expect (dest == expected);
+
+            parallelTransform (pool, source.begin(), source.end(), source.begin(), square, 100);
+            expect (source == expected);
+        }
+
+        beginTest ("parallelReduce");
+        {
+            Array<int> values;
+
+            for (int i = 0; i < 100000; ++i)
+                values.add (random.nextInt (1000));
+
+            auto expectedSum = std::accumulate (values.begin(), values.end(), (int64) 0);
+            expectEquals (parallelReduce (pool, values.begin(), values.end(), (int64) 0, std::plus<int64>()), expectedSum);
+
+            // concatenation isn't commutative, so this checks that the chunks are combined in order
+            StringArray words;
+
+            for (int i = 0; i < 500; ++i)
+                words.add (String (i));
+
+            auto joined = parallelReduce (pool, words.begin(), words.end(), String(),
+                                          [] (const String& a, const String& b) { return a + b; }, 3);
+            expectEquals (joined, words.joinIntoString ({}));
+
+            auto numChars = parallelTransformReduce (pool, words.begin(), words.end(), 0, std::plus<int>(),
+                                                     [] (const String& s) { return s.length(); });
+            expectEquals (numChars, joined.length());
+        }
+
+        beginTest ("parallelStableSort");
+        {
+            for (auto numItems : { 0, 1, 100, 10000, 100000 })
+            {
+                for (auto grainSize : { 0, 1000, 3333 })
+                {
+                    std::vector<std::pair<int, int>> items;
+
+                    for (int i = 0; i < numItems; ++i)
+                        items.push_back ({ random.nextInt (50), i });
+
+                    auto expected = items;
+                    auto compareKeys = [] (const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; };
+                    std::stable_sort (expected.begin(), expected.end(), compareKeys);
+                    parallelStableSort (pool, items.begin(), items.end(), compareKeys, grainSize);
+
+                    expect (items == expected);
+                }
+            }
+
+            Array<String> strings;
+
+            for (int i = 0; i < 20000; ++i)
+                strings.add (String (random.nextInt (100000)));
+
+            struct NaturalComparator
+            {
+                int compareElements (const String& a, const String& b) const    { return a.compareNatural (b); }
+            };
+
+            auto expected = strings;
+            NaturalComparator comparator;
+            expected.sort (comparator, true);
+            parallelStableSort (pool, strings, comparator);
+
+            expect (strings == expected);
+        }
+
+        beginTest ("Exceptions");
+        {
+            bool caught = false;
+
+            try
+            {
+                parallelFor (pool, 0, 1000, [] (int i) { if (i == 500) throw std::runtime_error ("failed"); });
+            }
+            catch (const std::runtime_error&)
+            {
+                caught = true;
+            }
+
+            expect (caught);
+        }
+
+        beginTest ("Nested calls");
+        {
+            ThreadPool singleThreadPool (1);
+            std::atomic<int> total { 0 };
+
+            auto outer = singleThreadPool.submit ([&]
+            {
+                parallelFor (singleThreadPool, 0, 10, [&] (int)
+                {
+                    parallelFor (singleThreadPool, 0, 10, [&] (int) { ++total; });
+                });
+            });
+
+            expect (outer.wait (10000));
+            expectEquals (total.load(), 100);
+        }
+    }
+};
+
+static ParallelAlgorithmsTests parallelAlgorithmsTests;
+
+#endif
+
+} // namespace juce
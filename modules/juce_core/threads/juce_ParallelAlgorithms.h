@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#ifndef DOXYGEN
+namespace detail
+{
+    /** Returns the number of chunks that runInParallel() will split a range into. */
+    JUCE_API int getNumParallelChunks (const ThreadPool& pool, int64 numItems, int64 grainSize) noexcept;
+
+    /** Returns the items belonging to one of the chunks that a range is split into. */
+    inline Range<int64> getParallelChunkRange (int64 numItems, int numChunks, int chunkIndex) noexcept
+    {
+        return { (numItems * chunkIndex) / numChunks, (numItems * (chunkIndex + 1)) / numChunks };
+    }
+
+    /** Splits a range of items into chunks, and calls processChunk for each one, using
+        both the calling thread and the pool's threads. Returns when all the chunks are done.
+    */
+    JUCE_API void runInParallel (ThreadPool& pool, int64 numItems, int64 grainSize,
+                                 const std::function<void (int chunkIndex, Range<int64> items)>& processChunk);
+} // namespace detail
+#endif
+
+//==============================================================================
+/*
+    The parallel algorithms below all split their work into chunks, which are run
+    by the calling thread together with the threads of a ThreadPool, and they all
+    block until the work has been done. The functions passed to them will be called
+    concurrently, so must be thread-safe.
+
+    The grainSize parameter is the number of items in each chunk. If it's zero, the
+    range is split into about four chunks for each of the pool's threads, so that
+    threads which finish early can take up the slack from slower ones. If your
+    per-item work is very cheap, a larger grain size will reduce the overhead, and
+    if there's only a single chunk, it'll be run directly on the calling thread.
+
+    If one of the functions throws an exception, the rest of the chunks are still
+    run, and the exception is then rethrown to the caller.
+
+    These can safely be called from tasks that are running on the same pool.
+*/
+
+/** Calls a function for each index in the range [begin, end), spreading the calls
+    across the calling thread and the threads of a ThreadPool.
+
+    @code
+    parallelFor (pool, 0, images.size(), [&] (int i) { applyFilter (images[i]); });
+    @endcode
+*/
+template <typename IndexType, typename FunctionType>
+void parallelFor (ThreadPool& pool, IndexType begin, IndexType end,
+                  FunctionType&& function, int64 grainSize = 0)
+{
+    detail::runInParallel (pool, (int64) (end - begin), grainSize, [&] (int, Range<int64> items)
+    {
+        for (auto i = items.getStart(); i < items.getEnd(); ++i)
+            function ((IndexType) (begin + (IndexType) i));
+    });
+}
+
+/** Applies a function to each item in a range, writing the results to a destination,
+    in the same way as std::transform(), but spreading the work across a ThreadPool.
+
+    The iterators must be random-access, and the destination may be the same as the
+    source. Returns an iterator to the end of the destination range.
+*/
+template <typename InputIterator, typename OutputIterator, typename UnaryOperation>
+OutputIterator parallelTransform (ThreadPool& pool, InputIterator first, InputIterator last,
+                                  OutputIterator destination, UnaryOperation&& operation,
+                                  int64 grainSize = 0)
+{
+    auto numItems = (int64) std::distance (first, last);
+
+    detail::runInParallel (pool, numItems, grainSize, [&] (int, Range<int64> items)
+    {
+        std::transform (first + items.getStart(), first + items.getEnd(), destination + items.getStart(),
+                        [&operation] (auto&& item) { return operation (item); });
+    });
+
+    return destination + numItems;
+}
+
+/** Transforms each item in a range and combines the results, spreading the work
+    across a ThreadPool.
+
+    Each chunk is reduced separately, starting from the identity value, and then the
+    results of the chunks are combined in order. So the reduction operation must be
+    associative, and identity must leave any value unchanged when combined with it,
+    but the operation doesn't need to be commutative. The iterators must be random-access.
+
+    @code
+    auto totalLength = parallelTransformReduce (pool, files.begin(), files.end(), (int64) 0,
+                                                [] (int64 a, int64 b) { return a + b; },
+                                                [] (const File& f) { return f.getSize(); });
+    @endcode
+*/
+template <typename Iterator, typename ValueType, typename BinaryOperation, typename UnaryOperation>
+ValueType parallelTransformReduce (ThreadPool& pool, Iterator first, Iterator last, ValueType identity,
+                                   BinaryOperation&& reduce, UnaryOperation&& transform,
+                                   int64 grainSize = 0)
+{
+    auto numItems = (int64) std::distance (first, last);
+    std::vector<ValueType> chunkResults ((size_t) detail::getNumParallelChunks (pool, numItems, grainSize), identity);
+
+    detail::runInParallel (pool, numItems, grainSize, [&] (int chunkIndex, Range<int64> items)
+    {
+        auto result = identity;
+
+        for (auto i = items.getStart(); i < items.getEnd(); ++i)
+            result = reduce (std::move (result), transform (first[i]));
+
+        chunkResults[(size_t) chunkIndex] = std::move (result);
+    });
+
+    for (auto& r : chunkResults)
+        identity = reduce (std::move (identity), std::move (r));
+
+    return identity;
+}
+
+/** Combines the items in a range, spreading the work across a ThreadPool.
+
+    This works like parallelTransformReduce(), without transforming the items first.
+*/
+template <typename Iterator, typename ValueType, typename BinaryOperation>
+ValueType parallelReduce (ThreadPool& pool, Iterator first, Iterator last, ValueType identity,
+                          BinaryOperation&& reduce, int64 grainSize = 0)
+{
+    return parallelTransformReduce (pool, first, last, std::move (identity),
+                                    std::forward<BinaryOperation> (reduce),
+                                    [] (const auto& item) -> decltype (auto) { return item; },
+                                    grainSize);
+}
+
+/** Sorts a range of items, keeping equivalent items in their original order, in
+    the same way as std::stable_sort(), but spreading the work across a ThreadPool.
+
+    The range is split into chunks which are sorted concurrently, and these are then
+    merged together in pairs, with the merges at each level also being run concurrently.
+    This needs a temporary copy of the items, so they must be copyable.
+
+    If the grain size is zero, the range is split into one chunk per thread, with a
+    minimum of 4096 items in each chunk.
+*/
+template <typename Iterator, typename LessThanFunction>
+void parallelStableSort (ThreadPool& pool, Iterator first, Iterator last,
+                         LessThanFunction&& lessThan, int64 grainSize = 0)
+{
+    auto numItems = (int64) std::distance (first, last);
+
+    if (grainSize <= 0)
+        grainSize = jmax ((int64) 4096, numItems / pool.getNumThreads());
+
+    auto numChunks = detail::getNumParallelChunks (pool, numItems, grainSize);
+
+    if (numChunks <= 1)
+    {
+        std::stable_sort (first, last, lessThan);
+        return;
+    }
+
+    auto chunkStart = [=] (int chunk) { return detail::getParallelChunkRange (numItems, numChunks, jmin (chunk, numChunks)).getStart(); };
+
+    detail::runInParallel (pool, numChunks, 1, [&] (int, Range<int64> chunks)
+    {
+        for (auto c = (int) chunks.getStart(); c < (int) chunks.getEnd(); ++c)
+            std::stable_sort (first + chunkStart (c), first + chunkStart (c + 1), lessThan);
+    });
+
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+    std::vector<ValueType> buffer (first, last);
+    auto resultIsInBuffer = false;
+
+    for (int width = 1; width < numChunks; width *= 2)
+    {
+        auto numMerges = (numChunks + 2 * width - 1) / (2 * width);
+
+        detail::runInParallel (pool, numMerges, 1, [&] (int, Range<int64> merges)
+        {
+            for (auto m = (int) merges.getStart(); m < (int) merges.getEnd(); ++m)
+            {
+                auto start = chunkStart (m * 2 * width);
+                auto middle = chunkStart (m * 2 * width + width);
+                auto end = chunkStart (m * 2 * width + 2 * width);
+
+                auto merge = [&] (auto source, auto dest)
+                {
+                    std::merge (std::make_move_iterator (source + start),  std::make_move_iterator (source + middle),
+                                std::make_move_iterator (source + middle), std::make_move_iterator (source + end),
+                                dest + start, lessThan);
+                };
+
+                if (resultIsInBuffer)
+                    merge (buffer.begin(), first);
+                else
+                    merge (first, buffer.begin());
+            }
+        });
+
+        resultIsInBuffer = ! resultIsInBuffer;
+    }
+
+    if (resultIsInBuffer)
+        parallelTransform (pool, buffer.begin(), buffer.end(), first,
+                           [] (ValueType& item) { return std::move (item); }, grainSize);
+}
+
+/** Sorts the elements of an Array, keeping equivalent elements in their original
+    order, and spreading the work across a ThreadPool.
+
+    The comparator works in the same way as for Array::sort(), but its
+    compareElements() method will be called concurrently, so must be thread-safe.
+
+    @see Array::sort
+*/
+template <typename ElementType, typename TypeOfCriticalSectionToUse, int minimumAllocatedSize, typename ElementComparator>
+void parallelStableSort (ThreadPool& pool,
+                         Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize>& array,
+                         ElementComparator& comparator, int64 grainSize = 0)
+{
+    const typename TypeOfCriticalSectionToUse::ScopedLockType lock (array.getLock());
+
+    parallelStableSort (pool, array.begin(), array.end(),
+                        [&comparator] (const ElementType& a, const ElementType& b) { return comparator.compareElements (a, b) < 0; },
+                        grainSize);
+}
+
+} // namespace juce
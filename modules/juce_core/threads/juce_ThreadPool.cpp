@@ -20,9 +20,71 @@
   ==============================================================================
 */
 
+#include <deque>
+
 namespace juce
 {
 
+struct ThreadPool::TaskQueue
+{
+    ~TaskQueue()
+    {
+        // the pool should have run all its tasks before being deleted
+        jassert (numTasks.load() == 0);
+    }
+
+    void push (std::unique_ptr<Task> task, TaskPriority priority)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+        queues[(int) priority].push_back (std::move (task));
+        ++numTasks;
+    }
+
+    std::unique_ptr<Task> popNewest (TaskPriority priority)
+    {
+        return pop (priority, false);
+    }
+
+    std::unique_ptr<Task> popOldest (TaskPriority priority)
+    {
+        return pop (priority, true);
+    }
+
+private:
+    std::unique_ptr<Task> pop (TaskPriority priority, bool fromFront)
+    {
+        if (numTasks.load() == 0)
+            return {};
+
+        const SpinLock::ScopedLockType sl (lock);
+        auto& queue = queues[(int) priority];
+
+        if (queue.empty())
+            return {};
+
+        std::unique_ptr<Task> task;
+
+        if (fromFront)
+        {
+            task = std::move (queue.front());
+            queue.pop_front();
+        }
+        else
+        {
+            task = std::move (queue.back());
+            queue.pop_back();
+        }
+
+        --numTasks;
+        return task;
+    }
+
+    SpinLock lock;
+    std::deque<std::unique_ptr<Task>> queues[3];
+    std::atomic<int> numTasks { 0 };
+};
+
+//==============================================================================
 struct ThreadPool::ThreadPoolThread  : public Thread
 {
     ThreadPoolThread (ThreadPool& p, size_t stackSize)
@@ -33,12 +95,26 @@ struct ThreadPool::ThreadPoolThread  : public Thread
     void run() override
     {
         while (! threadShouldExit())
-            if (! pool.runNextJob (*this))
+        {
+            if (pool.runNextWork (*this))
+                continue;
+
+            // Anyone adding a task after this flag is set will wake us up, so
+            // only tasks that were added before it need to be checked for here.
+            isIdle = true;
+
+            if (pool.numQueuedTasks.load() == 0)
                 wait (500);
+
+            isIdle = false;
+        }
     }
 
     std::atomic<ThreadPoolJob*> currentJob { nullptr };
     ThreadPool& pool;
+    TaskQueue tasks;
+    std::atomic<bool> isIdle { false };
+    bool preferJobs = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
@@ -91,6 +167,7 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 
 //==============================================================================
 ThreadPool::ThreadPool (int numThreads, size_t threadStackSize)
+    : sharedTasks (std::make_unique<TaskQueue>())
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
@@ -98,6 +175,7 @@ ThreadPool::ThreadPool (int numThreads, size_t threadStackSize)
 }
 
 ThreadPool::ThreadPool()
+    : sharedTasks (std::make_unique<TaskQueue>())
 {
     createThreads (SystemStats::getNumCpus());
 }
@@ -105,6 +183,7 @@ ThreadPool::ThreadPool()
 ThreadPool::~ThreadPool()
 {
     removeAllJobs (true, 5000);
+    waitForAllTasks();
     stopThreads();
 }
 
@@ -141,6 +220,7 @@ void ThreadPool::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished)
         {
             const ScopedLock sl (lock);
             jobs.add (job);
+            numJobs = jobs.size();
         }
 
         for (auto* t : threads)
@@ -252,6 +332,7 @@ bool ThreadPool::removeJob (ThreadPoolJob* job, bool interruptIfRunning, int tim
             else
             {
                 jobs.removeFirstMatchingValue (job);
+                numJobs = jobs.size();
                 addToDeleteList (deletionList, job);
             }
         }
@@ -291,6 +372,8 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
                     }
                 }
             }
+
+            numJobs = jobs.size();
         }
     }
 
@@ -343,6 +426,9 @@ bool ThreadPool::setThreadPriorities (int newPriority)
 
 ThreadPoolJob* ThreadPool::pickNextJobToRun()
 {
+    if (numJobs.load() == 0)
+        return nullptr;
+
     OwnedArray<ThreadPoolJob> deletionList;
 
     {
@@ -357,6 +443,7 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
                     if (job->shouldStop)
                     {
                         jobs.remove (i);
+                        numJobs = jobs.size();
                         addToDeleteList (deletionList, job);
                         --i;
                         continue;
@@ -395,13 +482,16 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
         {
             const ScopedLock sl (lock);
 
-            if (jobs.contains (job))
+            auto index = jobs.indexOf (job);
+
+            if (index >= 0)
             {
                 job->isActive = false;
 
                 if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
                 {
-                    jobs.removeFirstMatchingValue (job);
+                    jobs.remove (index);
+                    numJobs = jobs.size();
                     addToDeleteList (deletionList, job);
 
                     jobFinishedSignal.signal();
@@ -409,7 +499,7 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
                 else
                 {
                     // move the job to the end of the queue if it wants another go
-                    jobs.move (jobs.indexOf (job), -1);
+                    jobs.move (index, -1);
                 }
             }
         }
@@ -429,4 +519,361 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
         deletionList.add (job);
 }
 
+//==============================================================================
+int ThreadPool::getNumTasks() const noexcept
+{
+    return numTasks.load();
+}
+
+bool ThreadPool::waitForAllTasks (int timeOutMs) const
+{
+    // A task can't wait for itself to finish!
+    jassert (getCurrentPoolThread (*this) == nullptr);
+
+    auto start = Time::getMillisecondCounter();
+
+    while (numTasks.load() > 0)
+    {
+        if (timeOutMs >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMs)
+            return false;
+
+        taskFinishedSignal.wait (2);
+    }
+
+    return true;
+}
+
+ThreadPool::ThreadPoolThread* ThreadPool::getCurrentPoolThread (const ThreadPool& pool)
+{
+    if (auto* t = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread()))
+        if (&t->pool == &pool)
+            return t;
+
+    return nullptr;
+}
+
+void ThreadPool::addTask (std::unique_ptr<Task> task, TaskPriority priority)
+{
+    auto* currentThread = getCurrentPoolThread (*this);
+
+    ++numTasks;
+    ++numQueuedTasks;
+    (currentThread != nullptr ? currentThread->tasks : *sharedTasks).push (std::move (task), priority);
+
+    for (auto* t : threads)
+    {
+        if (t != currentThread && t->isIdle.exchange (false))
+        {
+            t->notify();
+            break;
+        }
+    }
+}
+
+std::unique_ptr<ThreadPool::Task> ThreadPool::popNextTask (ThreadPoolThread* thread, TaskPriority priority)
+{
+    std::unique_ptr<Task> task;
+
+    if (thread != nullptr)
+        task = thread->tasks.popNewest (priority);
+
+    if (task == nullptr)
+        task = sharedTasks->popOldest (priority);
+
+    if (task == nullptr)
+    {
+        auto numThreads = threads.size();
+        auto start = thread != nullptr ? threads.indexOf (thread) : 0;
+
+        for (int i = 1; i <= numThreads && task == nullptr; ++i)
+        {
+            auto* other = threads.getUnchecked ((start + i) % numThreads);
+
+            if (other != thread)
+                task = other->tasks.popOldest (priority);
+        }
+    }
+
+    if (task != nullptr)
+        --numQueuedTasks;
+
+    return task;
+}
+
+bool ThreadPool::runNextTask (ThreadPoolThread& thread, TaskPriority priority)
+{
+    if (numQueuedTasks.load() <= 0)
+        return false;
+
+    if (auto task = popNextTask (&thread, priority))
+    {
+        task->run();
+        task.reset();
+
+        if (--numTasks == 0)
+            taskFinishedSignal.signal();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool ThreadPool::runNextTask (ThreadPoolThread& thread)
+{
+    return runNextTask (thread, TaskPriority::high)
+        || runNextTask (thread, TaskPriority::normal)
+        || runNextTask (thread, TaskPriority::low);
+}
+
+bool ThreadPool::runNextWork (ThreadPoolThread& thread)
+{
+    if (runNextTask (thread, TaskPriority::high))
+        return true;
+
+    // jobs run at the same priority as normal tasks, so take turns between them
+    thread.preferJobs = ! thread.preferJobs;
+
+    if (thread.preferJobs ? (runNextJob (thread) || runNextTask (thread, TaskPriority::normal))
+                          : (runNextTask (thread, TaskPriority::normal) || runNextJob (thread)))
+        return true;
+
+    return runNextTask (thread, TaskPriority::low);
+}
+
+//==============================================================================
+bool ThreadPool::FutureStateBase::wait (int timeOutMs) const
+{
+    auto* thread = getCurrentPoolThread (pool);
+    auto start = Time::getMillisecondCounter();
+
+    while (! isReady())
+    {
+        auto timeLeft = -1;
+
+        if (timeOutMs >= 0)
+        {
+            auto elapsed = (int) (Time::getMillisecondCounter() - start);
+
+            if (elapsed >= timeOutMs)
+                return false;
+
+            timeLeft = timeOutMs - elapsed;
+        }
+
+        if (thread != nullptr)
+        {
+            // Blocking one of the pool's threads could deadlock if the task we're waiting
+            // for is stuck behind us in its queue, so keep busy with other tasks instead.
+            if (! pool.runNextTask (*thread))
+                finishedEvent.wait (1);
+        }
+        else
+        {
+            finishedEvent.wait (timeLeft);
+        }
+    }
+
+    return true;
+}
+
+void ThreadPool::FutureStateBase::rethrowIfFailed() const
+{
+    if (exception != nullptr)
+        std::rethrow_exception (exception);
+}
+
+void ThreadPool::FutureStateBase::setFinished()
+{
+    decltype (continuations) continuationsToRun;
+
+    {
+        const SpinLock::ScopedLockType sl (continuationLock);
+        ready = true;
+        continuationsToRun.swap (continuations);
+    }
+
+    finishedEvent.signal();
+
+    for (auto& c : continuationsToRun)
+        pool.addTask (std::move (c.first), c.second);
+}
+
+void ThreadPool::FutureStateBase::addContinuation (std::unique_ptr<Task> task, TaskPriority priority)
+{
+    {
+        const SpinLock::ScopedLockType sl (continuationLock);
+
+        if (! ready)
+        {
+            continuations.emplace_back (std::move (task), priority);
+            return;
+        }
+    }
+
+    pool.addTask (std::move (task), priority);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests()
+        : UnitTest ("ThreadPool", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Submitted tasks return their results");
+        {
+            ThreadPool pool (4);
+            std::vector<ThreadPoolFuture<int>> futures;
+
+            for (int i = 0; i < 2000; ++i)
+                futures.push_back (pool.submit ([i] { return i * 2; }));
+
+            bool allCorrect = true;
+
+            for (int i = 0; i < (int) futures.size(); ++i)
+                allCorrect = allCorrect && futures[(size_t) i].get() == i * 2;
+
+            expect (allCorrect);
+            expect (pool.waitForAllTasks (5000));
+            expectEquals (pool.getNumTasks(), 0);
+        }
+
+        beginTest ("Tasks can wait for tasks that they submit");
+        {
+            // With only one thread, this would deadlock if waiting tasks didn't run other tasks
+            ThreadPool pool (1);
+
+            auto total = pool.submit ([&pool]
+            {
+                std::vector<ThreadPoolFuture<int>> parts;
+
+                for (int i = 0; i < 10; ++i)
+                    parts.push_back (pool.submit ([i] { return i; }));
+
+                int sum = 0;
+
+                for (auto& p : parts)
+                    sum += p.get();
+
+                return sum;
+            });
+
+            expectEquals (total.get(), 45);
+        }
+
+        beginTest ("Continuations");
+        {
+            ThreadPool pool (2);
+
+            auto chained = pool.submit ([] { return 10; })
+                               .then ([] (int x) { return String (x + 1); })
+                               .then ([] (const String& s) { return s + "!"; });
+
+            expectEquals (chained.get(), String ("11!"));
+
+            std::atomic<bool> continuationRan { false };
+            pool.submit ([] {}).then ([&] { continuationRan = true; }).wait();
+            expect (continuationRan.load());
+
+            auto finished = pool.submit ([] { return 3; });
+            expect (finished.wait (5000));
+            expectEquals (finished.then ([] (int x) { return x * 3; }).get(), 9);
+        }
+
+       #if ! JUCE_EXCEPTIONS_DISABLED
+        beginTest ("Exceptions are passed on to futures");
+        {
+            ThreadPool pool (1);
+
+            auto failed = pool.submit ([]() -> int { throw std::runtime_error ("task failed"); })
+                              .then ([] (int x) { return x + 1; });
+
+            bool caught = false;
+
+            try
+            {
+                failed.get();
+            }
+            catch (const std::runtime_error&)
+            {
+                caught = true;
+            }
+
+            expect (caught);
+        }
+       #endif
+
+        beginTest ("Higher priority tasks run first");
+        {
+            ThreadPool pool (1);
+            WaitableEvent blockerStarted, releaseBlocker;
+
+            auto blocker = pool.submit ([&] { blockerStarted.signal(); releaseBlocker.wait(); });
+            blockerStarted.wait();
+
+            Array<int> order;
+            std::vector<ThreadPoolFuture<void>> futures;
+            futures.push_back (pool.submit ([&] { order.add (0); }, ThreadPool::TaskPriority::low));
+            futures.push_back (pool.submit ([&] { order.add (1); }, ThreadPool::TaskPriority::normal));
+            futures.push_back (pool.submit ([&] { order.add (2); }, ThreadPool::TaskPriority::high));
+
+            releaseBlocker.signal();
+
+            for (auto& f : futures)
+                f.wait();
+
+            expect (order == Array<int> (2, 1, 0));
+        }
+
+        beginTest ("Jobs and tasks can share a pool");
+        {
+            ThreadPool pool (2);
+            std::atomic<int> numJobsRun { 0 };
+            std::vector<ThreadPoolFuture<int>> futures;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                pool.addJob ([&] { ++numJobsRun; });
+                futures.push_back (pool.submit ([i] { return i; }));
+            }
+
+            int sum = 0;
+
+            for (auto& f : futures)
+                sum += f.get();
+
+            for (int i = 0; i < 1000 && pool.getNumJobs() > 0; ++i)
+                Thread::sleep (5);
+
+            expectEquals (sum, 4950);
+            expectEquals (numJobsRun.load(), 100);
+        }
+
+        beginTest ("Deleting a pool runs its waiting tasks");
+        {
+            std::atomic<int> numTasksRun { 0 };
+
+            {
+                ThreadPool pool (1);
+
+                for (int i = 0; i < 50; ++i)
+                    pool.submit ([&] { ++numTasksRun; });
+            }
+
+            expectEquals (numTasksRun.load(), 50);
+        }
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+#endif
+
 } // namespace juce
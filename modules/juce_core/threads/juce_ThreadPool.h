@@ -24,6 +24,7 @@ namespace juce
 {
 
 class ThreadPool;
+template <typename ResultType> class ThreadPoolFuture;
 
 //==============================================================================
 /**
@@ -315,6 +316,48 @@ public:
     */
     bool setThreadPriorities (int newPriority);
 
+    //==============================================================================
+    /** The priorities that can be given to tasks that are added with submit(). */
+    enum class TaskPriority
+    {
+        low,
+        normal,
+        high
+    };
+
+    /** Runs a function on one of the pool's threads, and returns a ThreadPoolFuture
+        that can be used to wait for the function to finish and to get its result.
+
+        Tasks are much lighter than jobs: rather than sharing the pool's list of jobs,
+        each thread keeps its own queues of tasks. A task that's submitted from one of
+        the pool's threads goes into that thread's queue, which the thread takes from
+        newest-first, while any threads that run out of work steal the oldest tasks from
+        the others. Tasks submitted from other threads go into a shared queue.
+
+        Higher-priority tasks are always started before lower-priority ones. Jobs added
+        with addJob() are run at the same priority as TaskPriority::normal, with threads
+        alternating between the two so that neither can hold up the other.
+
+        Tasks can't be removed or interrupted once they've been submitted, and any that
+        are still waiting when the pool is deleted will be run before it is destroyed.
+        If the function throws an exception, ThreadPoolFuture::get() will rethrow it
+        (unless exceptions are disabled, in which case it mustn't throw).
+
+        @see ThreadPoolFuture
+    */
+    template <typename FunctionType>
+    auto submit (FunctionType&& function, TaskPriority priority = TaskPriority::normal)
+        -> ThreadPoolFuture<typename std::decay<decltype (function())>::type>;
+
+    /** Returns the number of tasks which have been submitted and haven't finished yet. */
+    int getNumTasks() const noexcept;
+
+    /** Waits until all the tasks that have been submitted have finished running.
+
+        This must not be called from one of the pool's threads. Returns false if the
+        timeout expires before all the tasks have finished.
+    */
+    bool waitForAllTasks (int timeOutMilliseconds = -1) const;
 
 private:
     //==============================================================================
@@ -326,6 +369,55 @@ private:
 
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
+    std::atomic<int> numJobs { 0 };
+
+    //==============================================================================
+    struct Task
+    {
+        virtual ~Task() = default;
+        virtual void run() = 0;
+    };
+
+    struct FutureStateBase
+    {
+        explicit FutureStateBase (ThreadPool& p) noexcept  : pool (p) {}
+        virtual ~FutureStateBase() = default;
+
+        bool isReady() const noexcept       { return ready.load(); }
+        bool wait (int timeOutMilliseconds) const;
+        void rethrowIfFailed() const;
+        void setFinished();
+        void addContinuation (std::unique_ptr<Task>, TaskPriority);
+
+        ThreadPool& pool;
+        std::exception_ptr exception;
+
+    private:
+        std::atomic<bool> ready { false };
+        WaitableEvent finishedEvent { true };
+        SpinLock continuationLock;
+        std::vector<std::pair<std::unique_ptr<Task>, TaskPriority>> continuations;
+    };
+
+    template <typename ResultType> struct FutureState;
+    template <typename ResultType, typename FunctionType> struct FutureTask;
+    template <typename ResultType> friend class ThreadPoolFuture;
+
+    template <typename FunctionType>
+    auto createTask (FunctionType&&)
+        -> std::pair<std::unique_ptr<Task>, ThreadPoolFuture<typename std::decay<decltype (std::declval<FunctionType&>()())>::type>>;
+
+    struct TaskQueue;
+    std::unique_ptr<TaskQueue> sharedTasks;
+    std::atomic<int> numTasks { 0 }, numQueuedTasks { 0 };
+    WaitableEvent taskFinishedSignal;
+
+    void addTask (std::unique_ptr<Task>, TaskPriority);
+    std::unique_ptr<Task> popNextTask (ThreadPoolThread*, TaskPriority);
+    bool runNextTask (ThreadPoolThread&, TaskPriority);
+    bool runNextTask (ThreadPoolThread&);
+    bool runNextWork (ThreadPoolThread&);
+    static ThreadPoolThread* getCurrentPoolThread (const ThreadPool&);
 
     bool runNextJob (ThreadPoolThread&);
     ThreadPoolJob* pickNextJobToRun();
@@ -340,4 +432,172 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPool)
 };
 
+//==============================================================================
+/**
+    Refers to the result of a task that has been submitted to a ThreadPool.
+
+    A ThreadPoolFuture is returned by ThreadPool::submit(), and can be copied
+    freely: all the copies share the same result. Use wait() or get() to block
+    until the task has finished, or then() to have another task run with the
+    result once it's available, without blocking at all.
+
+    If wait() or get() is called from one of the pool's own threads, rather than
+    blocking, the thread will keep itself busy by running other tasks until the
+    result is ready, so tasks can safely wait for tasks that they've submitted.
+
+    @see ThreadPool::submit
+
+    @tags{Core}
+*/
+template <typename ResultType>
+class ThreadPoolFuture
+{
+public:
+    /** Creates an invalid future that doesn't refer to any task. */
+    ThreadPoolFuture() = default;
+
+    /** Returns true if this refers to a task. */
+    bool isValid() const noexcept                       { return state != nullptr; }
+
+    /** Returns true if the task has finished running. */
+    bool isReady() const noexcept                       { return state != nullptr && state->isReady(); }
+
+    /** Waits for the task to finish, returning false if the timeout expires first. */
+    bool wait (int timeOutMilliseconds = -1) const
+    {
+        jassert (isValid());
+        return state->wait (timeOutMilliseconds);
+    }
+
+    /** Waits for the task to finish and returns its result.
+
+        If the task threw an exception, this will rethrow it. For tasks which return
+        void, this just waits for the task to finish.
+    */
+    decltype (auto) get() const
+    {
+        wait();
+        state->rethrowIfFailed();
+        return state->getResult();
+    }
+
+    /** Submits a task that will be run with this task's result once it has finished.
+
+        The continuation is called with a const reference to the result, or with no
+        arguments if this task returns void. If this task has already finished, the
+        continuation is submitted straight away. If this task threw an exception,
+        the continuation isn't called, and the future it returns will rethrow the
+        same exception.
+
+        Returns a future for the result of the continuation.
+    */
+    template <typename FunctionType>
+    auto then (FunctionType&& continuation,
+               ThreadPool::TaskPriority priority = ThreadPool::TaskPriority::normal)
+    {
+        jassert (isValid());
+
+        auto source = state;
+        auto task = source->pool.createTask ([source, fn = std::forward<FunctionType> (continuation)]() mutable
+                                             {
+                                                 source->rethrowIfFailed();
+                                                 return source->invoke (fn);
+                                             });
+
+        source->addContinuation (std::move (task.first), priority);
+        return task.second;
+    }
+
+private:
+    friend class ThreadPool;
+
+    explicit ThreadPoolFuture (std::shared_ptr<ThreadPool::FutureState<ResultType>> s) noexcept
+        : state (std::move (s)) {}
+
+    std::shared_ptr<ThreadPool::FutureState<ResultType>> state;
+};
+
+#ifndef DOXYGEN
+//==============================================================================
+template <typename ResultType>
+struct ThreadPool::FutureState  : public ThreadPool::FutureStateBase
+{
+    using FutureStateBase::FutureStateBase;
+
+    template <typename FunctionType>
+    void run (FunctionType& function)                   { result.reset (new ResultType (function())); }
+
+    template <typename FunctionType>
+    auto invoke (FunctionType& function) const          { return function (getResult()); }
+
+    const ResultType& getResult() const noexcept        { return *result; }
+
+    std::unique_ptr<ResultType> result;
+};
+
+template <>
+struct ThreadPool::FutureState<void>  : public ThreadPool::FutureStateBase
+{
+    using FutureStateBase::FutureStateBase;
+
+    template <typename FunctionType>
+    void run (FunctionType& function)                   { function(); }
+
+    template <typename FunctionType>
+    auto invoke (FunctionType& function) const          { return function(); }
+
+    void getResult() const noexcept {}
+};
+
+template <typename ResultType, typename FunctionType>
+struct ThreadPool::FutureTask  : public ThreadPool::Task
+{
+    FutureTask (std::shared_ptr<FutureState<ResultType>> s, FunctionType&& f)
+        : state (std::move (s)), function (std::move (f)) {}
+
+    void run() override
+    {
+       #if JUCE_EXCEPTIONS_DISABLED
+        state->run (function);
+       #else
+        try
+        {
+            state->run (function);
+        }
+        catch (...)
+        {
+            state->exception = std::current_exception();
+        }
+       #endif
+
+        state->setFinished();
+    }
+
+    std::shared_ptr<FutureState<ResultType>> state;
+    FunctionType function;
+};
+
+template <typename FunctionType>
+auto ThreadPool::createTask (FunctionType&& function)
+    -> std::pair<std::unique_ptr<Task>, ThreadPoolFuture<typename std::decay<decltype (std::declval<FunctionType&>()())>::type>>
+{
+    using ResultType = typename std::decay<decltype (std::declval<FunctionType&>()())>::type;
+    using StoredFunctionType = typename std::decay<FunctionType>::type;
+
+    auto state = std::make_shared<FutureState<ResultType>> (*this);
+    std::unique_ptr<Task> task (new FutureTask<ResultType, StoredFunctionType> (state, StoredFunctionType (std::forward<FunctionType> (function))));
+
+    return { std::move (task), ThreadPoolFuture<ResultType> (std::move (state)) };
+}
+
+template <typename FunctionType>
+auto ThreadPool::submit (FunctionType&& function, TaskPriority priority)
+    -> ThreadPoolFuture<typename std::decay<decltype (function())>::type>
+{
+    auto task = createTask (std::forward<FunctionType> (function));
+    addTask (std::move (task.first), priority);
+    return task.second;
+}
+#endif
+
 } // namespace juce
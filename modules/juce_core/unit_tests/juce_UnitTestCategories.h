@@ -39,6 +39,7 @@ namespace UnitTestCategories
     static const String gui                        { "GUI" };
     static const String json                       { "JSON" };
     static const String maths                      { "Maths" };
+    static const String memory                     { "Memory" };
     static const String midi                       { "MIDI" };
     static const String networking                 { "Networking" };
     static const String osc                        { "OSC" };
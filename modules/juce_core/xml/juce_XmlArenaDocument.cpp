@@ -0,0 +1,786 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// Parses a null-terminated buffer in place. Entities are expanded and line-endings
+// normalised by moving the text towards the start of the buffer, which is always
+// possible because the decoded text is never longer than the original, and each
+// name, value and text block gets a null written after it so that the tree can
+// point directly at it.
+struct XmlArenaDocument::Parser
+{
+    Parser (char* textToParse, MonotonicArena& arenaToUse, bool ignoreEmptyText) noexcept
+        : input (textToParse), arena (arenaToUse), ignoreEmptyTextElements (ignoreEmptyText)
+    {
+    }
+
+    Element* parseDocument()
+    {
+        if ((uint8) input[0] == 0xef && (uint8) input[1] == 0xbb && (uint8) input[2] == 0xbf)
+            input += 3;
+
+        for (;;)
+        {
+            skipWhitespace();
+
+            if (*input == 0)
+                return fail ("not enough input");
+
+            if (*input != '<')
+                return fail ("text found outside the document element");
+
+            if (startsWith ("<!--"))
+            {
+                input += 4;
+
+                if (! skipPast ("-->"))
+                    return fail ("unterminated comment");
+
+                continue;
+            }
+
+            if (startsWith ("<?"))
+            {
+                input += 2;
+
+                if (! skipPast ("?>"))
+                    return fail ("malformed header");
+
+                continue;
+            }
+
+            if (startsWith ("<!DOCTYPE"))
+            {
+                input += 9;
+
+                if (! skipDTD())
+                    return fail ("malformed DTD");
+
+                continue;
+            }
+
+            ++input;
+            return parseElement();
+        }
+    }
+
+    Element* parseElement()
+    {
+        // (like XmlDocument, this allows a gap after the '<')
+        skipWhitespace();
+        auto* tagName = input;
+        input = findEndOfName (input);
+
+        if (input == tagName)
+            return fail ("tag name missing");
+
+        auto* element = create<Element>();
+        element->content = tagName;
+        auto** nextAttribute = &element->firstAttribute;
+
+        // The character after each name is remembered before the name's terminating
+        // null gets written over it
+        auto c = *input;
+        *input = 0;
+
+        for (;;)
+        {
+            if (CharacterFunctions::isWhitespace (c))
+            {
+                c = *++input;
+                continue;
+            }
+
+            if (c == '>')
+            {
+                ++input;
+                return parseContent (*element) ? element : nullptr;
+            }
+
+            if (c == '/' && input[1] == '>')
+            {
+                input += 2;
+                return element;
+            }
+
+            if (c == 0)
+                return fail ("unexpected end of input");
+
+            if (! XmlIdentifierChars::isIdentifierByte (c))
+                return fail ("illegal character found in " + String::fromUTF8 (tagName) + ": '" + String::charToString ((juce_wchar) (uint8) c) + "'");
+
+            auto* attribute = create<Attribute>();
+            attribute->name = input;
+            input = findEndOfName (input);
+            c = *input;
+            *input = 0;
+
+            while (CharacterFunctions::isWhitespace (c))
+                c = *++input;
+
+            if (c != '=')
+                return fail ("expected '=' after attribute '" + String::fromUTF8 (attribute->name) + "'");
+
+            ++input;
+            skipWhitespace();
+            auto quote = *input;
+
+            if (quote != '"' && quote != '\'')
+                return fail ("expected a quoted value for attribute '" + String::fromUTF8 (attribute->name) + "'");
+
+            attribute->value = ++input;
+
+            if (! readAttributeValue (quote))
+                return fail ("unmatched quotes");
+
+            c = *input;
+            *nextAttribute = attribute;
+            nextAttribute = &attribute->nextAttribute;
+        }
+    }
+
+    bool parseContent (Element& parent)
+    {
+        auto** nextChild = &parent.firstChild;
+
+        auto addChild = [&nextChild] (Element* child)
+        {
+            *nextChild = child;
+            nextChild = &child->nextSibling;
+        };
+
+        for (;;)
+        {
+            if (*input != '<')
+            {
+                auto* textStart = input;
+                bool shouldBeKept = false;
+
+                if (! readText (shouldBeKept))
+                    return false;
+
+                if (shouldBeKept)
+                    addChild (createTextElement (textStart));
+            }
+            else
+            {
+                ++input;
+            }
+
+            // The input is now just after a '<'
+            auto c = *input;
+
+            if (c == '/')
+            {
+                auto* closingTagName = ++input;
+                input = findEndOfName (input);
+                auto length = (size_t) (input - closingTagName);
+
+                if (strncmp (closingTagName, parent.content, length) != 0 || parent.content[length] != 0)
+                    return failed ("mismatched tags: expected </" + String::fromUTF8 (parent.content) + ">");
+
+                skipWhitespace();
+
+                if (*input != '>')
+                    return failed ("expected '>' after closing tag");
+
+                ++input;
+                return true;
+            }
+
+            if (startsWith ("!--"))
+            {
+                input += 3;
+
+                if (! skipPast ("-->"))
+                    return failed ("unterminated comment");
+
+                continue;
+            }
+
+            if (startsWith ("![CDATA["))
+            {
+                input += 8;
+                auto* end = strstr (input, "]]>");
+
+                if (end == nullptr)
+                    return failed ("unterminated CDATA section");
+
+                *end = 0;
+                addChild (createTextElement (input));
+                input = end + 3;
+                continue;
+            }
+
+            if (c == '?')
+            {
+                ++input;
+
+                if (! skipPast ("?>"))
+                    return failed ("unterminated processing instruction");
+
+                continue;
+            }
+
+            if (auto* child = parseElement())
+                addChild (child);
+            else
+                return false;
+        }
+    }
+
+    // Reads a block of text up to the next tag, leaving the input just after its '<'
+    bool readText (bool& shouldBeKept)
+    {
+        auto* dest = input;
+        bool containsNonWhitespace = false, containsEntities = false;
+
+        for (;;)
+        {
+            auto c = *input;
+
+            if (c == '<')
+            {
+                if (input[1] == '!' && input[2] == '-' && input[3] == '-')
+                {
+                    input += 4;
+
+                    if (! skipPast ("-->"))
+                        return failed ("unterminated comment");
+
+                    continue;
+                }
+
+                break;
+            }
+
+            if (c == 0)
+                return failed ("unmatched tags");
+
+            if (c == '&')
+            {
+                auto decoded = readEntity (dest);
+                containsEntities = true;
+                containsNonWhitespace = containsNonWhitespace || ! CharacterFunctions::isWhitespace (decoded);
+                continue;
+            }
+
+            ++input;
+
+            if (c == '\r')
+            {
+                // line-endings are normalised to a single '\n', as they are by XmlDocument
+                if (*input == '\n')
+                    continue;
+
+                c = '\n';
+            }
+
+            containsNonWhitespace = containsNonWhitespace || ! CharacterFunctions::isWhitespace (c);
+            *dest++ = c;
+        }
+
+        // the text's terminating null may go where the '<' was, so move past it first
+        ++input;
+        *dest = 0;
+
+        // Like XmlDocument, this always drops whitespace that runs up to a tag, and only
+        // keeps whitespace that includes an entity if empty text isn't being ignored
+        shouldBeKept = containsNonWhitespace || (containsEntities && ! ignoreEmptyTextElements);
+        return true;
+    }
+
+    bool readAttributeValue (char quote)
+    {
+        auto* dest = input;
+
+        for (;;)
+        {
+            auto c = *input;
+
+            if (c == quote)
+            {
+                *dest = 0;
+                ++input;
+                return true;
+            }
+
+            if (c == 0)
+                return false;
+
+            if (c == '&')
+            {
+                readEntity (dest);
+                continue;
+            }
+
+            *dest++ = c;
+            ++input;
+        }
+    }
+
+    juce_wchar readEntity (char*& dest)
+    {
+        auto* nameStart = input + 1;
+        auto* semicolon = nameStart;
+
+        while (*semicolon != ';' && *semicolon != 0 && semicolon - nameStart <= XmlEntities::maxNameLength)
+            ++semicolon;
+
+        if (*semicolon == ';')
+        {
+            if (auto c = XmlEntities::decode (nameStart, semicolon))
+            {
+                CharPointer_UTF8 writer (dest);
+                writer.write (c);
+                dest = writer.getAddress();
+                input = semicolon + 1;
+                return c;
+            }
+        }
+
+        // not a standard entity, so leave it in the text
+        *dest++ = '&';
+        ++input;
+        return '&';
+    }
+
+    Element* createTextElement (const char* text)
+    {
+        auto* element = create<Element>();
+        element->content = text;
+        element->isText = true;
+        return element;
+    }
+
+    //==============================================================================
+    static char* findEndOfName (char* p) noexcept
+    {
+        while (XmlIdentifierChars::isIdentifierByte (*p))
+            ++p;
+
+        return p;
+    }
+
+    bool startsWith (const char* text) const noexcept
+    {
+        return strncmp (input, text, strlen (text)) == 0;
+    }
+
+    void skipWhitespace() noexcept
+    {
+        while (CharacterFunctions::isWhitespace (*input))
+            ++input;
+    }
+
+    bool skipPast (const char* terminator) noexcept
+    {
+        if (auto* found = strstr (input, terminator))
+        {
+            input = found + strlen (terminator);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool skipDTD() noexcept
+    {
+        for (int depth = 1; depth > 0; ++input)
+        {
+            auto c = *input;
+
+            if (c == 0)
+                return false;
+
+            if (c == '<')
+                ++depth;
+            else if (c == '>')
+                --depth;
+        }
+
+        return true;
+    }
+
+    // Elements and attributes have private constructors, so can't be made by MonotonicArena::create().
+    // They're trivially destructible, so the arena doesn't need to keep track of them.
+    template <typename ObjectType>
+    ObjectType* create()
+    {
+        static_assert (std::is_trivially_destructible<ObjectType>::value, "The arena won't call any destructors");
+        return new (arena.allocate (sizeof (ObjectType), alignof (ObjectType))) ObjectType();
+    }
+
+    Element* fail (const String& message)
+    {
+        failed (message);
+        return nullptr;
+    }
+
+    bool failed (const String& message)
+    {
+        if (error.isEmpty())
+            error = message;
+
+        return false;
+    }
+
+    char* input;
+    MonotonicArena& arena;
+    const bool ignoreEmptyTextElements;
+    String error;
+
+    JUCE_DECLARE_NON_COPYABLE (Parser)
+};
+
+//==============================================================================
+static constexpr size_t maxArenaBlockSize = (size_t) 1 << 22;
+
+XmlArenaDocument::XmlArenaDocument() {}
+XmlArenaDocument::~XmlArenaDocument() {}
+
+void XmlArenaDocument::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+Result XmlArenaDocument::parse (const String& textToParse)
+{
+    text.replaceAll (textToParse.toRawUTF8(), textToParse.getNumBytesAsUTF8() + 1);
+    return parseText();
+}
+
+Result XmlArenaDocument::parse (InputStream& source)
+{
+    text.reset();
+    source.readIntoMemoryBlock (text);
+
+    auto* data = static_cast<const char*> (text.getData());
+
+    if (text.getSize() >= 2 && (CharPointer_UTF16::isByteOrderMarkBigEndian (data)
+                                  || CharPointer_UTF16::isByteOrderMarkLittleEndian (data)))
+        return parse (text.toString());
+
+    text.append ("", 1);
+    return parseText();
+}
+
+Result XmlArenaDocument::parse (const File& file)
+{
+    FileInputStream in (file);
+
+    if (in.failedToOpen())
+        return in.getStatus();
+
+    return parse (in);
+}
+
+Result XmlArenaDocument::parseText()
+{
+    documentElement = nullptr;
+    arena.reset (new MonotonicArena (jlimit ((size_t) 16384, maxArenaBlockSize, text.getSize() / 4), maxArenaBlockSize));
+
+    Parser parser (static_cast<char*> (text.getData()), *arena, ignoreEmptyTextElements);
+    documentElement = parser.parseDocument();
+
+    if (documentElement != nullptr)
+        return Result::ok();
+
+    text.reset();
+    arena.reset();
+    return Result::fail (parser.error);
+}
+
+size_t XmlArenaDocument::getMemoryUsage() const noexcept
+{
+    return text.getSize() + (arena != nullptr ? arena->getCapacity() : 0);
+}
+
+//==============================================================================
+bool XmlArenaDocument::Element::hasTagName (StringRef possibleTagName) const noexcept
+{
+    return ! isText && getTagName() == possibleTagName;
+}
+
+String XmlArenaDocument::Element::getAllSubText() const
+{
+    if (isText)
+        return String::fromUTF8 (content);
+
+    MemoryOutputStream mem (1024);
+
+    for (auto* child = firstChild; child != nullptr; child = child->nextSibling)
+    {
+        if (child->isText)
+            mem.write (child->content, strlen (child->content));
+        else
+            mem << child->getAllSubText();
+    }
+
+    return mem.toUTF8();
+}
+
+int XmlArenaDocument::Element::getNumAttributes() const noexcept
+{
+    int num = 0;
+
+    for (auto* a = firstAttribute; a != nullptr; a = a->nextAttribute)
+        ++num;
+
+    return num;
+}
+
+const XmlArenaDocument::Attribute* XmlArenaDocument::Element::getAttribute (StringRef attributeName) const noexcept
+{
+    for (auto* a = firstAttribute; a != nullptr; a = a->nextAttribute)
+        if (a->getName() == attributeName)
+            return a;
+
+    return nullptr;
+}
+
+StringRef XmlArenaDocument::Element::getStringAttribute (StringRef attributeName, StringRef defaultReturnValue) const noexcept
+{
+    if (auto* a = getAttribute (attributeName))
+        return a->getValue();
+
+    return defaultReturnValue;
+}
+
+int XmlArenaDocument::Element::getIntAttribute (StringRef attributeName, int defaultReturnValue) const noexcept
+{
+    if (auto* a = getAttribute (attributeName))
+        return CharacterFunctions::getIntValue<int> (CharPointer_UTF8 (a->value));
+
+    return defaultReturnValue;
+}
+
+double XmlArenaDocument::Element::getDoubleAttribute (StringRef attributeName, double defaultReturnValue) const noexcept
+{
+    if (auto* a = getAttribute (attributeName))
+        return CharacterFunctions::getDoubleValue (CharPointer_UTF8 (a->value));
+
+    return defaultReturnValue;
+}
+
+bool XmlArenaDocument::Element::getBoolAttribute (StringRef attributeName, bool defaultReturnValue) const noexcept
+{
+    if (auto* a = getAttribute (attributeName))
+    {
+        auto firstChar = *(CharPointer_UTF8 (a->value).findEndOfWhitespace());
+
+        return firstChar == '1'
+            || firstChar == 't'
+            || firstChar == 'y'
+            || firstChar == 'T'
+            || firstChar == 'Y';
+    }
+
+    return defaultReturnValue;
+}
+
+int XmlArenaDocument::Element::getNumChildElements() const noexcept
+{
+    int num = 0;
+
+    for (auto* child = firstChild; child != nullptr; child = child->nextSibling)
+        ++num;
+
+    return num;
+}
+
+const XmlArenaDocument::Element* XmlArenaDocument::Element::getNextElementWithTagName (StringRef requiredTagName) const noexcept
+{
+    auto* e = nextSibling;
+
+    while (e != nullptr && ! e->hasTagName (requiredTagName))
+        e = e->nextSibling;
+
+    return e;
+}
+
+const XmlArenaDocument::Element* XmlArenaDocument::Element::getChildByName (StringRef tagNameToLookFor) const noexcept
+{
+    for (auto* child = firstChild; child != nullptr; child = child->nextSibling)
+        if (child->hasTagName (tagNameToLookFor))
+            return child;
+
+    return nullptr;
+}
+
+std::unique_ptr<XmlElement> XmlArenaDocument::Element::createXmlElement() const
+{
+    if (isText)
+        return std::unique_ptr<XmlElement> (XmlElement::createTextElement (String::fromUTF8 (content)));
+
+    auto tagName = String::CharPointerType (content);
+    auto element = std::make_unique<XmlElement> (tagName, tagName.findTerminatingNull());
+
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+
+    for (auto* a = firstAttribute; a != nullptr; a = a->nextAttribute)
+    {
+        auto name = String::CharPointerType (a->name);
+        auto* attribute = new XmlElement::XmlAttributeNode (name, name.findTerminatingNull());
+        attribute->value = String::fromUTF8 (a->value);
+        attributeAppender.append (attribute);
+    }
+
+    LinkedListPointer<XmlElement>::Appender childAppender (element->firstChildElement);
+
+    for (auto* child = firstChild; child != nullptr; child = child->nextSibling)
+        childAppender.append (child->createXmlElement().release());
+
+    return element;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlArenaDocumentTests  : public UnitTest
+{
+public:
+    XmlArenaDocumentTests()
+        : UnitTest ("XmlArenaDocument", UnitTestCategories::xml)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Parsing");
+        {
+            XmlArenaDocument doc;
+            auto result = doc.parse (CharPointer_UTF8 ("\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+                                                       "<!DOCTYPE doc [ <!ELEMENT doc ANY> ]>\n"
+                                                       "<!-- comment -->\n"
+                                                       "<doc a=\"1\" b = 'x &amp; &lt;y&gt; &#65;&#x20ac;' c=\"2.5\" d=\"yes\">\r\n"
+                                                       "  <empty/>\n"
+                                                       "  text &quot;\xc3\xa9&quot; <!-- ignored --> &unknown; more\r\n\r"
+                                                       "  <![CDATA[<raw> & ]] text]]>\n"
+                                                       "  <n\xc3\xa9st x='y'><?pi data?></n\xc3\xa9st  >\n"
+                                                       "</doc>\n"));
+            expect (result.wasOk(), result.getErrorMessage());
+
+            auto* e = doc.getDocumentElement();
+            expect (e != nullptr && e->hasTagName ("doc"));
+            expectEquals (e->getNumAttributes(), 4);
+            expectEquals (String (e->getStringAttribute ("b")), String (CharPointer_UTF8 ("x & <y> A\xe2\x82\xac")));
+            expectEquals (e->getIntAttribute ("a"), 1);
+            expectEquals (e->getDoubleAttribute ("c"), 2.5);
+            expect (e->getBoolAttribute ("d"));
+            expectEquals (String (e->getStringAttribute ("missing", "default")), String ("default"));
+            expectEquals (e->getNumChildElements(), 4);
+
+            auto* child = e->getFirstChildElement();
+            expect (child->hasTagName ("empty") && child->getFirstChildElement() == nullptr);
+
+            child = child->getNextElement();
+            expect (child->isTextElement());
+            expectEquals (String (child->getText()), String (CharPointer_UTF8 ("\n  text \"\xc3\xa9\"  &unknown; more\n\n  ")));
+
+            child = child->getNextElement();
+            expectEquals (String (child->getText()), String ("<raw> & ]] text"));
+
+            child = child->getNextElement();
+            expectEquals (String (child->getTagName()), String (CharPointer_UTF8 ("n\xc3\xa9st")));
+            expectEquals (String (child->getStringAttribute ("x")), String ("y"));
+            expect (child->getNextElement() == nullptr);
+
+            auto xml = e->createXmlElement();
+            expectEquals (xml->getStringAttribute ("b"), String (CharPointer_UTF8 ("x & <y> A\xe2\x82\xac")));
+            expectEquals (xml->getNumChildElements(), 4);
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto* badXml : { "", "  ", "<a>", "<a></b>", "<a b></a>", "<a b=1/>", "<a b='1></a>", "<a><!-- </a>",
+                                  "<a><![CDATA[x</a>", "<a/ >", "< >", "text", "<a>x" })
+            {
+                XmlArenaDocument doc;
+                expect (doc.parse (String (badXml)).failed(), badXml);
+                expect (doc.getDocumentElement() == nullptr);
+            }
+        }
+
+        beginTest ("Trees match XmlDocument");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto text = XmlReaderTests::createRandomElement (r, 0)->toString();
+                auto ignoreEmptyText = r.nextBool();
+
+                XmlArenaDocument doc;
+                doc.setEmptyTextElementsIgnored (ignoreEmptyText);
+                auto result = doc.parse (text);
+                expect (result.wasOk(), result.getErrorMessage());
+
+                XmlDocument xmlDoc (text);
+                xmlDoc.setEmptyTextElementsIgnored (ignoreEmptyText);
+                auto expected = xmlDoc.getDocumentElement();
+
+                expect (doc.getDocumentElement() != nullptr && expected != nullptr);
+
+                if (doc.getDocumentElement() != nullptr && expected != nullptr)
+                {
+                    expectEquals (doc.getDocumentElement()->createXmlElement()->toString(), expected->toString());
+                    expectEquals (doc.getDocumentElement()->getAllSubText(), expected->getAllSubText());
+                }
+            }
+        }
+
+        beginTest ("Iterating");
+        {
+            XmlArenaDocument doc;
+            expect (doc.parse ("<a><b n='1'/>text<c/><b n='2'/><b n='3'/></a>").wasOk());
+
+            int total = 0, numChildren = 0;
+
+            for (auto* b : doc.getDocumentElement()->getChildWithTagNameIterator ("b"))
+                total += b->getIntAttribute ("n");
+
+            for (auto* child : doc.getDocumentElement()->getChildIterator())
+                numChildren += (child != nullptr ? 1 : 0);
+
+            expectEquals (total, 6);
+            expectEquals (numChildren, 5);
+
+            // The iterator has to keep its own copy of a temporary tag name
+            total = 0;
+
+            for (auto* b : doc.getDocumentElement()->getChildWithTagNameIterator (String ("b")))
+                total += b->getIntAttribute ("n");
+
+            expectEquals (total, 6);
+        }
+    }
+};
+
+static XmlArenaDocumentTests xmlArenaDocumentTests;
+
+#endif
+
+} // namespace juce
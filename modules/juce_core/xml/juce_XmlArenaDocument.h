@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Parses an XML document into a compact, read-only tree that's much quicker to
+    build than a tree of XmlElement objects.
+
+    An XmlDocument creates a separate XmlElement for every element, and a
+    separate heap-allocated Identifier and String for every attribute, which
+    makes parsing large documents slow and memory-hungry. An XmlArenaDocument
+    instead keeps its own copy of the source text and decodes it in place, so that
+    all the tag names, attribute values and text in the tree are just pointers into
+    that buffer. The elements and attributes themselves are all carved out of a
+    few large blocks of memory, so the number of allocations doesn't depend on
+    the size of the document, and they're all freed in one go when the document
+    is deleted or another document is parsed.
+
+    @code
+    XmlArenaDocument session;
+    auto result = session.parse (sessionFile);
+
+    if (result.wasOk())
+    {
+        for (auto* track : session.getDocumentElement()->getChildWithTagNameIterator ("TRACK"))
+            addTrack (track->getStringAttribute ("name"), track->getIntAttribute ("colour"));
+    }
+    @endcode
+
+    The parser accepts the same syntax as XmlDocument, except that entities which
+    are declared in a DTD are left in the text unchanged, and closing tags must
+    match the elements that they close. If you need to modify part of the tree,
+    use Element::createXmlElement() to turn it into an XmlElement.
+
+    The Element and Attribute objects, and all the text that they return, belong to
+    the document, and are only valid until it's deleted or parse() is called again.
+
+    @see XmlDocument, XmlReader, XmlElement
+
+    @tags{Core}
+*/
+class JUCE_API  XmlArenaDocument
+{
+public:
+    //==============================================================================
+    /** Creates an empty document. Call parse() to load some XML into it. */
+    XmlArenaDocument();
+
+    /** Destructor. */
+    ~XmlArenaDocument();
+
+    //==============================================================================
+    /** An attribute of an Element. */
+    class JUCE_API  Attribute
+    {
+    public:
+        /** Returns the attribute's name. */
+        StringRef getName() const noexcept                      { return name; }
+
+        /** Returns the attribute's value, with any entities expanded. */
+        StringRef getValue() const noexcept                     { return value; }
+
+        /** Returns the element's next attribute, or nullptr if this is the last one. */
+        const Attribute* getNextAttribute() const noexcept      { return nextAttribute; }
+
+    private:
+        friend class XmlArenaDocument;
+        Attribute() = default;
+
+        const char* name = nullptr;
+        const char* value = nullptr;
+        Attribute* nextAttribute = nullptr;
+    };
+
+    //==============================================================================
+    /** An element in the document, which is either a tag with attributes and child
+        elements, or a block of text.
+
+        The methods are named after their equivalents in XmlElement.
+    */
+    class JUCE_API  Element
+    {
+    public:
+        //==============================================================================
+        /** Returns the element's tag name, or an empty string for a text element. */
+        StringRef getTagName() const noexcept                   { return isTextElement() ? "" : content; }
+
+        /** Returns true if this element has the given tag name. */
+        bool hasTagName (StringRef possibleTagName) const noexcept;
+
+        /** Returns true if this element is a block of text rather than a tag. */
+        bool isTextElement() const noexcept                     { return isText; }
+
+        /** Returns the text of a text element, or an empty string for other elements. */
+        StringRef getText() const noexcept                      { return isTextElement() ? content : ""; }
+
+        /** Returns all the text from this element's child text elements, and from
+            their children, concatenated.
+        */
+        String getAllSubText() const;
+
+        //==============================================================================
+        /** Returns the number of attributes that this element has. */
+        int getNumAttributes() const noexcept;
+
+        /** Returns the first of this element's attributes, or nullptr if it has none. */
+        const Attribute* getFirstAttribute() const noexcept     { return firstAttribute; }
+
+        /** Returns the attribute with the given name, or nullptr if there isn't one. */
+        const Attribute* getAttribute (StringRef attributeName) const noexcept;
+
+        /** Returns true if the element has an attribute with the given name. */
+        bool hasAttribute (StringRef attributeName) const noexcept    { return getAttribute (attributeName) != nullptr; }
+
+        /** Returns the value of an attribute, or the default value if there's no such attribute. */
+        StringRef getStringAttribute (StringRef attributeName, StringRef defaultReturnValue = {}) const noexcept;
+
+        /** Returns the value of an attribute as an integer, or the default value if there's no such attribute.
+            @see XmlElement::getIntAttribute
+        */
+        int getIntAttribute (StringRef attributeName, int defaultReturnValue = 0) const noexcept;
+
+        /** Returns the value of an attribute as a double, or the default value if there's no such attribute.
+            @see XmlElement::getDoubleAttribute
+        */
+        double getDoubleAttribute (StringRef attributeName, double defaultReturnValue = 0.0) const noexcept;
+
+        /** Returns the value of an attribute as a boolean, or the default value if there's no such attribute.
+            @see XmlElement::getBoolAttribute
+        */
+        bool getBoolAttribute (StringRef attributeName, bool defaultReturnValue = false) const noexcept;
+
+        //==============================================================================
+        /** Returns the number of child elements, including text elements. */
+        int getNumChildElements() const noexcept;
+
+        /** Returns the first child element, or nullptr if there aren't any. */
+        const Element* getFirstChildElement() const noexcept    { return firstChild; }
+
+        /** Returns the next element that has the same parent as this one, or nullptr. */
+        const Element* getNextElement() const noexcept          { return nextSibling; }
+
+        /** Returns the next element with the same parent and the given tag name, or nullptr. */
+        const Element* getNextElementWithTagName (StringRef requiredTagName) const noexcept;
+
+        /** Returns the first child element with the given tag name, or nullptr. */
+        const Element* getChildByName (StringRef tagNameToLookFor) const noexcept;
+
+        //==============================================================================
+        /** Allows iteration over an element's children with a range-based for loop. */
+        class Iterator
+        {
+        public:
+            Iterator() = default;
+            Iterator (const Element* e, String tag) noexcept    : element (e), tagName (std::move (tag)) {}
+
+            Iterator begin() const noexcept                     { return *this; }
+            Iterator end() const noexcept                       { return {}; }
+
+            bool operator== (const Iterator& other) const noexcept  { return element == other.element; }
+            bool operator!= (const Iterator& other) const noexcept  { return ! operator== (other); }
+
+            const Element* operator*() const noexcept           { return element; }
+
+            Iterator& operator++() noexcept
+            {
+                if (element != nullptr)
+                    element = tagName.isEmpty() ? element->getNextElement()
+                                                : element->getNextElementWithTagName (tagName);
+
+                return *this;
+            }
+
+        private:
+            const Element* element = nullptr;
+            String tagName;   // (a copy, as the name passed in is often a temporary)
+        };
+
+        /** Returns an iterator over all of this element's children. */
+        Iterator getChildIterator() const noexcept              { return { firstChild, {} }; }
+
+        /** Returns an iterator over the children of this element which have the given tag name. */
+        Iterator getChildWithTagNameIterator (StringRef tagName) const
+        {
+            jassert (tagName.isNotEmpty());
+            return { getChildByName (tagName), tagName };
+        }
+
+        //==============================================================================
+        /** Creates an XmlElement which is a copy of this element and all its children. */
+        std::unique_ptr<XmlElement> createXmlElement() const;
+
+    private:
+        friend class XmlArenaDocument;
+        Element() = default;
+
+        const char* content = nullptr;
+        Attribute* firstAttribute = nullptr;
+        Element* firstChild = nullptr;
+        Element* nextSibling = nullptr;
+        bool isText = false;
+    };
+
+    //==============================================================================
+    /** Parses some XML text.
+
+        Any tree that was previously loaded is deleted. If the text is valid, this returns
+        Result::ok(), and getDocumentElement() will return its outer element.
+    */
+    Result parse (const String& text);
+
+    /** Reads the whole of a stream and parses it as XML.
+        The stream can be in UTF-8, or in UTF-16 if it begins with a byte-order mark.
+        @see parse
+    */
+    Result parse (InputStream& source);
+
+    /** Loads a file and parses it as XML.
+        @see parse
+    */
+    Result parse (const File& file);
+
+    /** Sets a flag to change the treatment of empty text elements.
+        This works in the same way as XmlDocument::setEmptyTextElementsIgnored(), and must
+        be called before parse() for it to take effect.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+    //==============================================================================
+    /** Returns the outer element of the document, or nullptr if the last call to parse() failed. */
+    const Element* getDocumentElement() const noexcept          { return documentElement; }
+
+    /** Returns the number of bytes that the document is using for its copy of the source
+        text and for its elements and attributes.
+    */
+    size_t getMemoryUsage() const noexcept;
+
+private:
+    //==============================================================================
+    struct Parser;
+
+    MemoryBlock text;
+    std::unique_ptr<MonotonicArena> arena;
+    Element* documentElement = nullptr;
+    bool ignoreEmptyTextElements = true;
+
+    Result parseText();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlArenaDocument)
+};
+
+} // namespace juce
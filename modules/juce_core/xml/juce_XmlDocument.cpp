@@ -105,6 +105,12 @@ namespace XmlIdentifierChars
 
         return p;
     }
+
+    // For parsers that work on raw UTF-8 bytes, which treat any multi-byte character as part of a name
+    static bool isIdentifierByte (char c) noexcept
+    {
+        return (uint8) c >= 0x80 || isIdentifierChar ((juce_wchar) (uint8) c);
+    }
 }
 
 std::unique_ptr<XmlElement> XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentElement)
@@ -774,6 +774,8 @@ private:
     };
 
     friend class XmlDocument;
+    friend class XmlReader;
+    friend class XmlArenaDocument;
     friend class LinkedListPointer<XmlAttributeNode>;
     friend class LinkedListPointer<XmlElement>;
     friend class LinkedListPointer<XmlElement>::Appender;
@@ -0,0 +1,990 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace XmlEntities
+{
+    // The longest entity name that's looked for between an '&' and a ';'
+    static constexpr int maxNameLength = 16;
+
+    // Returns the character that one of the standard entities or a character reference
+    // represents, or 0 if the name between the '&' and ';' isn't one of them.
+    static juce_wchar decode (const char* name, const char* end) noexcept
+    {
+        auto length = (int) (end - name);
+
+        auto isNamed = [&] (const char* entityName, int entityLength)
+        {
+            return length == entityLength
+                    && CharPointer_UTF8 (name).compareIgnoreCaseUpTo (CharPointer_ASCII (entityName), entityLength) == 0;
+        };
+
+        if (isNamed ("amp", 3))   return '&';
+        if (isNamed ("quot", 4))  return '"';
+        if (isNamed ("apos", 4))  return '\'';
+        if (isNamed ("lt", 2))    return '<';
+        if (isNamed ("gt", 2))    return '>';
+
+        if (length < 2 || *name != '#')
+            return 0;
+
+        uint32 charCode = 0;
+
+        if (name[1] == 'x' || name[1] == 'X')
+        {
+            if (length < 3 || length > 10)
+                return 0;
+
+            for (auto* p = name + 2; p < end; ++p)
+            {
+                auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) *p);
+
+                if (digitValue < 0)
+                    return 0;
+
+                charCode = (charCode << 4) | (uint32) digitValue;
+            }
+        }
+        else
+        {
+            if (length > 8)
+                return 0;
+
+            for (auto* p = name + 1; p < end; ++p)
+            {
+                if (! isPositiveAndBelow (*p - '0', 10))
+                    return 0;
+
+                charCode = charCode * 10 + (uint32) (*p - '0');
+            }
+        }
+
+        return charCode <= 0x10ffff ? (juce_wchar) charCode : 0;
+    }
+}
+
+//==============================================================================
+static const int xmlReaderBufferSize = 32768;
+
+XmlReader::XmlReader (InputStream& source)
+    : input (source), buffer ((size_t) xmlReaderBufferSize)
+{
+    readPosition = bufferEnd = buffer.get();
+}
+
+XmlReader::~XmlReader() {}
+
+void XmlReader::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+//==============================================================================
+bool XmlReader::ensureAvailable (int numBytes)
+{
+    jassert (numBytes <= xmlReaderBufferSize);
+
+    while (bufferEnd - readPosition < numBytes)
+    {
+        if (reachedEndOfInput)
+            return false;
+
+        // move whatever's left to the start of the buffer, and fill up the space after it
+        auto numLeft = (int) (bufferEnd - readPosition);
+        bufferStartPosition += readPosition - buffer.get();
+        memmove (buffer.get(), readPosition, (size_t) numLeft);
+
+        auto numRead = input.read (buffer.get() + numLeft, xmlReaderBufferSize - numLeft);
+        reachedEndOfInput = (numRead <= 0);
+
+        readPosition = buffer.get();
+        bufferEnd = readPosition + numLeft + jmax (0, numRead);
+    }
+
+    return true;
+}
+
+int XmlReader::peekByte()
+{
+    if (readPosition == bufferEnd && ! ensureAvailable (1))
+        return -1;
+
+    return (uint8) *readPosition;
+}
+
+bool XmlReader::matches (const char* text, int numBytes)
+{
+    return ensureAvailable (numBytes) && memcmp (readPosition, text, (size_t) numBytes) == 0;
+}
+
+void XmlReader::skipWhitespace()
+{
+    for (;;)
+    {
+        while (readPosition < bufferEnd && CharacterFunctions::isWhitespace (*readPosition))
+            ++readPosition;
+
+        if (readPosition < bufferEnd || ! ensureAvailable (1))
+            return;
+    }
+}
+
+bool XmlReader::skipPast (const char* terminator, int terminatorLength)
+{
+    for (;;)
+    {
+        if (! ensureAvailable (terminatorLength))
+        {
+            readPosition = bufferEnd;
+            return false;
+        }
+
+        auto* lastStart = bufferEnd - (terminatorLength - 1);
+        auto* found = static_cast<const char*> (memchr (readPosition, *terminator, (size_t) (lastStart - readPosition)));
+
+        if (found == nullptr)
+        {
+            readPosition = lastStart;
+            continue;
+        }
+
+        readPosition = found;
+
+        if (memcmp (found, terminator, (size_t) terminatorLength) == 0)
+        {
+            readPosition += terminatorLength;
+            return true;
+        }
+
+        ++readPosition;
+    }
+}
+
+bool XmlReader::skipDTD()
+{
+    for (int depth = 1; depth > 0;)
+    {
+        auto c = peekByte();
+
+        if (c < 0)
+            return false;
+
+        ++readPosition;
+
+        if (c == '<')
+            ++depth;
+        else if (c == '>')
+            --depth;
+    }
+
+    return true;
+}
+
+int64 XmlReader::getPosition() const noexcept
+{
+    return bufferStartPosition + (readPosition - buffer.get());
+}
+
+XmlReader::Token XmlReader::fail (const String& message)
+{
+    error = Result::fail ("byte " + String (getPosition()) + ": " + message);
+    return currentToken = Token::error;
+}
+
+//==============================================================================
+XmlReader::Token XmlReader::next()
+{
+    if (currentToken == Token::error || currentToken == Token::endOfStream)
+        return currentToken;
+
+    if (currentToken == Token::none && matches ("\xef\xbb\xbf", 3))
+        readPosition += 3;
+
+    if (isEmptyElement)
+    {
+        // the tag name is still at the start of the token text
+        isEmptyElement = false;
+        attributeOffsets.clearQuick();
+        return closeElement();
+    }
+
+    for (;;)
+    {
+        auto c = peekByte();
+
+        if (c < 0)
+        {
+            if (openElementStarts.isEmpty())
+                return currentToken = Token::endOfStream;
+
+            return fail ("unmatched tags");
+        }
+
+        if (c != '<')
+        {
+            if (openElementStarts.isEmpty())
+            {
+                if (! CharacterFunctions::isWhitespace ((char) c))
+                    return fail ("text found outside the document element");
+
+                skipWhitespace();
+                continue;
+            }
+
+            auto token = readText();
+
+            if (token != Token::none)
+                return token;
+
+            continue;
+        }
+
+        if (matches ("<!--", 4))
+        {
+            readPosition += 4;
+
+            if (! skipPast ("-->", 3))
+                return fail ("unterminated comment");
+
+            continue;
+        }
+
+        if (matches ("<?", 2))
+        {
+            readPosition += 2;
+
+            if (! skipPast ("?>", 2))
+                return fail ("unterminated processing instruction");
+
+            continue;
+        }
+
+        if (matches ("<!DOCTYPE", 9))
+        {
+            readPosition += 9;
+
+            if (! skipDTD())
+                return fail ("malformed DTD");
+
+            continue;
+        }
+
+        if (matches ("<![CDATA[", 9))
+        {
+            if (openElementStarts.isEmpty())
+                return fail ("text found outside the document element");
+
+            readPosition += 9;
+            return readCDATA();
+        }
+
+        if (matches ("</", 2))
+        {
+            readPosition += 2;
+            return readEndTag();
+        }
+
+        ++readPosition;
+        return readStartTag();
+    }
+}
+
+bool XmlReader::readName()
+{
+    bool anyChars = false;
+
+    for (;;)
+    {
+        auto* start = readPosition;
+
+        while (readPosition < bufferEnd && XmlIdentifierChars::isIdentifierByte (*readPosition))
+            ++readPosition;
+
+        if (readPosition != start)
+        {
+            tokenText.write (start, (size_t) (readPosition - start));
+            anyChars = true;
+        }
+
+        if (readPosition < bufferEnd || ! ensureAvailable (1))
+            return anyChars;
+    }
+}
+
+XmlReader::Token XmlReader::readStartTag()
+{
+    tokenText.reset();
+    attributeOffsets.clearQuick();
+
+    // (like XmlDocument, this allows a gap after the '<')
+    skipWhitespace();
+
+    if (! readName())
+        return fail ("tag name missing");
+
+    auto tagNameLength = (int) tokenText.getDataSize();
+    tokenText.writeByte (0);
+
+    for (;;)
+    {
+        skipWhitespace();
+        auto c = peekByte();
+
+        if (c == '>')
+        {
+            ++readPosition;
+            break;
+        }
+
+        if (c == '/')
+        {
+            ++readPosition;
+
+            if (peekByte() != '>')
+                return fail ("illegal character found in " + String::fromUTF8 (getTokenText (0)) + ": '/'");
+
+            ++readPosition;
+            isEmptyElement = true;
+            break;
+        }
+
+        if (c < 0)
+            return fail ("unexpected end of input");
+
+        if (! XmlIdentifierChars::isIdentifierByte ((char) c))
+            return fail ("illegal character found in " + String::fromUTF8 (getTokenText (0))
+                           + ": '" + String::charToString ((juce_wchar) c) + "'");
+
+        auto nameOffset = (int) tokenText.getDataSize();
+        readName();
+        tokenText.writeByte (0);
+        skipWhitespace();
+
+        if (peekByte() != '=')
+            return fail ("expected '=' after attribute '" + String::fromUTF8 (getTokenText (nameOffset)) + "'");
+
+        ++readPosition;
+        skipWhitespace();
+        auto quote = peekByte();
+
+        if (quote != '"' && quote != '\'')
+            return fail ("expected a quoted value for attribute '" + String::fromUTF8 (getTokenText (nameOffset)) + "'");
+
+        ++readPosition;
+        auto valueOffset = (int) tokenText.getDataSize();
+
+        if (! readAttributeValue ((char) quote))
+            return fail ("unmatched quotes");
+
+        tokenText.writeByte (0);
+        attributeOffsets.add (nameOffset, valueOffset);
+    }
+
+    openElementStarts.add (openElementNames.size());
+    openElementNames.addArray (getTokenText (0), tagNameLength + 1);
+    return currentToken = Token::startElement;
+}
+
+XmlReader::Token XmlReader::readEndTag()
+{
+    tokenText.reset();
+    attributeOffsets.clearQuick();
+    readName();
+    tokenText.writeByte (0);
+    skipWhitespace();
+
+    if (peekByte() != '>')
+        return fail ("expected '>' after closing tag");
+
+    ++readPosition;
+
+    if (openElementStarts.isEmpty())
+        return fail ("unexpected closing tag: " + String::fromUTF8 (getTokenText (0)));
+
+    auto* openTagName = openElementNames.begin() + openElementStarts.getLast();
+
+    if (strcmp (openTagName, getTokenText (0)) != 0)
+        return fail ("mismatched tags: expected </" + String::fromUTF8 (openTagName) + ">");
+
+    return closeElement();
+}
+
+XmlReader::Token XmlReader::closeElement()
+{
+    openElementNames.resize (openElementStarts.getLast());
+    openElementStarts.removeLast();
+    return currentToken = Token::endElement;
+}
+
+juce_wchar XmlReader::readEntity()
+{
+    ensureAvailable (XmlEntities::maxNameLength + 2);
+
+    auto* nameStart = readPosition + 1;
+    auto* searchEnd = jmin (bufferEnd, nameStart + XmlEntities::maxNameLength + 1);
+
+    if (auto* semicolon = static_cast<const char*> (memchr (nameStart, ';', (size_t) (searchEnd - nameStart))))
+    {
+        if (auto c = XmlEntities::decode (nameStart, semicolon))
+        {
+            if (! isSkipping)
+                tokenText.appendUTF8Char (c);
+
+            readPosition = semicolon + 1;
+            return c;
+        }
+    }
+
+    // not a standard entity, so leave it in the text
+    if (! isSkipping)
+        tokenText.writeByte ('&');
+
+    ++readPosition;
+    return '&';
+}
+
+bool XmlReader::readAttributeValue (char quote)
+{
+    for (;;)
+    {
+        auto* start = readPosition;
+
+        while (readPosition < bufferEnd && *readPosition != quote && *readPosition != '&')
+            ++readPosition;
+
+        if (! isSkipping)
+            tokenText.write (start, (size_t) (readPosition - start));
+
+        if (readPosition == bufferEnd)
+        {
+            if (! ensureAvailable (1))
+                return false;
+
+            continue;
+        }
+
+        if (*readPosition == quote)
+        {
+            ++readPosition;
+            return true;
+        }
+
+        readEntity();
+    }
+}
+
+XmlReader::Token XmlReader::readText()
+{
+    tokenText.reset();
+    attributeOffsets.clearQuick();
+    bool containsNonWhitespace = false, containsEntities = false;
+
+    for (;;)
+    {
+        auto* start = readPosition;
+
+        while (readPosition < bufferEnd)
+        {
+            auto c = *readPosition;
+
+            if (c == '<' || c == '&' || c == '\r')
+                break;
+
+            containsNonWhitespace = containsNonWhitespace || ! CharacterFunctions::isWhitespace (c);
+            ++readPosition;
+        }
+
+        if (! isSkipping)
+            tokenText.write (start, (size_t) (readPosition - start));
+
+        if (readPosition == bufferEnd)
+        {
+            if (! ensureAvailable (1))
+                return fail ("unmatched tags");
+
+            continue;
+        }
+
+        auto c = *readPosition;
+
+        if (c == '\r')
+        {
+            // line-endings are normalised to a single '\n', as they are by XmlDocument
+            ++readPosition;
+
+            if (peekByte() != '\n' && ! isSkipping)
+                tokenText.writeByte ('\n');
+
+            continue;
+        }
+
+        if (c == '&')
+        {
+            containsEntities = true;
+            containsNonWhitespace = ! CharacterFunctions::isWhitespace (readEntity()) || containsNonWhitespace;
+            continue;
+        }
+
+        if (matches ("<!--", 4))
+        {
+            readPosition += 4;
+
+            if (! skipPast ("-->", 3))
+                return fail ("unterminated comment");
+
+            continue;
+        }
+
+        break;
+    }
+
+    // Like XmlDocument, this always drops whitespace that runs up to a tag, and only
+    // keeps whitespace that includes an entity if empty text isn't being ignored
+    if (! (containsNonWhitespace || (containsEntities && ! ignoreEmptyTextElements)))
+        return Token::none;
+
+    tokenText.writeByte (0);
+    return currentToken = Token::text;
+}
+
+XmlReader::Token XmlReader::readCDATA()
+{
+    tokenText.reset();
+    attributeOffsets.clearQuick();
+
+    for (;;)
+    {
+        auto* start = readPosition;
+        auto* bracket = static_cast<const char*> (memchr (readPosition, ']', (size_t) (bufferEnd - readPosition)));
+        readPosition = bracket != nullptr ? bracket : bufferEnd;
+
+        if (! isSkipping)
+            tokenText.write (start, (size_t) (readPosition - start));
+
+        if (readPosition == bufferEnd)
+        {
+            if (! ensureAvailable (1))
+                return fail ("unterminated CDATA section");
+
+            continue;
+        }
+
+        if (matches ("]]>", 3))
+        {
+            readPosition += 3;
+            break;
+        }
+
+        if (! isSkipping)
+            tokenText.writeByte (']');
+
+        ++readPosition;
+    }
+
+    tokenText.writeByte (0);
+    return currentToken = Token::text;
+}
+
+//==============================================================================
+const char* XmlReader::getTokenText (int offset) const noexcept
+{
+    return static_cast<const char*> (tokenText.getData()) + offset;
+}
+
+StringRef XmlReader::getTagName() const noexcept
+{
+    if (currentToken == Token::startElement || currentToken == Token::endElement)
+        return getTokenText (0);
+
+    return {};
+}
+
+bool XmlReader::hasTagName (StringRef possibleTagName) const noexcept
+{
+    return (currentToken == Token::startElement || currentToken == Token::endElement)
+             && StringRef (getTokenText (0)) == possibleTagName;
+}
+
+StringRef XmlReader::getAttributeName (int attributeIndex) const noexcept
+{
+    if (isPositiveAndBelow (attributeIndex, getNumAttributes()))
+        return getTokenText (attributeOffsets.getUnchecked (attributeIndex * 2));
+
+    return {};
+}
+
+StringRef XmlReader::getAttributeValue (int attributeIndex) const noexcept
+{
+    if (isPositiveAndBelow (attributeIndex, getNumAttributes()))
+        return getTokenText (attributeOffsets.getUnchecked (attributeIndex * 2 + 1));
+
+    return {};
+}
+
+const char* XmlReader::findAttribute (StringRef attributeName) const noexcept
+{
+    for (int i = 0; i < attributeOffsets.size(); i += 2)
+        if (StringRef (getTokenText (attributeOffsets.getUnchecked (i))) == attributeName)
+            return getTokenText (attributeOffsets.getUnchecked (i + 1));
+
+    return nullptr;
+}
+
+bool XmlReader::hasAttribute (StringRef attributeName) const noexcept
+{
+    return findAttribute (attributeName) != nullptr;
+}
+
+StringRef XmlReader::getStringAttribute (StringRef attributeName, StringRef defaultReturnValue) const noexcept
+{
+    if (auto* value = findAttribute (attributeName))
+        return value;
+
+    return defaultReturnValue;
+}
+
+int XmlReader::getIntAttribute (StringRef attributeName, int defaultReturnValue) const noexcept
+{
+    if (auto* value = findAttribute (attributeName))
+        return CharacterFunctions::getIntValue<int> (String::CharPointerType (value));
+
+    return defaultReturnValue;
+}
+
+double XmlReader::getDoubleAttribute (StringRef attributeName, double defaultReturnValue) const noexcept
+{
+    if (auto* value = findAttribute (attributeName))
+        return CharacterFunctions::getDoubleValue (String::CharPointerType (value));
+
+    return defaultReturnValue;
+}
+
+bool XmlReader::getBoolAttribute (StringRef attributeName, bool defaultReturnValue) const noexcept
+{
+    if (auto* value = findAttribute (attributeName))
+    {
+        auto firstChar = *(String::CharPointerType (value).findEndOfWhitespace());
+
+        return firstChar == '1'
+            || firstChar == 't'
+            || firstChar == 'y'
+            || firstChar == 'T'
+            || firstChar == 'Y';
+    }
+
+    return defaultReturnValue;
+}
+
+StringRef XmlReader::getText() const noexcept
+{
+    if (currentToken == Token::text)
+        return getTokenText (0);
+
+    return {};
+}
+
+//==============================================================================
+std::unique_ptr<XmlElement> XmlReader::readElement()
+{
+    if (currentToken == Token::text)
+        return std::unique_ptr<XmlElement> (XmlElement::createTextElement (String::fromUTF8 (getTokenText (0),
+                                                                                             (int) tokenText.getDataSize() - 1)));
+
+    if (currentToken != Token::startElement)
+        return {};
+
+    auto tagName = String::CharPointerType (getTokenText (0));
+    auto element = std::make_unique<XmlElement> (tagName, tagName.findTerminatingNull());
+
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+
+    for (int i = 0; i < attributeOffsets.size(); i += 2)
+    {
+        auto name = String::CharPointerType (getTokenText (attributeOffsets.getUnchecked (i)));
+        auto* attribute = new XmlElement::XmlAttributeNode (name, name.findTerminatingNull());
+        attribute->value = String (String::CharPointerType (getTokenText (attributeOffsets.getUnchecked (i + 1))));
+        attributeAppender.append (attribute);
+    }
+
+    LinkedListPointer<XmlElement>::Appender childAppender (element->firstChildElement);
+
+    for (;;)
+    {
+        auto token = next();
+
+        if (token == Token::endElement)
+            return element;
+
+        if (token != Token::startElement && token != Token::text)
+            return {};
+
+        auto child = readElement();
+
+        if (child == nullptr)
+            return {};
+
+        childAppender.append (child.release());
+    }
+}
+
+void XmlReader::skip()
+{
+    if (currentToken != Token::startElement)
+        return;
+
+    auto depth = getDepth();
+    const ScopedValueSetter<bool> svs (isSkipping, true);
+
+    while (getDepth() >= depth)
+    {
+        auto token = next();
+
+        if (token == Token::error || token == Token::endOfStream)
+            break;
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlReaderTests  : public UnitTest
+{
+public:
+    XmlReaderTests()
+        : UnitTest ("XmlReader", UnitTestCategories::xml)
+    {}
+
+    // Hands out its data a few bytes at a time, so that tokens get split between reads
+    struct TrickleInputStream  : public MemoryInputStream
+    {
+        TrickleInputStream (const MemoryBlock& block, Random& r)
+            : MemoryInputStream (block, false), random (r)
+        {}
+
+        int read (void* dest, int maxBytes) override
+        {
+            return MemoryInputStream::read (dest, jmin (maxBytes, 1 + random.nextInt (7)));
+        }
+
+        Random& random;
+    };
+
+    static MemoryBlock toMemoryBlock (const String& text)
+    {
+        return { text.toRawUTF8(), text.getNumBytesAsUTF8() };
+    }
+
+    static Array<XmlReader::Token> readAllTokens (const String& text)
+    {
+        MemoryInputStream in (toMemoryBlock (text), true);
+        XmlReader reader (in);
+        Array<XmlReader::Token> tokens;
+
+        for (;;)
+        {
+            tokens.add (reader.next());
+
+            if (tokens.getLast() == XmlReader::Token::endOfStream || tokens.getLast() == XmlReader::Token::error)
+                return tokens;
+        }
+    }
+
+    static String createRandomText (Random& r)
+    {
+        static const char* const pieces[] = { "abc", " ", "&", "<", ">", "\"", "'", "\n", "]]", "x y", "\xc3\xa9", "\xe2\x82\xac", "123" };
+        String s;
+
+        for (int i = r.nextInt (6); --i >= 0;)
+            s << String (CharPointer_UTF8 (pieces[r.nextInt (numElementsInArray (pieces))]));
+
+        return s;
+    }
+
+    static std::unique_ptr<XmlElement> createRandomElement (Random& r, int depth)
+    {
+        auto element = std::make_unique<XmlElement> ("E" + String (r.nextInt (5)));
+
+        for (int i = r.nextInt (4); --i >= 0;)
+            element->setAttribute ("a" + String (i), createRandomText (r));
+
+        if (depth < 4)
+        {
+            for (int i = r.nextInt (5); --i >= 0;)
+            {
+                if (r.nextInt (3) == 0)
+                    element->addTextElement (createRandomText (r));
+                else
+                    element->addChildElement (createRandomElement (r, depth + 1).release());
+            }
+        }
+
+        return element;
+    }
+
+    void runTest() override
+    {
+        using Token = XmlReader::Token;
+
+        beginTest ("Tokens");
+        {
+            MemoryInputStream in (toMemoryBlock (CharPointer_UTF8 ("\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+                                                                   "<!DOCTYPE doc [ <!ELEMENT doc ANY> ]>\n"
+                                                                   "<!-- comment -->\n"
+                                                                   "<doc a=\"1\" b = 'x &amp; &lt;y&gt; &#65;&#x42;'>\r\n"
+                                                                   "  <empty  c=\"true\"/>\n"
+                                                                   "  text &quot;\xc3\xa9&quot; <!-- ignored --> more\r\n\r"
+                                                                   "  <![CDATA[<raw> & ]] text]]>\n"
+                                                                   "  <n\xc3\xa9st><?pi data?></n\xc3\xa9st  >\n"
+                                                                   "</doc>\n")), true);
+            XmlReader reader (in);
+
+            expect (reader.next() == Token::startElement);
+            expectEquals (String (reader.getTagName()), String ("doc"));
+            expectEquals (reader.getDepth(), 1);
+            expectEquals (reader.getNumAttributes(), 2);
+            expectEquals (String (reader.getAttributeName (1)), String ("b"));
+            expectEquals (String (reader.getAttributeValue (1)), String ("x & <y> AB"));
+            expectEquals (reader.getIntAttribute ("a"), 1);
+            expectEquals (reader.getIntAttribute ("missing", 7), 7);
+            expect (! reader.hasAttribute ("c"));
+
+            expect (reader.next() == Token::startElement);
+            expect (reader.hasTagName ("empty"));
+            expect (reader.getBoolAttribute ("c"));
+            expectEquals (reader.getDepth(), 2);
+            expect (reader.next() == Token::endElement);
+            expect (reader.hasTagName ("empty"));
+            expectEquals (reader.getNumAttributes(), 0);
+            expectEquals (reader.getDepth(), 1);
+
+            expect (reader.next() == Token::text);
+            expectEquals (String (reader.getText()), String (CharPointer_UTF8 ("\n  text \"\xc3\xa9\"  more\n\n  ")));
+
+            expect (reader.next() == Token::text);
+            expectEquals (String (reader.getText()), String ("<raw> & ]] text"));
+
+            expect (reader.next() == Token::startElement);
+            expectEquals (String (reader.getTagName()), String (CharPointer_UTF8 ("n\xc3\xa9st")));
+            expect (reader.next() == Token::endElement);
+            expect (reader.next() == Token::endElement);
+            expect (reader.hasTagName ("doc"));
+            expectEquals (reader.getDepth(), 0);
+            expect (reader.next() == Token::endOfStream);
+            expect (reader.next() == Token::endOfStream);
+            expect (reader.getError().wasOk());
+        }
+
+        beginTest ("Empty text");
+        {
+            auto text = toMemoryBlock ("<a> <b/>&#32;\n</a>");
+
+            {
+                MemoryInputStream in (text, false);
+                XmlReader reader (in);
+                reader.setEmptyTextElementsIgnored (false);
+
+                expect (reader.next() == Token::startElement);
+                expect (reader.next() == Token::startElement);
+                expect (reader.next() == Token::endElement);
+                expect (reader.next() == Token::text);
+                expectEquals (String (reader.getText()), String (" \n"));
+                expect (reader.next() == Token::endElement);
+            }
+
+            expect (readAllTokens (text.toString()) == Array<Token> { Token::startElement, Token::startElement, Token::endElement,
+                                                                      Token::endElement, Token::endOfStream });
+        }
+
+        beginTest ("Multiple elements");
+        {
+            expect (readAllTokens ("<a x='1'/>\n<b>t</b>\n") == Array<Token> { Token::startElement, Token::endElement,
+                                                                               Token::startElement, Token::text, Token::endElement,
+                                                                               Token::endOfStream });
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto* badXml : { "<a>", "<a></b>", "</a>", "<a b></a>", "<a b=1/>", "<a b='1></a>", "<a><!-- </a>",
+                                  "<a><![CDATA[x</a>", "<a/ >", "< >", "text", "<a>x", "<a></a>x" })
+            {
+                auto tokens = readAllTokens (badXml);
+                expect (tokens.getLast() == Token::error, badXml);
+            }
+        }
+
+        beginTest ("Elements match XmlDocument");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto text = createRandomElement (r, 0)->toString (XmlElement::TextFormat().withoutHeader());
+                auto data = toMemoryBlock (text);
+                auto ignoreEmptyText = r.nextBool();
+
+                TrickleInputStream in (data, r);
+                XmlReader reader (in);
+                reader.setEmptyTextElementsIgnored (ignoreEmptyText);
+                reader.next();
+                auto element = reader.readElement();
+
+                expect (reader.getError().wasOk(), reader.getError().getErrorMessage());
+                expect (reader.next() == Token::endOfStream);
+
+                XmlDocument doc (text);
+                doc.setEmptyTextElementsIgnored (ignoreEmptyText);
+                auto expected = doc.getDocumentElement();
+
+                expect (element != nullptr && expected != nullptr);
+
+                if (element != nullptr && expected != nullptr)
+                    expectEquals (element->toString(), expected->toString());
+            }
+        }
+
+        beginTest ("Skipping");
+        {
+            MemoryInputStream in (toMemoryBlock ("<doc><skipped a=\"1\"><x><y>text</y></x><x/></skipped><kept b=\"2\">t</kept></doc>"), true);
+            XmlReader reader (in);
+
+            expect (reader.next() == Token::startElement);
+            expect (reader.next() == Token::startElement);
+            reader.skip();
+            expect (reader.getCurrentToken() == Token::endElement);
+            expect (reader.hasTagName ("skipped"));
+            expect (reader.next() == Token::startElement);
+            auto kept = reader.readElement();
+            expect (kept != nullptr && kept->getIntAttribute ("b") == 2 && kept->getAllSubText() == "t");
+            expect (reader.next() == Token::endElement);
+            expect (reader.next() == Token::endOfStream);
+        }
+    }
+};
+
+static XmlReaderTests xmlReaderTests;
+
+#endif
+
+} // namespace juce
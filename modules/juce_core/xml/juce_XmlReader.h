@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Parses a text-based XML document from a stream, one tag or piece of text at a time.
+
+    Instead of creating an XmlElement for the whole document like XmlDocument does,
+    this steps through the start tags, end tags and text in the order in which they
+    appear. When the reader is at a start tag, you can call readElement() to turn
+    just that element into an XmlElement, or skip() to jump past it and all of its
+    children.
+
+    e.g.
+    @code
+    FileInputStream in (sessionFile);
+    XmlReader reader (in);
+
+    while (reader.next() != XmlReader::Token::endOfStream)
+    {
+        if (reader.getCurrentToken() == XmlReader::Token::error)
+        {
+            DBG (reader.getError().getErrorMessage());
+            break;
+        }
+
+        if (reader.getCurrentToken() == XmlReader::Token::startElement)
+        {
+            if (reader.hasTagName ("TRACK"))
+                addTrack (reader.getStringAttribute ("name"), reader.getIntAttribute ("colour"));
+            else if (reader.hasTagName ("PLUGINSTATE"))
+                loadPluginState (reader.readElement());
+            else if (reader.hasTagName ("UNDOHISTORY"))
+                reader.skip();
+        }
+    }
+    @endcode
+
+    An empty element such as \<foo/\> produces a startElement token followed by an
+    endElement token, just like \<foo\>\</foo\>. Comments, processing instructions
+    and the DTD are skipped. The standard entities and character references are
+    expanded, but unlike XmlDocument, the reader won't load entities that are declared
+    in the DTD, and leaves them in the text as they are. It does check that each
+    closing tag matches its opening tag.
+
+    The stream must be UTF-8, and may contain more than one top-level element.
+
+    @see XmlDocument, XmlArenaDocument
+
+    @tags{Core}
+*/
+class JUCE_API  XmlReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a stream.
+        The stream isn't owned by the reader, so must remain valid until the reader is deleted.
+    */
+    explicit XmlReader (InputStream& source);
+
+    /** Destructor. */
+    ~XmlReader();
+
+    //==============================================================================
+    /** The kinds of token that the reader can find. */
+    enum class Token
+    {
+        none,           /**< next() hasn't been called yet. */
+        startElement,   /**< The opening tag of an element. Its name and attributes are available. */
+        endElement,     /**< The closing tag of an element. Its name is available. */
+        text,           /**< A block of text or a CDATA section. */
+        endOfStream,    /**< There's nothing left to read. */
+        error           /**< The data wasn't valid XML. Use getError() for the details. */
+    };
+
+    /** Reads the next token from the stream, and returns its type.
+        Once the end of the stream or an error has been reached, this will keep returning
+        the same thing.
+    */
+    Token next();
+
+    /** Returns the token that the last call to next() returned. */
+    Token getCurrentToken() const noexcept              { return currentToken; }
+
+    /** Returns the number of elements that the current token is inside.
+        The start token of an element counts as being inside it, but its end token doesn't.
+    */
+    int getDepth() const noexcept                       { return openElementStarts.size(); }
+
+    /** Sets a flag to change the treatment of empty text elements.
+
+        If this is true (the default state), then any blocks of text that contain only
+        whitespace characters will be skipped, in the same way as
+        XmlDocument::setEmptyTextElementsIgnored().
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+    //==============================================================================
+    /** Returns the tag name of the current startElement or endElement token.
+        The text is only valid until the next call to next(), so make a copy if you need to keep it.
+    */
+    StringRef getTagName() const noexcept;
+
+    /** Returns true if the current token is the start or end of an element with this tag name. */
+    bool hasTagName (StringRef possibleTagName) const noexcept;
+
+    /** Returns the number of attributes of the current startElement token. */
+    int getNumAttributes() const noexcept               { return attributeOffsets.size() / 2; }
+
+    /** Returns the name of one of the current element's attributes.
+        The text is only valid until the next call to next(), so make a copy if you need to keep it.
+    */
+    StringRef getAttributeName (int attributeIndex) const noexcept;
+
+    /** Returns the value of one of the current element's attributes.
+        The text is only valid until the next call to next(), so make a copy if you need to keep it.
+    */
+    StringRef getAttributeValue (int attributeIndex) const noexcept;
+
+    /** Returns true if the current element has an attribute with this name. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    /** Returns the value of one of the current element's attributes, or the default
+        value if it doesn't have an attribute with this name.
+        The text is only valid until the next call to next(), so make a copy if you need to keep it.
+    */
+    StringRef getStringAttribute (StringRef attributeName, StringRef defaultReturnValue = {}) const noexcept;
+
+    /** Returns the value of one of the current element's attributes as an integer, or
+        the default value if it doesn't have an attribute with this name.
+        @see XmlElement::getIntAttribute
+    */
+    int getIntAttribute (StringRef attributeName, int defaultReturnValue = 0) const noexcept;
+
+    /** Returns the value of one of the current element's attributes as a double, or
+        the default value if it doesn't have an attribute with this name.
+        @see XmlElement::getDoubleAttribute
+    */
+    double getDoubleAttribute (StringRef attributeName, double defaultReturnValue = 0.0) const noexcept;
+
+    /** Returns the value of one of the current element's attributes as a boolean, or
+        the default value if it doesn't have an attribute with this name.
+        @see XmlElement::getBoolAttribute
+    */
+    bool getBoolAttribute (StringRef attributeName, bool defaultReturnValue = false) const noexcept;
+
+    /** Returns the content of the current text token, with any entities expanded.
+        The text is only valid until the next call to next(), so make a copy if you need to keep it.
+    */
+    StringRef getText() const noexcept;
+
+    //==============================================================================
+    /** Reads the whole of the element that starts with the current token.
+
+        If the current token is a startElement, this will read everything up to and
+        including its endElement token, and return it as an XmlElement. If the current
+        token is some text, it returns a text element. For other tokens, or if an
+        error is found, it returns nullptr, and getError() will describe any error.
+    */
+    std::unique_ptr<XmlElement> readElement();
+
+    /** Skips over the element that starts with the current token.
+
+        If the current token is a startElement, this reads up to and including its
+        endElement token without keeping any of the text inside it, which is quicker
+        than reading it. For any other token, this does nothing.
+    */
+    void skip();
+
+    //==============================================================================
+    /** Returns the number of bytes of the stream that have been read so far. */
+    int64 getPosition() const noexcept;
+
+    /** Returns an error if the stream contained invalid XML, or Result::ok() otherwise. */
+    Result getError() const                             { return error; }
+
+private:
+    //==============================================================================
+    InputStream& input;
+    HeapBlock<char> buffer;
+    const char* readPosition = nullptr;
+    const char* bufferEnd = nullptr;
+    int64 bufferStartPosition = 0;
+    bool reachedEndOfInput = false;
+    MemoryOutputStream tokenText;
+    Array<int> attributeOffsets;
+    Array<char> openElementNames;
+    Array<int> openElementStarts;
+    Token currentToken = Token::none;
+    bool isEmptyElement = false, ignoreEmptyTextElements = true, isSkipping = false;
+    Result error { Result::ok() };
+
+    bool ensureAvailable (int numBytes);
+    int peekByte();
+    bool matches (const char* text, int numBytes);
+    void skipWhitespace();
+    bool skipPast (const char* terminator, int terminatorLength);
+    bool skipDTD();
+    bool readName();
+    juce_wchar readEntity();
+    bool readAttributeValue (char quote);
+    Token readText();
+    Token readCDATA();
+    Token readStartTag();
+    Token readEndTag();
+    Token closeElement();
+    Token fail (const String& message);
+    const char* getTokenText (int offset) const noexcept;
+    const char* findAttribute (StringRef attributeName) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlReader)
+};
+
+} // namespace juce